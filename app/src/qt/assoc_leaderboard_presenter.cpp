@@ -59,7 +59,6 @@ void AssocLeaderboardPresenter::slotShowNote(const QItemSelection& selected, con
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
         note->incReads();
-        note->makeDirty();
 
         orloj->showFacetNoteView(note);
     } // else do nothing
@@ -112,6 +112,11 @@ void CliAndBreadcrumbsPresenter::executeCommand()
                     outlines = mind->findOutlineByNameFts(name);
                 }
             }
+            if(!outlines || !outlines->size()) {
+                // typo in the name
+                outlines.reset(new vector<Outline*>{});
+                mind->findOutlineByNameFuzzy(name, *outlines, 1);
+            }
             if(outlines && outlines->size()) {
                 mainPresenter->getOrloj()->showFacetOutline(outlines->front());
                 // TODO efficient
@@ -25,7 +25,8 @@ namespace m8r {
 using namespace std;
 
 FindOutlineByNameDialog::FindOutlineByNameDialog(QWidget *parent)
-    : QDialog(parent)
+    : QDialog(parent),
+      fuzzyRow{-1}
 {
     // widgets
     listView = new QListView(this);
@@ -112,11 +113,18 @@ void FindOutlineByNameDialog::show(
     }
 
     things.clear();
+    names.clear();
+    rows.clear();
     listViewStrings.clear();
+    fuzzyRow = -1;
     bool useCustomNames = customizedNames!=nullptr && customizedNames->size()>0;
     if(ts.size()) {
         for(size_t i=0; i<ts.size(); i++) {
             things.push_back(ts[i]);
+            names.push_back(QString::fromStdString(ts[i]->getName()));
+            if(fuzzyFinder) {
+                rows[ts[i]] = static_cast<int>(i);
+            }
             if(useCustomNames) {
                 listViewStrings << QString::fromStdString(customizedNames->at(i));
             } else {
@@ -145,12 +153,12 @@ void FindOutlineByNameDialog::show(
 void FindOutlineByNameDialog::enableFindButton(const QString& text)
 {
     listViewStrings.clear();
+    fuzzyRow = -1;
     if(!text.isEmpty()) {
         if(keywordsCheckBox->isEnabled() && keywordsCheckBox->isChecked()) {
             int visible = 0;
             int row = 0;
-            for(Thing* e:things) {
-                QString s = QString::fromStdString(e->getName());
+            for(const QString& s:names) {
                 if(stringMatchByKeywords(text, s, caseCheckBox->isChecked())) {
                     listView->setRowHidden(row, false);
                     visible++;
@@ -159,14 +167,16 @@ void FindOutlineByNameDialog::enableFindButton(const QString& text)
                 }
                 row++;
             }
+            if(!visible) {
+                visible = showFuzzyMatches(text);
+            }
             findButton->setEnabled(visible);
         } else {
             Qt::CaseSensitivity c = caseCheckBox->isChecked()?Qt::CaseInsensitive:Qt::CaseSensitive;
             // IMPROVE find a list view method giving # of visible rows
             int visible = 0;
             int row = 0;
-            for(Thing* e:things) {
-                QString s = QString::fromStdString(e->getName());
+            for(const QString& s:names) {
                 if(s.startsWith(text,c)) {
                     listView->setRowHidden(row, false);
                     visible++;
@@ -175,6 +185,9 @@ void FindOutlineByNameDialog::enableFindButton(const QString& text)
                 }
                 row++;
             }
+            if(!visible) {
+                visible = showFuzzyMatches(text);
+            }
             findButton->setEnabled(visible);
         }
     } else {
@@ -185,9 +198,37 @@ void FindOutlineByNameDialog::enableFindButton(const QString& text)
     }
 }
 
+int FindOutlineByNameDialog::showFuzzyMatches(const QString& text)
+{
+    if(!fuzzyFinder) {
+        return 0;
+    }
+    vector<Thing*> matches{};
+    fuzzyFinder(text.toStdString(), matches);
+    int visible = 0;
+    for(Thing* t:matches) {
+        auto row = rows.find(t);
+        if(row != rows.end()) {
+            listView->setRowHidden(row->second, false);
+            if(!visible) {
+                fuzzyRow = row->second;
+                listView->setCurrentIndex(listView->model()->index(fuzzyRow, 0));
+            }
+            visible++;
+        }
+    }
+    return visible;
+}
+
 void FindOutlineByNameDialog::handleReturn()
 {
     if(findButton->isEnabled()) {
+        if(fuzzyRow >= 0) {
+            choice = things[fuzzyRow];
+            QDialog::close();
+            emit searchFinished();
+            return;
+        }
         for(size_t row = 0; row<things.size(); row++) {
             if(!listView->isRowHidden(row)) {
                 choice = things[row];
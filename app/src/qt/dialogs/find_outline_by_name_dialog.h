@@ -19,6 +19,9 @@
 #ifndef M8RUI_FIND_OUTLINE_BY_NAME_DIALOG_H
 #define M8RUI_FIND_OUTLINE_BY_NAME_DIALOG_H
 
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <QtWidgets>
@@ -31,6 +34,13 @@ class FindOutlineByNameDialog : public QDialog
 {
     Q_OBJECT
 
+public:
+    /**
+     * @brief Typo tolerant lookup of things by name - the best match first.
+     */
+    typedef std::function<void(const std::string& name, std::vector<Thing*>& matches)> FuzzyFinder;
+
+private:
     class MyLineEdit : public QLineEdit
     {
     private:
@@ -65,6 +75,12 @@ private:
 
     Thing* choice;
     std::vector<Thing*> things;
+    // names of things converted once on show
+    std::vector<QString> names;
+    // typo tolerant lookup (of Mind's index) used when names don't match
+    FuzzyFinder fuzzyFinder;
+    std::unordered_map<const Thing*,int> rows;
+    int fuzzyRow;
 
 protected:
     QLabel* label;
@@ -85,6 +101,7 @@ public:
     QCheckBox* getKeywordsCheckbox() const { return keywordsCheckBox; }
     QPushButton* getFindButton() const { return findButton; }
     Thing* getChoice() const { return choice; }
+    void setFuzzyFinder(FuzzyFinder finder) { fuzzyFinder = finder; }
 
     void show(
         std::vector<Thing*>& outlines,
@@ -100,6 +117,12 @@ private slots:
     void enableFindButton(const QString &text);
     void handleChoice();
     void handleReturn();
+
+private:
+    /**
+     * @brief Show rows of names similar to the text (typos) - the best match is current.
+     */
+    int showFuzzyMatches(const QString& text);
 };
 
 }
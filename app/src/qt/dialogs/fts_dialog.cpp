@@ -135,6 +135,17 @@ void FtsDialog::refreshResult(std::vector<Note*>* notes)
     resultListingPresenter->refresh(notes);
 }
 
+void FtsDialog::appendResult(const std::vector<Note*>& notes)
+{
+    bool first = getResultSize() == 0;
+    resultListingPresenter->add(notes);
+    if(first && getResultSize() > 0) {
+        resultPreview->setHtml(QString{});
+        resultSplit->setVisible(true);
+        setSizeResultFacet();
+    }
+}
+
 void FtsDialog::updateFacet()
 {
     if(scopeType == ResourceType::NOTE) {
@@ -179,6 +190,9 @@ void FtsDialog::setSizeResultFacet()
 
 void FtsDialog::enableSearchButton(const QString& text)
 {
+    // running search is obsolete
+    emit signalPatternChanged();
+
     if(text.isEmpty()) {
         searchButton->setEnabled(false);
         resultSplit->setVisible(false);
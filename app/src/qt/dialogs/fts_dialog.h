@@ -106,14 +106,30 @@ public:
     void updateFacet();
 
     void refreshResult(std::vector<Note*>* notes);
+    /**
+     * @brief Append streamed matches - result is shown on the first batch.
+     */
+    void appendResult(const std::vector<Note*>& notes);
+    void clearResult() { resultListingPresenter->getModel()->removeAllRows(); }
     int getResultSize() const { return resultListingPresenter->getModel()->rowCount(); }
 
+protected:
+    void hideEvent(QHideEvent* event) override {
+        QDialog::hideEvent(event);
+        emit signalHidden();
+    }
+
 private:
     void setSizeSearchFacet();
     void setSizeResultFacet();
 
 signals:
     void signalNoteScopeSearch();
+    void signalPatternChanged();
+    /**
+     * @brief Dialog was closed/hidden (Cancel, Esc, window close, ...).
+     */
+    void signalHidden();
 
 public slots:
     void searchAndAddPatternToHistory();
@@ -25,7 +25,9 @@ using namespace std;
 FtsDialogPresenter::FtsDialogPresenter(FtsDialog* view, Mind* mind, OrlojPresenter* orloj)
     : view{view},
       mind{mind},
-      orloj{orloj}
+      orloj{orloj},
+      ftsStream{},
+      ftsTimerId{0}
 {
     QObject::connect(
         view->getSearchButton(), SIGNAL(clicked()),
@@ -47,10 +49,19 @@ FtsDialogPresenter::FtsDialogPresenter(FtsDialog* view, Mind* mind, OrlojPresent
     QObject::connect(
         view, SIGNAL(signalNoteScopeSearch()),
         orloj->getMainPresenter(), SLOT(slotHandleFts()));
+    QObject::connect(
+        view, SIGNAL(signalPatternChanged()),
+        this, SLOT(slotPatternChanged()));
+    QObject::connect(
+        view, SIGNAL(signalHidden()),
+        this, SLOT(slotDialogHidden()));
 }
 
+constexpr int FtsDialogPresenter::FTS_POLL_MILLIS;
+
 FtsDialogPresenter::~FtsDialogPresenter()
 {
+    cancelSearch();
 }
 
 void FtsDialogPresenter::doSearch()
@@ -93,28 +104,75 @@ QString &FtsDialogPresenter::getNoteWithMatchesAsHtml(const Note* note)
 void FtsDialogPresenter::doFts(
         const string& pattern,
         const FtsSearch searchMode,
-        Outline* scope) const
+        Outline* scope)
+{
+    cancelSearch();
+    view->clearResult();
+    view->hideResult();
+
+    ftsPattern = pattern;
+    ftsStream = mind->findNoteFtsStream(pattern, searchMode, scope);
+    if(ftsStream->isDone()) {
+        pollFts();
+    } else {
+        ftsTimerId = startTimer(FTS_POLL_MILLIS);
+    }
+}
+
+void FtsDialogPresenter::timerEvent(QTimerEvent* event)
+{
+    if(event->timerId() == ftsTimerId) {
+        pollFts();
+    }
+}
+
+void FtsDialogPresenter::pollFts()
 {
-    vector<Note*>* result = mind->findNoteFts(pattern, searchMode, scope);
+    if(!ftsStream) {
+        return;
+    }
+
+    // check done before taking matches so that no match is left in the stream
+    bool done = ftsStream->isDone();
+    vector<Note*> matches{};
+    if(ftsStream->takeMatches(matches)) {
+        view->appendResult(matches);
+    }
+    if(done) {
+        finishFts();
+    }
+}
+
+void FtsDialogPresenter::finishFts()
+{
+    size_t matchesCount = ftsStream->getMatchesCount();
+    cancelSearch();
 
-    QString info = QString::number(result->size());
+    QString info = QString::number(matchesCount);
     info += QString::fromUtf8(" result(s) found for '");
-    info += QString::fromStdString(pattern);
+    info += QString::fromStdString(ftsPattern);
     info += QString::fromUtf8("'");
     orloj->getMainPresenter()->getView().getStatusBar()->showInfo(info);
 
-    if(result && result->size()) {
-        // show in view
-        view->refreshResult(result);
-    } else {
+    if(!matchesCount && view->isVisible()) {
         view->hideResult();
-        view->getResultListingPresenter()->getModel()->removeAllRows();
+        view->clearResult();
         QMessageBox::information(view, tr("Full-text Search Result"), tr("No matching Notebook or Note found."));
     }
 
     view->searchAndAddPatternToHistory();
 }
 
+void FtsDialogPresenter::cancelSearch()
+{
+    if(ftsTimerId) {
+        killTimer(ftsTimerId);
+        ftsTimerId = 0;
+    }
+    // destructor cancels the search and waits for workers
+    ftsStream.reset();
+}
+
 void FtsDialogPresenter::slotShowMatchingNotePreview(const QItemSelection& selected, const QItemSelection& deselected)
 {
     Q_UNUSED(deselected);
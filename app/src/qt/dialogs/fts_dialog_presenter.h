@@ -19,6 +19,7 @@
 #ifndef M8RUI_FTS_DIALOG_PRESENTER_H
 #define M8RUI_FTS_DIALOG_PRESENTER_H
 
+#include <memory>
 #include <vector>
 
 #include <QtWidgets>
@@ -44,6 +45,14 @@ private:
     Note* selectedNote;
     QString qHtml;
 
+    // running search - matches are polled by timer and appended to the result
+    std::unique_ptr<FtsStream> ftsStream;
+    int ftsTimerId;
+    std::string ftsPattern;
+
+public:
+    static constexpr int FTS_POLL_MILLIS = 50;
+
 public:
     explicit FtsDialogPresenter(FtsDialog* view, Mind* mind, OrlojPresenter* orloj);
     FtsDialogPresenter(const FtsDialogPresenter&) = delete;
@@ -56,17 +65,35 @@ public:
     Note* getSelectedNote() const { return selectedNote; }
 
     void doSearch();
+    /**
+     * @brief Check whether search is running (Os must not be modified).
+     */
+    bool isSearching() const { return ftsStream != nullptr; }
+    void cancelSearch();
+
+protected:
+    void timerEvent(QTimerEvent* event) override;
 
 private:
     QString &getNoteWithMatchesAsHtml(const Note* note);
-    void doFts(const std::string& pattern, const FtsSearch searchMode, Outline* scope) const;
+    void doFts(const std::string& pattern, const FtsSearch searchMode, Outline* scope);
+    void pollFts();
+    void finishFts();
 
 private slots:
     void slotSearch();
+    void slotPatternChanged() {
+        cancelSearch();
+    }
     void slotShowMatchingNotePreview(const QItemSelection& selected, const QItemSelection& deselected);
     void slotHideDialog() {
+        // workers must not read Os which might be modified once the dialog is closed
+        cancelSearch();
         view->hide();
     }
+    void slotDialogHidden() {
+        cancelSearch();
+    }
 };
 
 }
@@ -109,7 +109,6 @@ void KanbanColumnPresenter::slotShowSelectedNote()
     Note* note = this->getSelectedNote();
     if(note != nullptr) {
         note->incReads();
-        note->makeDirty();
 
         orloj->showFacetNoteView(note);
     }
@@ -129,7 +128,6 @@ void KanbanColumnPresenter::slotShowNote(
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
         note->incReads();
-        note->makeDirty();
 
         orloj->showFacetNoteView(note);
     } // else do nothing
@@ -63,6 +63,19 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     findOutlineByTagDialog = new FindOutlineByTagDialog{mind->remind().getOntology(), &view};
     findNoteByTagDialog = new FindNoteByTagDialog{mind->remind().getOntology(), &view};
     refactorNoteToOutlineDialog = new RefactorNoteToOutlineDialog{&view};
+    // names w/ typos are looked up in Mind's names index
+    FindOutlineByNameDialog::FuzzyFinder outlineFinder = [this](const string& name, vector<Thing*>& matches) {
+        vector<Outline*> outlines{};
+        mind->findOutlineByNameFuzzy(name, outlines);
+        matches.insert(matches.end(), outlines.begin(), outlines.end());
+    };
+    findOutlineByNameDialog->setFuzzyFinder(outlineFinder);
+    refactorNoteToOutlineDialog->setFuzzyFinder(outlineFinder);
+    findNoteByNameDialog->setFuzzyFinder([this](const string& name, vector<Thing*>& matches) {
+        vector<Note*> notes{};
+        mind->findNoteByNameFuzzy(name, notes, Mind::FUZZY_NAME_LIMIT, findNoteByNameDialog->getScope());
+        matches.insert(matches.end(), notes.begin(), notes.end());
+    });
     configDialog = new ConfigurationDialog{&view};
     terminalDialog = new TerminalDialog{&view};
     insertImageDialog = new InsertImageDialog{&view};
@@ -186,6 +199,8 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
 
     // let Mind to learn active repository & preserve desired state
     mind->learn();
+    // learn repository changes made outside of MindForger
+    watchTimerId = startTimer(RepositoryIndexer::WATCH_DEBOUNCE_MILLIS);
 }
 
 MainWindowPresenter::~MainWindowPresenter()
@@ -690,6 +705,60 @@ void MainWindowPresenter::doActionMindLearnFile()
     } // else directory closed / nothing choosen
 }
 
+void MainWindowPresenter::timerEvent(QTimerEvent* event)
+{
+    if(event->timerId() != watchTimerId) {
+        return;
+    }
+    // FTS workers read Os - learn changes on the next tick
+    if(ftsDialogPresenter->isSearching()) {
+        return;
+    }
+
+    // O being edited is not relearned - user's edits would be saved to forgotten O
+    string editedOutlineKey{};
+    if(orloj->isFacetActive(OrlojPresenterFacets::FACET_EDIT_NOTE)) {
+        editedOutlineKey = orloj->getNoteEdit()->getCurrentNote()->getOutlineKey();
+    } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_EDIT_OUTLINE_HEADER)) {
+        editedOutlineKey = orloj->getOutlineHeaderEdit()->getCurrentOutline()->getKey();
+    }
+
+    vector<RepositoryChange> changes{};
+    vector<RepositoryChange> postponed{};
+    bool learned = mind->learnChanges(
+        changes,
+        postponed,
+        editedOutlineKey.empty()?nullptr:&editedOutlineKey);
+    if(postponed.size()) {
+        statusBar->showError(
+            QString(tr("File '%1' was changed outside of MindForger while being edited or modified - save to overwrite it"))
+                .arg(QString::fromStdString(postponed[0].path)));
+    }
+    if(learned) {
+        if(postponed.empty()) {
+            statusBar->showInfo(QString(tr("Learned %1 file(s) changed outside of MindForger")).arg(changes.size()));
+        }
+
+        if(orloj->isFacetActive(OrlojPresenterFacets::FACET_LIST_OUTLINES)) {
+            orloj->showFacetOutlineList(mind->getOutlines());
+        } else if(orloj->isFacetActiveOutlineOrNoteView()) {
+            // forgotten O is in limbo > its key is valid
+            string key{orloj->getOutlineView()->getCurrentOutline()->getKey()};
+            for(RepositoryChange& change:changes) {
+                if(change.path == key) {
+                    Outline* o = mind->remind().getOutline(key);
+                    if(o) {
+                        orloj->showFacetOutline(o);
+                    } else {
+                        orloj->showFacetOutlineList(mind->getOutlines());
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
 void MainWindowPresenter::doActionMindRelearn(QString path)
 {
     Repository* r = RepositoryIndexer::getRepositoryForPath(path.toStdString());
@@ -749,6 +818,7 @@ void MainWindowPresenter::doFts(const QString& pattern, bool doSearch)
 
 void MainWindowPresenter::slotHandleFts()
 {
+    ftsDialogPresenter->cancelSearch();
     ftsDialog->hide();
 
     QString searchedString = ftsDialog->getSearchPattern();
@@ -900,7 +970,6 @@ void MainWindowPresenter::handleFindNoteByTag()
         Note* choice = (Note*)findNoteByTagDialog->getChoice();
 
         choice->incReads();
-        choice->makeDirty();
 
         orloj->showFacetOutline(choice->getOutline());
         orloj->getNoteView()->refresh(choice);
@@ -969,7 +1038,6 @@ void MainWindowPresenter::handleFindNoteByName()
         Note* choice = (Note*)findNoteByNameDialog->getChoice();
 
         choice->incReads();
-        choice->makeDirty();
 
         orloj->showFacetOutline(choice->getOutline());
         orloj->getNoteView()->refresh(choice);
@@ -2392,6 +2460,9 @@ void MainWindowPresenter::doActionNoteExternalEdit()
                 } else {
                     note->clearDescription();
                 }
+                for(string* l:description) {
+                    delete l;
+                }
             }
 
             // update view
@@ -2514,10 +2585,10 @@ void MainWindowPresenter::doActionNoteExtract()
                         n?n->getDepth():0);
             if(extractedNote) {
                 // parse selected text to description
-                std::vector<std::string*> description{};
+                Description description{};
                 string t{selectedText.toStdString()};
                 mdRepresentation->description(&t, description);
-                extractedNote->setDescription(description);
+                extractedNote->setDescription(std::move(description));
 
                 mind->remember(orloj->getOutlineView()->getCurrentOutline()->getKey());
                 // IMPROVE smarter refresh of outline tree (do less then overall load)
@@ -144,6 +144,9 @@ private:
     NerChooseTagTypesDialog *nerChooseTagsDialog;
     NerResultDialog* nerResultDialog;
 
+    // timer to learn repository changes made outside of MindForger
+    int watchTimerId;
+
 public:
     explicit MainWindowPresenter(MainWindowView& view);
     MainWindowPresenter(const MainWindowPresenter&) = delete;
@@ -377,6 +380,9 @@ private:
     void copyLinkOrImageToRepository(const std::string& srcPath, QString& path);
 
     void statusInfoPreviewFlickering();
+
+protected:
+    void timerEvent(QTimerEvent* event) override;
 };
 
 }
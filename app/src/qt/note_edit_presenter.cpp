@@ -99,9 +99,9 @@ void NoteEditPresenter::slotSaveNote()
         if(!view->isDescriptionEmpty()) {
             string s{view->getDescription().toStdString()};
             //MF_DEBUG("- BEGIN N description -" << endl << s << "- END N description -" << endl);
-            vector<string*> d{};
+            Description d{};
             mwp->getMarkdownRepresentation()->description(&s, d);
-            currentNote->setDescription(d);
+            currentNote->setDescription(std::move(d));
         } else {
             currentNote->clearDescription();
         }
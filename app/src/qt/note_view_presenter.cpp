@@ -81,9 +81,9 @@ void NoteViewPresenter::refreshLivePreview()
 
     QString description = orloj->getNoteEdit()->getView()->getDescription();
     string s{description.toStdString()};
-    vector<string*> d{};
+    Description d{};
     orloj->getMainPresenter()->getMarkdownRepresentation()->description(&s, d);
-    auxNote.setDescription(d);
+    auxNote.setDescription(std::move(d));
 
     double yScrollPct{0};
     QScrollBar* scrollbar = orloj->getNoteEdit()->getView()->getNoteEditor()->verticalScrollBar();
@@ -131,7 +131,7 @@ void NoteViewPresenter::refreshLivePreview()
 // IMPROVE first decorate MD with HTML colors > then MD to HTML conversion
 void NoteViewPresenter::refresh(Note* note)
 {
-    note->makeRead();
+    mind->noteRead(note);
     this->currentNote = note;
 
     // HTML
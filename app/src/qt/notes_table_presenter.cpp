@@ -39,4 +39,11 @@ void NotesTablePresenter::refresh(vector<Note*>* result)
     delete result;
 }
 
+void NotesTablePresenter::add(const vector<Note*>& notes)
+{
+    for(Note* note:notes) {
+        model->addRow(note);
+    }
+}
+
 } // m8r namespace
@@ -45,6 +45,10 @@ public:
     NotesTableView* getView() const { return view; }
 
     void refresh(std::vector<Note*>* notes);
+    /**
+     * @brief Append Ns to the table (w/o clearing it).
+     */
+    void add(const std::vector<Note*>& notes);
 };
 
 }
@@ -105,7 +105,6 @@ void OrganizerQuadrantPresenter::slotShowSelectedNote()
     Note* note = this->getSelectedNote();
     if(note != nullptr) {
         note->incReads();
-        note->makeDirty();
 
         orloj->showFacetNoteView(note);
     }
@@ -124,7 +123,6 @@ void OrganizerQuadrantPresenter::slotShowNote(const QItemSelection& selected, co
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
         note->incReads();
-        note->makeDirty();
 
         orloj->showFacetNoteView(note);
     } // else do nothing
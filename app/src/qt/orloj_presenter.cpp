@@ -242,12 +242,14 @@ void OrlojPresenter::showFacetDashboard() {
     map<const Tag*,int> allTags{};
     mind->getTagsCardinality(allTags);
 
+    MindStatistics* stats = mind->getStatistics();
+
     dashboardPresenter->refresh(
         mind->getOutlines(),
         allNotes,
         allTags,
-        mind->remind().getOutlineMarkdownsSize(),
-        mind->getStatistics()
+        static_cast<int>(stats->markdownsBytesize),
+        stats
     );
     view->showFacetDashboard();
     mainPresenter->getMainMenu()->showFacetDashboard();
@@ -429,6 +431,9 @@ void OrlojPresenter::slotShowSelectedOrganizer()
 
 void OrlojPresenter::showFacetOutline(Outline* outline)
 {
+    // Ns bodies of header-only learned O must be in memory before it's shown
+    mind->remind().recall(outline);
+
     if(activeFacet == OrlojPresenterFacets::FACET_NAVIGATOR) {
         outlineHeaderViewPresenter->refresh(outline);
         view->showFacetNavigatorOutline();
@@ -440,8 +445,8 @@ void OrlojPresenter::showFacetOutline(Outline* outline)
         view->showFacetOutlineHeaderView();
     }
 
+    // reads are persisted on save - viewed O is not dirty (Ns bodies could not be forgotten)
     outline->incReads();
-    outline->makeDirty();
 
     mainPresenter->getMainMenu()->showFacetOutlineView();
 
@@ -599,6 +604,8 @@ void OrlojPresenter::showFacetNoteView()
 
 void OrlojPresenter::showFacetNoteView(Note* note)
 {
+    mind->remind().recall(note->getOutline());
+
     if(activeFacet == OrlojPresenterFacets::FACET_NAVIGATOR) {
         noteViewPresenter->refresh(note);
         view->showFacetNavigatorNote();
@@ -628,6 +635,9 @@ void OrlojPresenter::showFacetNoteEdit(Note* note)
         return;
     }
 
+    // N must be edited w/ its body, otherwise the body would be lost on save
+    mind->remind().recall(note->getOutline());
+
     if(activeFacet == OrlojPresenterFacets::FACET_NAVIGATOR) {
         outlineViewPresenter->refresh(note->getOutline());
     }
@@ -829,7 +839,6 @@ void OrlojPresenter::slotShowNote(const QItemSelection& selected, const QItemSel
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
         note->incReads();
-        note->makeDirty();
 
         showFacetNoteView(note);
     } else {
@@ -847,7 +856,6 @@ void OrlojPresenter::slotShowNoteNavigator(Note* note)
 {
     if(note) {
         note->incReads();
-        note->makeDirty();
 
         showFacetNoteView(note);
     }
@@ -884,7 +892,8 @@ void OrlojPresenter::slotGetLinksForPattern(const QString& pattern)
         &thingsNames,
         &prefix,
         ThingNameSerialization::LINK,
-        currentOutline);
+        currentOutline,
+        LINK_COMPLETION_PAGE_SIZE);
 
     vector<string>* links = new vector<string>{};
     *links = thingsNames;
@@ -97,6 +97,10 @@ class OrlojPresenter : public QObject
 {
     Q_OBJECT
 
+public:
+    // links are serialized only for the completion popup page
+    static constexpr int LINK_COMPLETION_PAGE_SIZE = 250;
+
 private:
     MainWindowPresenter* mainPresenter;
 
@@ -95,9 +95,9 @@ void OutlineHeaderEditPresenter::slotSaveOutlineHeader()
 
         if(!view->isDescriptionEmpty()) {
             string s{view->getDescription().toStdString()};
-            vector<string*> d{};
+            Description d{};
             mwp->getMarkdownRepresentation()->description(&s, d);
-            currentOutline->setDescription(d);
+            currentOutline->setDescription(std::move(d));
         } else {
             currentOutline->clearDescription();
         }
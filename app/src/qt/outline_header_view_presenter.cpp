@@ -69,9 +69,9 @@ void OutlineHeaderViewPresenter::refreshLivePreview()
 
     QString description = orloj->getOutlineHeaderEdit()->getView()->getDescription();
     string s{description.toStdString()};
-    vector<string*> d{};
+    Description d{};
     orloj->getMainPresenter()->getMarkdownRepresentation()->description(&s, d);
-    auxOutline.setDescription(d);
+    auxOutline.setDescription(std::move(d));
 
     double yScrollPct{0};
     QScrollBar* scrollbar = orloj->getOutlineHeaderEdit()->getView()->getHeaderEditor()->verticalScrollBar();
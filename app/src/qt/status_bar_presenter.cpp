@@ -81,15 +81,16 @@ void StatusBarPresenter::showMindStatistics()
     }
 
     // IMPROVE helper method @ QString gear
+    MindStatistics* stats = mind->getStatistics();
     status += stringFormatIntAsUs(mind->remind().getOutlinesCount());
     status += " notebooks   ";
-    status += stringFormatIntAsUs(mind->remind().getNotesCount());
+    status += stringFormatIntAsUs(static_cast<int>(stats->notesCount));
     status += " notes   ";
 #ifdef MF_WIP
     status += stringFormatIntAsUs(mind->getTriplesCount());
     status += " triples   ";
 #endif
-    status += stringFormatIntAsUs(mind->remind().getOutlineMarkdownsSize());
+    status += stringFormatIntAsUs(static_cast<int>(stats->markdownsBytesize));
     status += " bytes   ";
     if(mind->getScopeAspect().isEnabled()) {
         status += "scope:";
@@ -84,6 +84,8 @@ SOURCES += \
     ./src/model/stencil.cpp \
     ./src/model/tag.cpp \
     ./src/persistence/filesystem_persistence.cpp \
+    ./src/persistence/fts_index_store.cpp \
+    ./src/persistence/outline_cache.cpp \
     ./src/representations/html/html_outline_representation.cpp \
     ./src/representations/markdown/markdown_ast_node.cpp \
     ./src/representations/markdown/markdown_lexem.cpp \
@@ -107,6 +109,7 @@ SOURCES += \
     ./src/representations/markdown/markdown_configuration_representation.cpp \
     ./src/config/time_scope.cpp \
     ./src/model/link.cpp \
+    ./src/model/description.cpp \
     ./src/config/palette.cpp \
     src/config/repository_configuration.cpp \
     src/gear/async_utils.cpp \
@@ -131,9 +134,17 @@ SOURCES += \
     src/mind/ai/nlp/string_char_provider.cpp \
     src/mind/ai/nn/genann.c \
     src/mind/ai/nlp/word_frequency_list.cpp \
+    src/mind/ai/nlp/sparse_word_vectors.cpp \
     src/gear/trie.cpp \
+    src/gear/string_interner.cpp \
+    src/gear/linear_regex.cpp \
+    src/gear/fuzzy_name_index.cpp \
+    src/gear/roaring_bitmap.cpp \
+    src/gear/task_executor.cpp \
     src/mind/ai/nlp/stemmer/stemmer.cpp \
     src/mind/ai/ai_aa_bow.cpp \
+    src/mind/ai/aa_top_k_store.cpp \
+    src/mind/ai/min_hash_lsh.cpp \
     src/mind/ai/ai_aa_weighted_fts.cpp \
     src/mind/ai/aa_notes_feature.cpp \
     src/mind/ai/nlp/common_words_blacklist.cpp \
@@ -150,6 +161,14 @@ SOURCES += \
     src/representations/markdown/cmark_gfm_markdown_transcoder.cpp \
     src/mind/ai/autolinking/autolinking_mind.cpp \
     src/mind/limbo.cpp \
+    src/mind/trigram_index.cpp \
+    src/mind/outline_changes.cpp \
+    src/mind/thing_prefix_index.cpp \
+    src/mind/query_planner.cpp \
+    src/mind/tag_index.cpp \
+    src/mind/mind_aggregates.cpp \
+    src/mind/fts_stream.cpp \
+    src/mind/bm25_ranking.cpp \
     src/representations/unicode.cpp
 
 !mfnomd2html {
@@ -189,6 +208,8 @@ HEADERS += \
     ./src/model/stencil.h \
     ./src/model/tag.h \
     ./src/persistence/filesystem_persistence.h \
+    ./src/persistence/fts_index_store.h \
+    ./src/persistence/outline_cache.h \
     ./src/persistence/persistence.h \
     ./src/representations/html/html_outline_representation.h \
     ./src/representations/markdown/markdown_ast_node.h \
@@ -219,6 +240,7 @@ HEADERS += \
     ./src/representations/markdown/markdown_configuration_representation.h \
     ./src/config/time_scope.h \
     ./src/model/link.h \
+    ./src/model/description.h \
     ./src/config/palette.h \
     ./src/config/repository_configuration.h \
     ./src/gear/async_utils.h \
@@ -245,7 +267,13 @@ HEADERS += \
     src/mind/ai/nlp/string_char_provider.h \
     src/mind/ai/nn/genann.h \
     src/mind/ai/nlp/word_frequency_list.h \
+    src/mind/ai/nlp/sparse_word_vectors.h \
     src/gear/trie.h \
+    src/gear/string_interner.h \
+    src/gear/linear_regex.h \
+    src/gear/fuzzy_name_index.h \
+    src/gear/roaring_bitmap.h \
+    src/gear/task_executor.h \
     src/mind/ai/nlp/char_provider.h \
     src/mind/ai/nlp/stemmer/stemmer.h \
     src/mind/ai/nlp/stemmer/stemming/danish_stem.h \
@@ -267,6 +295,8 @@ HEADERS += \
     src/mind/ai/nlp/stemmer/utilities/safe_math.h \
     src/mind/ai/nlp/stemmer/utilities/utilities.h \
     src/mind/ai/ai_aa_bow.h \
+    src/mind/ai/aa_top_k_store.h \
+    src/mind/ai/min_hash_lsh.h \
     src/mind/ai/ai_aa_weighted_fts.h \
     src/mind/ai/aa_model.h \
     src/mind/ai/aa_notes_feature.h \
@@ -286,7 +316,16 @@ HEADERS += \
     src/representations/representation_type.h \
     src/representations/markdown/cmark_gfm_markdown_transcoder.h \
     src/mind/ai/autolinking/autolinking_mind.h \
-    src/mind/limbo.h
+    src/mind/limbo.h \
+    src/mind/trigram_index.h \
+    src/mind/outline_changes.h \
+    src/mind/thing_prefix_index.h \
+    src/mind/query_planner.h \
+    src/mind/tag_index.h \
+    src/mind/mind_aggregates.h \
+    src/mind/fts_stream.h \
+    src/mind/bm25_ranking.h \
+    src/gear/top_k.h
 
 !mfnomd2html {
     HEADERS += \
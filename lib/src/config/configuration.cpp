@@ -49,6 +49,8 @@ Configuration::Configuration()
       autolinkingCaseInsensitive{},
       md2HtmlOptions{},
       distributorSleepInterval{DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL},
+      memoryLearnThreads{DEFAULT_MEMORY_LEARN_THREADS},
+      memoryOutlineBodies{DEFAULT_MEMORY_OUTLINE_BODIES},
       markdownQuoteSections{},
       uiNerdTargetAudience{DEFAULT_UI_NERD_MENU},
       uiHtmlZoom{},
@@ -163,6 +165,8 @@ void Configuration::clear()
     }
 
     distributorSleepInterval = DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL;
+    memoryLearnThreads = DEFAULT_MEMORY_LEARN_THREADS;
+    memoryOutlineBodies = DEFAULT_MEMORY_OUTLINE_BODIES;
 
     // GUI
     uiNerdTargetAudience = false;
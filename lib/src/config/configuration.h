@@ -57,6 +57,7 @@ constexpr const auto DIRNAME_LIMBO = "limbo";
 constexpr const auto DIRNAME_STENCILS = "stencils";
 constexpr const auto DIRNAME_OUTLINES = "notebooks";
 constexpr const auto DIRNAME_NOTES = "notes";
+constexpr const auto FILENAME_OUTLINES_CACHE = "outlines.cache";
 
 constexpr const auto UI_THEME_DARK = "dark";
 constexpr const auto UI_THEME_LIGHT = "light";
@@ -177,6 +178,11 @@ public:
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_BOW = 200;
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS = 20000;
     static constexpr const int DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL = 500;
+    // 0 ~ use as many threads as there are hardware threads
+    static constexpr const int DEFAULT_MEMORY_LEARN_THREADS = 0;
+    static constexpr const int MAX_MEMORY_LEARN_THREADS = 256;
+    // 0 ~ keep bodies of all Os in memory
+    static constexpr const int DEFAULT_MEMORY_OUTLINE_BODIES = 0;
 
     static const std::string DEFAULT_ACTIVE_REPOSITORY_PATH;
     static const std::string DEFAULT_TIME_SCOPE;
@@ -255,6 +261,8 @@ private:
     unsigned int md2HtmlOptions;
     AssociationAssessmentAlgorithm aaAlgorithm;
     int distributorSleepInterval;
+    unsigned int memoryLearnThreads; // threads used to parse repository Markdowns (0 ~ hardware concurrency)
+    unsigned int memoryOutlineBodies; // max Os w/ Ns bodies kept in memory (0 ~ all, else header-only learn)
     bool markdownQuoteSections;
 
     // GUI configuration
@@ -397,6 +405,10 @@ public:
     void setAaAlgorithm(AssociationAssessmentAlgorithm aaa) { aaAlgorithm = aaa; }
     int getDistributorSleepInterval() const { return distributorSleepInterval; }
     void setDistributorSleepInterval(int sleepInterval) { distributorSleepInterval = sleepInterval; }
+    unsigned int getMemoryLearnThreads() const { return memoryLearnThreads; }
+    void setMemoryLearnThreads(unsigned int threads) { memoryLearnThreads = threads; }
+    unsigned int getMemoryOutlineBodies() const { return memoryOutlineBodies; }
+    void setMemoryOutlineBodies(unsigned int outlines) { memoryOutlineBodies = outlines; }
     bool isMarkdownQuoteSections() const { return markdownQuoteSections; }
     void setMarkdownQuoteSections(bool markdownQuoteSections) { this->markdownQuoteSections = markdownQuoteSections; }
 
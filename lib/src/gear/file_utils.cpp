@@ -21,6 +21,10 @@
 #ifdef _WIN32
   #include <ShlObj.h>
   #include <KnownFolders.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
 #endif // _WIN32
 
 using namespace std;
@@ -109,6 +113,53 @@ Path::~Path()
 {
 }
 
+MappedFile::MappedFile(const std::string& fileName, bool map)
+    : data{nullptr},
+      size{0},
+      mapped{false},
+      buffer{}
+{
+#ifndef _WIN32
+    int fd = map?open(fileName.c_str(), O_RDONLY):-1;
+    if(fd >= 0) {
+        struct stat info;
+        if(!fstat(fd, &info) && S_ISREG(info.st_mode)) {
+            size = static_cast<size_t>(info.st_size);
+            if(size) {
+                void* m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(m != MAP_FAILED) {
+                    madvise(m, size, MADV_SEQUENTIAL);
+                    data = static_cast<const char*>(m);
+                    mapped = true;
+                }
+            }
+        }
+        close(fd);
+    }
+    if(mapped || (map && !size)) {
+        return;
+    }
+#else
+    UNUSED_ARG(map);
+#endif
+    // fallback: read the content to heap buffer
+    ifstream is(fileName, ios::in | ios::binary);
+    if(is) {
+        buffer.assign((istreambuf_iterator<char>(is)), istreambuf_iterator<char>());
+    }
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if(mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
 } // namespace: filesystem
 
 /*
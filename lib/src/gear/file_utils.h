@@ -189,6 +189,39 @@ namespace filesystem {
      */
     std::ostream& operator<<(std::ostream& out, const Path& p);
 
+    /**
+     * @brief Read only file content mapped to memory.
+     *
+     * File is mapped to memory using mmap() on POSIX platforms, elsewhere
+     * (or if the file cannot be mapped) its content is read to a heap buffer.
+     * Either way the content is available as a contiguous array of bytes
+     * until the instance is destroyed.
+     *
+     * Reading mapped file which was truncated by another process raises SIGBUS,
+     * therefore files which might be written meanwhile (e.g. by external editor)
+     * must not be mapped.
+     */
+    class MappedFile
+    {
+    private:
+        const char* data;
+        size_t size;
+        bool mapped;
+        std::string buffer;
+
+    public:
+        explicit MappedFile(const std::string& fileName, bool map=true);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(const MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&&) = delete;
+        ~MappedFile();
+
+        const char* getData() const { return data; }
+        size_t getSize() const { return size; }
+        bool isMapped() const { return mapped; }
+    };
+
 } // namespace: filesystem
 
 #ifdef __cplusplus
@@ -0,0 +1,217 @@
+/*
+ fuzzy_name_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "fuzzy_name_index.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr int FuzzyNameIndex::MAX_DISTANCE;
+
+FuzzyNameIndex::FuzzyNameIndex()
+    : sortedCount{0},
+      removedCount{0},
+      dropRemoved{false},
+      maxLength{0}
+{
+}
+
+FuzzyNameIndex::~FuzzyNameIndex()
+{
+}
+
+void FuzzyNameIndex::add(const string& name, uint32_t id, long long recency)
+{
+    string lower{};
+    stringToLower(name, lower);
+
+    // word suffixes make words in the middle of the name findable by prefix
+    maxLength = std::max(maxLength, lower.size());
+    keys.push_back(Key{lower, id});
+    for(size_t i=1; i<lower.size(); i++) {
+        if(lower[i-1]==' ' && lower[i]!=' ') {
+            keys.push_back(Key{lower.substr(i), id});
+        }
+    }
+    if(recencies.size() <= id) {
+        recencies.resize(id+1, 0);
+        removed.resize(id+1, false);
+    }
+    recencies[id] = recency;
+}
+
+void FuzzyNameIndex::remove(uint32_t id)
+{
+    if(id < removed.size() && !removed[id]) {
+        removed[id] = true;
+        removedCount++;
+        dropRemoved = true;
+    }
+}
+
+void FuzzyNameIndex::clear()
+{
+    keys.clear();
+    sortedCount = 0;
+    recencies.clear();
+    removed.clear();
+    removedCount = 0;
+    dropRemoved = false;
+    maxLength = 0;
+}
+
+void FuzzyNameIndex::sort()
+{
+    if(dropRemoved) {
+        // remove_if is stable > sorted keys stay sorted and added keys follow them
+        auto isRemoved = [this](const Key& key) { return static_cast<bool>(removed[key.id]); };
+        auto sortedEnd = std::remove_if(keys.begin(), keys.begin()+sortedCount, isRemoved);
+        auto end = std::remove_if(keys.begin()+sortedCount, keys.end(), isRemoved);
+        end = std::move(keys.begin()+sortedCount, end, sortedEnd);
+        sortedCount = static_cast<size_t>(sortedEnd-keys.begin());
+        keys.erase(end, keys.end());
+        dropRemoved = false;
+    }
+    auto keyLess = [](const Key& k1, const Key& k2) {
+        return k1.text<k2.text || (k1.text==k2.text && k1.id<k2.id);
+    };
+    std::sort(keys.begin()+sortedCount, keys.end(), keyLess);
+    std::inplace_merge(keys.begin(), keys.begin()+sortedCount, keys.end(), keyLess);
+    sortedCount = keys.size();
+}
+
+void FuzzyNameIndex::find(const string& query, vector<Match>& result, size_t limit, int maxDistance)
+{
+    string q{};
+    stringToLower(query, q);
+    if(q.empty() || keys.empty() || !limit) {
+        return;
+    }
+    if(sortedCount < keys.size() || dropRemoved) {
+        sort();
+    }
+    const int k = maxDistance<0 ? FuzzyNameIndex::maxDistance(q.size()) : maxDistance;
+
+    // DP row for every depth of the (implicit) trie - rows of the common prefix are reused
+    const size_t m = q.size();
+    const size_t w = m+1;
+    vector<int> rows((maxLength+1)*w);
+    for(size_t j=0; j<w; j++) {
+        rows[j] = static_cast<int>(j);
+    }
+    // the best distance of the query to a prefix of the name up to the depth
+    vector<int> prefixDistances(maxLength+1);
+    prefixDistances[0] = static_cast<int>(m);
+
+    unordered_map<uint32_t,Match> matches{};
+    auto report = [&](uint32_t id, int distance, bool prefix) {
+        auto found = matches.find(id);
+        if(found == matches.end()) {
+            matches[id] = Match{id, distance, prefix, recencies[id]};
+        } else if(distance < found->second.distance
+                    ||
+                  (distance == found->second.distance && found->second.prefix && !prefix))
+        {
+            found->second.distance = distance;
+            found->second.prefix = prefix;
+        }
+    };
+
+    const string* previous = nullptr;
+    size_t validDepth = 0;
+    size_t i = 0;
+    while(i < keys.size()) {
+        const string& t = keys[i].text;
+        size_t depth = 0;
+        if(previous) {
+            while(depth < validDepth && depth < t.size() && (*previous)[depth]==t[depth]) {
+                depth++;
+            }
+        }
+
+        bool pruned = false;
+        while(depth < t.size()) {
+            depth++;
+            const int* above = &rows[(depth-1)*w];
+            int* row = &rows[depth*w];
+            const char c = t[depth-1];
+            row[0] = static_cast<int>(depth);
+            int rowMin = row[0];
+            for(size_t j=1; j<w; j++) {
+                int v = std::min(above[j]+1, row[j-1]+1);
+                v = std::min(v, above[j-1] + (q[j-1]!=c ? 1 : 0));
+                row[j] = v;
+                rowMin = std::min(rowMin, v);
+            }
+            prefixDistances[depth] = std::min(prefixDistances[depth-1], row[m]);
+            if(rowMin > k) {
+                pruned = true;
+                break;
+            }
+        }
+        previous = &t;
+        validDepth = depth;
+
+        if(pruned) {
+            // distance can only grow > skip all names w/ the prefix (they are sorted after this one)
+            auto end = std::partition_point(keys.begin()+i+1, keys.end(), [&](const Key& key) {
+                return !key.text.compare(0, depth, t, 0, depth);
+            });
+            size_t endIndex = static_cast<size_t>(end-keys.begin());
+            if(prefixDistances[depth] <= k) {
+                for(; i<endIndex; i++) {
+                    report(keys[i].id, prefixDistances[depth], true);
+                }
+            }
+            i = endIndex;
+        } else {
+            // prefix distances include the whole name > prefix is reported only if it's closer
+            if(prefixDistances[depth] <= k) {
+                report(keys[i].id, prefixDistances[depth], prefixDistances[depth] < rows[depth*w+m]);
+            }
+            i++;
+        }
+    }
+
+    vector<Match> best{};
+    best.reserve(matches.size());
+    for(auto& match:matches) {
+        best.push_back(match.second);
+    }
+    auto better = [](const Match& m1, const Match& m2) {
+        if(m1.distance != m2.distance) return m1.distance < m2.distance;
+        if(m1.prefix != m2.prefix) return !m1.prefix;
+        if(m1.recency != m2.recency) return m1.recency > m2.recency;
+        return m1.id < m2.id;
+    };
+    if(best.size() > limit) {
+        std::partial_sort(best.begin(), best.begin()+limit, best.end(), better);
+        best.resize(limit);
+    } else {
+        std::sort(best.begin(), best.end(), better);
+    }
+    result.insert(result.end(), best.begin(), best.end());
+}
+
+} // m8r namespace
@@ -0,0 +1,119 @@
+/*
+ fuzzy_name_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_FUZZY_NAME_INDEX_H
+#define M8R_FUZZY_NAME_INDEX_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Typo tolerant (case insensitive) lookup of names w/ bounded edit distance.
+ *
+ * Lower case names and their word suffixes (name from the 2nd, 3rd, ... word) are
+ * kept sorted, which makes them a compact trie: Levenshtein DP rows are shared by
+ * names w/ a common prefix and once the minimum of the row exceeds max distance,
+ * all names w/ the prefix are skipped by binary search. Query is matched either
+ * against whole name or its prefix (name being typed) - whole name match wins.
+ *
+ * Distance is measured in bytes i.e. UTF-8 character typo costs up to 2 edits.
+ *
+ * Names can be added and removed incrementally - keys of added names are sorted
+ * and merged, keys of removed names are dropped on the next find.
+ */
+class FuzzyNameIndex
+{
+public:
+    static constexpr int MAX_DISTANCE = 2;
+
+    struct Match {
+        uint32_t id;
+        int distance;
+        // query matched only a prefix of the name
+        bool prefix;
+        long long recency;
+    };
+
+private:
+    struct Key {
+        std::string text;
+        uint32_t id;
+    };
+
+    std::vector<Key> keys;
+    // keys before the index are sorted
+    size_t sortedCount;
+    std::vector<long long> recencies;
+    std::vector<bool> removed;
+    size_t removedCount;
+    // removed names have keys
+    bool dropRemoved;
+    size_t maxLength;
+
+public:
+    explicit FuzzyNameIndex();
+    FuzzyNameIndex(const FuzzyNameIndex&) = delete;
+    FuzzyNameIndex(const FuzzyNameIndex&&) = delete;
+    FuzzyNameIndex& operator=(const FuzzyNameIndex&) = delete;
+    FuzzyNameIndex& operator=(const FuzzyNameIndex&&) = delete;
+    ~FuzzyNameIndex();
+
+    /**
+     * @brief Add name - IDs must be assigned sequentially from 0 (IDs of removed names are not reused).
+     *
+     * @param recency   higher recency wins among matches w/ the same distance
+     */
+    void add(const std::string& name, uint32_t id, long long recency=0);
+    /**
+     * @brief Remove name w/ the ID.
+     */
+    void remove(uint32_t id);
+    void clear();
+    size_t size() const { return recencies.size()-removedCount; }
+    size_t getRemovedCount() const { return removedCount; }
+
+    /**
+     * @brief Find up to limit the best matches ordered by distance, whole name match
+     * and recency.
+     *
+     * @param maxDistance   -1 to derive the distance from query length
+     */
+    void find(const std::string& query, std::vector<Match>& result, size_t limit, int maxDistance=-1);
+
+    /**
+     * @brief Max distance for the query - short queries must be (almost) exact.
+     */
+    static int maxDistance(size_t queryLength) {
+        return queryLength<=2 ? 0 : (queryLength<=5 ? 1 : MAX_DISTANCE);
+    }
+
+private:
+    /**
+     * @brief Drop keys of removed names and merge sorted keys of added names.
+     */
+    void sort();
+};
+
+} // m8r namespace
+
+#endif // M8R_FUZZY_NAME_INDEX_H
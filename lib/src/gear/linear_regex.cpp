@@ -0,0 +1,830 @@
+/*
+ linear_regex.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "linear_regex.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace m8r {
+
+constexpr size_t LinearRegex::MAX_INSTRUCTIONS;
+constexpr size_t LinearRegex::MAX_DFA_STATES;
+
+namespace {
+
+// regexp is not supported by the engine (or it is invalid) > std::regex decides
+struct Unsupported {};
+
+typedef bitset<256> ByteSet;
+
+bool isWordByte(unsigned char c)
+{
+    return (c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9') || c=='_';
+}
+
+ByteSet classSet(char c)
+{
+    ByteSet s{};
+    for(int b=0; b<256; b++) {
+        switch(c) {
+        case 'd':
+        case 'D':
+            s[b] = b>='0' && b<='9';
+            break;
+        case 'w':
+        case 'W':
+            s[b] = isWordByte(static_cast<unsigned char>(b));
+            break;
+        default:
+            s[b] = b==' ' || (b>='\t' && b<='\r');
+        }
+    }
+    return c>='A' && c<='Z' ? ~s : s;
+}
+
+int hexValue(char c)
+{
+    if(c>='0' && c<='9') return c-'0';
+    if(c>='a' && c<='f') return c-'a'+10;
+    if(c>='A' && c<='F') return c-'A'+10;
+    throw Unsupported{};
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Recursive descent parser which compiles regexp AST to the program.
+ */
+class LinearRegex::Parser
+{
+private:
+    struct Node {
+        enum Kind {
+            SET,
+            CONCATENATION,
+            ALTERNATION,
+            REPETITION,
+            ASSERTION
+        };
+
+        Kind kind;
+        ByteSet set;
+        Op assertion;
+        // REPETITION - max -1 stands for infinity
+        int min;
+        int max;
+        vector<unique_ptr<Node>> children;
+
+        explicit Node(Kind kind) : kind(kind), set{}, assertion(MATCH), min(0), max(0) {}
+    };
+
+    const string& pattern;
+    size_t i;
+    LinearRegex& regex;
+
+public:
+    explicit Parser(const string& pattern, LinearRegex& regex) : pattern(pattern), i(0), regex(regex) {}
+    Parser(const Parser&) = delete;
+    Parser(const Parser&&) = delete;
+    Parser& operator=(const Parser&) = delete;
+    Parser& operator=(const Parser&&) = delete;
+    ~Parser() {}
+
+    void parse() {
+        unique_ptr<Node> root = alternation();
+        if(i < pattern.size()) {
+            // unbalanced )
+            throw Unsupported{};
+        }
+        compile(*root);
+        emit(MATCH, 0, 0);
+        extractLiteral(*root);
+    }
+
+private:
+    bool more() const { return i < pattern.size(); }
+    char peek() const { return pattern[i]; }
+
+    unique_ptr<Node> alternation() {
+        unique_ptr<Node> n{new Node{Node::ALTERNATION}};
+        n->children.push_back(concatenation());
+        while(more() && peek()=='|') {
+            i++;
+            n->children.push_back(concatenation());
+        }
+        if(n->children.size() == 1) {
+            return std::move(n->children[0]);
+        }
+        return n;
+    }
+
+    unique_ptr<Node> concatenation() {
+        unique_ptr<Node> n{new Node{Node::CONCATENATION}};
+        while(more() && peek()!='|' && peek()!=')') {
+            n->children.push_back(repetition());
+        }
+        return n;
+    }
+
+    unique_ptr<Node> repetition() {
+        unique_ptr<Node> atom = this->atom();
+        if(!more()) {
+            return atom;
+        }
+
+        int min, max;
+        switch(peek()) {
+        case '*':
+            min = 0; max = -1; i++;
+            break;
+        case '+':
+            min = 1; max = -1; i++;
+            break;
+        case '?':
+            min = 0; max = 1; i++;
+            break;
+        case '{':
+            i++;
+            min = max = number();
+            if(more() && peek()==',') {
+                i++;
+                max = more() && peek()=='}' ? -1 : number();
+            }
+            if(!more() || peek()!='}' || (max!=-1 && max<min)) {
+                throw Unsupported{};
+            }
+            i++;
+            break;
+        default:
+            return atom;
+        }
+        if(atom->kind == Node::ASSERTION) {
+            throw Unsupported{};
+        }
+        // lazy quantifier matches the same texts
+        if(more() && peek()=='?') {
+            i++;
+        }
+        if(more() && (peek()=='*' || peek()=='+' || peek()=='?' || peek()=='{')) {
+            throw Unsupported{};
+        }
+
+        unique_ptr<Node> n{new Node{Node::REPETITION}};
+        n->min = min;
+        n->max = max;
+        n->children.push_back(std::move(atom));
+        return n;
+    }
+
+    int number() {
+        size_t start = i;
+        int n = 0;
+        while(more() && peek()>='0' && peek()<='9') {
+            n = n*10 + (peek()-'0');
+            if(n > static_cast<int>(MAX_INSTRUCTIONS)) {
+                throw Unsupported{};
+            }
+            i++;
+        }
+        if(start == i) {
+            throw Unsupported{};
+        }
+        return n;
+    }
+
+    unique_ptr<Node> atom() {
+        char c = pattern[i++];
+        switch(c) {
+        case '(': {
+            if(more() && peek()=='?') {
+                // only non-capturing group, no lookahead
+                if(i+1 < pattern.size() && pattern[i+1]==':') {
+                    i += 2;
+                } else {
+                    throw Unsupported{};
+                }
+            }
+            unique_ptr<Node> n = alternation();
+            if(!more() || peek()!=')') {
+                throw Unsupported{};
+            }
+            i++;
+            return n;
+        }
+        case '[':
+            return byteClass();
+        case '.': {
+            unique_ptr<Node> n{new Node{Node::SET}};
+            n->set.set();
+            n->set['\n'] = false;
+            n->set['\r'] = false;
+            return n;
+        }
+        case '^':
+            return assertion(BOL);
+        case '$':
+            return assertion(EOL);
+        case '\\':
+            return escape();
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case '}':
+        case ']':
+        case ')':
+            throw Unsupported{};
+        default:
+            return byte(c);
+        }
+    }
+
+    unique_ptr<Node> assertion(Op op) {
+        unique_ptr<Node> n{new Node{Node::ASSERTION}};
+        n->assertion = op;
+        return n;
+    }
+
+    unique_ptr<Node> byte(char c) {
+        unique_ptr<Node> n{new Node{Node::SET}};
+        n->set[static_cast<unsigned char>(c)] = true;
+        return n;
+    }
+
+    unique_ptr<Node> escape() {
+        if(!more()) {
+            throw Unsupported{};
+        }
+        char c = peek();
+        switch(c) {
+        case 'b':
+            i++;
+            regex.wordAssertions = true;
+            return assertion(WORD_BOUNDARY);
+        case 'B':
+            i++;
+            regex.wordAssertions = true;
+            return assertion(NOT_WORD_BOUNDARY);
+        case 'd':
+        case 'D':
+        case 'w':
+        case 'W':
+        case 's':
+        case 'S': {
+            i++;
+            unique_ptr<Node> n{new Node{Node::SET}};
+            n->set = classSet(c);
+            return n;
+        }
+        default:
+            return byte(escapedByte());
+        }
+    }
+
+    // escape sequence (after \) which stands for a single byte
+    char escapedByte() {
+        char c = pattern[i++];
+        switch(c) {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case '0':
+            if(more() && peek()>='0' && peek()<='9') {
+                throw Unsupported{};
+            }
+            return '\0';
+        case 'x': {
+            if(i+2 > pattern.size()) {
+                throw Unsupported{};
+            }
+            int b = hexValue(pattern[i])*16 + hexValue(pattern[i+1]);
+            i += 2;
+            return static_cast<char>(b);
+        }
+        default:
+            // backreferences, \c, \u, ...
+            if((c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9')) {
+                throw Unsupported{};
+            }
+            // identity escape
+            return c;
+        }
+    }
+
+    unique_ptr<Node> byteClass() {
+        unique_ptr<Node> n{new Node{Node::SET}};
+        bool negated = false;
+        if(more() && peek()=='^') {
+            negated = true;
+            i++;
+        }
+        // [] and [^] are ECMAScript specific
+        if(more() && peek()==']') {
+            throw Unsupported{};
+        }
+        while(more() && peek()!=']') {
+            char from;
+            if(peek()=='[') {
+                // POSIX [:alpha:] and alike
+                if(i+1 < pattern.size() && (pattern[i+1]==':' || pattern[i+1]=='.' || pattern[i+1]=='=')) {
+                    throw Unsupported{};
+                }
+                from = pattern[i++];
+            } else if(peek()=='\\') {
+                i++;
+                if(!more()) {
+                    throw Unsupported{};
+                }
+                char c = peek();
+                if(c=='d' || c=='D' || c=='w' || c=='W' || c=='s' || c=='S') {
+                    i++;
+                    n->set |= classSet(c);
+                    if(more() && peek()=='-' && i+1 < pattern.size() && pattern[i+1]!=']') {
+                        throw Unsupported{};
+                    }
+                    continue;
+                } else if(c=='b') {
+                    // backspace
+                    throw Unsupported{};
+                }
+                from = escapedByte();
+            } else {
+                from = pattern[i++];
+            }
+
+            char to = from;
+            if(more() && peek()=='-' && i+1 < pattern.size() && pattern[i+1]!=']') {
+                i++;
+                if(peek()=='[') {
+                    throw Unsupported{};
+                } else if(peek()=='\\') {
+                    i++;
+                    if(!more()) {
+                        throw Unsupported{};
+                    }
+                    char c = peek();
+                    if(c=='d' || c=='D' || c=='w' || c=='W' || c=='s' || c=='S' || c=='b') {
+                        throw Unsupported{};
+                    }
+                    to = escapedByte();
+                } else {
+                    to = pattern[i++];
+                }
+                // std::regex compares signed chars
+                if(from<0 || to<0 || from>to) {
+                    throw Unsupported{};
+                }
+            }
+            for(int b=static_cast<unsigned char>(from); b<=static_cast<unsigned char>(to); b++) {
+                n->set[b] = true;
+            }
+        }
+        if(!more()) {
+            throw Unsupported{};
+        }
+        i++;
+        if(negated) {
+            n->set.flip();
+        }
+        return n;
+    }
+
+    int emit(Op op, int x, int y) {
+        if(regex.program.size() >= MAX_INSTRUCTIONS) {
+            throw Unsupported{};
+        }
+        regex.program.push_back(Instruction{op, x, y});
+        return static_cast<int>(regex.program.size()-1);
+    }
+
+    int pc() const { return static_cast<int>(regex.program.size()); }
+
+    void compile(const Node& n) {
+        switch(n.kind) {
+        case Node::SET:
+            regex.byteSets.push_back(n.set);
+            emit(BYTE_SET, static_cast<int>(regex.byteSets.size()-1), 0);
+            break;
+        case Node::ASSERTION:
+            emit(n.assertion, 0, 0);
+            break;
+        case Node::CONCATENATION:
+            for(const unique_ptr<Node>& c:n.children) {
+                compile(*c);
+            }
+            break;
+        case Node::ALTERNATION: {
+            vector<int> jumps{};
+            for(size_t c=0; c<n.children.size(); c++) {
+                if(c+1 < n.children.size()) {
+                    int split = emit(SPLIT, 0, 0);
+                    regex.program[split].x = pc();
+                    compile(*n.children[c]);
+                    jumps.push_back(emit(JUMP, 0, 0));
+                    regex.program[split].y = pc();
+                } else {
+                    compile(*n.children[c]);
+                }
+            }
+            for(int j:jumps) {
+                regex.program[j].x = pc();
+            }
+            break;
+        }
+        case Node::REPETITION: {
+            const Node& child = *n.children[0];
+            for(int r=0; r<n.min; r++) {
+                compile(child);
+            }
+            if(n.max == -1) {
+                int split = emit(SPLIT, 0, 0);
+                regex.program[split].x = pc();
+                compile(child);
+                emit(JUMP, split, 0);
+                regex.program[split].y = pc();
+            } else {
+                // optional copies - each of them can skip the rest
+                vector<int> splits{};
+                for(int r=n.min; r<n.max; r++) {
+                    int split = emit(SPLIT, 0, 0);
+                    regex.program[split].x = pc();
+                    splits.push_back(split);
+                    compile(child);
+                }
+                for(int s:splits) {
+                    regex.program[s].y = pc();
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    // the longest run of single byte sets in the top level concatenation
+    void extractLiteral(const Node& root) {
+        if(root.kind == Node::SET) {
+            if(root.set.count() == 1) {
+                regex.literal = string(1, static_cast<char>(singleByte(root.set)));
+            }
+            return;
+        }
+        if(root.kind != Node::CONCATENATION) {
+            return;
+        }
+        string run{};
+        auto flush = [&]() {
+            if(run.size() > regex.literal.size()) {
+                regex.literal = run;
+            }
+            run.clear();
+        };
+        for(const unique_ptr<Node>& c:root.children) {
+            if(c->kind == Node::SET && c->set.count() == 1) {
+                run += static_cast<char>(singleByte(c->set));
+            } else if(c->kind == Node::REPETITION
+                      && c->min > 0
+                      && c->children[0]->kind == Node::SET
+                      && c->children[0]->set.count() == 1)
+            {
+                // at least one byte is present, but the run cannot continue
+                run += static_cast<char>(singleByte(c->children[0]->set));
+                flush();
+            } else {
+                flush();
+            }
+        }
+        flush();
+    }
+
+    static int singleByte(const ByteSet& set) {
+        for(int b=0; b<256; b++) {
+            if(set[b]) {
+                return b;
+            }
+        }
+        return 0;
+    }
+};
+
+LinearRegex::LinearRegex(const string& pattern)
+    : wordAssertions{false},
+      dfaStart{-1}
+{
+    try {
+        Parser parser{pattern, *this};
+        parser.parse();
+    } catch(Unsupported&) {
+        MF_DEBUG("LinearRegex: delegating to std::regex '" << pattern << "'" << endl);
+        program.clear();
+        byteSets.clear();
+        literal.clear();
+        // throws std::regex_error if the regexp is invalid
+        fallback.reset(new std::regex{pattern});
+    }
+}
+
+LinearRegex::~LinearRegex()
+{
+}
+
+bool LinearRegex::mayMatch(const char* begin, const char* end) const
+{
+    if(literal.empty()) {
+        return true;
+    }
+
+    const char first = literal[0];
+    const size_t size = literal.size();
+    while(static_cast<size_t>(end-begin) >= size) {
+        const char* c = static_cast<const char*>(memchr(begin, first, (end-begin)-size+1));
+        if(!c) {
+            return false;
+        }
+        if(!memcmp(c+1, literal.data()+1, size-1)) {
+            return true;
+        }
+        begin = c+1;
+    }
+    return false;
+}
+
+bool LinearRegex::search(const char* begin, const char* end)
+{
+    if(fallback) {
+        return std::regex_search(begin, end, *fallback);
+    }
+    if(!mayMatch(begin, end)) {
+        return false;
+    }
+
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(begin);
+    const unsigned char* e = reinterpret_cast<const unsigned char*>(end);
+    // empty text may match assertions in any order
+    if(wordAssertions || b == e) {
+        return searchNfa(b, e);
+    }
+    return searchDfa(b, e);
+}
+
+/*
+ * NFA simulation
+ */
+
+void LinearRegex::addThread(
+        vector<int>& threads,
+        vector<char>& onList,
+        int pc,
+        const unsigned char* begin,
+        const unsigned char* end,
+        const unsigned char* at,
+        bool& matched) const
+{
+    // explicit stack - no recursion
+    vector<int> stack{pc};
+    while(!stack.empty()) {
+        pc = stack.back();
+        stack.pop_back();
+        if(onList[pc]) {
+            continue;
+        }
+        onList[pc] = 1;
+        threads.push_back(pc);
+
+        const Instruction& in = program[pc];
+        switch(in.op) {
+        case BYTE_SET:
+            break;
+        case MATCH:
+            matched = true;
+            return;
+        case JUMP:
+            stack.push_back(in.x);
+            break;
+        case SPLIT:
+            stack.push_back(in.y);
+            stack.push_back(in.x);
+            break;
+        case BOL:
+            if(at == begin) stack.push_back(pc+1);
+            break;
+        case EOL:
+            if(at == end) stack.push_back(pc+1);
+            break;
+        case WORD_BOUNDARY:
+        case NOT_WORD_BOUNDARY: {
+            bool left = at > begin && isWordByte(at[-1]);
+            bool right = at < end && isWordByte(*at);
+            if((left != right) == (in.op == WORD_BOUNDARY)) stack.push_back(pc+1);
+            break;
+        }
+        }
+    }
+}
+
+bool LinearRegex::searchNfa(const unsigned char* begin, const unsigned char* end) const
+{
+    vector<int> current{}, next{};
+    vector<char> onCurrent(program.size(), 0), onNext(program.size(), 0);
+    bool matched = false;
+
+    for(const unsigned char* at=begin; ; at++) {
+        // unanchored search > thread is started at every position
+        addThread(current, onCurrent, 0, begin, end, at, matched);
+        if(matched) {
+            return true;
+        }
+        if(at == end) {
+            return false;
+        }
+
+        for(int pc:current) {
+            if(program[pc].op == BYTE_SET && byteSets[program[pc].x][*at]) {
+                addThread(next, onNext, pc+1, begin, end, at+1, matched);
+                if(matched) {
+                    return true;
+                }
+            }
+        }
+
+        for(int pc:current) {
+            onCurrent[pc] = 0;
+        }
+        current.clear();
+        current.swap(next);
+        onCurrent.swap(onNext);
+    }
+}
+
+/*
+ * Lazy DFA
+ */
+
+void LinearRegex::closure(
+        vector<int>& pcs,
+        vector<char>& onList,
+        int pc,
+        bool atBegin,
+        bool atEnd,
+        bool& matched) const
+{
+    vector<int> stack{pc};
+    while(!stack.empty()) {
+        pc = stack.back();
+        stack.pop_back();
+        if(onList[pc]) {
+            continue;
+        }
+        onList[pc] = 1;
+
+        const Instruction& in = program[pc];
+        switch(in.op) {
+        case BYTE_SET:
+            pcs.push_back(pc);
+            break;
+        case MATCH:
+            matched = true;
+            break;
+        case JUMP:
+            stack.push_back(in.x);
+            break;
+        case SPLIT:
+            stack.push_back(in.y);
+            stack.push_back(in.x);
+            break;
+        case BOL:
+            if(atBegin) stack.push_back(pc+1);
+            break;
+        case EOL:
+            if(atEnd) {
+                stack.push_back(pc+1);
+            } else {
+                // decided at the end of the text
+                pcs.push_back(pc);
+            }
+            break;
+        default:
+            // word assertions are handled by NFA simulation
+            break;
+        }
+    }
+}
+
+void LinearRegex::flushDfa()
+{
+    dfaStart = -1;
+    dfaStates.clear();
+    dfaStateIds.clear();
+}
+
+vector<int> LinearRegex::dfaKey(vector<int>& pcs, bool match)
+{
+    std::sort(pcs.begin(), pcs.end());
+    vector<int> key{pcs};
+    if(match) {
+        // accepting state differs from the state w/ the same instructions
+        key.push_back(-1);
+    }
+    return key;
+}
+
+int LinearRegex::dfaState(vector<int>& pcs, bool match)
+{
+    vector<int> key = dfaKey(pcs, match);
+    auto i = dfaStateIds.find(key);
+    if(i != dfaStateIds.end()) {
+        return i->second;
+    }
+
+    int id = static_cast<int>(dfaStates.size());
+    dfaStates.push_back(DfaState{});
+    DfaState& s = dfaStates.back();
+    s.pcs = pcs;
+    s.match = match;
+    std::fill(s.next, s.next+256, -1);
+    dfaStateIds[key] = id;
+    return id;
+}
+
+int LinearRegex::dfaNext(int state, unsigned char c)
+{
+    vector<int> pcs{};
+    vector<char> onList(program.size(), 0);
+    bool match = false;
+    for(int pc:dfaStates[state].pcs) {
+        if(program[pc].op == BYTE_SET && byteSets[program[pc].x][c]) {
+            closure(pcs, onList, pc+1, false, false, match);
+        }
+    }
+    // unanchored search > match can start at every position
+    closure(pcs, onList, 0, false, false, match);
+
+    if(dfaStates.size() >= MAX_DFA_STATES && dfaStateIds.find(dfaKey(pcs, match)) == dfaStateIds.end()) {
+        flushDfa();
+        return dfaState(pcs, match);
+    }
+    int next = dfaState(pcs, match);
+    dfaStates[state].next[c] = next;
+    return next;
+}
+
+bool LinearRegex::dfaMatchAtEnd(int state) const
+{
+    vector<int> pcs{};
+    vector<char> onList(program.size(), 0);
+    bool match = false;
+    for(int pc:dfaStates[state].pcs) {
+        if(program[pc].op == EOL) {
+            closure(pcs, onList, pc, false, true, match);
+        }
+    }
+    return match;
+}
+
+bool LinearRegex::searchDfa(const unsigned char* begin, const unsigned char* end)
+{
+    if(dfaStart < 0) {
+        vector<int> pcs{};
+        vector<char> onList(program.size(), 0);
+        bool match = false;
+        closure(pcs, onList, 0, true, false, match);
+        dfaStart = dfaState(pcs, match);
+    }
+
+    int s = dfaStart;
+    if(dfaStates[s].match) {
+        return true;
+    }
+    for(const unsigned char* at=begin; at<end; at++) {
+        int next = dfaStates[s].next[*at];
+        if(next < 0) {
+            next = dfaNext(s, *at);
+        }
+        s = next;
+        if(dfaStates[s].match) {
+            return true;
+        }
+    }
+    return dfaMatchAtEnd(s);
+}
+
+} // m8r namespace
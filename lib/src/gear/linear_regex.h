@@ -0,0 +1,166 @@
+/*
+ linear_regex.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_LINEAR_REGEX_H
+#define M8R_LINEAR_REGEX_H
+
+#include <bitset>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Linear time regular expression search.
+ *
+ * ECMAScript regexp (std::regex default grammar) subset is compiled to Thompson NFA
+ * which is searched by lazily built DFA (or by NFA simulation if the regexp contains
+ * word boundary assertions) - the time is linear in the length of the text and there
+ * is no backtracking/recursion. Text is matched byte by byte, just like std::regex
+ * does for std::string.
+ *
+ * Supported: literals, identity escapes, ., classes incl. ranges and negation,
+ * \d \D \w \W \s \S \t \n \r \f \v \xHH, ^ $ \b \B, groups (...) (?:...),
+ * alternation and greedy/lazy quantifiers * + ? {n} {n,} {n,m}.
+ *
+ * Other regexps (backreferences, lookaheads, POSIX classes, ...) are delegated
+ * to std::regex, which also throws std::regex_error for invalid regexps.
+ *
+ * Search is NOT thread safe (lazy DFA) - use one instance per thread.
+ */
+class LinearRegex
+{
+public:
+    // repetitions are expanded - larger programs are delegated to std::regex
+    static constexpr size_t MAX_INSTRUCTIONS = 10000;
+    // lazy DFA cache is flushed when it grows over the limit
+    static constexpr size_t MAX_DFA_STATES = 1000;
+
+private:
+    enum Op {
+        BYTE_SET,
+        SPLIT,
+        JUMP,
+        BOL,
+        EOL,
+        WORD_BOUNDARY,
+        NOT_WORD_BOUNDARY,
+        MATCH
+    };
+
+    struct Instruction {
+        Op op;
+        // BYTE_SET index or jump target
+        int x;
+        // second SPLIT target
+        int y;
+    };
+
+    struct DfaState {
+        // sorted BYTE_SET and EOL instructions
+        std::vector<int> pcs;
+        // MATCH instruction reached
+        bool match;
+        // -1 transition not computed yet
+        int next[256];
+    };
+
+    class Parser;
+
+    std::vector<Instruction> program;
+    std::vector<std::bitset<256>> byteSets;
+    // program contains \b or \B > NFA simulation
+    bool wordAssertions;
+    // the longest literal which must be present in every match
+    std::string literal;
+
+    // lazy DFA (-1 start state not computed yet)
+    int dfaStart;
+    std::vector<DfaState> dfaStates;
+    std::map<std::vector<int>,int> dfaStateIds;
+
+    // regexp not supported by the engine
+    std::unique_ptr<std::regex> fallback;
+
+public:
+    /**
+     * @throws std::regex_error if the regexp is invalid.
+     */
+    explicit LinearRegex(const std::string& pattern);
+    LinearRegex(const LinearRegex&) = delete;
+    LinearRegex(const LinearRegex&&) = delete;
+    LinearRegex& operator=(const LinearRegex&) = delete;
+    LinearRegex& operator=(const LinearRegex&&) = delete;
+    ~LinearRegex();
+
+    /**
+     * @brief Check whether the regexp is searched by std::regex.
+     */
+    bool isFallback() const { return fallback != nullptr; }
+
+    /**
+     * @brief Get the longest literal which must be present in the matched text.
+     */
+    const std::string& getLiteral() const { return literal; }
+
+    /**
+     * @brief Fast check whether the text (or any of its lines) can match - false if the literal is missing.
+     */
+    bool mayMatch(const char* begin, const char* end) const;
+    bool mayMatch(const std::string& text) const { return mayMatch(text.data(), text.data()+text.size()); }
+
+    /**
+     * @brief Check whether the regexp matches any substring of the text (std::regex_search).
+     */
+    bool search(const char* begin, const char* end);
+    bool search(const std::string& text) { return search(text.data(), text.data()+text.size()); }
+
+private:
+    bool searchNfa(const unsigned char* begin, const unsigned char* end) const;
+    bool searchDfa(const unsigned char* begin, const unsigned char* end);
+
+    void addThread(
+            std::vector<int>& threads,
+            std::vector<char>& onList,
+            int pc,
+            const unsigned char* begin,
+            const unsigned char* end,
+            const unsigned char* at,
+            bool& matched) const;
+    void closure(
+            std::vector<int>& pcs,
+            std::vector<char>& onList,
+            int pc,
+            bool atBegin,
+            bool atEnd,
+            bool& matched) const;
+    void flushDfa();
+    static std::vector<int> dfaKey(std::vector<int>& pcs, bool match);
+    int dfaState(std::vector<int>& pcs, bool match);
+    int dfaNext(int state, unsigned char c);
+    bool dfaMatchAtEnd(int state) const;
+};
+
+} // m8r namespace
+
+#endif // M8R_LINEAR_REGEX_H
@@ -19,9 +19,55 @@
 #ifndef M8R_MATH_UTILS_H
 #define M8R_MATH_UTILS_H
 
+#include <cstdint>
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
 namespace m8r {
 
 int pythonModulo(int a, int b);
 
+/**
+ * @brief Count trailing zero bits of non-zero 64-bit word.
+ */
+inline unsigned ctz64(uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned>(index);
+#else
+    unsigned count = 0;
+    while(!(word & 1)) {
+        word >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Count set bits of 64-bit word.
+ */
+inline unsigned popcount64(uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    return static_cast<unsigned>(__popcnt64(word));
+#else
+    unsigned count = 0;
+    while(word) {
+        word &= word-1;
+        count++;
+    }
+    return count;
+#endif
+}
+
 }
 #endif // M8R_MATH_UTILS_H
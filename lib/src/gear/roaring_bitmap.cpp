@@ -0,0 +1,286 @@
+/*
+ roaring_bitmap.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "roaring_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "math_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr size_t RoaringBitmap::ARRAY_MAX;
+constexpr size_t RoaringBitmap::BITMAP_WORDS;
+
+void RoaringBitmap::Chunk::toBitmap()
+{
+    bits.assign(BITMAP_WORDS, 0);
+    for(uint16_t v:array) {
+        bits[v >> 6] |= 1ULL << (v & 63);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RoaringBitmap::Chunk::toArray()
+{
+    array.clear();
+    array.reserve(cardinality);
+    for(size_t w=0; w<BITMAP_WORDS; w++) {
+        uint64_t word = bits[w];
+        while(word) {
+            array.push_back(static_cast<uint16_t>((w << 6) + ctz64(word)));
+            word &= word-1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+RoaringBitmap::RoaringBitmap()
+{
+}
+
+RoaringBitmap::~RoaringBitmap()
+{
+}
+
+vector<RoaringBitmap::Chunk>::iterator RoaringBitmap::findChunk(uint16_t key)
+{
+    return std::lower_bound(chunks.begin(), chunks.end(), key, [](const Chunk& c, uint16_t k) {
+        return c.key < k;
+    });
+}
+
+vector<RoaringBitmap::Chunk>::const_iterator RoaringBitmap::findChunk(uint16_t key) const
+{
+    return std::lower_bound(chunks.begin(), chunks.end(), key, [](const Chunk& c, uint16_t k) {
+        return c.key < k;
+    });
+}
+
+void RoaringBitmap::add(uint32_t value)
+{
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    auto c = findChunk(key);
+    if(c == chunks.end() || c->key != key) {
+        c = chunks.insert(c, Chunk{key, 0, {}, {}});
+    }
+    if(c->isBitmap()) {
+        uint64_t& word = c->bits[low >> 6];
+        const uint64_t bit = 1ULL << (low & 63);
+        if(!(word & bit)) {
+            word |= bit;
+            c->cardinality++;
+        }
+    } else {
+        auto a = std::lower_bound(c->array.begin(), c->array.end(), low);
+        if(a == c->array.end() || *a != low) {
+            c->array.insert(a, low);
+            if(++c->cardinality > ARRAY_MAX) {
+                c->toBitmap();
+            }
+        }
+    }
+}
+
+void RoaringBitmap::remove(uint32_t value)
+{
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    auto c = findChunk(key);
+    if(c == chunks.end() || c->key != key) {
+        return;
+    }
+    if(c->isBitmap()) {
+        uint64_t& word = c->bits[low >> 6];
+        const uint64_t bit = 1ULL << (low & 63);
+        if(word & bit) {
+            word &= ~bit;
+            if(--c->cardinality <= ARRAY_MAX) {
+                c->toArray();
+            }
+        }
+    } else {
+        auto a = std::lower_bound(c->array.begin(), c->array.end(), low);
+        if(a != c->array.end() && *a == low) {
+            c->array.erase(a);
+            c->cardinality--;
+        }
+    }
+    if(!c->cardinality) {
+        chunks.erase(c);
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const
+{
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    auto c = findChunk(key);
+    if(c == chunks.end() || c->key != key) {
+        return false;
+    }
+    if(c->isBitmap()) {
+        return c->bits[low >> 6] & (1ULL << (low & 63));
+    }
+    return std::binary_search(c->array.begin(), c->array.end(), low);
+}
+
+size_t RoaringBitmap::cardinality() const
+{
+    size_t count = 0;
+    for(const Chunk& c:chunks) {
+        count += c.cardinality;
+    }
+    return count;
+}
+
+size_t RoaringBitmap::getBitmapChunksCount() const
+{
+    size_t count = 0;
+    for(const Chunk& c:chunks) {
+        if(c.isBitmap()) count++;
+    }
+    return count;
+}
+
+void RoaringBitmap::intersect(const RoaringBitmap& other)
+{
+    vector<Chunk> result{};
+    auto c = chunks.begin();
+    auto o = other.chunks.begin();
+    while(c!=chunks.end() && o!=other.chunks.end()) {
+        if(c->key < o->key) {
+            ++c;
+        } else if(o->key < c->key) {
+            ++o;
+        } else {
+            Chunk chunk{c->key, 0, {}, {}};
+            if(c->isBitmap() && o->isBitmap()) {
+                chunk.bits.resize(BITMAP_WORDS);
+                for(size_t w=0; w<BITMAP_WORDS; w++) {
+                    chunk.bits[w] = c->bits[w] & o->bits[w];
+                    chunk.cardinality += popcount64(chunk.bits[w]);
+                }
+                if(chunk.cardinality <= ARRAY_MAX) {
+                    chunk.toArray();
+                }
+            } else if(c->isBitmap() || o->isBitmap()) {
+                const Chunk& sparse = c->isBitmap() ? *o : *c;
+                const Chunk& dense = c->isBitmap() ? *c : *o;
+                for(uint16_t v:sparse.array) {
+                    if(dense.bits[v >> 6] & (1ULL << (v & 63))) {
+                        chunk.array.push_back(v);
+                    }
+                }
+                chunk.cardinality = chunk.array.size();
+            } else {
+                std::set_intersection(
+                    c->array.begin(), c->array.end(),
+                    o->array.begin(), o->array.end(),
+                    std::back_inserter(chunk.array));
+                chunk.cardinality = chunk.array.size();
+            }
+            if(chunk.cardinality) {
+                result.push_back(std::move(chunk));
+            }
+            ++c;
+            ++o;
+        }
+    }
+    chunks.swap(result);
+}
+
+void RoaringBitmap::unite(const RoaringBitmap& other)
+{
+    vector<Chunk> result{};
+    result.reserve(chunks.size() + other.chunks.size());
+    auto c = chunks.begin();
+    auto o = other.chunks.begin();
+    while(c!=chunks.end() || o!=other.chunks.end()) {
+        if(o==other.chunks.end() || (c!=chunks.end() && c->key < o->key)) {
+            result.push_back(std::move(*c++));
+        } else if(c==chunks.end() || o->key < c->key) {
+            result.push_back(*o++);
+        } else {
+            Chunk chunk{c->key, 0, {}, {}};
+            if(!c->isBitmap() && !o->isBitmap()) {
+                std::set_union(
+                    c->array.begin(), c->array.end(),
+                    o->array.begin(), o->array.end(),
+                    std::back_inserter(chunk.array));
+                chunk.cardinality = chunk.array.size();
+                if(chunk.cardinality > ARRAY_MAX) {
+                    chunk.toBitmap();
+                }
+            } else {
+                // bits are moved from this bitmap chunk (if any)
+                const Chunk& rest = c->isBitmap() ? *o : *c;
+                if(c->isBitmap()) {
+                    chunk.bits = std::move(c->bits);
+                } else {
+                    chunk.bits = o->bits;
+                }
+                if(rest.isBitmap()) {
+                    for(size_t w=0; w<BITMAP_WORDS; w++) {
+                        chunk.bits[w] |= rest.bits[w];
+                    }
+                } else {
+                    for(uint16_t v:rest.array) {
+                        chunk.bits[v >> 6] |= 1ULL << (v & 63);
+                    }
+                }
+                for(size_t w=0; w<BITMAP_WORDS; w++) {
+                    chunk.cardinality += popcount64(chunk.bits[w]);
+                }
+            }
+            result.push_back(std::move(chunk));
+            ++c;
+            ++o;
+        }
+    }
+    chunks.swap(result);
+}
+
+void RoaringBitmap::toVector(vector<uint32_t>& values) const
+{
+    values.reserve(values.size() + cardinality());
+    for(const Chunk& c:chunks) {
+        const uint32_t high = static_cast<uint32_t>(c.key) << 16;
+        if(c.isBitmap()) {
+            for(size_t w=0; w<BITMAP_WORDS; w++) {
+                uint64_t word = c.bits[w];
+                while(word) {
+                    values.push_back(high | static_cast<uint32_t>((w << 6) + ctz64(word)));
+                    word &= word-1;
+                }
+            }
+        } else {
+            for(uint16_t v:c.array) {
+                values.push_back(high | v);
+            }
+        }
+    }
+}
+
+} // m8r namespace
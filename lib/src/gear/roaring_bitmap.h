@@ -0,0 +1,103 @@
+/*
+ roaring_bitmap.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_ROARING_BITMAP_H
+#define M8R_ROARING_BITMAP_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Compressed bitmap of 32b integers (roaring style).
+ *
+ * Integers are partitioned to chunks by their upper 16b. Chunk stores lower 16b
+ * either in a sorted array (sparse chunk, up to ARRAY_MAX integers) or in a 8kB
+ * bitmap (dense chunk). Intersection and union are done chunk by chunk - array
+ * w/ array by merge, array w/ bitmap by bit test and bitmap w/ bitmap by words.
+ */
+class RoaringBitmap
+{
+public:
+    // chunk w/ more integers is stored as bitmap
+    static constexpr size_t ARRAY_MAX = 4096;
+
+private:
+    static constexpr size_t BITMAP_WORDS = 1024;
+
+    struct Chunk {
+        uint16_t key;
+        uint32_t cardinality;
+        // sorted lower 16b (sparse chunk)
+        std::vector<uint16_t> array;
+        // bits (dense chunk)
+        std::vector<uint64_t> bits;
+
+        bool isBitmap() const { return !bits.empty(); }
+        void toBitmap();
+        void toArray();
+    };
+
+    // sorted by key
+    std::vector<Chunk> chunks;
+
+public:
+    explicit RoaringBitmap();
+    RoaringBitmap(const RoaringBitmap&) = default;
+    RoaringBitmap(RoaringBitmap&&) = default;
+    RoaringBitmap& operator=(const RoaringBitmap&) = default;
+    RoaringBitmap& operator=(RoaringBitmap&&) = default;
+    ~RoaringBitmap();
+
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+    size_t cardinality() const;
+    bool empty() const { return chunks.empty(); }
+    void clear() { chunks.clear(); }
+
+    /**
+     * @brief Keep only integers which are also in the other bitmap.
+     */
+    void intersect(const RoaringBitmap& other);
+    /**
+     * @brief Add integers of the other bitmap.
+     */
+    void unite(const RoaringBitmap& other);
+
+    /**
+     * @brief Append integers to the vector in ascending order.
+     */
+    void toVector(std::vector<uint32_t>& values) const;
+
+    /**
+     * @brief Number of chunks stored as bitmaps (for diagnostics and tests).
+     */
+    size_t getBitmapChunksCount() const;
+
+private:
+    std::vector<Chunk>::iterator findChunk(uint16_t key);
+    std::vector<Chunk>::const_iterator findChunk(uint16_t key) const;
+};
+
+} // m8r namespace
+
+#endif // M8R_ROARING_BITMAP_H
@@ -0,0 +1,75 @@
+/*
+ string_interner.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "string_interner.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr StringInterner::Id StringInterner::NO_ID;
+
+StringInterner::StringInterner()
+{
+    static const string EMPTY{};
+    strings.push_back(&EMPTY);
+}
+
+StringInterner::~StringInterner()
+{
+}
+
+StringInterner::Id StringInterner::intern(const string& s)
+{
+    lock_guard<mutex> criticalSection{internMutex};
+
+    auto entry = ids.find(s);
+    if(entry != ids.end()) {
+        return entry->second;
+    }
+
+    Id id = static_cast<Id>(strings.size());
+    // references to unordered_map keys are stable (rehash doesn't move nodes)
+    entry = ids.insert(pair<string,Id>(s, id)).first;
+    strings.push_back(&entry->first);
+    return id;
+}
+
+StringInterner::Id StringInterner::find(const string& s) const
+{
+    lock_guard<mutex> criticalSection{internMutex};
+
+    auto entry = ids.find(s);
+    return entry==ids.end() ? NO_ID : entry->second;
+}
+
+const string& StringInterner::get(Id id) const
+{
+    lock_guard<mutex> criticalSection{internMutex};
+
+    return id<strings.size() ? *strings[id] : *strings[NO_ID];
+}
+
+size_t StringInterner::size() const
+{
+    lock_guard<mutex> criticalSection{internMutex};
+
+    return strings.size()-1;
+}
+
+} // m8r namespace
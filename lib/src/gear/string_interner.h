@@ -0,0 +1,87 @@
+/*
+ string_interner.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_STRING_INTERNER_H
+#define M8R_STRING_INTERNER_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief String interner.
+ *
+ * Every distinct string is stored once and identified by a compact integer
+ * ID, therefore interned strings can be compared and used as hash keys
+ * using integer operations. IDs are never recycled i.e. string for given
+ * ID is valid for the lifetime of the interner.
+ *
+ * Interner is thread safe.
+ */
+class StringInterner
+{
+public:
+    typedef uint32_t Id;
+
+    /**
+     * @brief ID which is not assigned to any string.
+     */
+    static constexpr Id NO_ID = 0;
+
+private:
+    mutable std::mutex internMutex;
+
+    std::unordered_map<std::string,Id> ids;
+    // ID to string (pointer to the key of ids map entry) - ID 0 is reserved
+    std::vector<const std::string*> strings;
+
+public:
+    explicit StringInterner();
+    StringInterner(const StringInterner&) = delete;
+    StringInterner(const StringInterner&&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&&) = delete;
+    ~StringInterner();
+
+    /**
+     * @brief Get ID of the string - string is interned if it is not known yet.
+     */
+    Id intern(const std::string& s);
+    /**
+     * @brief Get ID of the string w/o interning it.
+     *
+     * @return ID or NO_ID if the string is not interned.
+     */
+    Id find(const std::string& s) const;
+    /**
+     * @brief Get interned string (empty string for NO_ID).
+     */
+    const std::string& get(Id id) const;
+
+    size_t size() const;
+};
+
+} // m8r namespace
+
+#endif // M8R_STRING_INTERNER_H
@@ -20,6 +20,10 @@
 
 #include <cassert>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace m8r {
@@ -192,4 +196,113 @@ void replaceAll(const std::string& old_s, const std::string& new_s, std::string&
     }
 }
 
+namespace {
+
+inline char asciiToLower(char c)
+{
+    return (c>='A' && c<='Z') ? c+('a'-'A') : c;
+}
+
+// compare candidate w/ lower case needle (first and last chars are already matched)
+inline bool matchIgnoreCase(const char* s, const char* lowerNeedle, size_t size)
+{
+    for(size_t i=1; i+1<size; i++) {
+        if(asciiToLower(s[i]) != lowerNeedle[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(__AVX2__)
+
+inline __m256i simdToLower(__m256i v)
+{
+    // signed compare: bytes >= 0x80 are negative i.e. never in A..Z
+    const __m256i upper = _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8('A'-1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('Z'+1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+#elif defined(__SSE2__)
+
+inline __m128i simdToLower(__m128i v)
+{
+    // signed compare: bytes >= 0x80 are negative i.e. never in A..Z
+    const __m128i upper = _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8('A'-1)),
+        _mm_cmplt_epi8(v, _mm_set1_epi8('Z'+1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+#endif
+
+} // anonymous namespace
+
+size_t stringFindIgnoreCase(const char* haystack, size_t haystackSize, const std::string& lowerNeedle, size_t pos)
+{
+    const size_t size = lowerNeedle.size();
+    if(size == 0) {
+        return pos<=haystackSize ? pos : std::string::npos;
+    }
+    if(pos >= haystackSize || haystackSize-pos < size) {
+        return std::string::npos;
+    }
+
+    const char* needle = lowerNeedle.data();
+    const size_t last = haystackSize-size;
+    size_t i = pos;
+
+    // compare blocks of first and last needle chars at once (candidate positions
+    // are verified char by char)
+#if defined(__AVX2__)
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i lastChar = _mm256_set1_epi8(needle[size-1]);
+    for(; i+32 <= last+1; i += 32) {
+        const __m256i blockFirst = simdToLower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack+i)));
+        const __m256i blockLast = simdToLower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack+i+size-1)));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, lastChar))));
+        while(mask) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if(matchIgnoreCase(haystack+i+bit, needle, size)) {
+                return i+bit;
+            }
+            mask &= mask-1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i lastChar = _mm_set1_epi8(needle[size-1]);
+    for(; i+16 <= last+1; i += 16) {
+        const __m128i blockFirst = simdToLower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack+i)));
+        const __m128i blockLast = simdToLower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack+i+size-1)));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, lastChar))));
+        while(mask) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if(matchIgnoreCase(haystack+i+bit, needle, size)) {
+                return i+bit;
+            }
+            mask &= mask-1;
+        }
+    }
+#endif
+
+    // scalar tail (or whole haystack w/o SIMD)
+    for(; i <= last; i++) {
+        if(asciiToLower(haystack[i]) == needle[0]
+             &&
+           asciiToLower(haystack[i+size-1]) == needle[size-1]
+             &&
+           matchIgnoreCase(haystack+i, needle, size))
+        {
+            return i;
+        }
+    }
+
+    return std::string::npos;
+}
+
 } /* namespace */
@@ -20,6 +20,7 @@
 #define M8R_STRING_UTILS_H_
 
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 
 #include <algorithm>
@@ -197,6 +198,34 @@ static inline std::string stringIntFormat(std::string value, char thousandSep =
 
 void replaceAll(const std::string& old_s, const std::string& new_s, std::string& s);
 
+/**
+ * @brief Find lower case needle in the haystack while ignoring (ASCII) case of the haystack.
+ *
+ * Result is identical to stringToLower() of the haystack followed by find(), but
+ * haystack is neither copied nor converted - it's scanned using SIMD instructions
+ * (AVX2 or SSE2 if available at compile time, scalar code otherwise).
+ *
+ * @return position of the first match at or after pos, std::string::npos if not found.
+ */
+size_t stringFindIgnoreCase(const char* haystack, size_t haystackSize, const std::string& lowerNeedle, size_t pos=0);
+static inline size_t stringFindIgnoreCase(const std::string& haystack, const std::string& lowerNeedle, size_t pos=0)
+{
+    return stringFindIgnoreCase(haystack.data(), haystack.size(), lowerNeedle, pos);
+}
+
+/**
+ * @brief FNV-1a 64b hash of bytes.
+ */
+static inline uint64_t bytesHash(const char* bytes, size_t size)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i=0; i<size; i++) {
+        h ^= static_cast<unsigned char>(bytes[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
 } /* namespace*/
 
 #endif /* M8R_STRING_UTILS_H_ */
@@ -0,0 +1,228 @@
+/*
+ task_executor.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "task_executor.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr unsigned TaskExecutor::PRIORITIES;
+
+namespace {
+
+// executor, worker and task of the calling thread (if it is a worker)
+thread_local TaskExecutor* currentExecutor = nullptr;
+thread_local unsigned currentWorker = 0;
+thread_local TaskExecutor::Task* currentTask = nullptr;
+
+} // anonymous namespace
+
+TaskExecutor::Task::Task(function<void()> work, Priority priority)
+    : work(work),
+      priority(priority),
+      cancelled{false},
+      done{false}
+{
+}
+
+TaskExecutor::Task::~Task()
+{
+}
+
+bool TaskExecutor::isCurrentTaskCancelled()
+{
+    return currentTask && currentTask->isCancelled();
+}
+
+TaskExecutor::TaskExecutor(unsigned workersCount)
+    : pending{0},
+      nextWorker{0},
+      stopping{false}
+{
+    if(!workersCount) {
+        workersCount = thread::hardware_concurrency();
+        if(!workersCount) {
+            workersCount = 1;
+        }
+    }
+
+    for(unsigned w=0; w<workersCount; w++) {
+        workers.push_back(unique_ptr<Worker>{new Worker{}});
+    }
+    for(unsigned w=0; w<workersCount; w++) {
+        threads.push_back(thread(&TaskExecutor::work, this, w));
+    }
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    {
+        lock_guard<mutex> criticalSection{idleMutex};
+        stopping = true;
+    }
+    for(unique_ptr<Worker>& worker:workers) {
+        lock_guard<mutex> criticalSection{worker->mutex};
+        for(deque<TaskHandle>& queue:worker->queues) {
+            for(TaskHandle& task:queue) {
+                finish(task);
+            }
+            pending -= queue.size();
+            queue.clear();
+        }
+    }
+    submitted.notify_all();
+
+    for(thread& t:threads) {
+        t.join();
+    }
+}
+
+bool TaskExecutor::isWorkerThread() const
+{
+    return currentExecutor == this;
+}
+
+TaskExecutor::TaskHandle TaskExecutor::submit(function<void()> work, Priority priority)
+{
+    TaskHandle task = make_shared<Task>(work, priority);
+    if(stopping) {
+        finish(task);
+        return task;
+    }
+
+    unsigned w = isWorkerThread()?currentWorker:(nextWorker++ % workers.size());
+    {
+        lock_guard<mutex> criticalSection{workers[w]->mutex};
+        workers[w]->queues[static_cast<unsigned>(priority)].push_back(task);
+        pending++;
+    }
+    {
+        lock_guard<mutex> criticalSection{idleMutex};
+    }
+    submitted.notify_one();
+
+    return task;
+}
+
+void TaskExecutor::wait(const TaskHandle& task)
+{
+    if(isWorkerThread()) {
+        // help instead of blocking the worker - waited task might be queued behind
+        while(!task->isDone()) {
+            TaskHandle t = take(currentWorker);
+            if(t) {
+                run(t);
+            } else {
+                unique_lock<mutex> lock{idleMutex};
+                finished.wait_for(lock, chrono::milliseconds(1), [this,&task]() {
+                    return task->isDone() || pending;
+                });
+            }
+        }
+    } else {
+        unique_lock<mutex> lock{idleMutex};
+        finished.wait(lock, [&task]() { return task->isDone(); });
+    }
+}
+
+void TaskExecutor::work(unsigned w)
+{
+    currentExecutor = this;
+    currentWorker = w;
+
+    while(true) {
+        TaskHandle task = take(w);
+        if(task) {
+            run(task);
+        } else {
+            unique_lock<mutex> lock{idleMutex};
+            submitted.wait(lock, [this]() { return stopping || pending; });
+            if(stopping) {
+                return;
+            }
+        }
+    }
+}
+
+TaskExecutor::TaskHandle TaskExecutor::take(unsigned w)
+{
+    const unsigned n = static_cast<unsigned>(workers.size());
+    for(unsigned p=0; p<PRIORITIES && pending; p++) {
+        // the newest task from own deque
+        if(w < n) {
+            Worker& own = *workers[w];
+            lock_guard<mutex> criticalSection{own.mutex};
+            if(!own.queues[p].empty()) {
+                TaskHandle task = own.queues[p].back();
+                own.queues[p].pop_back();
+                pending--;
+                return task;
+            }
+        }
+        // the oldest task stolen from other worker
+        for(unsigned i=1; i<=n; i++) {
+            unsigned v = (w+i) % n;
+            if(v == w) {
+                continue;
+            }
+            Worker& victim = *workers[v];
+            lock_guard<mutex> criticalSection{victim.mutex};
+            if(!victim.queues[p].empty()) {
+                TaskHandle task = victim.queues[p].front();
+                victim.queues[p].pop_front();
+                pending--;
+                return task;
+            }
+        }
+    }
+    return TaskHandle{};
+}
+
+void TaskExecutor::run(TaskHandle& task)
+{
+    if(task->isCancelled()) {
+        finish(task);
+        return;
+    }
+
+    // worker may run tasks while it waits for a task
+    Task* waiting = currentTask;
+    currentTask = task.get();
+    try {
+        task->work();
+    } catch(...) {
+        // tasks report problems through their results
+    }
+    currentTask = waiting;
+
+    finish(task);
+}
+
+void TaskExecutor::finish(TaskHandle& task)
+{
+    // release state captured by the task
+    task->work = nullptr;
+    {
+        lock_guard<mutex> criticalSection{idleMutex};
+        task->done = true;
+    }
+    finished.notify_all();
+}
+
+} // m8r namespace
@@ -0,0 +1,178 @@
+/*
+ task_executor.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_TASK_EXECUTOR_H
+#define M8R_TASK_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Work-stealing executor of background tasks.
+ *
+ * Executor has a fixed number of workers (hardware concurrency by default) and
+ * every worker has its own deque of tasks for every priority. Task submitted by
+ * a worker is pushed to the worker's deque (worker takes the newest task first),
+ * task submitted by another thread is pushed to deques in round robin. Idle worker
+ * steals the oldest task from deques of other workers. Higher priority task is
+ * always taken before lower priority one.
+ *
+ * Task which has not started yet is skipped when cancelled, running task may check
+ * isCurrentTaskCancelled() to finish early.
+ */
+class TaskExecutor
+{
+public:
+    enum class Priority {
+        HIGH,   // 0 user is waiting for the result
+        NORMAL, // 1
+        LOW     // 2 housekeeping
+    };
+    static constexpr unsigned PRIORITIES = 3;
+
+    class Task
+    {
+        friend class TaskExecutor;
+
+    private:
+        std::function<void()> work;
+        Priority priority;
+        std::atomic<bool> cancelled;
+        std::atomic<bool> done;
+
+    public:
+        explicit Task(std::function<void()> work, Priority priority);
+        Task(const Task&) = delete;
+        Task(const Task&&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(const Task&&) = delete;
+        ~Task();
+
+        Priority getPriority() const { return priority; }
+        /**
+         * @brief Cancel the task - task which has not started yet will not run.
+         */
+        void cancel() { cancelled = true; }
+        bool isCancelled() const { return cancelled; }
+        /**
+         * @brief Check whether the task finished or it was skipped because it was cancelled.
+         */
+        bool isDone() const { return done; }
+    };
+    typedef std::shared_ptr<Task> TaskHandle;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<TaskHandle> queues[PRIORITIES];
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // queued (not taken) tasks
+    std::atomic<size_t> pending;
+    std::atomic<unsigned> nextWorker;
+    std::atomic<bool> stopping;
+
+    // idle workers wait for submit, other threads wait for tasks to finish
+    std::mutex idleMutex;
+    std::condition_variable submitted;
+    std::condition_variable finished;
+
+public:
+    /**
+     * @brief Get executor shared by Mind, AI and persistence.
+     */
+    static TaskExecutor& getInstance() {
+        static TaskExecutor SINGLETON{};
+        return SINGLETON;
+    }
+
+    /**
+     * @brief Check whether the task being run by calling worker was cancelled.
+     */
+    static bool isCurrentTaskCancelled();
+
+    /**
+     * @param workersCount  number of workers, 0 to use hardware concurrency.
+     */
+    explicit TaskExecutor(unsigned workersCount=0);
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor(const TaskExecutor&&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&&) = delete;
+    /**
+     * @brief Cancel queued tasks and wait for running tasks.
+     */
+    ~TaskExecutor();
+
+    unsigned getWorkersCount() const { return static_cast<unsigned>(workers.size()); }
+    size_t getPendingCount() const { return pending; }
+    /**
+     * @brief Check whether calling thread is a worker of this executor.
+     */
+    bool isWorkerThread() const;
+
+    TaskHandle submit(std::function<void()> work, Priority priority=Priority::NORMAL);
+
+    /**
+     * @brief Submit function and get future of its result.
+     *
+     * If the task is cancelled before it starts, then the future throws broken promise.
+     */
+    template<typename F>
+    auto async(F f, Priority priority=Priority::NORMAL, TaskHandle* handle=nullptr)
+        -> std::shared_future<decltype(f())>
+    {
+        typedef decltype(f()) R;
+        std::shared_ptr<std::packaged_task<R()>> task = std::make_shared<std::packaged_task<R()>>(f);
+        std::shared_future<R> result = task->get_future().share();
+        TaskHandle t = submit([task]() { (*task)(); }, priority);
+        if(handle) {
+            *handle = t;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Wait for the task to finish (or to be skipped).
+     *
+     * Worker runs other tasks while waiting, therefore tasks may wait for their subtasks.
+     */
+    void wait(const TaskHandle& task);
+
+private:
+    void work(unsigned w);
+    TaskHandle take(unsigned w);
+    void run(TaskHandle& task);
+    void finish(TaskHandle& task);
+};
+
+} // m8r namespace
+
+#endif // M8R_TASK_EXECUTOR_H
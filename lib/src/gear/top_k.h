@@ -0,0 +1,92 @@
+/*
+ top_k.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_TOP_K_H
+#define M8R_TOP_K_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Bounded heap which keeps k items w/ the highest score.
+ *
+ * Push is O(log k) and items which cannot get to the top are rejected in O(1)
+ * i.e. arbitrary number of candidates is ranked w/o materializing and sorting them.
+ */
+template<class ITEM, class SCORE=float>
+class TopK
+{
+public:
+    typedef std::pair<ITEM,SCORE> Entry;
+
+private:
+    size_t k;
+    // min-heap - the worst item of the top is in the front
+    std::vector<Entry> heap;
+
+public:
+    explicit TopK(size_t k) : k(k) { heap.reserve(k); }
+    TopK(const TopK&) = delete;
+    TopK(const TopK&&) = delete;
+    TopK &operator=(const TopK&) = delete;
+    TopK &operator=(const TopK&&) = delete;
+    ~TopK() {}
+
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    size_t getK() const { return k; }
+
+    /**
+     * @brief Check whether an item w/ given score would get to the top.
+     */
+    bool accepts(SCORE score) const {
+        return heap.size() < k || (k && score > heap.front().second);
+    }
+
+    void push(const ITEM& item, SCORE score) {
+        if(heap.size() < k) {
+            heap.push_back(Entry{item, score});
+            std::push_heap(heap.begin(), heap.end(), worse);
+        } else if(accepts(score)) {
+            std::pop_heap(heap.begin(), heap.end(), worse);
+            heap.back() = Entry{item, score};
+            std::push_heap(heap.begin(), heap.end(), worse);
+        }
+    }
+
+    /**
+     * @brief Append items to the result ordered by score (the best first) and clear the top.
+     */
+    void take(std::vector<Entry>& result) {
+        std::sort_heap(heap.begin(), heap.end(), worse);
+        result.insert(result.end(), heap.begin(), heap.end());
+        heap.clear();
+    }
+
+private:
+    static bool worse(const Entry& e1, const Entry& e2) {
+        return e1.second > e2.second;
+    }
+};
+
+} // m8r namespace
+
+#endif // M8R_TOP_K_H
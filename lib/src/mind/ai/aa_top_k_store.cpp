@@ -0,0 +1,96 @@
+/*
+ aa_top_k_store.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_top_k_store.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr uint16_t AaTopKStore::NOT_CALCULATED;
+constexpr float AaTopKStore::QUANTIZATION_SCALE;
+
+AaTopKStore::AaTopKStore(size_t k)
+    : k(k)
+{
+}
+
+AaTopKStore::~AaTopKStore()
+{
+}
+
+void AaTopKStore::reset(size_t notesCount)
+{
+    ids.assign(notesCount*k, 0);
+    scores.assign(notesCount*k, 0);
+    counts.assign(notesCount, NOT_CALCULATED);
+    if(!notesCount) {
+        ids.shrink_to_fit();
+        scores.shrink_to_fit();
+        counts.shrink_to_fit();
+    }
+}
+
+uint16_t AaTopKStore::quantize(float score)
+{
+    if(score <= 0.f) return 0;
+    if(score >= 1.f) return static_cast<uint16_t>(QUANTIZATION_SCALE);
+    return static_cast<uint16_t>(score*QUANTIZATION_SCALE + .5f);
+}
+
+void AaTopKStore::set(size_t y, TopK<uint32_t>& top)
+{
+    vector<Association> row{};
+    top.take(row);
+    // deterministic order of associations w/ the same score
+    std::stable_sort(row.begin(), row.end(), [](const Association& a1, const Association& a2) {
+        return a1.second > a2.second || (a1.second == a2.second && a1.first < a2.first);
+    });
+
+    size_t count = std::min(row.size(), k);
+    for(size_t i=0; i<count; i++) {
+        ids[y*k+i] = row[i].first;
+        scores[y*k+i] = quantize(row[i].second);
+    }
+    counts[y] = static_cast<uint16_t>(count);
+}
+
+void AaTopKStore::get(size_t y, vector<Association>& associations) const
+{
+    if(isCalculated(y)) {
+        for(size_t i=y*k; i<y*k+counts[y]; i++) {
+            associations.push_back(Association{ids[i], dequantize(scores[i])});
+        }
+    }
+}
+
+bool AaTopKStore::isAffectedBy(size_t y, uint32_t x, float score) const
+{
+    if(!isCalculated(y) || counts[y] < k) {
+        return true;
+    }
+    for(size_t i=y*k; i<y*k+counts[y]; i++) {
+        if(ids[i] == x) {
+            return true;
+        }
+    }
+    // the worst association is the last one
+    return quantize(score) >= scores[y*k+counts[y]-1];
+}
+
+} // m8r namespace
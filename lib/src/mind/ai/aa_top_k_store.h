@@ -0,0 +1,101 @@
+/*
+ aa_top_k_store.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_TOP_K_STORE_H
+#define M8R_AA_TOP_K_STORE_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../../gear/top_k.h"
+
+namespace m8r {
+
+/**
+ * @brief Sparse associations assessment store: k best associated Ns for every N.
+ *
+ * Replaces dense N x N AA matrix - only leaderboards are used, therefore N's row
+ * is reduced to its top k associations when calculated. Associations are stored
+ * in flat arrays (N x k IDs and scores) and AA scores from [0,1] are quantized
+ * to 16b i.e. memory is 6 x N x k bytes.
+ */
+class AaTopKStore
+{
+public:
+    typedef std::pair<uint32_t,float> Association;
+
+private:
+    static constexpr uint16_t NOT_CALCULATED = 0xFFFF;
+    static constexpr float QUANTIZATION_SCALE = 65535.f;
+
+    size_t k;
+
+    // row of N y is at [y*k, y*k + counts[y])
+    std::vector<uint32_t> ids;
+    std::vector<uint16_t> scores;
+    std::vector<uint16_t> counts;
+
+public:
+    explicit AaTopKStore(size_t k);
+    AaTopKStore(const AaTopKStore&) = delete;
+    AaTopKStore(const AaTopKStore&&) = delete;
+    AaTopKStore &operator=(const AaTopKStore&) = delete;
+    AaTopKStore &operator=(const AaTopKStore&&) = delete;
+    ~AaTopKStore();
+
+    /**
+     * @brief Drop all rows and prepare (not calculated) rows for given number of Ns.
+     */
+    void reset(size_t notesCount);
+    void clear() { reset(0); }
+
+    size_t size() const { return counts.size(); }
+    size_t getK() const { return k; }
+    size_t getBytesize() const {
+        return ids.capacity()*sizeof(uint32_t) + (scores.capacity()+counts.capacity())*sizeof(uint16_t);
+    }
+
+    bool isCalculated(size_t y) const { return counts[y] != NOT_CALCULATED; }
+    void invalidate(size_t y) { counts[y] = NOT_CALCULATED; }
+
+    /**
+     * @brief Check whether (new) AA score of N x might change calculated row of N y
+     * i.e. x is in the row or it would enter the row.
+     */
+    bool isAffectedBy(size_t y, uint32_t x, float score) const;
+
+    /**
+     * @brief Store top associations of N y - the top is cleared.
+     */
+    void set(size_t y, TopK<uint32_t>& top);
+
+    /**
+     * @brief Append associations of N y ordered by score (the best first, lower ID for the same score).
+     */
+    void get(size_t y, std::vector<Association>& associations) const;
+
+    static uint16_t quantize(float score);
+    static float dequantize(uint16_t score) { return score / QUANTIZATION_SCALE; }
+};
+
+} // m8r namespace
+
+#endif // M8R_AA_TOP_K_STORE_H
@@ -18,6 +18,8 @@
 */
 #include "ai_aa_bow.h"
 
+#include "../../gear/string_utils.h"
+
 namespace m8r {
 
 using namespace std;
@@ -27,34 +29,37 @@ AiAaBoW::AiAaBoW(Memory& memory, Mind& mind)
       memory(memory),
       lexicon{},
       wordBlacklist{},
-      tokenizer{lexicon,wordBlacklist}
+      tokenizer{lexicon,wordBlacklist},
+      deleteWatermark{},
+      aaStore{AA_LEADERBOARD_SIZE}
 {
 }
 
 AiAaBoW::~AiAaBoW()
 {
-    // delete dead threads
-    auto zombieIterator
-        = std::remove_if(runningWorkers.begin(),
-                         runningWorkers.end(),
-                         [](const thread* t) { if(!t->joinable()) { delete t; return true; } else return false; });
-    runningWorkers.erase(zombieIterator, runningWorkers.end());
+    lock_guard<mutex> criticalSection{tasksMutex};
+    for(TaskExecutor::TaskHandle& t:tasks) {
+        t->cancel();
+    }
+    for(TaskExecutor::TaskHandle& t:tasks) {
+        TaskExecutor::getInstance().wait(t);
+    }
 }
 
-void AiAaBoW::addWorkerAndCleanZombies(thread* t)
+shared_future<bool> AiAaBoW::submitTask(function<bool()> task, TaskExecutor::Priority priority)
 {
-    lock_guard<mutex> criticalSection{runningWorkersMutex};
-    MF_DEBUG("AA.BoW: workers+zombies " << runningWorkers.size() << endl);
+    lock_guard<mutex> criticalSection{tasksMutex};
 
-    // IMPROVE: if zombies is erased > future/promise is deleted as well > frontend that has future calls a method on it > crash
-    //   - temporal SOLUTION: threads are deleted on MF exit (i.e. finished threads are kept in memory for whole MF run)
-    //     (see destructor for dead threads code to move in here)
-    //   - IDEA: frontend could use a thread hook to indicate that it got future and t can be freed
+    tasks.erase(
+        std::remove_if(tasks.begin(), tasks.end(), [](const TaskExecutor::TaskHandle& t) { return t->isDone(); }),
+        tasks.end());
 
-    // add new one
-    runningWorkers.push_back(t);
+    TaskExecutor::TaskHandle handle{};
+    shared_future<bool> result = TaskExecutor::getInstance().async(task, priority, &handle);
+    tasks.push_back(handle);
+    MF_DEBUG("AA.BoW: tasks " << tasks.size() << endl);
 
-    MF_DEBUG("AA.BoW: workers " << runningWorkers.size() << endl);
+    return result;
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
@@ -63,16 +68,11 @@ shared_future<bool> AiAaBoW::dream() {
         MF_DEBUG("AA.BoW: ASYNC dream..." << endl);
         mind.incActiveProcesses();
 
-        // packaged task is parametrized by function/method signature (not return type)
-        std::packaged_task<bool (AiAaBoW*,thread*)> learnMemoryTask([](AiAaBoW* a,thread* t) { return a->learnMemorySync(t); });
-        future<bool> result = learnMemoryTask.get_future(); // move
-        thread* t = new thread{};
-        *t = thread(std::move(learnMemoryTask), this, t);
-        addWorkerAndCleanZombies(t);
-
-        return shared_future<bool>(std::move(result));
+        return submitTask([this]() { return learnMemorySync(); }, TaskExecutor::Priority::NORMAL);
     } else {
         MF_DEBUG("AA.BoW: SYNC dream..." << endl);
+        // learning decrements active processes in both variants
+        mind.incActiveProcesses();
         promise<bool> p{};
         bool status = learnMemorySync();
         p.set_value(status);
@@ -83,9 +83,22 @@ shared_future<bool> AiAaBoW::dream() {
     }
 }
 
-bool AiAaBoW::learnMemorySync(thread* t)
+bool AiAaBoW::learnMemorySync()
 {
     MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
+    learnNotes();
+
+    // NN to be trained on demand - just initialize it
+
+    mind.persistMindState(Configuration::MindState::THINKING);
+    mind.decActiveProcesses();
+
+    MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
+    return true;
+}
+
+void AiAaBoW::learnNotes()
+{
     notes.clear();
     memory.getAllNotes(notes);
     // let N know it's indexed in AI
@@ -96,15 +109,34 @@ bool AiAaBoW::learnMemorySync(thread* t)
     // build lexicon and BoW
     lexicon.clear();
     bow.clear();
+    titleBow.clear();
+    titleVectors.clear();
+    vector<pair<uint32_t,float>> entries{};
     for(Note* n:notes) {
         NoteCharProvider chars{n};
         WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
         tokenizer.tokenize(chars, *wfl);
         bow.add(n, wfl);
+
+        StringCharProvider titleChars{n->getName()};
+        WordFrequencyList* title = new WordFrequencyList{&lexicon};
+        tokenizer.tokenize(titleChars, *title, false, true, false);
+        titleBow.add(n, title);
+        title->toSparseVector(entries, SIZE_MAX, false);
+        titleVectors.add(entries);
     }
     // prepare DATA to quickly create association assessment features
     lexicon.recalculateWeights();
-    bow.reorderDocVectorsByWeight();
+    bow.sortDocVectors();
+    wordVectors.clear();
+    for(Note* n:notes) {
+        bow.get(n)->toSparseVector(entries);
+        wordVectors.add(entries);
+    }
+    lsh.clear();
+    if(notes.size() > AA_LSH_NOTES_THRESHOLD) {
+        indexLsh();
+    }
 
 #ifdef DO_MF_DEBUG
     lexicon.print();
@@ -112,30 +144,25 @@ bool AiAaBoW::learnMemorySync(thread* t)
 #endif
 
     // AA to be built incrementally - just initialize it
-    if(notes.size() != aaMatrix.size()) {
-        aaMatrix.clear();
-        aaMatrix.resize(notes.size());
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            aaMatrix[i].resize(aaMatrix.size(),(float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    } else {
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            std::fill(aaMatrix[i].begin(), aaMatrix[i].end(), (float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    }
-
-    // NN to be trained on demand - just initialize it
+    aaStore.reset(notes.size());
+    leaderboardCache.clear();
 
-    mind.persistMindState(Configuration::MindState::THINKING);
-    mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
-
-    MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
-    return true;
+    noteStamps.clear();
+    for(Note* n:notes) {
+        noteStamps.push_back(make_pair(n->getModified(), n->getRevision()));
+    }
+    outlineNotesCounts.clear();
+    for(Outline* o:memory.getOutlines()) {
+        outlineNotesCounts[o] = o->getNotesCount();
+    }
+    changesCursor = memory.getChanges().end();
+    deleteWatermark = mind.getDeleteWatermark();
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations) {
+    learnChangedNotes();
+
     auto cachedLeaderboard = leaderboardCache.find(note);
     if(cachedLeaderboard != leaderboardCache.end()) {
         MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
@@ -157,69 +184,270 @@ shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<No
             return p.get_future(); // move
         } else {
             mind.incActiveProcesses();
-            MF_DEBUG("AA.BoW: starting THREAD for '" << note->getName() << "'" << endl);
+            MF_DEBUG("AA.BoW: submitting TASK for '" << note->getName() << "'" << endl);
+
+            // user is waiting for the leaderboard
+            return submitTask([this,note]() { return calculateLeaderboardSync(note); }, TaskExecutor::Priority::HIGH);
+        }
+    }
+}
+
+float AiAaBoW::calculateAa(size_t x, size_t y)
+{
+    Note* n1 = notes[x];
+    Note* n2 = notes[y];
+    AssociationAssessmentNotesFeature aaFeature{};
+    aaFeature.setHaveMutualRel(false); // TODO
+    aaFeature.setTypeMatches(n1->getType()==n2->getType());
+    aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
+    aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
+    aaFeature.setSimilarityByTitles(titleVectors.similarity(x,y));
+    aaFeature.setSimilarityByDescription(wordVectors.relevantSimilarity(x,y,AA_WORD_RELEVANCY_THRESHOLD));
+    aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
+
+    return aaFeature.areNotesAssociatedMetric();
+}
 
-            // packaged task is parametrized by function/method signature (not return type)
-            packaged_task<bool (AiAaBoW*,const Note*,thread*)> calculateLeaderboardTask([](AiAaBoW* a, const Note* n, thread* t) { return a->calculateLeaderboardSync(n,t); });
-            future<bool> result = calculateLeaderboardTask.get_future(); // move
-            thread* t = new thread{};
-            *t = thread(std::move(calculateLeaderboardTask), this, note, t); // run task w/ handle to self thread
-            addWorkerAndCleanZombies(t);
+void AiAaBoW::getLshFeatures(size_t y, vector<uint64_t>& features)
+{
+    // features of different kinds are distinguished by the highest 32b, features are
+    // hashes of words and names (not IDs or pointers) to get the same candidates in every run
+    features.clear();
+    const uint32_t* ids = wordVectors.getIds(y);
+    const uint8_t* ranks = wordVectors.getRanks(y);
+    for(size_t i=0; i<wordVectors.getEntriesCount(y); i++) {
+        if(ranks[i] < AA_WORD_RELEVANCY_THRESHOLD) {
+            features.push_back(lexicon.getHash(ids[i]));
+        }
+    }
+    ids = titleVectors.getIds(y);
+    for(size_t i=0; i<titleVectors.getEntriesCount(y); i++) {
+        features.push_back(uint64_t{1}<<32 | lexicon.getHash(ids[i]));
+    }
+    for(const Tag* t:*notes[y]->getTags()) {
+        const string& name = t->getName();
+        features.push_back(uint64_t{2}<<32 | static_cast<uint32_t>(bytesHash(name.data(), name.size())));
+    }
+    const string& key = notes[y]->getOutlineKey();
+    features.push_back(uint64_t{3}<<32 | static_cast<uint32_t>(bytesHash(key.data(), key.size())));
+}
+
+void AiAaBoW::indexLsh()
+{
+    vector<uint64_t> features{};
+    for(size_t y=0; y<notes.size(); y++) {
+        getLshFeatures(y, features);
+        lsh.add(features);
+    }
+    lsh.index();
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+size_t AiAaBoW::learnChangedNotes()
+{
+    // added or deleted Ns: N IDs are no longer valid (deleted Ns must not be touched)
+    bool relearn = deleteWatermark != mind.getDeleteWatermark();
+    vector<Outline*> changedOutlines{};
+    vector<const Outline*> forgottenOutlines{};
+    if(!memory.getChanges().since(changesCursor, changedOutlines, forgottenOutlines)) {
+        relearn = true;
+    }
+    // Os replaced by relearned Markdowns: forgotten Os are in limbo, new O of the same
+    // key w/ the same Ns count takes IDs of the replaced Ns
+    unordered_map<StringInterner::Id,const Outline*> replaced{};
+    for(size_t i=0; !relearn && i<forgottenOutlines.size(); i++) {
+        const Outline* o = forgottenOutlines[i];
+        auto c = outlineNotesCounts.find(o);
+        if(c!=outlineNotesCounts.end() && c->second) {
+            relearn = c->second!=o->getNotesCount();
+            for(size_t j=0; !relearn && j<o->getNotesCount(); j++) {
+                int y = o->getNotes()[j]->getAiAaMatrixIndex();
+                relearn = y<0 || static_cast<size_t>(y)>=notes.size() || notes[y]!=o->getNotes()[j];
+            }
+            replaced[o->getKeyId()] = o;
+        }
+    }
+    vector<pair<const Outline*,Outline*>> replacements{};
+    for(size_t i=0; !relearn && i<changedOutlines.size(); i++) {
+        Outline* o = changedOutlines[i];
+        auto c = outlineNotesCounts.find(o);
+        if(c!=outlineNotesCounts.end()) {
+            relearn = c->second!=o->getNotesCount();
+        } else if(o->getNotesCount()) {
+            auto r = replaced.find(o->getKeyId());
+            if(r!=replaced.end() && r->second->getNotesCount()==o->getNotesCount()) {
+                replacements.push_back(make_pair(r->second, o));
+                replaced.erase(r);
+            } else {
+                relearn = true;
+            }
+        }
+    }
+    // deleted Os w/ Ns
+    relearn = relearn || !replaced.empty();
+    for(const Outline* o:forgottenOutlines) {
+        outlineNotesCounts.erase(o);
+    }
+    if(!relearn && changedOutlines.empty()) {
+        return 0;
+    }
+
+    {
+        // running tasks read AA data structures
+        lock_guard<mutex> criticalSection{tasksMutex};
+        for(TaskExecutor::TaskHandle& t:tasks) {
+            TaskExecutor::getInstance().wait(t);
+        }
+    }
+
+    if(relearn) {
+        MF_DEBUG("AA.BoW: Ns added or deleted - learning all Ns" << endl);
+        learnNotes();
+        return notes.size();
+    }
+
+    vector<size_t> changed{};
+    // replaced Ns: forget words of the old N and learn the new N under its ID
+    for(pair<const Outline*,Outline*>& r:replacements) {
+        for(size_t i=0; i<r.second->getNotesCount(); i++) {
+            Note* old = r.first->getNotes()[i];
+            Note* n = r.second->getNotes()[i];
+            size_t y = static_cast<size_t>(old->getAiAaMatrixIndex());
+            unlearnNoteWords(old);
+            bow.remove(old);
+            titleBow.remove(old);
+            leaderboardCache.erase(old);
+
+            notes[y] = n;
+            n->setAiAaMatrixIndex(static_cast<int>(y));
+            learnNoteWords(n);
+            noteStamps[y] = make_pair(n->getModified(), n->getRevision());
+            changed.push_back(y);
+        }
+    }
+    // changed Ns: tokenize again and adjust lexicon frequencies
+    for(Outline* o:changedOutlines) {
+        outlineNotesCounts[o] = o->getNotesCount();
+
+        for(Note* n:o->getNotes()) {
+            int y = n->getAiAaMatrixIndex();
+            if(y >= 0 && static_cast<size_t>(y) < notes.size() && notes[y] == n
+                 && noteStamps[y] != make_pair(n->getModified(), n->getRevision()))
+            {
+                unlearnNoteWords(n);
+                learnNoteWords(n);
+
+                noteStamps[y] = make_pair(n->getModified(), n->getRevision());
+                changed.push_back(static_cast<size_t>(y));
+            }
+        }
+    }
+    if(changed.empty()) {
+        return 0;
+    }
+    MF_DEBUG("AA.BoW: learning " << changed.size() << " changed N(s)" << endl);
+
+    // words of old descriptions and titles keep their IDs - lexicon is rebuilt once they prevail
+    if(lexicon.getUnusedCount()*2 > lexicon.size()) {
+        MF_DEBUG("AA.BoW: lexicon w/ " << lexicon.getUnusedCount() << " unused word(s) - learning all Ns" << endl);
+        learnNotes();
+        return notes.size();
+    }
+
+    // vectors of changed Ns w/ current weights
+    lexicon.recalculateWeights();
+    wordVectors.reweight(lexicon);
+    vector<pair<uint32_t,float>> entries{};
+    vector<uint64_t> features{};
+    for(size_t y:changed) {
+        bow.get(notes[y])->toSparseVector(entries);
+        wordVectors.set(y, entries);
+
+        titleBow.get(notes[y])->toSparseVector(entries, SIZE_MAX, false);
+        titleVectors.set(y, entries);
+
+        if(lsh.isIndexed()) {
+            getLshFeatures(y, features);
+            lsh.set(static_cast<uint32_t>(y), features);
+        }
+    }
 
-            return shared_future<bool>(std::move(result));
+    // invalidate leaderboards which changed N may enter or leave
+    for(size_t y:changed) {
+        aaStore.invalidate(y);
+        leaderboardCache.erase(notes[y]);
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x != y
+                 && aaStore.isCalculated(x)
+                 && aaStore.isAffectedBy(x, static_cast<uint32_t>(y), calculateAa(x, y)))
+            {
+                aaStore.invalidate(x);
+                leaderboardCache.erase(notes[x]);
+            }
         }
     }
+    for(size_t y:changed) {
+        calculateAaRow(y);
+    }
+
+    return changed.size();
+}
+
+void AiAaBoW::unlearnNoteWords(Note* n)
+{
+    const WordFrequencyList* old = bow.get(n);
+    for(size_t i=0; i<old->getWordIds().size(); i++) {
+        lexicon.remove(old->getWordIds()[i], static_cast<int>(old->getFrequencies()[i]));
+    }
+    old = titleBow.get(n);
+    for(size_t i=0; i<old->getWordIds().size(); i++) {
+        lexicon.remove(old->getWordIds()[i], static_cast<int>(old->getFrequencies()[i]));
+    }
+}
+
+void AiAaBoW::learnNoteWords(Note* n)
+{
+    NoteCharProvider chars{n};
+    WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+    tokenizer.tokenize(chars, *wfl);
+    bow.add(n, wfl);
+
+    StringCharProvider titleChars{n->getName()};
+    WordFrequencyList* title = new WordFrequencyList{&lexicon};
+    tokenizer.tokenize(titleChars, *title, false, true, false);
+    titleBow.add(n, title);
 }
 
-// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
-// to fill the beginning of the line.
 // This is a private method called from AI ~ AI state/async/critical sections handled by caller.
 void AiAaBoW::calculateAaRow(size_t y)
 {
     MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
-    // calculate row and column that cross diagonal on [y][y]
 
-    // check diagonal to find out whether the cross has been already calculated
-    if(aaMatrix[y][y] == 1.f) {
+    if(aaStore.isCalculated(y)) {
         return;
     }
 
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-
+    // only the best associations are kept - row is never materialized
     notes[y]->setAiAaMatrixIndex(y);
-    for(size_t x=0; x<aaMatrix.size(); x++) {
-        // set diagonal at the end
-        if(x!=y) {
-            // skip if value has been already calculated
-            if(aaMatrix[y][x] == AA_NOT_SET) {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    TopK<uint32_t> top{aaStore.getK()};
+    if(lsh.isIndexed()) {
+        vector<uint32_t> candidates{};
+        lsh.getCandidates(static_cast<uint32_t>(y), candidates);
+        for(uint32_t x:candidates) {
+            top.push(x, calculateAa(x, y));
+        }
+    } else {
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x!=y) {
+                top.push(static_cast<uint32_t>(x), calculateAa(x, y));
             }
         }
     }
-
-    // set diagonal at the end to indicate calculation is done (consider reentrancy)
-    aaMatrix[y][y] = 1.;
+    aaStore.set(y, top);
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("AA.BoW: AA row calculated!" << endl);
     //printAa();
-    //assertAaSymmetry();
 #endif
 }
 
@@ -227,100 +455,62 @@ void AiAaBoW::calculateAaRow(size_t y)
 void AiAaBoW::precalculateAa()
 {
 #ifdef DO_MF_DEBUG
-    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.+notes.size()/2.);
-    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
+    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.-notes.size()/2.);
+    MF_DEBUG("  Building AA w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
     float c=0;
     float p;
 #endif
 
-    // calculate FULL matrix of Ns associativity assessment for every N1 and N2 tuple
+    // calculate AA of every N1 and N2 tuple ONCE (symmetry) and offer it to leaderboards of both Ns
+    vector<unique_ptr<TopK<uint32_t>>> tops{};
+    for(size_t y=0; y<notes.size(); y++) {
+        tops.push_back(unique_ptr<TopK<uint32_t>>{new TopK<uint32_t>{aaStore.getK()}});
+    }
     float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-    for(size_t y=0; y<aaMatrix.size(); y++) {
+    if(lsh.isIndexed()) {
+        // near linear: only pairs which share LSH bucket
+        vector<pair<uint32_t,uint32_t>> candidates{};
+        lsh.getCandidatePairs(candidates);
+        MF_DEBUG("  Building AA w/ " << candidates.size() << " LSH candidate rankings..." << endl);
+        for(auto& c:candidates) {
+            aa = calculateAa(c.first, c.second);
+            tops[c.second]->push(c.first, aa);
+            tops[c.first]->push(c.second, aa);
+        }
+        for(size_t y=0; y<notes.size(); y++) {
+            notes[y]->setAiAaMatrixIndex(y);
+            aaStore.set(y, *tops[y]);
+        }
+        return;
+    }
+    for(size_t y=0; y<notes.size(); y++) {
         notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
 
 #ifdef DO_MF_DEBUG
         p = c/(UNIQUE_AA_CELLS/100.);
-        MF_DEBUG("    " << (int)p << "% AA matrix rankings for '" << notes[y]->getName() << "'" << endl);
+        MF_DEBUG("    " << (int)p << "% AA rankings for '" << notes[y]->getName() << "'" << endl);
 #endif
 
-        // calculate only values ABOVE diagonal i.e. initialize x=y
-        for(size_t x=y; x<aaMatrix.size(); x++) {
+        // calculate only values ABOVE diagonal
+        for(size_t x=y+1; x<notes.size(); x++) {
 #ifdef DO_MF_DEBUG
             c++;
 #endif
-
-            if(x==y) {
-                aaMatrix[x][y] = 1.;
-            } else {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
-            }
+            aa = calculateAa(x, y);
+            tops[y]->push(static_cast<uint32_t>(x), aa);
+            tops[x]->push(static_cast<uint32_t>(y), aa);
         }
     }
+    for(size_t y=0; y<notes.size(); y++) {
+        aaStore.set(y, *tops[y]);
+    }
 
 #ifdef DO_MF_DEBUG
-    MF_DEBUG("  AA matrix built!" << endl);
+    MF_DEBUG("  AA built!" << endl);
     //printAa();
-    assertAaSymmetry();
 #endif
 }
 
-float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
-{
-    StringCharProvider cp1{t1};
-    WordFrequencyList v1{&lexicon};
-    tokenizer.tokenize(cp1, v1, false, true, false);
-    StringCharProvider cp2{t2};
-    WordFrequencyList v2{&lexicon};
-    tokenizer.tokenize(cp2, v2, false, true, false);
-
-    // calculate overlap
-    if(!v1.size() || !v2.size()) {
-        return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-
-        for(auto& e:v1.iterable()) {
-            uWeight += 1;
-            if(v2.contains(e.first)) {
-                iWeight += 1;
-                intersection.add(e.first);
-            }
-        }
-
-        for(auto& e:v2.iterable()) {
-            if(!intersection.contains(e.first)) {
-                uWeight += 1;
-                if(v1.contains(e.first)) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
-                }
-            }
-        }
-
-        //MF_DEBUG("  titleSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
-    }
-}
-
 // algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
 float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vector<const Tag*>* t2)
 {
@@ -362,56 +552,9 @@ float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vec
     }
 }
 
-// consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
-float AiAaBoW::calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold)
+bool AiAaBoW::calculateLeaderboardSync(const Note* n)
 {
-    if(!v1.size() || !v2.size()) {
-        return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-        int t=0;
-
-        // iterate at most *threshold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& e:v1.iterable()) {
-            if(t++>=threshold) break;
-
-            float w = lexicon.get(e.first)->weight;
-            uWeight += w;
-            if(v2.contains(e.first)) {
-                iWeight += w;
-                intersection.add(e.first);
-            }
-        }
-        // uWeight contains weight of 1st 10 v1's words, iWeight weight of v1 intersection v2
-
-        // iterate at most *threshold* words from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        t=0;
-        for(auto& e:v2.iterable()) {
-            // consider at most threshold words from v2
-            if(++t>=threshold) break;
-
-            if(!intersection.contains(e.first)) {
-                float w = lexicon.get(e.first)->weight;
-                uWeight += w;
-                if(v1.contains(e.first)) {
-                    iWeight += w;
-                    // no need to update iVector as it won't be needed
-                }
-            }
-        }
-
-        // intersection % of union
-        float result = (iWeight/(uWeight/100.))/100;
-        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" (t="<<t<<") -> " << result << endl);
-        return result;
-    }
-}
-
-bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
-{
-    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << t << endl);
+    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "'" << endl);
 
     // If N was REMOVED, then nobody will ask for leaderboard.
     // If N was MODIFIED, then leaderboard will not be accurate (but it's not critical).
@@ -426,64 +569,16 @@ bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
         // calculate row/column of AA matrix & build leaderboard
         calculateAaRow(n->getAiAaMatrixIndex());
 
-        int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
-        for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
-            aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
-        }
-
-        float aa;
-        for(size_t x=0, y=n->getAiAaMatrixIndex(); x<notes.size(); x++) {
-            if(x==y) continue; // self on diagonal
-
-            aa = aaMatrix[x][y];
-
-            if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
-                // find target leaderboard row
-                size_t target;
-                for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
-                    if(aaLeaderboard[target][0] == AA_NOT_SET) {
-                        break; // fill empty row -> no shift needed
-                    } else {
-                        if(aa > aaMatrix[aaLeaderboard[target][0]][aaLeaderboard[target][1]]) {
-                            break;
-                        }
-                    }
-                }
-
-                /// empty row > no shift needed
-                if(aaLeaderboard[target][0] != AA_NOT_SET) {
-                    // shift leaderboard
-                    int sx = aaLeaderboard[target][0];
-                    int sy = aaLeaderboard[target][1];
-                    for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
-                        if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
-                            int tx=aaLeaderboard[ll][0];
-                            int ty=aaLeaderboard[ll][1];
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            sx=tx;
-                            sy=ty;
-                        } else {
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            break;
-                        }
-                    }
-                }
-
-                // assign value
-                aaLeaderboard[target][0]=x;
-                aaLeaderboard[target][1]=y;
-            }
-        }
+        vector<AaTopKStore::Association> associations{};
+        aaStore.get(n->getAiAaMatrixIndex(), associations);
 
         MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
         vector<pair<Note*,float>> leaderboard{};
-        for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
-            MF_DEBUG("  #" << i << " " <<
-                     notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
-                     " ~ " << aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]] << endl);
-            leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]]));
+        for(AaTopKStore::Association& a:associations) {
+            MF_DEBUG("  #" << leaderboard.size() << " " <<
+                     notes[a.first]->getName() << " (" << notes[a.first]->getOutline()->getName() << ")" <<
+                     " ~ " << a.second << endl);
+            leaderboard.push_back(std::make_pair(notes[a.first],a.second));
         }
 
         // cache leaderboard (copied)
@@ -492,29 +587,23 @@ bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
 
     leaderboardWip.erase(n);
     mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
     return true;
 }
 
-void AiAaBoW::assertAaSymmetry()
-{
-    MF_DEBUG("AI: checking AA symmetry..." << endl);
-    for(size_t i=0; i<aaMatrix.size(); ++i) {
-        for(size_t j=0; i<aaMatrix.size(); ++i) {
-            if(aaMatrix[i][j] != aaMatrix[j][i]) {
-                MF_DEBUG("  Symmetry ERROR: aa["<<i<<"]["<<j<<"]" << endl);
-            }
-        }
-    }
-    MF_DEBUG("AI: AA symmetry checked!" << endl);
-}
-
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::sleep() {
     lexicon.clear();
     notes.clear();
     outlines.clear();
     bow.clear();
+    titleBow.clear();
+    wordVectors.clear();
+    titleVectors.clear();
+    lsh.clear();
+    noteStamps.clear();
+    outlineNotesCounts.clear();
+    changesCursor = OutlineChanges::Cursor{};
+    leaderboardCache.clear();
 
     return true;
 }
@@ -522,7 +611,7 @@ bool AiAaBoW::sleep() {
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::amnesia() {
     sleep();
-    aaMatrix.clear();
+    aaStore.clear();
 
     return true;
 }
@@ -19,14 +19,20 @@
 #ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 
+#include <cstdint>
 #include <future>
+#include <unordered_map>
 
+#include "../../gear/task_executor.h"
 #include "../mind.h"
 #include "ai_aa.h"
+#include "aa_top_k_store.h"
+#include "min_hash_lsh.h"
 #include "./nlp/markdown_tokenizer.h"
 #include "./nlp/note_char_provider.h"
 #include "./nlp/bag_of_words.h"
 #include "./nlp/common_words_blacklist.h"
+#include "./nlp/sparse_word_vectors.h"
 
 namespace m8r {
 
@@ -41,10 +47,11 @@ class Mind;
 class AiAaBoW : public AiAssociationsAssessment
 {
 private:
-    static constexpr int THREAD_POOL_SIZE = 2; // IMPROVE thread pool size to be either configured OR #CPU detected and 1/2 or 1/3 used
     static constexpr float AA_NOT_SET = -1.f;
     static constexpr int AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
     static constexpr float AA_TITLE_WORD_BONUS = 0.2f;
+    // AA of bigger repositories is calculated only for LSH candidates (not all Ns)
+    static constexpr size_t AA_LSH_NOTES_THRESHOLD = 1000;
 
 private:
     Mind& mind;
@@ -54,6 +61,8 @@ private:
     CommonWordsBlacklist wordBlacklist;
     BagOfWords bow;
     MarkdownTokenizer tokenizer;
+    // title words are not stemmed, they share lexicon (and affect weights) w/ descriptions
+    BagOfWords titleBow;
 
     /*
      * Data sets
@@ -63,6 +72,25 @@ private:
     std::vector<Outline*> outlines; // IMPROVE make O* pair where .second is O embedding w/ classifications/attributes
     // Ns - vector index is used as ID through other data structures
     std::vector<Note*> notes; // IMPROVE make N* pair where .second is N embedding w/ classifications/attributes
+    // N ID > words of N description (AA_WORD_RELEVANCY_THRESHOLD most relevant are compared)
+    SparseWordVectors wordVectors;
+    // N ID > words of N title
+    SparseWordVectors titleVectors;
+    // Ns which are likely to be associated (N ID is LSH document)
+    MinHashLsh lsh;
+
+    /*
+     * Changes: modification and revision of Ns when they were learned, Os changed since
+     * then are reported by Memory changes (N change modifies its O as well). Added Ns
+     * change Ns count of O, deleted Ns and Os forgotten by user increment Mind delete
+     * watermark and Os replaced by relearned Markdowns are forgotten Os of Memory changes.
+     */
+
+    std::vector<std::pair<time_t,uint32_t>> noteStamps;
+    // O > Ns count when it was learned
+    std::unordered_map<const Outline*,size_t> outlineNotesCounts;
+    OutlineChanges::Cursor changesCursor;
+    int deleteWatermark;
 
     /*
      * Associations
@@ -76,10 +104,8 @@ private:
     // associate as you WRITE: word(s) -> O/N
     // IMPROVE std::map<const Note*,std::vector<std::pair<string*,float>>> leaderboardCache;
 
-    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry).
-    // Changed from float** to vector<vector>> to enable row/col extension on new N/O
-    // (keep & avoid realloc)
-    std::vector<std::vector<float>> aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Associations assessment w/ the best rankings for every N (row is calculated on demand)
+    AaTopKStore aaStore; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
 
 public:
     explicit AiAaBoW(Memory& memory, Mind& mind);
@@ -128,29 +154,29 @@ public:
 private:
 
     /*
-     * Worker threads:
-     *  1. packaged task is assigned to thread
-     *  2. thread performs the task and calls detach() on self when finishes
-     *     to indicate that it's ready to be deleted
-     *  3. if main thread detects that !thread.joinable(), then it can be deleted;
-     *     cleanup is done on any new thread launch AND/OR by this class destructor.
+     * Background tasks run by shared executor - tasks which have not started yet
+     * are cancelled and running tasks are awaited when AA is destroyed.
      */
 
-    // IMPROVE introduce a LIMIT on number of running threads in configuration
-    std::vector<std::thread*> runningWorkers;
-    std::mutex runningWorkersMutex;
+    std::vector<TaskExecutor::TaskHandle> tasks;
+    std::mutex tasksMutex;
 
 private:
 
     /**
      * @brief Learn Memory to start thinking.
      */
-    bool learnMemorySync(std::thread* t = nullptr);
+    bool learnMemorySync();
+
+    /**
+     * @brief Learn all Ns of Memory to data sets - calculated AA and leaderboards are dropped.
+     */
+    void learnNotes();
 
     /**
      * @brief Calculate leaderboard and indicate that it has been stored to cache.
      */
-    bool calculateLeaderboardSync(const Note* n, std::thread* t = nullptr);
+    bool calculateLeaderboardSync(const Note* n);
 
     /**
      * @brief Initialize blacklist using common words.
@@ -168,31 +194,58 @@ private:
     void precalculateAa();
 
     /**
-     * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
-     *
-     * LONG running method on bigger repositories.
+     * @brief Index Ns features (the most relevant words, title words, tags and O) to LSH.
      */
-    void calculateAaRow(size_t y);
+    void indexLsh();
+    void getLshFeatures(size_t y, std::vector<uint64_t>& features);
 
     /**
-     * @brief Calculate similarity of two word vectors.
+     * @brief Learn Ns which were changed since they were learned.
+     *
+     * Changed N is tokenized again, lexicon frequencies and weights are adjusted and its
+     * AA row is recalculated. Calculated rows and cached leaderboards of other Ns are
+     * invalidated only if the changed N is in the leaderboard or it would enter it.
+     * Lexicon weights of all words are updated, but the most relevant words of unchanged
+     * Ns are chosen again on the next dream.
+     *
+     * Ns of O which replaced forgotten O of the same key (relearned Markdown) take IDs
+     * of the replaced Ns if Ns count is the same and they are learned as changed Ns.
+     * If Ns were added or deleted since they were learned, then IDs of Ns are no longer
+     * valid and all Ns are learned again. The same applies when title lexicon is mostly
+     * formed by words of old titles.
+     *
+     * Running AA tasks are awaited before changes are learned.
+     *
+     * @return number of learned Ns.
+     */
+    size_t learnChangedNotes();
+    /**
+     * @brief Remove words of N description and title from lexicon.
      */
-    float calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold=1000);
+    void unlearnNoteWords(Note* n);
+    /**
+     * @brief Tokenize N description and title to BoWs (word lists are replaced).
+     */
+    void learnNoteWords(Note* n);
 
     /**
-     * @brief Calculate similarity of two tag lists.
+     * @brief Calculate AA row i.e. associations of N with other Ns and keep the best ones.
+     *
+     * All Ns are assessed in small repositories, only LSH candidates otherwise.
+     *
+     * LONG running method on bigger repositories.
      */
-    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
+    void calculateAaRow(size_t y);
 
     /**
-     * @brief Calculate similarity of two N/O names.
+     * @brief Calculate associations assessment of two Ns (given by ID).
      */
-    float calculateSimilarityByTitles(const std::string& t1, const std::string& t2);
+    float calculateAa(size_t x, size_t y);
 
     /**
-     * @brief Check AA matrix symmetry.
+     * @brief Calculate similarity of two tag lists.
      */
-    void assertAaSymmetry();
+    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
 
     /**
      * @brief Get AA leaderboard from cache.
@@ -200,22 +253,21 @@ private:
     bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
 
     /**
-     * @brief Remove finished workers and add new one.
+     * @brief Submit task to shared executor and forget finished tasks.
      */
-    void addWorkerAndCleanZombies(std::thread* t);
+    std::shared_future<bool> submitTask(std::function<bool()> task, TaskExecutor::Priority priority);
 
 public:
 #ifdef DO_MF_DEBUG
     void printAa() {
-        std::cout << "AA Matrix:" << std::endl;
-        for(size_t i=0; i<aaMatrix.size(); i++) {
+        std::cout << "AA:" << std::endl;
+        std::vector<AaTopKStore::Association> row{};
+        for(size_t i=0; i<aaStore.size(); i++) {
             std::cout << "AA[" << i << "] = ";
-            for(size_t j=0; j<aaMatrix.size(); j++) {
-                if(aaMatrix[i][j] == -1) {
-                    std::cout << "_ ";
-                } else {
-                    std::cout << aaMatrix[i][j] << " ";
-                }
+            row.clear();
+            aaStore.get(i, row);
+            for(AaTopKStore::Association& a:row) {
+                std::cout << a.first << "~" << a.second << " ";
             }
             std::cout << std::endl;
         }
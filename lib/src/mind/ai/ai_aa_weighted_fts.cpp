@@ -71,11 +71,6 @@ shared_future<bool> AiAaWeightedFts::dream()
  * WORDS -> Ns
  */
 
-bool weightedMatchesComparator(const std::pair<Note*,float>& p1, const std::pair<Note*,float>& p2)
-{
-    return p1.second > p2.second;
-}
-
 void AiAaWeightedFts::tokenizeAndStripString(string s, const bool ignoreCase, vector<string>& words)
 {
     size_t pos = 0;
@@ -168,44 +163,31 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
         }
     }
 
-    // sort to have the best match in head
-    if(result->size()) {
-        std::sort(result->begin(), result->end(), weightedMatchesComparator);
-    }
-
     return result;
 }
 
 void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,float>>* result, vector<string>& regexps, const bool ignoreCase)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
     if(ignoreCase) {
-        // case INSENSITIVE
+        // case INSENSITIVE - regexps are lower case, text is matched w/o conversion
 
         // O matches
         float oScore = 0.f;
-        string s{};
         // O.title matches
-        stringToLower(outline->getName(), s);
         for(auto& regexp:regexps) {
-            if(s.find(regexp)!=string::npos) {
+            if(stringFindIgnoreCase(outline->getName(), regexp)!=string::npos) {
                 oScore += 100.f;
             }
         }
         // O.description matches
         float matches = 0.f;
-        for(string* d:outline->getDescription()) {
-            if(d) {
-                s.clear();
-                stringToLower(*d, s);
-                for(auto& regexp:regexps) {
-                    // find all matches (regexp matched more than once)
-                    size_t m = s.find(regexp, 0);
-                    while(m != string::npos) {
-                        matches++;
-                        m = s.find(regexp,m+1);
-                    }
-                }
+        const string& od = outline->getDescription().getText();
+        for(auto& regexp:regexps) {
+            // find all matches (regexp matched more than once)
+            size_t m = stringFindIgnoreCase(od, regexp, 0);
+            while(m != string::npos) {
+                matches++;
+                m = stringFindIgnoreCase(od, regexp, m+1);
             }
         }
         if(matches != 0.f) {
@@ -226,27 +208,20 @@ void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,f
                 continue;
             }
             // N.title matches
-            s.clear();
-            stringToLower(note->getName(), s);
             for(auto& regexp:regexps) {
-                if(s.find(regexp)!=string::npos) {
+                if(stringFindIgnoreCase(note->getName(), regexp)!=string::npos) {
                     nScore += 100.f;
                 }
             }
             // N.description matches
             float matches=0.;
-            for(string* d:note->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    for(auto& regexp:regexps) {
-                        // find them all
-                        size_t m = s.find(regexp, 0);
-                        while(m != string::npos) {
-                            matches++;
-                            m = s.find(regexp,m+1);
-                        }
-                    }
+            const string& nd = note->getDescription().getText();
+            for(auto& regexp:regexps) {
+                // find them all
+                size_t m = stringFindIgnoreCase(nd, regexp, 0);
+                while(m != string::npos) {
+                    matches++;
+                    m = stringFindIgnoreCase(nd, regexp, m+1);
                 }
             }
             if(nScore!=0.f || matches!=0.f) {
@@ -288,17 +263,15 @@ std::shared_future<bool> AiAaWeightedFts::getAssociatedNotes(
     if(m->size()>0) {
         MF_DEBUG("AA.FTS.words '" << words << "' w/ " << m->size() << " matches" << endl);
 
-        // build leaderboard
-        std::vector<pair<Note*,float>>::iterator it;
-        for(it = m->begin(); it != m->end(); ++it) {
-            if(self && self==it->first) {
+        // build leaderboard - bounded heap instead of sorting all matches
+        TopK<Note*> leaderboard{AA_LEADERBOARD_SIZE};
+        for(auto& match:*m) {
+            if(self && self==match.first) {
                 continue;
             }
-            associations.push_back(*it);
-            if(associations.size() >= AA_LEADERBOARD_SIZE) {
-                break;
-            }
+            leaderboard.push(match.first, match.second);
         }
+        leaderboard.take(associations);
         // recalculate % (and debug)
         MF_DEBUG("Leaderboard of '" << words << "' word(s)[" << associations.size() << "]:" << endl);
         if(associations.size()) {
@@ -26,6 +26,7 @@
 #include "ai_aa.h"
 #include "../mind.h"
 #include "../../gear/hash_map.h"
+#include "../../gear/top_k.h"
 #include "./nlp/common_words_blacklist.h"
 #include "./nlp/markdown_tokenizer.h"
 
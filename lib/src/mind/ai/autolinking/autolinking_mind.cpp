@@ -100,10 +100,10 @@ void AutolinkingMind::addThingToTrie(const Thing *t) {
     trie->addWord(t->getAutolinkingAbbr());
 }
 
-void AutolinkingMind::removeThingFromTrie(const Thing *t) {
-    trie->removeWord(t->getAutolinkingName());
-    trie->removeWord(getLowerName(t->getAutolinkingName()));
-    trie->removeWord(t->getAutolinkingAbbr());
+void AutolinkingMind::removeThingFromTrie(const Thing *t, bool decRefCountOnly) {
+    trie->removeWord(t->getAutolinkingName(), decRefCountOnly);
+    trie->removeWord(getLowerName(t->getAutolinkingName()), decRefCountOnly);
+    trie->removeWord(t->getAutolinkingAbbr(), decRefCountOnly);
 }
 
 void AutolinkingMind::update(const std::string& oldName, const std::string& newName)
@@ -124,6 +124,30 @@ void AutolinkingMind::update(const std::string& oldName, const std::string& newN
     MF_DEBUG("DONE autolink update: '" << oldName << "' > '" << newName << "'" << endl);
 }
 
+void AutolinkingMind::update(const vector<Outline*>& forgotten, const vector<Outline*>& learned)
+{
+    if(!trie) {
+        updateTrieIndex();
+        return;
+    }
+
+    // names shared by more things are reference counted in trie
+    for(const Outline* o:forgotten) {
+        removeThingFromTrie(o, true);
+        for(const Note* n:o->getNotes()) {
+            removeThingFromTrie(n, true);
+        }
+    }
+    for(const Outline* o:learned) {
+        addThingToTrie(o);
+        for(const Note* n:o->getNotes()) {
+            addThingToTrie(n);
+        }
+    }
+
+    MF_DEBUG("[Autolinking] trie updated w/ " << forgotten.size() << " forgotten and " << learned.size() << " learned Os" << endl);
+}
+
 void AutolinkingMind::clear()
 {
     if(trie) {
@@ -31,6 +31,7 @@
 namespace m8r {
 
 class Mind;
+class Outline;
 
 /**
  * @brief Autolinking indices and inferences.
@@ -62,6 +63,11 @@ public:
      */
     void update(const std::string& oldName, const std::string& newName);
 
+    /**
+     * @brief Update indices on forgotten and learned Os e.g. when external changes are learned.
+     */
+    void update(const std::vector<Outline*>& forgotten, const std::vector<Outline*>& learned);
+
     /**
      * @brief Find longest autolinking match.
      */
@@ -93,9 +99,9 @@ protected:
     void addThingToTrie(const Thing *t);
 
     /**
-     * @brief Remove thing's name (and abbrev) from trie.
+     * @brief Remove thing's name (and abbrev) from trie - either completely or just one its reference.
      */
-    void removeThingFromTrie(const Thing *t);
+    void removeThingFromTrie(const Thing *t, bool decRefCountOnly=false);
 };
 
 }
@@ -281,15 +281,14 @@ CmarkAhoCorasickBlockAutolinkingPreprocessor::~CmarkAhoCorasickBlockAutolinkingP
 }
 
 void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
-    const vector<string*>& md,
+    const Description& md,
     string& amd
 ) {
 #ifdef MF_MD_2_HTML_CMARK
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] begin CMARK" << endl);
-    string ds{};
-    toString(md, ds);
+    const string& ds = md.getText();
     MF_DEBUG("[Autolinking] input:" << endl << ">>>" << ds << "<<<" << endl);
 
     auto begin = chrono::high_resolution_clock::now();
@@ -302,13 +301,11 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
     // some part (prefix) of the input MD will be autolinked.
 
     if(md.size()) {
-        string mds{};
-        toString(md, mds);
-        const char* mdsc{mds.c_str()};
+        const char* mdsc{md.getText().c_str()};
 
         cmark_node* document = cmark_parse_document(
             mdsc,
-            strlen(mdsc),
+            md.getText().size(),
             CMARK_OPT_DEFAULT
         );
 
@@ -364,7 +361,7 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
 
 #else
     // cmark-gfm not available - returning Markdown as is
-    toString(md, amd);
+    amd.append(md.getText());
 #endif
 }
 
@@ -106,7 +106,7 @@ public:
     /**
      * @brief Autolink Markdown.
      */
-    virtual void process(const std::vector<std::string*>& md, std::string& amd) override;
+    virtual void process(const Description& md, std::string& amd) override;
 };
 
 }
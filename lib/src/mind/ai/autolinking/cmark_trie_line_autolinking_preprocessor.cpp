@@ -120,15 +120,14 @@ void CmarkTrieLineAutolinkingPreprocessor::processAndAutolinkBlock(
 }
 
 void CmarkTrieLineAutolinkingPreprocessor::process(
-        const vector<string*>& md,
+        const Description& md,
         string& amd)
 {
 #ifdef MF_MD_2_HTML_CMARK
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] begin CMARK" << endl);
-    string ds{};
-    toString(md, ds);
+    const string& ds = md.getText();
     MF_DEBUG("[Autolinking] input:" << endl << ">>>" << ds << "<<<" << endl);
 
     auto begin = chrono::high_resolution_clock::now();
@@ -136,15 +135,18 @@ void CmarkTrieLineAutolinkingPreprocessor::process(
 
     insensitive = Configuration::getInstance().isAutolinkingCaseInsensitive();
 
+    // blocks are assembled from lines (copies)
+    vector<string*> lines{};
+    md.toLines(lines);
     vector<string*> block{};
-    if(md.size()) {
+    if(lines.size()) {
 
         // IMPROVE measure time in here and if over give limit, than STOP injecting
         // and leave i.e. what happens is that a time SLA will be fulfilled and
         // some part (prefix) of the input MD will be autolinked.
 
         bool inCodeBlock=false, inMathBlock=false;
-        for(string* l:md) {
+        for(string* l:lines) {
             if(l && stringStartsWith(*l, CODE_BLOCK)) {
                 block.push_back(l);
                 if(inCodeBlock) {
@@ -168,6 +170,9 @@ void CmarkTrieLineAutolinkingPreprocessor::process(
     }
 
     processAndAutolinkBlock(block, amd);
+    for(string* l:lines) {
+        delete l;
+    }
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] output:" << endl << ">>>" << amd << "<<<" << endl);
@@ -177,7 +182,7 @@ void CmarkTrieLineAutolinkingPreprocessor::process(
 #endif
 
 #else
-    toString(md, amd);
+    amd.append(md.getText());
 #endif
 }
 
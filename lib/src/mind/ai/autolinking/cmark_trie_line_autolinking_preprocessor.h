@@ -105,7 +105,7 @@ public:
      *
      * Provide previous Thing's name to update indices.
      */
-    virtual void process(const std::vector<std::string*>& md, std::string& amd) override;
+    virtual void process(const Description& md, std::string& amd) override;
 
 private:
     virtual void processLineByLine(const std::vector<std::string*>& md, std::string& amd);
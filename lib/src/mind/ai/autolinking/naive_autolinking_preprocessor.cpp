@@ -96,7 +96,7 @@ void NaiveAutolinkingPreprocessor::updateThingsIndex()
 #endif
 }
 
-void NaiveAutolinkingPreprocessor::process(const vector<string*>& md, string &amd)
+void NaiveAutolinkingPreprocessor::process(const Description& description, string &amd)
 {
     MF_DEBUG("[Autolinking] NAIVE" << endl);
 
@@ -106,6 +106,8 @@ void NaiveAutolinkingPreprocessor::process(const vector<string*>& md, string &am
     updateThingsIndex();
 
     std::vector<std::string*> amdl;
+    std::vector<std::string*> md;
+    description.toLines(md);
 
     // IMPROVE ORDER of Ns determines what will be found > have active O Ns in head, etc.
 
@@ -242,6 +244,9 @@ void NaiveAutolinkingPreprocessor::process(const vector<string*>& md, string &am
     }
 
     toString(amdl, amd);
+    for(string* l:md) {
+        delete l;
+    }
 }
 
 void NaiveAutolinkingPreprocessor::clear()
@@ -55,7 +55,7 @@ public:
     NaiveAutolinkingPreprocessor &operator=(const NaiveAutolinkingPreprocessor&&) = delete;
     virtual ~NaiveAutolinkingPreprocessor();
 
-    virtual void process(const std::vector<std::string*>& md, std::string& amd) override;
+    virtual void process(const Description& md, std::string& amd) override;
     void clear();
 
 private:
@@ -60,9 +60,9 @@ public:
     virtual ~AutolinkingPreprocessor();
 
     /**
-     * @brief Inject links to given MD source (list of rows) and return valid MD string.
+     * @brief Inject links to given MD source (description lines) and return valid MD string.
      */
-    virtual void process(const std::vector<std::string*>& in, std::string& out) = 0;
+    virtual void process(const Description& in, std::string& out) = 0;
 };
 
 }
@@ -0,0 +1,160 @@
+/*
+ min_hash_lsh.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "min_hash_lsh.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace m8r {
+
+constexpr unsigned MinHashLsh::DEFAULT_BANDS;
+constexpr unsigned MinHashLsh::DEFAULT_ROWS;
+constexpr size_t MinHashLsh::DEFAULT_BUCKET_WINDOW;
+
+MinHashLsh::MinHashLsh(unsigned bands, unsigned rows, size_t bucketWindow)
+    : bands(bands),
+      rows(rows),
+      bucketWindow(bucketWindow)
+{
+    // deterministic hash functions
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for(unsigned i=0; i<bands*rows; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        seeds.push_back(mix(seed));
+    }
+}
+
+MinHashLsh::~MinHashLsh()
+{
+}
+
+void MinHashLsh::clear()
+{
+    keys.clear();
+    featured.clear();
+    buckets.clear();
+}
+
+uint32_t MinHashLsh::add(const vector<uint64_t>& features)
+{
+    const uint32_t doc = static_cast<uint32_t>(featured.size());
+    featured.push_back(false);
+    keys.resize(keys.size()+bands);
+    sign(doc, features);
+
+    buckets.clear();
+    return doc;
+}
+
+void MinHashLsh::set(uint32_t doc, const vector<uint64_t>& features)
+{
+    if(isIndexed() && featured[doc]) {
+        for(unsigned b=0; b<bands; b++) {
+            vector<pair<uint64_t,uint32_t>>& band = buckets[b];
+            auto i = std::lower_bound(band.begin(), band.end(), make_pair(keys[doc*bands+b], doc));
+            band.erase(i);
+        }
+    }
+    sign(doc, features);
+    if(isIndexed() && featured[doc]) {
+        for(unsigned b=0; b<bands; b++) {
+            vector<pair<uint64_t,uint32_t>>& band = buckets[b];
+            const pair<uint64_t,uint32_t> entry{keys[doc*bands+b], doc};
+            band.insert(std::lower_bound(band.begin(), band.end(), entry), entry);
+        }
+    }
+}
+
+void MinHashLsh::sign(uint32_t doc, const vector<uint64_t>& features)
+{
+    featured[doc] = !features.empty();
+
+    vector<uint64_t> signature(seeds.size(), UINT64_MAX);
+    for(uint64_t f:features) {
+        for(size_t i=0; i<seeds.size(); i++) {
+            const uint64_t h = mix(f ^ seeds[i]);
+            if(h < signature[i]) {
+                signature[i] = h;
+            }
+        }
+    }
+    for(unsigned b=0; b<bands; b++) {
+        uint64_t key = seeds[b];
+        for(unsigned r=0; r<rows; r++) {
+            key = mix(key ^ signature[b*rows+r]);
+        }
+        keys[doc*bands+b] = key;
+    }
+}
+
+void MinHashLsh::index()
+{
+    buckets.assign(bands, vector<pair<uint64_t,uint32_t>>{});
+    for(unsigned b=0; b<bands; b++) {
+        vector<pair<uint64_t,uint32_t>>& band = buckets[b];
+        band.reserve(featured.size());
+        for(uint32_t doc=0; doc<featured.size(); doc++) {
+            if(featured[doc]) {
+                band.push_back(make_pair(keys[doc*bands+b], doc));
+            }
+        }
+        std::sort(band.begin(), band.end());
+    }
+}
+
+void MinHashLsh::getCandidates(uint32_t doc, vector<uint32_t>& candidates) const
+{
+    candidates.clear();
+    if(!isIndexed() || doc >= featured.size() || !featured[doc]) {
+        return;
+    }
+
+    for(unsigned b=0; b<bands; b++) {
+        const vector<pair<uint64_t,uint32_t>>& band = buckets[b];
+        const pair<uint64_t,uint32_t> self{keys[doc*bands+b], doc};
+        const size_t p = std::lower_bound(band.begin(), band.end(), self) - band.begin();
+        for(size_t i=p+1; i<band.size() && i-p<=bucketWindow && band[i].first==self.first; i++) {
+            candidates.push_back(band[i].second);
+        }
+        for(size_t i=p; i>0 && p-(i-1)<=bucketWindow && band[i-1].first==self.first; i--) {
+            candidates.push_back(band[i-1].second);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void MinHashLsh::getCandidatePairs(vector<pair<uint32_t,uint32_t>>& pairs) const
+{
+    pairs.clear();
+    for(const vector<pair<uint64_t,uint32_t>>& band:buckets) {
+        for(size_t i=0; i<band.size(); i++) {
+            for(size_t j=i+1; j<band.size() && j-i<=bucketWindow && band[j].first==band[i].first; j++) {
+                // documents are sorted within bucket
+                pairs.push_back(make_pair(band[i].second, band[j].second));
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+} // m8r namespace
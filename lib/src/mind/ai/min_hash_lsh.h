@@ -0,0 +1,127 @@
+/*
+ min_hash_lsh.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_MIN_HASH_LSH_H
+#define M8R_MIN_HASH_LSH_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Locality sensitive hashing of feature sets using MinHash signatures.
+ *
+ * Every document (N) is a set of 64b features (words, tags, ...). Signature of
+ * the document is a vector of bands x rows minimums of the features hashed by
+ * different hash functions - probability that two documents have the same
+ * minimum is Jaccard similarity of their feature sets. Rows of every band are
+ * hashed to a bucket and documents which share a bucket in at least one band are
+ * candidates i.e. similar documents are candidates with high probability:
+ *
+ *   P(candidates) = 1 - (1 - J^rows)^bands
+ *
+ * Buckets are sorted (bucket, document) arrays. To keep candidates count linear
+ * in a huge bucket, only documents which are at most maxBucketWindow positions
+ * apart in the bucket are candidates.
+ */
+class MinHashLsh
+{
+public:
+    static constexpr unsigned DEFAULT_BANDS = 32;
+    static constexpr unsigned DEFAULT_ROWS = 2;
+    static constexpr size_t DEFAULT_BUCKET_WINDOW = 128;
+
+private:
+    unsigned bands;
+    unsigned rows;
+    size_t bucketWindow;
+    std::vector<uint64_t> seeds;
+
+    // document > band bucket keys at [doc*bands, (doc+1)*bands)
+    std::vector<uint64_t> keys;
+    // document > has features (document w/o features is never candidate)
+    std::vector<bool> featured;
+    // band > (bucket key, document) sorted
+    std::vector<std::vector<std::pair<uint64_t,uint32_t>>> buckets;
+
+public:
+    explicit MinHashLsh(
+            unsigned bands=DEFAULT_BANDS,
+            unsigned rows=DEFAULT_ROWS,
+            size_t bucketWindow=DEFAULT_BUCKET_WINDOW);
+    MinHashLsh(const MinHashLsh&) = delete;
+    MinHashLsh(const MinHashLsh&&) = delete;
+    MinHashLsh &operator=(const MinHashLsh&) = delete;
+    MinHashLsh &operator=(const MinHashLsh&&) = delete;
+    ~MinHashLsh();
+
+    void clear();
+    size_t size() const { return featured.size(); }
+    bool isIndexed() const { return !buckets.empty(); }
+
+    /**
+     * @brief Add document given by its features.
+     *
+     * @return document ID (documents are numbered in the order they are added).
+     */
+    uint32_t add(const std::vector<uint64_t>& features);
+
+    /**
+     * @brief Replace features of the document - buckets are updated if indexed.
+     */
+    void set(uint32_t doc, const std::vector<uint64_t>& features);
+
+    /**
+     * @brief Build buckets once all documents were added.
+     */
+    void index();
+
+    /**
+     * @brief Get candidates of the document (sorted, w/o the document itself).
+     */
+    void getCandidates(uint32_t doc, std::vector<uint32_t>& candidates) const;
+
+    /**
+     * @brief Get all candidate pairs (x,y) w/ x < y (sorted, unique).
+     */
+    void getCandidatePairs(std::vector<std::pair<uint32_t,uint32_t>>& pairs) const;
+
+private:
+    void sign(uint32_t doc, const std::vector<uint64_t>& features);
+
+public:
+    /**
+     * @brief 64b hash mixing function (SplitMix64 finalizer).
+     */
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+};
+
+} // m8r namespace
+
+#endif // M8R_MIN_HASH_LSH_H
@@ -24,7 +24,7 @@ BagOfWords::BagOfWords()
 {
 }
 
-void BagOfWords::reorderDocVectorsByWeight()
+void BagOfWords::sortDocVectors()
 {
     for(auto& e:bow) {
         e.second->sort();
@@ -70,15 +70,36 @@ public:
         bow.clear();
     }
 
+    /**
+     * @brief Add (or replace) word frequency list of the doc - BoW takes ownership.
+     */
     void add(Thing* t, WordFrequencyList* wfl) {
-        bow[t] = wfl;
+        WordFrequencyList*& e = bow[t];
+        if(e != wfl) {
+            delete e;
+            e = wfl;
+        }
     }
 
     WordFrequencyList* get(Thing* t) {
         return bow[t];
     }
 
-    void reorderDocVectorsByWeight();
+    /**
+     * @brief Remove (and delete) word frequency list of the doc.
+     */
+    void remove(Thing* t) {
+        auto e = bow.find(t);
+        if(e != bow.end()) {
+            delete e->second;
+            bow.erase(e);
+        }
+    }
+
+    /**
+     * @brief Sort word frequency lists of all docs once BoW is built.
+     */
+    void sortDocVectors();
 
 #ifdef DO_MF_DEBUG
     void print() const {
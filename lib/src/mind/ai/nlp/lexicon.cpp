@@ -20,7 +20,13 @@
 
 namespace m8r {
 
+using namespace std;
+
+constexpr uint32_t Lexicon::EMPTY_SLOT;
+constexpr size_t Lexicon::INITIAL_SLOTS;
+
 Lexicon::Lexicon()
+    : slots(INITIAL_SLOTS, EMPTY_SLOT)
 {
     // inaccurate, but until the 1st word is added ;)
     maxFrequency = 1;
@@ -28,4 +34,96 @@ Lexicon::Lexicon()
 
 Lexicon::~Lexicon() = default;
 
+void Lexicon::clear()
+{
+    words.clear();
+    hashes.clear();
+    slots.assign(INITIAL_SLOTS, EMPTY_SLOT);
+    slots.shrink_to_fit();
+    maxFrequency = 1;
+}
+
+uint32_t Lexicon::hash(const string& word)
+{
+    uint32_t h = 2166136261u;
+    for(const char c:word) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t Lexicon::find(const string& word, uint32_t h) const
+{
+    const uint32_t mask = static_cast<uint32_t>(slots.size()-1);
+    uint32_t slot = h & mask;
+    while(slots[slot] != EMPTY_SLOT) {
+        const uint32_t id = slots[slot]-1;
+        if(hashes[id] == h && words[id].word == word) {
+            break;
+        }
+        slot = (slot+1) & mask;
+    }
+    return slot;
+}
+
+void Lexicon::rehash(size_t slotsCount)
+{
+    slots.assign(slotsCount, EMPTY_SLOT);
+    const uint32_t mask = static_cast<uint32_t>(slotsCount-1);
+    for(uint32_t id=0; id<hashes.size(); id++) {
+        uint32_t slot = hashes[id] & mask;
+        while(slots[slot] != EMPTY_SLOT) {
+            slot = (slot+1) & mask;
+        }
+        slots[slot] = id+1;
+    }
+}
+
+Lexicon::WordEmbedding* Lexicon::add(const string& word)
+{
+    const uint32_t h = hash(word);
+    uint32_t slot = find(word, h);
+    if(slots[slot] != EMPTY_SLOT) {
+        WordEmbedding* result = &words[slots[slot]-1];
+        ++result->frequency;
+        if(result->frequency>maxFrequency) maxFrequency=result->frequency;
+        return result;
+    }
+
+    const uint32_t id = static_cast<uint32_t>(words.size());
+    words.push_back(WordEmbedding{word,id,1,0});
+    hashes.push_back(h);
+    // keep load factor <= 1/2 to have short probe sequences
+    if(words.size()*2 > slots.size()) {
+        rehash(slots.size()*2);
+    } else {
+        slots[slot] = id+1;
+    }
+    return &words[id];
+}
+
+void Lexicon::remove(uint32_t id, int count)
+{
+    WordEmbedding& e = words[id];
+    const bool wasMax = e.frequency >= maxFrequency;
+    e.frequency = e.frequency>count?e.frequency-count:0;
+    if(wasMax) {
+        maxFrequency = 1;
+        for(const WordEmbedding& w:words) {
+            if(w.frequency>maxFrequency) maxFrequency=w.frequency;
+        }
+    }
+}
+
+size_t Lexicon::getBytesize() const
+{
+    size_t bytesize = words.capacity()*sizeof(WordEmbedding)
+        + (hashes.capacity()+slots.capacity())*sizeof(uint32_t);
+    for(const WordEmbedding& e:words) {
+        bytesize += e.word.capacity();
+    }
+    return bytesize;
+}
+
 } // m8r namespace
@@ -19,7 +19,10 @@
 #ifndef M8R_LEXICON_H
 #define M8R_LEXICON_H
 
-#include <map>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -36,8 +39,11 @@ namespace m8r {
  * @brief Lexicon of all words w/ global frequencies.
  *
  * Lexicon is the *only* data structure in MF's AI that keeps words by *value*.
- * Other data structures use either pointers or references to be memory efficient.
+ * Other data structures use dense word IDs to be memory efficient.
  *
+ * Words are stored in a vector indexed by ID (IDs are assigned in the order words
+ * are added) and looked up by an open addressing (linear probing) hash table of IDs.
+ * Pointers to words are valid until a new word is added.
  */
 // IMPROVE Stanford GloVe lexicon w/ word attributes & semantic domains (configure > check existence > use OR skip)
 class Lexicon
@@ -45,32 +51,35 @@ class Lexicon
 public:
 
     struct WordEmbedding {
-        // IMPROVE consider use of ptr to map's key
         std::string word;
+        // dense ID in the order words were added to lexicon
+        uint32_t id;
         int frequency;
         float weight;
 
         explicit WordEmbedding() {
+            id = 0;
             frequency = 0;
             weight = 0.;
         }
-        explicit WordEmbedding(const std::string& ww, int f, float w) {
+        explicit WordEmbedding(const std::string& ww, uint32_t i, int f, float w) {
             word = ww;
+            id = i;
             frequency = f;
             weight = w;
         }
     };
 
-
 private:
-    // map of word-to-frequency pairs for fast lookup and duplicity detection
-    // IMPROVE C++ SL uses map's comparator for string to do comparisons - thefore insert
-    //         complexity is O(log(n)) string comparisons. Consider TRIE data structure
-    //         instead.
-    std::map<std::string,WordEmbedding> m;
+    static constexpr uint32_t EMPTY_SLOT = 0;
+    static constexpr size_t INITIAL_SLOTS = 1024;
 
-    // sorted/ordered words by weight/frequency/... referencing/pointing to map
-    //std::vector<WordEmbedding*> words;
+    // ID > word
+    std::vector<WordEmbedding> words;
+    // ID > hash of the word (rehash w/o hashing words again)
+    std::vector<uint32_t> hashes;
+    // open addressing hash table: ID+1 or EMPTY_SLOT, size is power of 2
+    std::vector<uint32_t> slots;
 
     // keeping max word frequency for efficient weighs calculation
     int maxFrequency;
@@ -83,14 +92,20 @@ public:
     Lexicon &operator=(const Lexicon&&) = delete;
     ~Lexicon();
 
-    size_t size() const { return m.size(); }
-    void clear() { m.clear(); }
-    const std::map<std::string,WordEmbedding>& get() const { return m; }
+    size_t size() const { return words.size(); }
+    /**
+     * @brief Get the number of removed words i.e. words w/ zero frequency.
+     */
+    size_t getUnusedCount() const {
+        return std::count_if(words.begin(), words.end(), [](const WordEmbedding& e) { return e.frequency <= 0; });
+    }
+    void clear();
+    const std::vector<WordEmbedding>& get() const { return words; }
 
     WordEmbedding* get(const std::string& word) {
-        std::map<std::string,WordEmbedding>::iterator i = m.find(word);
-        if(i != m.end()) {
-            return &i->second;
+        uint32_t slot = find(word, hash(word));
+        if(slots[slot] != EMPTY_SLOT) {
+            return &words[slots[slot]-1];
         } else {
             return nullptr;
         }
@@ -98,23 +113,26 @@ public:
     WordEmbedding* get(const std::string* word) {
         return get(*word);
     }
-
-    WordEmbedding* add(const std::string& word) {
-        WordEmbedding* result;
-        if((result=get(word)) != nullptr) {
-            ++result->frequency;
-            if(result->frequency>maxFrequency) maxFrequency=result->frequency;
-            return result;
-        } else {
-            WordEmbedding we{word,1,0};
-            m[word] = we;
-            return &(m[word]);
-        }
+    WordEmbedding* getById(uint32_t id) {
+        return &words[id];
+    }
+    /**
+     * @brief Get hash of the word which, unlike its ID, doesn't depend on the order words were added.
+     */
+    uint32_t getHash(uint32_t id) const {
+        return hashes[id];
     }
+
+    WordEmbedding* add(const std::string& word);
     WordEmbedding* add(const std::string* word) {
         return add(*word);
     }
 
+    /**
+     * @brief Decrease frequency of the word (word keeps its ID).
+     */
+    void remove(uint32_t id, int count=1);
+
     /**
      * @brief Recalculate word weights.
      *
@@ -130,23 +148,36 @@ public:
      *
      */
     void recalculateWeights() {
-        for(auto& e:m) {
-            e.second.weight =  1.f - ((((float)e.second.frequency)/100.f) / (((float)maxFrequency)/100.f));
+        for(WordEmbedding& e:words) {
+            e.weight =  1.f - ((((float)e.frequency)/100.f) / (((float)maxFrequency)/100.f));
 
             // IMPROVE fixed constant is eight too big or small
             // ensure max(w)'s weigh to be > 0
-            if(!e.second.weight) e.second.weight = 0.01f;
+            if(!e.weight) e.weight = 0.01f;
         }
     }
 
+    size_t getBytesize() const;
+
 #ifdef DO_MF_DEBUG
     void print() const {
-        MF_DEBUG("Lexicon[" << m.size() << "]:" << std::endl);
-        for(auto& e:m) {
-            MF_DEBUG("  " << e.second.word << "  " << e.second.frequency << "  " << e.second.weight << std::endl);
+        MF_DEBUG("Lexicon[" << words.size() << "]:" << std::endl);
+        for(const WordEmbedding& e:words) {
+            MF_DEBUG("  " << e.word << "  " << e.frequency << "  " << e.weight << std::endl);
         }
     }
 #endif
+
+private:
+    /**
+     * @brief FNV-1a hash of the word.
+     */
+    static uint32_t hash(const std::string& word);
+    /**
+     * @brief Find slot of the word or empty slot where the word belongs.
+     */
+    uint32_t find(const std::string& word, uint32_t h) const;
+    void rehash(size_t slotsCount);
 };
 
 }
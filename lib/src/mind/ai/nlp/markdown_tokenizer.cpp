@@ -142,8 +142,6 @@ void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool
             break;
         }
     }
-
-    lexicon.recalculateWeights();
 }
 
 void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist)
@@ -157,8 +155,7 @@ void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem,
         // remove common words
         if(!useBlacklist || !blacklist.findWord(w)) {
             // increment token frequency
-            Lexicon::WordEmbedding* we = lexicon.add(w);
-            ++wfl[&(we->word)];
+            wfl.add(lexicon.add(w)->id);
         }
     }
     w.clear();
@@ -41,6 +41,9 @@ namespace m8r {
  *   - stems words (optional)
  *   - computes token frequency via Lexicon
  *
+ * Lexicon weights are NOT recalculated - it is up to caller to recalculate
+ * them once all the documents are tokenized.
+ *
  * See also:
  * https://www.ibm.com/developerworks/community/blogs/nlp/entry/tokenization?lang=en
  */
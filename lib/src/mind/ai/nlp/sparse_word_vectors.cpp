@@ -0,0 +1,213 @@
+/*
+ sparse_word_vectors.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "sparse_word_vectors.h"
+
+using namespace std;
+
+namespace m8r {
+
+SparseWordVectors::SparseWordVectors()
+    : garbage{0}
+{
+}
+
+SparseWordVectors::~SparseWordVectors()
+{
+}
+
+void SparseWordVectors::clear()
+{
+    offsets.clear();
+    counts.clear();
+    ids.clear();
+    weights.clear();
+    ranks.clear();
+    totals.clear();
+    garbage = 0;
+}
+
+size_t SparseWordVectors::add(const vector<pair<uint32_t,float>>& entries)
+{
+    offsets.push_back(0);
+    counts.push_back(0);
+    totals.push_back(0);
+    set(totals.size()-1, entries);
+    return totals.size()-1;
+}
+
+void SparseWordVectors::set(size_t v, const vector<pair<uint32_t,float>>& entries)
+{
+    if(entries.size() > counts[v]) {
+        garbage += counts[v];
+        offsets[v] = static_cast<uint32_t>(ids.size());
+        ids.resize(ids.size()+entries.size());
+        weights.resize(weights.size()+entries.size());
+        ranks.resize(ranks.size()+entries.size());
+    } else {
+        garbage += counts[v]-entries.size();
+    }
+    float total = 0;
+    for(size_t i=0; i<entries.size(); i++) {
+        ids[offsets[v]+i] = entries[i].first;
+        weights[offsets[v]+i] = entries[i].second;
+        total += entries[i].second;
+    }
+    counts[v] = static_cast<uint32_t>(entries.size());
+    totals[v] = total;
+    rank(v);
+
+    if(garbage*2 > ids.size()) {
+        compact();
+    }
+}
+
+void SparseWordVectors::compact()
+{
+    if(!garbage) {
+        return;
+    }
+
+    vector<uint32_t> compactIds{};
+    vector<float> compactWeights{};
+    vector<uint8_t> compactRanks{};
+    compactIds.reserve(ids.size()-garbage);
+    compactWeights.reserve(ids.size()-garbage);
+    compactRanks.reserve(ids.size()-garbage);
+    for(size_t v=0; v<totals.size(); v++) {
+        uint32_t offset = static_cast<uint32_t>(compactIds.size());
+        compactIds.insert(compactIds.end(), ids.begin()+offsets[v], ids.begin()+offsets[v]+counts[v]);
+        compactWeights.insert(compactWeights.end(), weights.begin()+offsets[v], weights.begin()+offsets[v]+counts[v]);
+        compactRanks.insert(compactRanks.end(), ranks.begin()+offsets[v], ranks.begin()+offsets[v]+counts[v]);
+        offsets[v] = offset;
+    }
+    ids.swap(compactIds);
+    weights.swap(compactWeights);
+    ranks.swap(compactRanks);
+    garbage = 0;
+}
+
+void SparseWordVectors::reweight(Lexicon& lexicon)
+{
+    for(size_t v=0; v<totals.size(); v++) {
+        float total = 0;
+        for(size_t i=offsets[v]; i<offsets[v]+counts[v]; i++) {
+            weights[i] = lexicon.getById(ids[i])->weight;
+            total += weights[i];
+        }
+        totals[v] = total;
+        rank(v);
+    }
+}
+
+void SparseWordVectors::rank(size_t v)
+{
+    // the heaviest words first (lower ID for the same weight)
+    const uint32_t offset = offsets[v];
+    vector<uint32_t> order(counts[v]);
+    for(uint32_t i=0; i<counts[v]; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this,offset](uint32_t i1, uint32_t i2) {
+        return weights[offset+i1] > weights[offset+i2]
+            || (weights[offset+i1] == weights[offset+i2] && ids[offset+i1] < ids[offset+i2]);
+    });
+    for(size_t r=0; r<order.size(); r++) {
+        ranks[offset+order[r]] = static_cast<uint8_t>(std::min<size_t>(r, UINT8_MAX));
+    }
+}
+
+float SparseWordVectors::intersectionWeight(
+        const uint32_t* ids1, const float* weights1, size_t n1,
+        const uint32_t* ids2, size_t n2)
+{
+    if(!n1 || !n2 || ids1[n1-1] < ids2[0] || ids2[n2-1] < ids1[0]) {
+        return 0.f;
+    }
+
+    // branch-free merge: compiler emits conditional moves, no mispredicted jumps
+    float weight = 0.f;
+    size_t i = 0, j = 0;
+    while(i < n1 && j < n2) {
+        const uint32_t a = ids1[i];
+        const uint32_t b = ids2[j];
+        weight += a == b ? weights1[i] : 0.f;
+        i += a <= b;
+        j += b <= a;
+    }
+    return weight;
+}
+
+float SparseWordVectors::similarity(size_t v1, size_t v2) const
+{
+    const size_t n1 = getEntriesCount(v1);
+    const size_t n2 = getEntriesCount(v2);
+    if(!n1 || !n2) {
+        return 0.f;
+    }
+
+    float iWeight = intersectionWeight(
+        ids.data()+offsets[v1], weights.data()+offsets[v1], n1,
+        ids.data()+offsets[v2], n2);
+    float uWeight = totals[v1] + totals[v2] - iWeight;
+    return uWeight > 0.f ? iWeight/uWeight : 0.f;
+}
+
+float SparseWordVectors::relevantSimilarity(size_t v1, size_t v2, size_t threshold) const
+{
+    const size_t n1 = getEntriesCount(v1);
+    const size_t n2 = getEntriesCount(v2);
+    if(!n1 || !n2) {
+        return 0.f;
+    }
+
+    const uint32_t* ids1 = ids.data()+offsets[v1];
+    const uint32_t* ids2 = ids.data()+offsets[v2];
+    const float* weights1 = weights.data()+offsets[v1];
+    const float* weights2 = weights.data()+offsets[v2];
+    const uint8_t* ranks1 = ranks.data()+offsets[v1];
+    const uint8_t* ranks2 = ranks.data()+offsets[v2];
+    const size_t threshold2 = threshold ? threshold-1 : 0;
+
+    // branch-free merge: relevant words of one vector which are in the other one are
+    // both in union and intersection, other relevant words are in union only
+    float iWeight = 0.f, uWeight = 0.f;
+    size_t i = 0, j = 0;
+    while(i < n1 && j < n2) {
+        const uint32_t a = ids1[i];
+        const uint32_t b = ids2[j];
+        const bool relevant1 = ranks1[i] < threshold;
+        const bool relevant2 = ranks2[j] < threshold2;
+        const float shared = a == b && (relevant1 || relevant2) ? weights1[i] : 0.f;
+        iWeight += shared;
+        uWeight += shared;
+        uWeight += a < b && relevant1 ? weights1[i] : 0.f;
+        uWeight += b < a && relevant2 ? weights2[j] : 0.f;
+        i += a <= b;
+        j += b <= a;
+    }
+    for(; i<n1; i++) {
+        uWeight += ranks1[i] < threshold ? weights1[i] : 0.f;
+    }
+    for(; j<n2; j++) {
+        uWeight += ranks2[j] < threshold2 ? weights2[j] : 0.f;
+    }
+    return uWeight > 0.f ? iWeight/uWeight : 0.f;
+}
+
+} // m8r namespace
@@ -0,0 +1,134 @@
+/*
+ sparse_word_vectors.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_SPARSE_WORD_VECTORS_H
+#define M8R_SPARSE_WORD_VECTORS_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "lexicon.h"
+
+namespace m8r {
+
+/**
+ * @brief Sparse word vectors of documents (Ns) for fast similarity calculation.
+ *
+ * Vector is a sorted array of (word ID, weight) entries. Vectors are stored in flat
+ * arrays (IDs and weights are in separate arrays) with offsets, therefore similarity
+ * of two vectors is a merge of two short contiguous arrays w/o pointer chasing.
+ * Weight of a word is the same in all vectors (lexicon weight), rank of a word
+ * is its position in the vector ordered by weight (the heaviest words are the most
+ * relevant ones).
+ *
+ * Vector which is replaced by a longer one is appended to the end of the arrays.
+ * Space of original vectors is garbage which is reclaimed by compaction once it
+ * exceeds the space of live entries i.e. incremental updates don't grow arrays.
+ */
+class SparseWordVectors
+{
+private:
+    // vector v is at [offsets[v], offsets[v]+counts[v])
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> ids;
+    std::vector<float> weights;
+    // rank of the word in its vector: 0 is the heaviest word, saturated at UINT8_MAX
+    std::vector<uint8_t> ranks;
+    // sum of weights of vector words
+    std::vector<float> totals;
+    // entries in ids/weights which don't belong to any vector
+    size_t garbage;
+
+public:
+    explicit SparseWordVectors();
+    SparseWordVectors(const SparseWordVectors&) = delete;
+    SparseWordVectors(const SparseWordVectors&&) = delete;
+    SparseWordVectors &operator=(const SparseWordVectors&) = delete;
+    SparseWordVectors &operator=(const SparseWordVectors&&) = delete;
+    ~SparseWordVectors();
+
+    void clear();
+    size_t size() const { return totals.size(); }
+    size_t getGarbageCount() const { return garbage; }
+    size_t getCapacity() const { return ids.size(); }
+    size_t getEntriesCount(size_t v) const { return counts[v]; }
+    const uint32_t* getIds(size_t v) const { return ids.data()+offsets[v]; }
+    const uint8_t* getRanks(size_t v) const { return ranks.data()+offsets[v]; }
+    float getTotal(size_t v) const { return totals[v]; }
+
+    /**
+     * @brief Append vector - entries must be sorted by word ID.
+     *
+     * @return index of the vector.
+     */
+    size_t add(const std::vector<std::pair<uint32_t,float>>& entries);
+
+    /**
+     * @brief Replace vector v - entries must be sorted by word ID.
+     */
+    void set(size_t v, const std::vector<std::pair<uint32_t,float>>& entries);
+
+    /**
+     * @brief Move vectors to the beginning of the arrays so that there is no garbage.
+     */
+    void compact();
+
+    /**
+     * @brief Set weights (and ranks) of words of all vectors to current lexicon weights.
+     */
+    void reweight(Lexicon& lexicon);
+
+    /**
+     * @brief Weighted Jaccard similarity: weight of intersection % of union in [0,1].
+     *
+     * Similarity is 0 if any of vectors is empty.
+     */
+    float similarity(size_t v1, size_t v2) const;
+
+    /**
+     * @brief Similarity of the most relevant words: weight of intersection % of union in [0,1].
+     *
+     * Union is weight of threshold most relevant words of v1 and threshold-1 most relevant
+     * words of v2 (as BoW AA always did), intersection is weight of these words which are
+     * anywhere in the other vector. Threshold must be at most UINT8_MAX.
+     *
+     * Similarity is 0 if any of vectors is empty.
+     */
+    float relevantSimilarity(size_t v1, size_t v2, size_t threshold) const;
+
+    /**
+     * @brief Weight of words which are in both sorted ID arrays (weights of the 1st array are used).
+     */
+    static float intersectionWeight(
+            const uint32_t* ids1, const float* weights1, size_t n1,
+            const uint32_t* ids2, size_t n2);
+
+private:
+    /**
+     * @brief Calculate ranks of words of vector v from their weights.
+     */
+    void rank(size_t v);
+};
+
+} // m8r namespace
+
+#endif // M8R_SPARSE_WORD_VECTORS_H
@@ -25,8 +25,7 @@ namespace m8r {
 using namespace std;
 
 WordFrequencyList::WordFrequencyList(Lexicon* lexicon)
-    : lexicon(lexicon),
-      wordWeightComparator{lexicon}
+    : lexicon(lexicon)
 {
     weight = UNDEF_WEIGHT;
 }
@@ -35,24 +34,78 @@ WordFrequencyList::~WordFrequencyList()
 {
 }
 
-void WordFrequencyList::sort() {
-    // reset array
-    wordsByWeight.clear();
+void WordFrequencyList::sort() const
+{
+    if(added.empty()) {
+        return;
+    }
+
+    std::sort(added.begin(), added.end());
+    vector<uint32_t> ids{};
+    vector<uint32_t> counts{};
+    ids.reserve(wordIds.size()+added.size());
+    counts.reserve(wordIds.size()+added.size());
+    // merge sorted words w/ sorted runs of added words
+    size_t i=0, a=0;
+    while(i<wordIds.size() || a<added.size()) {
+        uint32_t id;
+        uint32_t count = 0;
+        if(a>=added.size() || (i<wordIds.size() && wordIds[i]<=added[a])) {
+            id = wordIds[i];
+            count = frequencies[i++];
+        } else {
+            id = added[a];
+        }
+        while(a<added.size() && added[a]==id) {
+            count++;
+            a++;
+        }
+        ids.push_back(id);
+        counts.push_back(count);
+    }
+    wordIds.swap(ids);
+    frequencies.swap(counts);
+    added.clear();
+}
 
-    for(auto& w:word2Frequency) {
-        wordsByWeight.push_back(&w);
+uint32_t WordFrequencyList::getFrequency(uint32_t wordId) const
+{
+    sort();
+    auto i = std::lower_bound(wordIds.begin(), wordIds.end(), wordId);
+    if(i != wordIds.end() && *i == wordId) {
+        return frequencies[i-wordIds.begin()];
     }
-    std::sort(wordsByWeight.begin(),wordsByWeight.end(),wordWeightComparator);
+    return 0;
 }
 
 float WordFrequencyList::recalculateWeight() {
     weight = 0;
-    for(auto& w:word2Frequency) {
-        Lexicon::WordEmbedding* e = lexicon->get(w.first);
+    for(uint32_t id:getWordIds()) {
         // IMPROVE if(e) result += e->weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
-        if(e) weight += e->weight;
+        weight += lexicon->getById(id)->weight;
     }
     return weight;
 }
 
+void WordFrequencyList::toSparseVector(vector<pair<uint32_t,float>>& entries, size_t limit, bool weighted) const
+{
+    // words are sorted by ID
+    entries.clear();
+    for(uint32_t id:getWordIds()) {
+        entries.push_back(make_pair(id, weighted?lexicon->getById(id)->weight:1.f));
+    }
+    if(entries.size() > limit) {
+        // the heaviest words (lower ID for the same weight)
+        std::nth_element(
+            entries.begin(),
+            entries.begin()+limit,
+            entries.end(),
+            [](const pair<uint32_t,float>& e1, const pair<uint32_t,float>& e2) {
+                return e1.second > e2.second || (e1.second == e2.second && e1.first < e2.first);
+            });
+        entries.resize(limit);
+        std::sort(entries.begin(), entries.end());
+    }
+}
+
 } // m8r namespace
@@ -19,7 +19,9 @@
 #ifndef M8R_WORD_FREQUENCY_LIST_H
 #define M8R_WORD_FREQUENCY_LIST_H
 
-#include <map>
+#include <sys/types.h>
+
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -35,65 +37,54 @@ namespace m8r {
 /**
  * @brief Word frequency list for a doc.
  *
+ * List is a flat vector of word IDs sorted by ID w/ a parallel vector of
+ * frequencies. Words are appended (w/ repetition) while the doc is tokenized
+ * and merged to the sorted vectors when the list is read or sorted.
+ *
  * See:
  *   https://en.wikipedia.org/wiki/Word_lists_by_frequency
  */
 class WordFrequencyList
 {
-    struct WordWeightComparator
-    {
-        Lexicon *l;
-        WordWeightComparator(Lexicon* l) : l(l) {}
-
-        // functor to compare words by weight
-        bool operator()(
-                const std::pair<const std::string* const,int>*const& p1,
-                const std::pair<const std::string* const,int>*const& p2
-        ) {
-            return l->get(p1->first)->weight > l->get(p2->first)->weight;
-        }
-    };
-
 public:
     static constexpr float UNDEF_WEIGHT = -1;
 
-    static void evalUnion(WordFrequencyList& l1, WordFrequencyList& l2, WordFrequencyList& u)
+    static void evalUnion(const WordFrequencyList& l1, const WordFrequencyList& l2, WordFrequencyList& u)
     {
-        // IMPROVE u.iterable().insert(l1.iterable().begin(),l1.iterable().end());
-        for(auto& e:l1.iterable()) {
-            u.add(e.first);
+        for(uint32_t id:l1.getWordIds()) {
+            u.add(id);
         }
-
-        for(auto& e:l2.iterable()) {
-            u.add(e.first);
+        for(uint32_t id:l2.getWordIds()) {
+            if(!l1.contains(id)) {
+                u.add(id);
+            }
         }
     }
 
-    static void evalIntersection(WordFrequencyList& l1, WordFrequencyList& l2, WordFrequencyList& u)
+    static void evalIntersection(const WordFrequencyList& l1, const WordFrequencyList& l2, WordFrequencyList& u)
     {
-        // IMPROVE u.iterable().insert(l1.iterable().begin(),l1.iterable().end());
-        for(auto& e:l1.iterable()) {
-            if(l2.contains(e.first)) {
-                u.add(e.first);
+        for(uint32_t id:l1.getWordIds()) {
+            if(l2.contains(id)) {
+                u.add(id);
             }
         }
     }
 
 private:
     Lexicon* lexicon;
-    WordWeightComparator wordWeightComparator;
 
     float weight;
 
     /**
-     * @brief List of words occuring in a Thing ordered by weight.
+     * @brief Word IDs sorted by ID and their frequencies.
      */
-    std::vector<std::pair<const std::string *const,int>*> wordsByWeight;
+    mutable std::vector<uint32_t> wordIds;
+    mutable std::vector<uint32_t> frequencies;
 
     /**
-     * @brief TRANSIENT map used for quick inserts (can be cleared once list is built).
+     * @brief Word IDs added since the last sort (w/ repetition).
      */
-    std::map<const std::string*,int> word2Frequency;
+    mutable std::vector<uint32_t> added;
 
 public:
     explicit WordFrequencyList(Lexicon* lexicon);
@@ -103,9 +94,9 @@ public:
     WordFrequencyList &operator=(const WordFrequencyList&&) = delete;
     ~WordFrequencyList();
 
-    int& operator[](std::string* key) { return word2Frequency[key]; }
-    size_t size() const { return word2Frequency.size(); }
-    const std::map<const std::string*,int>& iterable() const { return word2Frequency; }
+    size_t size() const { sort(); return wordIds.size(); }
+    const std::vector<uint32_t>& getWordIds() const { sort(); return wordIds; }
+    const std::vector<uint32_t>& getFrequencies() const { sort(); return frequencies; }
 
     float getWeight() {
         if(weight==UNDEF_WEIGHT) {
@@ -115,52 +106,53 @@ public:
         }
     }
 
-    int contains(const std::string* word) {
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            return true;
-        } else {
-            return false;
-        }
+    bool contains(uint32_t wordId) const {
+        return getFrequency(wordId) > 0;
     }
 
-    int add(const std::string* word) {
-        weight = UNDEF_WEIGHT;
-
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            ++i->second;
-            return word2Frequency[word];
-        } else {
-            word2Frequency[word] = 1;
-            return 1;
-        }
-    }
+    uint32_t getFrequency(uint32_t wordId) const;
 
-    void set(const std::string* word, int frequency) {
-        word2Frequency[word] = frequency;
+    void add(uint32_t wordId) {
+        weight = UNDEF_WEIGHT;
+        added.push_back(wordId);
     }
 
     /**
-     * @brief Sort words by weight.
+     * @brief Merge words added since the last sort to sorted words.
      */
-    void sort();
+    void sort() const;
 
     /**
      * @brief Get weight of vector words.
      */
     float recalculateWeight();
 
+    /**
+     * @brief Get at most limit words w/ the highest weight as (word ID, weight) sorted by ID.
+     *
+     * @param weighted  if false, then every word has weight 1.
+     */
+    void toSparseVector(
+            std::vector<std::pair<uint32_t,float>>& entries,
+            size_t limit=SIZE_MAX,
+            bool weighted=true) const;
+
+    size_t getBytesize() const {
+        return (wordIds.capacity()+frequencies.capacity()+added.capacity())*sizeof(uint32_t);
+    }
+
 #ifdef DO_MF_DEBUG
     void print() const {
-        std::cout << "WordFrequencyList[" << word2Frequency.size() << "]:" << std::endl;
-        for(auto& w:wordsByWeight) {
-            std::cout << "  " << (*w->first) << " [" << w->second << "] " << std::endl;
+        sort();
+        std::cout << "WordFrequencyList[" << wordIds.size() << "]:" << std::endl;
+        for(size_t i=0; i<wordIds.size(); i++) {
+            std::cout << "  " << lexicon->getById(wordIds[i])->word << " [" << frequencies[i] << "] " << std::endl;
         }
     }
     void printFlat() const {
-        for(auto& w:wordsByWeight) {
-            std::cout << (*w->first) << " [" << w->second << "] ";
+        sort();
+        for(size_t i=0; i<wordIds.size(); i++) {
+            std::cout << lexicon->getById(wordIds[i])->word << " [" << frequencies[i] << "] ";
         }
     }
 #endif
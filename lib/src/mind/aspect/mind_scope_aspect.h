@@ -47,6 +47,8 @@ public:
     virtual bool isEnabled() const {
         return timeScope.isEnabled() || tagsScope.isEnabled();
     }
+    const TimeScopeAspect& getTimeScopeAspect() const { return timeScope; }
+    const TagsScopeAspect& getTagsScopeAspect() const { return tagsScope; }
     bool isOutOfScope(const Outline* o) const {
         if(timeScope.isEnabled()) {
             if(timeScope.isOutOfScope(o)) {
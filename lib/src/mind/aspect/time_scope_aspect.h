@@ -73,6 +73,7 @@ public:
     void resetTimeScope() { timeScope.reset(); }
 
     void setTimePoint(time_t timePoint);
+    time_t getTimePoint() const { return timePoint; }
 };
 
 }
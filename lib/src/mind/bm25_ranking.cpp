@@ -0,0 +1,133 @@
+/*
+ bm25_ranking.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "bm25_ranking.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+using namespace std;
+
+namespace m8r {
+
+Bm25Ranking::Bm25Ranking(const string& query, const Bm25Parameters& parameters)
+    : parameters(parameters),
+      documents{},
+      titleLengths{},
+      descriptionLengths{},
+      ready{false},
+      averageTitleLength{},
+      averageDescriptionLength{}
+{
+    queryToTerms(query, terms);
+    frequencies.resize(terms.size(), 0);
+}
+
+Bm25Ranking::~Bm25Ranking()
+{
+}
+
+void Bm25Ranking::queryToTerms(const string& query, vector<string>& terms)
+{
+    string lower{};
+    stringToLower(query, lower);
+
+    string term{};
+    for(size_t i=0; i<=lower.size(); i++) {
+        unsigned char c = i<lower.size() ? static_cast<unsigned char>(lower[i]) : ' ';
+        // UTF-8 bytes are kept in terms
+        if(std::isalnum(c) || c=='_' || c>=0x80) {
+            term += static_cast<char>(c);
+        } else if(term.size()) {
+            if(std::find(terms.begin(), terms.end(), term) == terms.end()) {
+                terms.push_back(term);
+            }
+            term.clear();
+        }
+    }
+}
+
+size_t Bm25Ranking::countOccurrences(const string& text, const string& term)
+{
+    size_t count = 0;
+    for(size_t m = stringFindIgnoreCase(text, term); m != string::npos; m = stringFindIgnoreCase(text, term, m+term.size())) {
+        count++;
+    }
+    return count;
+}
+
+void Bm25Ranking::addDocument(size_t titleLength, size_t descriptionLength)
+{
+    documents++;
+    titleLengths += titleLength;
+    descriptionLengths += descriptionLength;
+}
+
+bool Bm25Ranking::addCandidate(const string& title, const string& description)
+{
+    addDocument(title.size(), description.size());
+
+    bool contains = false;
+    for(size_t t=0; t<terms.size(); t++) {
+        if(stringFindIgnoreCase(title, terms[t]) != string::npos
+             ||
+           stringFindIgnoreCase(description, terms[t]) != string::npos)
+        {
+            frequencies[t]++;
+            contains = true;
+        }
+    }
+    return contains;
+}
+
+float Bm25Ranking::score(const string& title, const string& description)
+{
+    if(!ready) {
+        ready = true;
+        for(size_t t=0; t<terms.size(); t++) {
+            double n = static_cast<double>(frequencies[t]);
+            idfs.push_back(static_cast<float>(std::log(1.0 + (documents - n + 0.5)/(n + 0.5))));
+        }
+        averageTitleLength = documents ? static_cast<float>(titleLengths/documents) : 0.f;
+        averageDescriptionLength = documents ? static_cast<float>(descriptionLengths/documents) : 0.f;
+        if(averageTitleLength < 1.f) averageTitleLength = 1.f;
+        if(averageDescriptionLength < 1.f) averageDescriptionLength = 1.f;
+    }
+
+    const float b = parameters.b;
+    const float titleNorm = 1.f - b + b*title.size()/averageTitleLength;
+    const float descriptionNorm = 1.f - b + b*description.size()/averageDescriptionLength;
+
+    float score = 0.f;
+    for(size_t t=0; t<terms.size(); t++) {
+        if(!frequencies[t]) {
+            continue;
+        }
+        // BM25F: field term frequencies are length normalized and boosted before saturation
+        float tf
+            = parameters.titleBoost*countOccurrences(title, terms[t])/titleNorm
+            + parameters.descriptionBoost*countOccurrences(description, terms[t])/descriptionNorm;
+        if(tf > 0.f) {
+            score += idfs[t] * tf*(parameters.k1 + 1.f)/(tf + parameters.k1);
+        }
+    }
+    return score;
+}
+
+} // m8r namespace
@@ -0,0 +1,106 @@
+/*
+ bm25_ranking.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_BM25_RANKING_H
+#define M8R_BM25_RANKING_H
+
+#include <string>
+#include <vector>
+
+#include "../gear/string_utils.h"
+
+namespace m8r {
+
+/**
+ * @brief BM25 parameters - field boosts weight title and description term frequencies.
+ */
+struct Bm25Parameters
+{
+    float k1;
+    float b;
+    float titleBoost;
+    float descriptionBoost;
+
+    Bm25Parameters() : k1(1.2f), b(0.75f), titleBoost(3.f), descriptionBoost(1.f) {}
+};
+
+/**
+ * @brief BM25F ranking of documents w/ title and description fields.
+ *
+ * Query is split to (lower case) terms which are matched in the same way as
+ * case insensitive FTS (substring). Field lengths are measured in bytes.
+ *
+ * Ranking is done in two passes: statistics (number of documents, average
+ * field lengths and document frequency of terms) are collected first, then
+ * documents are scored.
+ */
+class Bm25Ranking
+{
+private:
+    Bm25Parameters parameters;
+    std::vector<std::string> terms;
+
+    size_t documents;
+    double titleLengths;
+    double descriptionLengths;
+    // documents containing the term
+    std::vector<size_t> frequencies;
+
+    // statistics derived on the first score()
+    bool ready;
+    std::vector<float> idfs;
+    float averageTitleLength;
+    float averageDescriptionLength;
+
+public:
+    explicit Bm25Ranking(const std::string& query, const Bm25Parameters& parameters);
+    Bm25Ranking(const Bm25Ranking&) = delete;
+    Bm25Ranking(const Bm25Ranking&&) = delete;
+    Bm25Ranking& operator=(const Bm25Ranking&) = delete;
+    Bm25Ranking& operator=(const Bm25Ranking&&) = delete;
+    ~Bm25Ranking();
+
+    const std::vector<std::string>& getTerms() const { return terms; }
+
+    /**
+     * @brief Count document which cannot contain any term (statistics pass).
+     *
+     * Document is given by field lengths only - its description might not be in memory.
+     */
+    void addDocument(size_t titleLength, size_t descriptionLength);
+    /**
+     * @brief Count document and terms it contains (statistics pass).
+     *
+     * @return true if document contains any term.
+     */
+    bool addCandidate(const std::string& title, const std::string& description);
+
+    /**
+     * @brief Score document - 0 if it doesn't contain any term (scoring pass).
+     */
+    float score(const std::string& title, const std::string& description);
+
+    static void queryToTerms(const std::string& query, std::vector<std::string>& terms);
+
+private:
+    static size_t countOccurrences(const std::string& text, const std::string& term);
+};
+
+} // m8r namespace
+
+#endif // M8R_BM25_RANKING_H
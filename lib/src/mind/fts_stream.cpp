@@ -0,0 +1,139 @@
+/*
+ fts_stream.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "fts_stream.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr unsigned FtsStream::CHUNKS_PER_WORKER;
+
+FtsStream::FtsStream(vector<Outline*>&& outlines, OutlineSearchFactory newSearch, unsigned workersCount)
+    : outlines(std::move(outlines)),
+      newSearch(newSearch),
+      chunkSize{1},
+      chunksCount{},
+      cancelled{false},
+      nextChunk{0},
+      publishedChunks{},
+      matchesCount{}
+{
+    if(workersCount) {
+        chunkSize = this->outlines.size()/(workersCount*CHUNKS_PER_WORKER);
+        if(!chunkSize) {
+            chunkSize = 1;
+        }
+    } else {
+        chunkSize = this->outlines.size()?this->outlines.size():1;
+    }
+    chunksCount = (this->outlines.size()+chunkSize-1)/chunkSize;
+    chunkMatches.resize(chunksCount);
+    chunkDone.resize(chunksCount, false);
+
+    if(workersCount > chunksCount) {
+        workersCount = static_cast<unsigned>(chunksCount);
+    }
+    if(workersCount) {
+        for(unsigned w=0; w<workersCount; w++) {
+            // user is waiting for matches
+            workers.push_back(TaskExecutor::getInstance().submit([this]() { work(); }, TaskExecutor::Priority::HIGH));
+        }
+    } else {
+        work();
+    }
+}
+
+FtsStream::~FtsStream()
+{
+    cancel();
+    for(TaskExecutor::TaskHandle& w:workers) {
+        w->cancel();
+    }
+    for(TaskExecutor::TaskHandle& w:workers) {
+        TaskExecutor::getInstance().wait(w);
+    }
+}
+
+void FtsStream::work()
+{
+    OutlineSearch search = newSearch();
+    size_t chunk;
+    while(!cancelled && (chunk = nextChunk++) < chunksCount) {
+        vector<Note*> matches{};
+        searchChunk(search, chunk, matches);
+        if(!cancelled) {
+            publish(chunk, matches);
+        }
+    }
+}
+
+void FtsStream::searchChunk(OutlineSearch& search, size_t chunk, vector<Note*>& matches)
+{
+    size_t end = (chunk+1)*chunkSize;
+    if(end > outlines.size()) {
+        end = outlines.size();
+    }
+    for(size_t o=chunk*chunkSize; o<end && !cancelled; o++) {
+        search(&matches, outlines[o]);
+    }
+}
+
+void FtsStream::publish(size_t chunk, vector<Note*>& matches)
+{
+    lock_guard<mutex> criticalSection{resultsMutex};
+
+    chunkMatches[chunk].swap(matches);
+    chunkDone[chunk] = true;
+    // publish chunks in order - chunk waits until all preceding chunks are done
+    while(publishedChunks < chunksCount && chunkDone[publishedChunks]) {
+        vector<Note*>& m = chunkMatches[publishedChunks];
+        published.insert(published.end(), m.begin(), m.end());
+        matchesCount += m.size();
+        vector<Note*>{}.swap(m);
+        publishedChunks++;
+    }
+}
+
+bool FtsStream::isDone()
+{
+    lock_guard<mutex> criticalSection{resultsMutex};
+
+    return cancelled || publishedChunks == chunksCount;
+}
+
+bool FtsStream::takeMatches(vector<Note*>& matches)
+{
+    lock_guard<mutex> criticalSection{resultsMutex};
+
+    if(published.empty()) {
+        return false;
+    }
+    matches.insert(matches.end(), published.begin(), published.end());
+    published.clear();
+    return true;
+}
+
+size_t FtsStream::getMatchesCount()
+{
+    lock_guard<mutex> criticalSection{resultsMutex};
+
+    return matchesCount;
+}
+
+} // m8r namespace
@@ -0,0 +1,113 @@
+/*
+ fts_stream.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_FTS_STREAM_H
+#define M8R_FTS_STREAM_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "../gear/task_executor.h"
+#include "../model/outline.h"
+
+namespace m8r {
+
+/**
+ * @brief Full-text search which streams matches.
+ *
+ * Os are split to chunks which are searched by worker threads. Matches
+ * are published chunk by chunk in the order of Os i.e. concatenation of
+ * all taken matches is identical to the result of the synchronous search.
+ * Search can be cancelled at any time - workers stop before the next O.
+ *
+ * Stream w/o workers searches all Os synchronously in the constructor.
+ */
+class FtsStream
+{
+public:
+    /**
+     * @brief Search single O and append matches to the result.
+     */
+    typedef std::function<void(std::vector<Note*>* result, Outline* outline)> OutlineSearch;
+    /**
+     * @brief Create search for a worker - search is used by single thread, but workers run in parallel.
+     */
+    typedef std::function<OutlineSearch()> OutlineSearchFactory;
+
+    // more chunks than workers to balance the load
+    static constexpr unsigned CHUNKS_PER_WORKER = 8;
+
+private:
+    std::vector<Outline*> outlines;
+    OutlineSearchFactory newSearch;
+    size_t chunkSize;
+    size_t chunksCount;
+
+    std::atomic<bool> cancelled;
+    std::atomic<size_t> nextChunk;
+
+    std::mutex resultsMutex;
+    std::vector<std::vector<Note*>> chunkMatches;
+    std::vector<bool> chunkDone;
+    // chunks [0,publishedChunks) are published
+    size_t publishedChunks;
+    // published matches which were not taken yet
+    std::vector<Note*> published;
+    size_t matchesCount;
+
+    std::vector<TaskExecutor::TaskHandle> workers;
+
+public:
+    explicit FtsStream(std::vector<Outline*>&& outlines, OutlineSearchFactory newSearch, unsigned workersCount);
+    FtsStream(const FtsStream&) = delete;
+    FtsStream(const FtsStream&&) = delete;
+    FtsStream& operator=(const FtsStream&) = delete;
+    FtsStream& operator=(const FtsStream&&) = delete;
+    /**
+     * @brief Cancel the search and wait for workers which already started.
+     */
+    ~FtsStream();
+
+    void cancel() { cancelled = true; }
+    bool isCancelled() const { return cancelled; }
+    /**
+     * @brief Check whether all matches were published (or search was cancelled).
+     */
+    bool isDone();
+    /**
+     * @brief Move matches published since the last call to the given vector.
+     *
+     * @return true if any match was taken.
+     */
+    bool takeMatches(std::vector<Note*>& matches);
+    /**
+     * @brief Get the number of matches published so far.
+     */
+    size_t getMatchesCount();
+
+private:
+    void work();
+    void searchChunk(OutlineSearch& search, size_t chunk, std::vector<Note*>& matches);
+    void publish(size_t chunk, std::vector<Note*>& matches);
+};
+
+} // m8r namespace
+
+#endif // M8R_FTS_STREAM_H
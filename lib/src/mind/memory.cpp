@@ -34,6 +34,7 @@ Memory::Memory(
       ontology{ontology},
       mdRepresentation{htmlRepresentation.getMarkdownRepresentation()},
       persistence(new FilesystemPersistence{mdRepresentation, htmlRepresentation}),
+      outlineCache{ontology},
       twikiRepresentation{mdRepresentation, persistence},
       csvRepresentation{},
       limbo{}
@@ -57,8 +58,11 @@ vector<Stencil*>& Memory::getStencils(ResourceType type)
 void Memory::learn()
 {
     aware = true;
+    cache = !config.getMemoryOutlineBodies();
 
     repositoryIndexer.index(config.getActiveRepository());
+    // watch before learning to get also changes made while learning
+    repositoryIndexer.watch();
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG(endl << "LEARNING repository in mode " << config.getActiveRepository()->getMode() << ":");
@@ -67,29 +71,35 @@ void Memory::learn()
 
     if(config.getActiveRepository()->getMode() == Repository::RepositoryMode::REPOSITORY) {
         MF_DEBUG(endl << "Markdown files:");
-        for(const string* markdownFile:repositoryIndexer.getMarkdownFiles()) {
-            Outline* outline = mdRepresentation.outline(File(*markdownFile));
-            MF_DEBUG(endl << "  '" << *markdownFile << "' format " << (outline->getFormat()==MarkdownDocument::Format::MINDFORGER?"MF":"MD"));
-
-            // fix O type according to repository type
-            switch(config.getActiveRepository()->getType()) {
-            case Repository::RepositoryType::MINDFORGER:
-                outline->setFormat(MarkdownDocument::Format::MINDFORGER);
-                break;
-            case Repository::RepositoryType::MARKDOWN:
-                outline->setFormat(MarkdownDocument::Format::MARKDOWN);
-                break;
-            }
-
-            if(outline->isVirgin()) {
-                MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
-                delete outline;
-            } else {
-                outlines.push_back(outline);
-                outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
-            }
+        // indexer keeps files ordered by pointers > sort them by path to learn Os deterministically
+        const set<const string*> indexedFiles = repositoryIndexer.getMarkdownFiles();
+        vector<const string*> markdownFiles(indexedFiles.begin(), indexedFiles.end());
+        std::sort(
+            markdownFiles.begin(),
+            markdownFiles.end(),
+            [](const string* a, const string* b) { return *a < *b; });
+
+        // parsed Os cache is kept in mind/ directory of MindForger repository
+        string cacheDir{config.getActiveRepository()->getDir()};
+        cacheDir += FILE_PATH_SEPARATOR;
+        cacheDir += DIRNAME_MIND;
+        if(config.getActiveRepository()->getType() == Repository::RepositoryType::MINDFORGER
+             &&
+           isDirectory(cacheDir.c_str()))
+        {
+            // header-only learn caches and deserializes Os w/o Ns bodies
+            outlineCache.load(cacheDir + FILE_PATH_SEPARATOR + FILENAME_OUTLINES_CACHE, cache);
+            // segments are mapped > Os are indexed as they are learned (w/o bodies in header-only mode)
+            ftsStore.open(cacheDir);
+        } else {
+            outlineCache.clear();
+            ftsStore.close();
         }
 
+        learnOutlines(markdownFiles);
+        outlineCache.save();
+        ftsStore.flush();
+
 #ifdef MF_WIP
         MF_DEBUG(endl << "PDF files:");
         for(const string* pdfFile:repositoryIndexer.getPdfFiles()) {
@@ -147,29 +157,367 @@ void Memory::learn()
                 repositoryIndexer.getRepository()->setType(Repository::RepositoryType::MARKDOWN);
             }
 
-            if(outline->isVirgin()) {
-                MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
-                delete outline;
-            } else {
-                outlines.push_back(outline);
-                outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
-            }
+            learnOutline(outline);
 
             MF_DEBUG(endl);
         } // else wrong number of files (typically none)
     }
 
+    // indices reindex all Os
+    changes.reset();
+
 #ifdef DO_MF_DEBUG
     auto end = chrono::high_resolution_clock::now();
     MF_DEBUG("LEARNED in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 }
 
+void Memory::learnOutlines(const vector<const string*>& markdownFiles)
+{
+    // lex & parse: MDs to ASTs in parallel - ASTs have no notion of ontology
+    const bool useCache = outlineCache.getFilePath().size();
+    // header-only learn skips parsing of Ns bodies
+    const bool noteBodies = cache;
+    vector<MarkdownDocument*> documents(markdownFiles.size(), nullptr);
+    // vector<bool> cannot be written concurrently
+    vector<unsigned char> cached(markdownFiles.size(), 0);
+    atomic<size_t> nextFile{0};
+    auto parser = [this, useCache, noteBodies, &markdownFiles, &documents, &cached, &nextFile]() {
+        size_t i;
+        while((i=nextFile++) < markdownFiles.size()) {
+            if(useCache && outlineCache.isFresh(*markdownFiles[i])) {
+                cached[i] = 1;
+                continue;
+            }
+            MarkdownDocument* md = new MarkdownDocument{markdownFiles[i]};
+            md->setNoteBodies(noteBodies);
+            md->setHashBytes(useCache);
+            try {
+                md->from();
+                documents[i] = md;
+            } catch(...) {
+                // document will be parsed again on merge to report the problem
+                delete md;
+            }
+        }
+    };
+
+    unsigned threadsCount = getLearnThreadsCount(markdownFiles.size());
+    MF_DEBUG(endl << "  Parsing " << markdownFiles.size() << " files using " << threadsCount << " thread(s)");
+    if(threadsCount > 1) {
+        // calling thread parses as well - it never waits for tasks which did not start
+        TaskExecutor& executor = TaskExecutor::getInstance();
+        vector<TaskExecutor::TaskHandle> workers{};
+        workers.reserve(threadsCount-1);
+        for(unsigned t=1; t<threadsCount; t++) {
+            workers.push_back(executor.submit(parser, TaskExecutor::Priority::HIGH));
+        }
+        parser();
+        for(TaskExecutor::TaskHandle& worker:workers) {
+            worker->cancel();
+        }
+        for(TaskExecutor::TaskHandle& worker:workers) {
+            executor.wait(worker);
+        }
+    } else {
+        parser();
+    }
+
+    // merge: ASTs to Os in a deterministic order (ontology is modified > single thread)
+    for(size_t i=0; i<markdownFiles.size(); i++) {
+        Outline* outline = nullptr;
+        if(cached[i]) {
+            outline = outlineCache.outline(*markdownFiles[i]);
+        }
+        if(!outline) {
+            unique_ptr<MarkdownDocument> md{documents[i]};
+            documents[i] = nullptr;
+            if(!md) {
+                md.reset(new MarkdownDocument{markdownFiles[i]});
+                md->setNoteBodies(noteBodies);
+                md->setHashBytes(useCache);
+                md->from();
+            }
+            outline = mdRepresentation.outline(*md);
+            if(useCache) {
+                outlineCache.remember(
+                    *markdownFiles[i], md->getModified(), md->getBytesSize(), md->getBytesHash(), outline);
+            }
+        }
+        MF_DEBUG(endl << "  '" << *markdownFiles[i] << "' format " << (outline->getFormat()==MarkdownDocument::Format::MINDFORGER?"MF":"MD"));
+
+        fixOutlineFormat(outline);
+        learnOutline(outline);
+    }
+}
+
+bool Memory::learnChanges(
+        const vector<RepositoryChange>& changes,
+        vector<RepositoryChange>& postponed,
+        vector<Outline*>& forgotten,
+        vector<Outline*>& learned,
+        const string* editedOutlineKey)
+{
+    for(const RepositoryChange& change:changes) {
+        auto known = outlinesMap.find(Thing::getKeys().find(change.path));
+        Outline* o = known==outlinesMap.end()?nullptr:known->second;
+        if(o && (isModifiedSinceSaved(o) || (editedOutlineKey && *editedOutlineKey==change.path))) {
+            MF_DEBUG("Memory: " << change.path << " changed, but O is being modified > postponing change" << endl);
+            postponed.push_back(change);
+            continue;
+        }
+
+        if(change.type == RepositoryChange::Type::DELETED) {
+            if(o) {
+                MF_DEBUG("Memory: forgetting deleted " << change.path << endl);
+                forget(o);
+                forgotten.push_back(o);
+            }
+            continue;
+        }
+
+        MF_DEBUG("Memory: learning changed " << change.path << endl);
+        MarkdownDocument md{&change.path};
+        md.setNoteBodies(cache);
+        try {
+            md.from();
+        } catch(...) {
+            // file might be deleted/being written > its next change is learned
+            MF_DEBUG("Memory: unable to parse " << change.path << endl);
+            continue;
+        }
+        Outline* outline = mdRepresentation.outline(md);
+        fixOutlineFormat(outline);
+        if(o) {
+            forget(o);
+            forgotten.push_back(o);
+        }
+        if(learnOutline(outline)) {
+            learned.push_back(outline);
+        }
+    }
+    if(forgotten.size() || learned.size()) {
+        ftsStore.flush();
+        return true;
+    }
+    return false;
+}
+
+void Memory::fixOutlineFormat(Outline* outline)
+{
+    // fix O type according to repository type
+    switch(config.getActiveRepository()->getType()) {
+    case Repository::RepositoryType::MINDFORGER:
+        outline->setFormat(MarkdownDocument::Format::MINDFORGER);
+        break;
+    case Repository::RepositoryType::MARKDOWN:
+        outline->setFormat(MarkdownDocument::Format::MARKDOWN);
+        break;
+    }
+}
+
+unsigned Memory::getLearnThreadsCount(size_t filesCount) const
+{
+    unsigned threadsCount = config.getMemoryLearnThreads();
+    if(!threadsCount) {
+        // workers of shared executor and the calling thread
+        threadsCount = TaskExecutor::getInstance().getWorkersCount()+1;
+    }
+    if(threadsCount > filesCount) {
+        threadsCount = static_cast<unsigned>(filesCount);
+    }
+    return threadsCount?threadsCount:1;
+}
+
+bool Memory::learnOutline(Outline* outline)
+{
+    if(outline->isVirgin()) {
+        MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
+        delete outline;
+        return false;
+    } else {
+        outlines.push_back(outline);
+        outlinesMap.insert(unordered_map<StringInterner::Id,Outline*>::value_type(outline->getKeyId(), outline));
+        stampSaved(outline);
+        outline->setListener(&changes);
+        changes.onOutlineChanged(outline);
+        // header-only learned O w/o persisted trigrams is indexed once its Ns bodies are recalled
+        indexOutline(outline, cache);
+        if(!cache) {
+            forgetNoteBodies(outline);
+        }
+        return true;
+    }
+}
+
+void Memory::indexOutline(Outline* outline, bool compute)
+{
+    vector<uint32_t> trigrams{};
+    if(ftsStore.isOpen()) {
+        time_t fileModified = fileModificationTime(&outline->getKey());
+        // content hash is computed on parse (cache), saved O's file is hashed
+        uint64_t hash;
+        if(!outlineCache.getHash(outline->getKey(), fileModified, hash)) {
+            // O's file might be written by external editor meanwhile > not mapped
+            filesystem::MappedFile file{outline->getKey(), false};
+            hash = bytesHash(file.getData(), file.getSize());
+        }
+        FtsIndexStore::Stamp stamp{
+            static_cast<int64_t>(fileModified),
+            static_cast<int64_t>(outline->getModified()),
+            static_cast<uint32_t>(outline->getRevision()),
+            hash};
+        if(ftsStore.lookup(outline->getKey(), stamp, trigrams)) {
+            ftsIndex.index(outline, std::move(trigrams));
+        } else if(compute) {
+            TrigramIndex::trigrams(outline, trigrams);
+            // trigrams of O being modified are not persisted as it differs from its file
+            if(!outline->isDirty()) {
+                ftsStore.put(outline->getKey(), stamp, trigrams);
+            }
+            ftsIndex.index(outline, std::move(trigrams));
+        }
+    } else if(compute) {
+        ftsIndex.index(outline);
+    }
+}
+
+void Memory::recall(Outline* outline)
+{
+    if(cache || !outline) {
+        return;
+    }
+
+    lock_guard<mutex> criticalSection{bodiesMutex};
+    if(bodiesLruIndex.find(outline) == bodiesLruIndex.end()) {
+        vector<Description> bodies{};
+        if(loadNoteBodies(outline, bodies)) {
+            setNoteBodies(outline, bodies);
+        }
+    }
+
+    touchNoteBodies(outline);
+    forgetColdNoteBodies();
+}
+
+void Memory::recallShared(Outline* outline)
+{
+    if(cache || !outline) {
+        return;
+    }
+
+    bool recalled;
+    {
+        lock_guard<mutex> criticalSection{bodiesMutex};
+        pinnedBodies[outline]++;
+        recalled = bodiesLruIndex.find(outline) != bodiesLruIndex.end();
+    }
+    // pinned O is recalled by this worker only, but O might be recalled by UI meanwhile
+    vector<Description> bodies{};
+    bool loaded = !recalled && loadNoteBodies(outline, bodies);
+
+    lock_guard<mutex> criticalSection{bodiesMutex};
+    if(loaded && bodiesLruIndex.find(outline) == bodiesLruIndex.end()) {
+        setNoteBodies(outline, bodies);
+    }
+    touchNoteBodies(outline);
+    updateFtsIndex(outline);
+    forgetColdNoteBodies();
+}
+
+void Memory::releaseShared(Outline* outline)
+{
+    if(cache || !outline) {
+        return;
+    }
+
+    lock_guard<mutex> criticalSection{bodiesMutex};
+    auto pinned = pinnedBodies.find(outline);
+    if(pinned != pinnedBodies.end() && !--pinned->second) {
+        pinnedBodies.erase(pinned);
+    }
+    forgetColdNoteBodies();
+}
+
+bool Memory::loadNoteBodies(Outline* outline, vector<Description>& bodies)
+{
+    // O which was not saved yet has no bodies to load
+    if(isFile(outline->getKey().c_str())) {
+        MF_DEBUG("Memory: loading Ns bodies of " << outline->getKey() << endl);
+        MarkdownDocument md{&outline->getKey()};
+        md.from();
+        MarkdownOutlineRepresentation::noteBodies(md, bodies);
+        return true;
+    }
+    return false;
+}
+
+void Memory::setNoteBodies(Outline* outline, vector<Description>& bodies)
+{
+    // Ns might be renamed/moved/added while bodies were forgotten > fill forgotten bodies
+    // only, N remembers section (N) of the file w/ its body
+    for(Note* n:outline->getNotes()) {
+        int section = n->getForgottenBodySection();
+        if(section != Note::NO_FORGOTTEN_BODY && static_cast<size_t>(section) < bodies.size()) {
+            n->setDescription(std::move(bodies[section]));
+            bodies[section].clear();
+        }
+    }
+}
+
+bool Memory::isModifiedSinceSaved(const Outline* outline) const
+{
+    auto stamp = savedStamps.find(outline);
+    return stamp == savedStamps.end()
+        || stamp->second.modified != outline->getModified()
+        || stamp->second.revision != outline->getRevision();
+}
+
+void Memory::touchNoteBodies(Outline* outline)
+{
+    auto entry = bodiesLruIndex.find(outline);
+    if(entry == bodiesLruIndex.end()) {
+        bodiesLru.push_front(outline);
+        bodiesLruIndex[outline] = bodiesLru.begin();
+    } else {
+        bodiesLru.splice(bodiesLru.begin(), bodiesLru, entry->second);
+    }
+}
+
+void Memory::forgetNoteBodies(Outline* outline)
+{
+    // O is the same as its file i.e. Ns are file sections
+    for(size_t i=0; i<outline->getNotes().size(); i++) {
+        outline->getNotes()[i]->forgetBody(static_cast<int>(i));
+    }
+}
+
+void Memory::forgetColdNoteBodies()
+{
+    // the most recently used O (front) is never forgotten
+    auto o = bodiesLru.end();
+    while(bodiesLru.size() > config.getMemoryOutlineBodies() && --o != bodiesLru.begin()) {
+        // O w/ bodies modified since learn/save or searched by a worker cannot be evicted
+        if(!(*o)->isDirty() && !isModifiedSinceSaved(*o) && pinnedBodies.find(*o) == pinnedBodies.end()) {
+            MF_DEBUG("Memory: forgetting Ns bodies of " << (*o)->getKey() << endl);
+            forgetNoteBodies(*o);
+            bodiesLruIndex.erase(*o);
+            o = bodiesLru.erase(o);
+        }
+    }
+}
+
 void Memory::amnesia()
 {
     aware = false;
 
     repositoryIndexer.clear();
+    outlineCache.clear();
+    ftsStore.close();
+    bodiesLru.clear();
+    bodiesLruIndex.clear();
+    savedStamps.clear();
+    changes.reset();
 
     // IMPROVE reset ontology i.e. clear custom types & keep only default ontology
     // ontology.reset();
@@ -179,6 +527,7 @@ void Memory::amnesia()
     }
     outlines.clear();
     outlinesMap.clear();
+    ftsIndex.clear();
 
     for(Outline*& outline:limboOutlines) {
         delete outline;
@@ -231,6 +580,14 @@ void Memory::remember(const std::string& outlineKey)
         o->makeModified();
         o->checkAndFixProperties();
         persistence->save(o);
+        repositoryIndexer.onFileWritten(outlineKey);
+        stampSaved(o);
+        lock_guard<mutex> criticalSection{bodiesMutex};
+        indexOutline(o, true);
+        ftsStore.flush();
+        if(!cache) {
+            touchNoteBodies(o);
+        }
     } else {
         throw MindForgerException{
             "Save: unable to find outline w/ given key (" + outlineKey + ") to save"
@@ -247,16 +604,28 @@ void Memory::remember(Outline* outline)
     }
 
     outline->checkAndFixProperties();
+    // get recalls Ns bodies of known (header-only learned) O before it's saved
+    bool known = getOutline(outline->getKey()) != nullptr;
     persistence->save(outline);
-
-    if(!getOutline(outline->getKey())) {
+    repositoryIndexer.onFileWritten(outline->getKey());
+    if(!known) {
         outlines.push_back(outline);
-        outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+        outlinesMap.insert(unordered_map<StringInterner::Id,Outline*>::value_type(outline->getKeyId(), outline));
+        outline->setListener(&changes);
+    }
+    stampSaved(outline);
+    changes.onOutlineChanged(outline);
+    lock_guard<mutex> criticalSection{bodiesMutex};
+    indexOutline(outline, true);
+    ftsStore.flush();
+    if(!cache) {
+        touchNoteBodies(outline);
     }
 }
 
 void Memory::exportToHtml(Outline* outline, const string& fileName)
 {
+    recall(outline);
     persistence->saveAsHtml(outline, fileName);
 }
 
@@ -277,13 +646,25 @@ void Memory::exportToCsv(
 
 void Memory::forget(Outline* outline)
 {
-    outlinesMap.erase(outline->getKey());
+    lock_guard<mutex> criticalSection{bodiesMutex};
+    auto entry = bodiesLruIndex.find(outline);
+    if(entry != bodiesLruIndex.end()) {
+        bodiesLru.erase(entry->second);
+        bodiesLruIndex.erase(entry);
+    }
+    savedStamps.erase(outline);
+    outline->setListener(nullptr);
+    changes.onOutlineForgotten(outline);
+    outlinesMap.erase(outline->getKeyId());
+    ftsIndex.forget(outline);
+    ftsStore.remove(outline->getKey());
     limboOutlines.push_back(outline);
     outlines.erase(std::remove(outlines.begin(), outlines.end(), outline), outlines.end());
 }
 
 Memory::~Memory()
 {
+    ftsStore.close();
     for(Outline*& outline:outlines) {
         delete outline;
     }
@@ -341,10 +722,18 @@ string Memory::createLimboKey(const string* name)
 
 Outline* Memory::getOutline(const string& key)
 {
-    map<string,Outline*>::const_iterator entry = outlinesMap.find(key);
-    if(entry == outlinesMap.end()) {
+    return getOutline(Thing::getKeys().find(key));
+}
+
+Outline* Memory::getOutline(StringInterner::Id keyId)
+{
+    auto entry = outlinesMap.find(keyId);
+    if(keyId == StringInterner::NO_ID || entry == outlinesMap.end()) {
         return nullptr;
     } else {
+        if(!cache) {
+            recall(entry->second);
+        }
         return entry->second;
     }
 }
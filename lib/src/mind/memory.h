@@ -19,12 +19,21 @@
 #ifndef M8R_MEMORY_H_
 #define M8R_MEMORY_H_
 
+#include <cstdint>
 #include <vector>
+#include <list>
 #include <map>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "../debug.h"
 #include "../exceptions.h"
 #include "../gear/async_utils.h"
+#include "../gear/task_executor.h"
 #include "../mind/ontology/ontology.h"
 #include "../config/configuration.h"
 #include "../repository_indexer.h"
@@ -40,8 +49,12 @@
 #include "../model/resource_types.h"
 #include "../persistence/persistence.h"
 #include "../persistence/filesystem_persistence.h"
+#include "../persistence/fts_index_store.h"
+#include "../persistence/outline_cache.h"
 #include "aspect/mind_scope_aspect.h"
 #include "limbo.h"
+#include "outline_changes.h"
+#include "trigram_index.h"
 
 namespace m8r {
 
@@ -56,21 +69,43 @@ private:
     /**      
      * @brief Cache outlines in memory.
      *
-     * If FALSE, then outlines are always loaded from
-     * filesystem on get(), else keep already loaded outline
-     * ASTs in memory.
+     * If FALSE, then outlines are learned header-only (O name/description/metadata
+     * and Ns names/metadata) and Ns bodies are loaded from filesystem on get() -
+     * at most configured number of Os keeps Ns bodies in memory (LRU), else
+     * keep all outlines in memory.
      */
     bool cache;
 
+    struct OutlineStamp {
+        time_t modified;
+        uint32_t revision;
+    };
+    // O > its modification when it was learned or saved (O w/ another one differs from its file)
+    std::unordered_map<const Outline*,OutlineStamp> savedStamps;
+
+    // Os w/ Ns bodies in memory (header-only mode), most recently used first
+    std::list<Outline*> bodiesLru;
+    std::map<const Outline*,std::list<Outline*>::iterator> bodiesLruIndex;
+    // Os whose bodies were recalled by workers > they are not forgotten until released
+    std::unordered_map<const Outline*,unsigned> pinnedBodies;
+    // bodies LRU and FTS index are modified also by workers which recall bodies
+    std::mutex bodiesMutex;
+
     RepositoryIndexer repositoryIndexer;
     Configuration& config;
     Ontology& ontology;
     MarkdownOutlineRepresentation& mdRepresentation;
     Persistence* persistence;
+    // binary cache of parsed Os (MindForger repositories only)
+    OutlineCache outlineCache;
     TWikiOutlineRepresentation twikiRepresentation;
     CsvOutlineRepresentation csvRepresentation;
     MindScopeAspect* mindScope;
     Limbo limbo;
+    // narrows Os scanned by FTS
+    TrigramIndex ftsIndex;
+    // persisted trigrams of Os (MindForger repositories only)
+    FtsIndexStore ftsStore;
 
     std::vector<Outline*> outlines;
     std::vector<Note*> notes;
@@ -79,8 +114,11 @@ private:
 
     std::vector<Outline*> limboOutlines;
 
-    // IMPROVE unordered_map
-    std::map<std::string,Outline*> outlinesMap;
+    // interned O key ID (see Thing::getKeys()) to O
+    std::unordered_map<StringInterner::Id,Outline*> outlinesMap;
+
+    // learned, remembered, changed and forgotten Os - indices are updated using it
+    OutlineChanges changes;
 
 public:
     explicit Memory(
@@ -104,6 +142,29 @@ public:
      */
     void learn();
     bool isAware() { return aware; }
+    /**
+     * @brief Check whether Ns bodies of all Os are kept in memory.
+     */
+    bool isCache() const { return cache; }
+
+    /**
+     * @brief Learn Markdown files changed outside of MindForger.
+     *
+     * Only changed Os are (re)learned. Replaced and deleted Os are forgotten
+     * i.e. moved to limbo so that pointers to them remain valid. Os which are
+     * being modified in MindForger (modified since saved or edited O with given
+     * key) are kept and their changes are added to postponed changes.
+     * Forgotten and learned Os are added to given vectors so that indices
+     * can be updated incrementally.
+     *
+     * @return true if any O was learned or forgotten.
+     */
+    bool learnChanges(
+            const std::vector<RepositoryChange>& changes,
+            std::vector<RepositoryChange>& postponed,
+            std::vector<Outline*>& forgotten,
+            std::vector<Outline*>& learned,
+            const std::string* editedOutlineKey=nullptr);
 
     /**
      * @brief Forget everything.
@@ -201,6 +262,36 @@ public:
      * then AST is loaded and full outline returned.
      */
     Outline* getOutline(const std::string &key);
+    /**
+     * @brief Get full outline by ID of its interned key.
+     */
+    Outline* getOutline(StringInterner::Id keyId);
+
+    /**
+     * @brief Ensure that Ns bodies of the Outline are in memory.
+     *
+     * Ns bodies are loaded from the filesystem if Memory learned Os
+     * header-only and bodies of the O are not in memory, least recently
+     * used Os bodies (which are not modified) are forgotten then.
+     */
+    void recall(Outline* outline);
+    /**
+     * @brief Recall Ns bodies of the Outline by a worker thread and index it for FTS.
+     *
+     * More workers can recall (different) Os in parallel - Markdown is lexed and parsed
+     * w/o lock, bodies LRU and FTS index are updated under the lock. Bodies are kept
+     * in memory (not forgotten as cold) until the worker releases them.
+     */
+    void recallShared(Outline* outline);
+    /**
+     * @brief Release Ns bodies recalled by a worker - they can be forgotten then.
+     */
+    void releaseShared(Outline* outline);
+
+    /**
+     * @brief Check whether Outline was modified since it was learned or saved i.e. it differs from its file.
+     */
+    bool isModifiedSinceSaved(const Outline* outline) const;
 
     /**
      * @brief Get Ns of all outlines.
@@ -215,11 +306,88 @@ public:
      */
 
     RepositoryIndexer& getRepositoryIndexer() { return repositoryIndexer; }
+    /**
+     * @brief Get log of changed Os - learn and amnesia start its new epoch.
+     */
+    const OutlineChanges& getChanges() const { return changes; }
+    TrigramIndex& getFtsIndex() { return ftsIndex; }
+    FtsIndexStore& getFtsStore() { return ftsStore; }
+    /**
+     * @brief Index O unless it's current - Ns bodies must be in memory.
+     *
+     * Dirty O (being modified) is indexed when it's remembered - until then it's always a candidate.
+     */
+    void updateFtsIndex(Outline* outline) {
+        if(!outline->isDirty() && !ftsIndex.isCurrent(outline)) indexOutline(outline, true);
+    }
     Persistence& getPersistence() const { return *persistence; }
 
 private:
+    /**
+     * @brief Index O using persisted trigrams - compute (and persist) them if they are not stored.
+     *
+     * @param compute   trigrams can be computed i.e. Ns bodies are in memory
+     */
+    void indexOutline(Outline* outline, bool compute);
+
     const OutlineType* toOutlineType(const MarkdownAstSectionMetadata&);
 
+    /**
+     * @brief Learn Outlines from Markdown files.
+     *
+     * Markdown files are lexed and parsed to ASTs by tasks of shared executor
+     * and the calling thread (ASTs have no notion of ontology), then ASTs are converted to Outlines
+     * and merged to memory by the calling thread in the order of given files
+     * i.e. the result is the same as if the files were learned sequentially.
+     */
+    void learnOutlines(const std::vector<const std::string*>& markdownFiles);
+
+    /**
+     * @brief Get the number of threads to be used to learn given number of files.
+     */
+    unsigned getLearnThreadsCount(size_t filesCount) const;
+
+    /**
+     * @brief Fix O format according to the repository type.
+     */
+    void fixOutlineFormat(Outline* outline);
+
+    /**
+     * @brief Remember learned Outline unless it's virgin (wrongly parsed) - then delete it.
+     *
+     * @return false if Outline was deleted.
+     */
+    bool learnOutline(Outline* outline);
+
+    /**
+     * @brief Free Ns bodies of the Outline - N keeps an empty description line.
+     */
+    void forgetNoteBodies(Outline* outline);
+    /**
+     * @brief Load Ns bodies (file sections) of the Outline from its file - lexing and parsing is thread safe.
+     *
+     * @return false if the Outline has no file.
+     */
+    bool loadNoteBodies(Outline* outline, std::vector<Description>& bodies);
+    /**
+     * @brief Set forgotten Ns bodies of the Outline from loaded file sections.
+     */
+    void setNoteBodies(Outline* outline, std::vector<Description>& bodies);
+    /**
+     * @brief Forget Ns bodies of least recently used Os above configured limit (except pinned Os).
+     */
+    void forgetColdNoteBodies();
+    /**
+     * @brief Mark Outline as the most recently used one.
+     */
+    void touchNoteBodies(Outline* outline);
+    /**
+     * @brief Remember that Outline is the same as its file.
+     */
+    void stampSaved(const Outline* outline) {
+        savedStamps[outline] = OutlineStamp{outline->getModified(), outline->getRevision()};
+    }
+
 };
 
 } /* namespace */
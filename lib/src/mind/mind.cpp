@@ -48,7 +48,8 @@ Mind::Mind(Configuration &configuration)
       exclusiveMind{},
       timeScopeAspect{},
       tagsScopeAspect{ontology},
-      scopeAspect{timeScopeAspect, tagsScopeAspect}
+      scopeAspect{timeScopeAspect, tagsScopeAspect},
+      queryPlanner{memory, tagIndex}
 {
     ai = new Ai{memory,*this};
     deleteWatermark = 0;
@@ -67,6 +68,8 @@ Mind::Mind(Configuration &configuration)
     stats->mostReadNote = nullptr;
     stats->mostWrittenNote = nullptr;
     stats->mostUsedTag = nullptr;
+    stats->notesCount = 0;
+    stats->markdownsBytesize = 0;
 }
 
 Mind::~Mind()
@@ -106,6 +109,55 @@ bool Mind::learn()
     }
 }
 
+bool Mind::learnChanges(
+        vector<RepositoryChange>& changes,
+        vector<RepositoryChange>& postponed,
+        const string* editedOutlineKey)
+{
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    if(config.getMindState()!=Configuration::MindState::DREAMING && !activeProcesses) {
+        RepositoryIndexer& repositoryIndexer = memory.getRepositoryIndexer();
+        vector<RepositoryChange> fileChanges{};
+        if(!repositoryIndexer.getChanges(fileChanges)) {
+            return false;
+        }
+
+        size_t postponedCount = postponed.size();
+        vector<Outline*> forgotten{};
+        vector<Outline*> learned{};
+        bool changed = memory.learnChanges(fileChanges, postponed, forgotten, learned, editedOutlineKey);
+        for(size_t i=postponedCount; i<postponed.size(); i++) {
+            // change is learned once O is not modified, or it's overwritten by O save
+            repositoryIndexer.postponeChange(postponed[i]);
+        }
+        if(changed) {
+            // forgotten Os are in limbo > pointers are valid and indices (AA included)
+            // update only forgotten and learned Os reported by Memory changes
+            onRemembering();
+#ifdef MF_MD_2_HTML_CMARK
+            if(config.isAutolinking()) {
+                autolinking->update(forgotten, learned);
+            }
+#endif
+            for(RepositoryChange& change:fileChanges) {
+                bool isPostponed = false;
+                for(size_t i=postponedCount; i<postponed.size(); i++) {
+                    if(postponed[i].path == change.path) {
+                        isPostponed = true;
+                        break;
+                    }
+                }
+                if(!isPostponed) {
+                    changes.push_back(change);
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 shared_future<bool> Mind::think()
 {
     MF_DEBUG("@Think w/ threshold " << config.getAsyncMindThreshold() << endl);
@@ -253,6 +305,15 @@ bool Mind::mindAmnesia()
 
         // forget EVERYTHING
         memory.amnesia();
+        outlineNamesIndex.clear();
+        outlineNamesIndexThings.clear();
+        noteNamesIndex.clear();
+        noteNamesIndexThings.clear();
+        namesIndexEntries.clear();
+        thingPrefixIndex.clear();
+        tagIndex.clear();
+        aggregates.clear();
+        queryPlanner.clear();
 #ifdef MF_MD_2_HTML_CMARK
         autolinking->clear();
 #endif
@@ -357,90 +418,154 @@ void Mind::getOutlineNames(vector<string>& names) const
     }
 }
 
+void Mind::updateNamesIndex()
+{
+    const vector<Outline*>& outlines = memory.getOutlines();
+    vector<Outline*> changed{};
+    vector<const Outline*> forgotten{};
+    // IDs of removed names are not reused > reindex everything once most of them are removed
+    if(!memory.getChanges().since(namesIndexCursor, changed, forgotten)
+         ||
+       noteNamesIndex.getRemovedCount() > noteNamesIndex.size()
+         ||
+       outlineNamesIndex.getRemovedCount() > outlineNamesIndex.size())
+    {
+        outlineNamesIndex.clear();
+        outlineNamesIndexThings.clear();
+        noteNamesIndex.clear();
+        noteNamesIndexThings.clear();
+        namesIndexEntries.clear();
+        namesIndexCursor = memory.getChanges().end();
+        changed = outlines;
+        forgotten.clear();
+    }
+
+    // names of forgotten and changed Os are removed (O pointers are compared, never dereferenced)
+    auto removeNames = [this](NamesIndexEntry& entry) {
+        outlineNamesIndex.remove(entry.outlineId);
+        for(uint32_t id:entry.noteIds) {
+            noteNamesIndex.remove(id);
+        }
+    };
+    for(const Outline* o:forgotten) {
+        auto e = namesIndexEntries.find(o);
+        if(e != namesIndexEntries.end()) {
+            removeNames(e->second);
+            namesIndexEntries.erase(e);
+        }
+    }
+    for(Outline* o:changed) {
+        auto e = namesIndexEntries.find(o);
+        if(e != namesIndexEntries.end()) {
+            removeNames(e->second);
+        }
+
+        NamesIndexEntry& entry = namesIndexEntries[o];
+        entry.outlineId = static_cast<uint32_t>(outlineNamesIndexThings.size());
+        outlineNamesIndex.add(o->getName(), entry.outlineId, o->getModified());
+        outlineNamesIndexThings.push_back(o);
+        entry.noteIds.clear();
+        for(Note* n:o->getNotes()) {
+            entry.noteIds.push_back(static_cast<uint32_t>(noteNamesIndexThings.size()));
+            noteNamesIndex.add(n->getName(), entry.noteIds.back(), n->getModified());
+            noteNamesIndexThings.push_back(n);
+        }
+    }
+}
+
+void Mind::findOutlineByNameFuzzy(const string& pattern, vector<Outline*>& result, size_t limit)
+{
+    updateNamesIndex();
+
+    vector<FuzzyNameIndex::Match> matches{};
+    outlineNamesIndex.find(pattern, matches, limit);
+    for(FuzzyNameIndex::Match& m:matches) {
+        result.push_back(outlineNamesIndexThings[m.id]);
+    }
+}
+
+void Mind::findNoteByNameFuzzy(const string& pattern, vector<Note*>& result, size_t limit, Outline* outlineScope)
+{
+    vector<FuzzyNameIndex::Match> matches{};
+    if(outlineScope) {
+        // O has (relatively) few Ns > ad hoc index
+        FuzzyNameIndex index{};
+        const vector<Note*>& notes = outlineScope->getNotes();
+        for(size_t i=0; i<notes.size(); i++) {
+            index.add(notes[i]->getName(), static_cast<uint32_t>(i), notes[i]->getModified());
+        }
+        index.find(pattern, matches, limit);
+        for(FuzzyNameIndex::Match& m:matches) {
+            result.push_back(notes[m.id]);
+        }
+    } else {
+        updateNamesIndex();
+        noteNamesIndex.find(pattern, matches, limit);
+        for(FuzzyNameIndex::Match& m:matches) {
+            result.push_back(noteNamesIndexThings[m.id]);
+        }
+    }
+}
+
+void Mind::findNotesByQuery(const string& query, vector<Note*>& result)
+{
+    unique_ptr<NoteQuery> q = NoteQuery::parse(query, time(nullptr));
+    queryPlanner.find(*q, result, &scopeAspect);
+}
+
 // One match in either title or body is enought to be added to the result
 void Mind::findNoteFts(
         vector<Note*>* result,
         const string& pattern,
         const FtsSearch searchMode,
-        Outline* outline)
+        Outline* outline,
+        LinearRegex* regex)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
     // IMPROVE avoid duplicate code - introduce an pre-processing iface (lower/nop) and used one code
     if(searchMode == FtsSearch::IGNORE_CASE) {
-        string s{};
-        stringToLower(outline->getName(), s);
-        if(s.find(pattern)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    if(s.find(pattern)!=string::npos) {
-                        result->push_back(outline->getOutlineDescriptorAsNote());
-                        break;
-                    }
-                }
-            }
+        // pattern is lower case, text is matched w/o conversion
+        if(stringFindIgnoreCase(outline->getName(), pattern)!=string::npos) {
+            result->push_back(outline->getOutlineDescriptorNote());
+        } else if(stringFindIgnoreCase(outline->getDescription().getText(), pattern)!=string::npos) {
+            // description lines are contiguous > scan them at once
+            result->push_back(outline->getOutlineDescriptorNote());
         }
         for(Note* note:outline->getNotes()) {
             if(scopeAspect.isOutOfScope(note)) {
                 continue;
             }
-            s.clear();
-            stringToLower(note->getName(), s);
-            if(s.find(pattern)!=string::npos) {
+            if(stringFindIgnoreCase(note->getName(), pattern)!=string::npos
+                 ||
+               stringFindIgnoreCase(note->getDescription().getText(), pattern)!=string::npos)
+            {
                 result->push_back(note);
-            } else {
-                for(string* d:note->getDescription()) {
-                    if(d) {
-                        s.clear();
-                        stringToLower(*d, s);
-                        if(s.find(pattern)!=string::npos) {
-                            result->push_back(note);
-                            break;
-                        }
-                    }
-                }
             }
         }
     } else if (searchMode == FtsSearch::EXACT) {
         if(outline->getName().find(pattern)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d && d->find(pattern)!=string::npos) {
-                    result->push_back(outline->getOutlineDescriptorAsNote());
-                    // avoid multiple matches in the result
-                    break;
-                }
-            }
+            result->push_back(outline->getOutlineDescriptorNote());
+        } else if(outline->getDescription().getText().find(pattern)!=string::npos) {
+            result->push_back(outline->getOutlineDescriptorNote());
         }
         for(Note* note:outline->getNotes()) {
             if(scopeAspect.isOutOfScope(note)) {
                 continue;
             }
-            if(note->getName().find(pattern)!=string::npos) {
+            if(note->getName().find(pattern)!=string::npos
+                 ||
+               note->getDescription().getText().find(pattern)!=string::npos)
+            {
                 result->push_back(note);
-            } else {
-                for(string* d:note->getDescription()) {
-                    if(d && d->find(pattern)!=string::npos) {
-                        result->push_back(note);
-                        // avoid multiple matches in the result
-                        break;
-                    }
-                }
             }
         }
     } else if (searchMode == FtsSearch::REGEXP) {
-        std::smatch matchedString;
-        std::regex regex{pattern};
-        if(std::regex_search(outline->getName(), matchedString, regex)) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d && std::regex_search(*d, matchedString, regex)) {
-                    result->push_back(outline->getOutlineDescriptorAsNote());
+        // regexp is matched line by line to keep ^ and $ semantic, literal prefilter skips whole descriptions
+        if(regex->search(outline->getName())) {
+            result->push_back(outline->getOutlineDescriptorNote());
+        } else if(regex->mayMatch(outline->getDescription().getText())) {
+            for(DescriptionLine d:outline->getDescription()) {
+                if(regex->search(d.begin(), d.end())) {
+                    result->push_back(outline->getOutlineDescriptorNote());
                     // avoid multiple matches in the result
                     break;
                 }
@@ -450,11 +575,11 @@ void Mind::findNoteFts(
             if(scopeAspect.isOutOfScope(note)) {
                 continue;
             }
-            if(std::regex_search(outline->getName(), matchedString, regex)) {
+            if(regex->search(outline->getName())) {
                 result->push_back(note);
-            } else {
-                for(string* d:note->getDescription()) {
-                    if(d && std::regex_search(*d, matchedString, regex)) {
+            } else if(regex->mayMatch(note->getDescription().getText())) {
+                for(DescriptionLine d:note->getDescription()) {
+                    if(regex->search(d.begin(), d.end())) {
                         result->push_back(note);
                         // avoid multiple matches in the result
                         break;
@@ -465,6 +590,31 @@ void Mind::findNoteFts(
     }
 }
 
+void Mind::getFtsCandidates(const string& pattern, const FtsSearch searchMode, vector<Outline*>& candidates)
+{
+    // trigram index narrows Os to be scanned - Os which are not current in the index are always scanned
+    TrigramIndex& ftsIndex = memory.getFtsIndex();
+    vector<string> literals{};
+    if(searchMode == FtsSearch::REGEXP) {
+        TrigramIndex::regexToLiterals(pattern, literals);
+    } else {
+        literals.push_back(pattern);
+    }
+    unordered_set<const Outline*> indexCandidates{};
+    bool narrowed = ftsIndex.candidates(literals, indexCandidates);
+
+    const vector<m8r::Outline*>& outlines = memory.getOutlines();
+    for(Outline* outline:outlines) {
+        if(scopeAspect.isOutOfScope(outline)) {
+            continue;
+        }
+        if(narrowed && ftsIndex.isCurrent(outline) && indexCandidates.find(outline)==indexCandidates.end()) {
+            continue;
+        }
+        candidates.push_back(outline);
+    }
+}
+
 // IMPROVE consider result be parameter passed by caller (reuse, mem)
 vector<Note*>* Mind::findNoteFts(const string& pattern, FtsSearch searchMode, Outline* outlineScope)
 {
@@ -480,21 +630,180 @@ vector<Note*>* Mind::findNoteFts(const string& pattern, FtsSearch searchMode, Ou
     } else {
         r.assign(pattern);
     }
+    // regexp is compiled once per search - invalid regexp is reported regardless candidates
+    unique_ptr<LinearRegex> regex{};
+    if(searchMode == FtsSearch::REGEXP) {
+        regex.reset(new LinearRegex{r});
+    }
 
+    // Ns bodies of header-only learned Os are recalled on search
     if(outlineScope) {
-        findNoteFts(result, r, searchMode, outlineScope);
+        memory.recall(outlineScope);
+        outlineScope->getOutlineDescriptorAsNote();
+        findNoteFts(result, r, searchMode, outlineScope, regex.get());
     } else {
-        const vector<m8r::Outline*> outlines = memory.getOutlines();
+        vector<Outline*> outlines{};
+        getFtsCandidates(r, searchMode, outlines);
         for(Outline* outline:outlines) {
-            if(scopeAspect.isOutOfScope(outline)) {
-                continue;
-            }
-            findNoteFts(result, r, searchMode, outline);
+            memory.recall(outline);
+            memory.updateFtsIndex(outline);
+            outline->getOutlineDescriptorAsNote();
+            findNoteFts(result, r, searchMode, outline, regex.get());
         }
     }
     return result;
 }
 
+unique_ptr<FtsStream> Mind::findNoteFtsStream(const string& pattern, FtsSearch searchMode, Outline* outlineScope)
+{
+    if(allNotesCache.size()) {
+        allNotesCache.clear();
+    }
+
+    string r{};
+    if(searchMode == FtsSearch::IGNORE_CASE) {
+        stringToLower(pattern, r);
+    } else {
+        r.assign(pattern);
+    }
+
+    if(searchMode == FtsSearch::REGEXP) {
+        // invalid regexp is reported regardless candidates
+        LinearRegex validation{r};
+        UNUSED_ARG(validation);
+    }
+
+    vector<Outline*> outlines{};
+    if(outlineScope) {
+        outlines.push_back(outlineScope);
+    } else {
+        getFtsCandidates(r, searchMode, outlines);
+    }
+
+    if(memory.isCache()) {
+        // Ns bodies are in memory > index and O descriptors are updated upfront and workers only read Os
+        for(Outline* outline:outlines) {
+            memory.updateFtsIndex(outline);
+            outline->getOutlineDescriptorAsNote();
+        }
+        return unique_ptr<FtsStream>{new FtsStream{
+            std::move(outlines),
+            [this,r,searchMode]() -> FtsStream::OutlineSearch {
+                // regexp search is not thread safe > every worker has its own
+                shared_ptr<LinearRegex> regex{searchMode==FtsSearch::REGEXP?new LinearRegex{r}:nullptr};
+                return [this,r,searchMode,regex](vector<Note*>* result, Outline* outline) {
+                    findNoteFts(result, r, searchMode, outline, regex.get());
+                };
+            },
+            TaskExecutor::getInstance().getWorkersCount()
+        }};
+    } else {
+        // O descriptors are created upfront, workers recall Ns bodies of header-only learned Os
+        // in parallel and keep them until the O is searched
+        for(Outline* outline:outlines) {
+            outline->getOutlineDescriptorAsNote();
+        }
+        return unique_ptr<FtsStream>{new FtsStream{
+            std::move(outlines),
+            [this,r,searchMode]() -> FtsStream::OutlineSearch {
+                shared_ptr<LinearRegex> regex{searchMode==FtsSearch::REGEXP?new LinearRegex{r}:nullptr};
+                return [this,r,searchMode,regex](vector<Note*>* result, Outline* outline) {
+                    memory.recallShared(outline);
+                    findNoteFts(result, r, searchMode, outline, regex.get());
+                    memory.releaseShared(outline);
+                };
+            },
+            TaskExecutor::getInstance().getWorkersCount()
+        }};
+    }
+}
+
+void Mind::findNoteFtsRanked(
+        const string& query,
+        vector<pair<Note*,float>>& result,
+        size_t k,
+        const Bm25Parameters& parameters,
+        Outline* outlineScope)
+{
+    Bm25Ranking ranking{query, parameters};
+    if(ranking.getTerms().empty() || !k) {
+        return;
+    }
+
+    vector<Outline*> outlines{};
+    if(outlineScope) {
+        outlines.push_back(outlineScope);
+    } else {
+        for(Outline* outline:memory.getOutlines()) {
+            if(!scopeAspect.isOutOfScope(outline)) {
+                outlines.push_back(outline);
+            }
+        }
+    }
+
+    // O may contain a term only if it's index candidate for the term - terms shorter than
+    // trigram cannot narrow candidates, therefore they're skipped (Os are scanned and scored
+    // for them only if they contain a longer term) unless all terms are short
+    TrigramIndex& ftsIndex = memory.getFtsIndex();
+    unordered_set<const Outline*> indexCandidates{};
+    bool narrowed = false;
+    if(!outlineScope) {
+        for(const string& term:ranking.getTerms()) {
+            if(term.size() >= TrigramIndex::TRIGRAM_LENGTH) {
+                narrowed = ftsIndex.candidates(vector<string>{term}, indexCandidates);
+                if(!narrowed) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // statistics: all Ns count, but only candidates are scanned for terms - Ns bodies
+    // of Os which are not candidates are not recalled, their learned sizes are used
+    vector<Outline*> candidates{};
+    for(Outline* outline:outlines) {
+        if(narrowed && ftsIndex.isCurrent(outline) && indexCandidates.find(outline)==indexCandidates.end()) {
+            ranking.addDocument(outline->getName().size(), outline->getDescription().getText().size());
+            for(Note* note:outline->getNotes()) {
+                if(!scopeAspect.isOutOfScope(note)) {
+                    ranking.addDocument(note->getName().size(), note->getDescriptionBytesize());
+                }
+            }
+        } else {
+            memory.recall(outline);
+            memory.updateFtsIndex(outline);
+            bool contains = ranking.addCandidate(outline->getName(), outline->getDescription().getText());
+            for(Note* note:outline->getNotes()) {
+                if(!scopeAspect.isOutOfScope(note)) {
+                    contains |= ranking.addCandidate(note->getName(), note->getDescription().getText());
+                }
+            }
+            if(contains) {
+                candidates.push_back(outline);
+            }
+        }
+    }
+
+    // scoring: only the top k Ns are kept
+    TopK<Note*> top{k};
+    for(Outline* outline:candidates) {
+        memory.recall(outline);
+        float score = ranking.score(outline->getName(), outline->getDescription().getText());
+        if(score > 0.f && top.accepts(score)) {
+            top.push(outline->getOutlineDescriptorAsNote(), score);
+        }
+        for(Note* note:outline->getNotes()) {
+            if(!scopeAspect.isOutOfScope(note)) {
+                score = ranking.score(note->getName(), note->getDescription().getText());
+                if(score > 0.f && top.accepts(score)) {
+                    top.push(note, score);
+                }
+            }
+        }
+    }
+    top.take(result);
+}
+
 vector<Note*>* Mind::getReferencedNotes(const Note& note) const
 {
     UNUSED_ARG(note);
@@ -525,26 +834,27 @@ vector<Note*>* Mind::getRefereeNotes(const Note& note, const Outline& outline) c
     return nullptr;
 }
 
-void Mind::findNotesByTags(const vector<const Tag*>& tags, vector<Note*>& result) const
+void Mind::findNotesByTags(const vector<const Tag*>& tags, vector<Note*>& result, bool all) const
 {
-    vector<Note*> allNotes{};
-    memory.getAllNotes(allNotes);
-    for(Note* n:allNotes) {
-        const vector<const Tag*>* thingTags = n->getTags();
-        bool hasAllTags=true;
-        for(size_t i=0; i<tags.size(); i++) {
-            if(std::find(
-                        thingTags->begin(),
-                        thingTags->end(),
-                        tags.at(i)) == thingTags->end())
-            {
-                hasAllTags=false;
-                break;
+    const vector<Outline*>& outlines = memory.getOutlines();
+    tagIndex.update(outlines, memory.getChanges());
+    vector<Note*> tagged{};
+    tagIndex.findNotes(tags, tagged, all);
+
+    // IDs of reindexed Os are not in memory order > Ns of Os w/ a tagged N are walked in memory order
+    unordered_set<const Note*> found{tagged.begin(), tagged.end()};
+    unordered_set<const Outline*> foundOutlines{};
+    for(const Note* n:tagged) {
+        foundOutlines.insert(n->getOutline());
+    }
+    for(Outline* o:outlines) {
+        if(foundOutlines.find(o) != foundOutlines.end()) {
+            for(Note* n:o->getNotes()) {
+                if(found.find(n) != found.end() && scopeAspect.isInScope(n)) {
+                    result.push_back(n);
+                }
             }
         }
-        if(hasAllTags) {
-            result.push_back(n);
-        }
     }
 }
 
@@ -553,89 +863,100 @@ void Mind::getAllThings(
     vector<string>* thingsNames,
     string* pattern,
     ThingNameSerialization as,
-    Outline* currentO)
+    Outline* currentO,
+    int pageSize)
 {
-    const vector<Outline*>& os = getOutlines();
-    for(Outline* o:os) {
-        if((pattern && stringStartsWith(o->getName(), *pattern))
-              ||
-            pattern==nullptr)
-        {
-            things.push_back(o);
-            if(thingsNames) {
-                string s{};
-                switch(as) {
-                case ThingNameSerialization::LINK:
-                    // IMPROVE make this Note's method
-                    {
-                        s += "[";
-                        s += o->getName();
-                        s += "](";
-                        string p = RepositoryIndexer::makePathRelative(
-                             config.getActiveRepository(),
-                             currentO?currentO->getKey():o->getKey(),
-                             o->getKey());
-                        pathToLinuxDelimiters(p, p);
-                        s += p;
-                        s += ")";
-                        break;
-                    }
-                case ThingNameSerialization::NAME:
-                case ThingNameSerialization::SCOPED_NAME:
-                default:
-                    s += o->getName();
-                    break;
+    thingPrefixIndex.update(memory.getOutlines(), memory.getChanges());
+
+    const string prefix{pattern?*pattern:""};
+    const size_t limit = pageSize==ALL_ENTRIES ? thingPrefixIndex.size() : static_cast<size_t>(pageSize);
+    const size_t offset = things.size();
+    auto add = [&](std::pair<const ThingPrefixIndex::Entry*,const ThingPrefixIndex::Entry*> range, bool outline) {
+        for(const ThingPrefixIndex::Entry* e=range.first; e!=range.second && things.size()-offset<limit; e++) {
+            if(!scopeAspect.isEnabled()
+                 ||
+               (outline
+                  ? scopeAspect.isInScope(static_cast<Outline*>(e->thing))
+                  : scopeAspect.isInScope(static_cast<Note*>(e->thing))))
+            {
+                things.push_back(e->thing);
+                // names (links) are serialized only for the page
+                if(thingsNames) {
+                    thingsNames->push_back(outline
+                        ? outlineToName(static_cast<Outline*>(e->thing), as, currentO)
+                        : noteToName(static_cast<Note*>(e->thing), as, currentO));
                 }
-                thingsNames->push_back(s);
             }
         }
+    };
+    add(thingPrefixIndex.outlines(prefix), true);
+    add(thingPrefixIndex.notes(prefix), false);
+}
+
+string Mind::outlineToName(Outline* o, ThingNameSerialization as, Outline* currentO) const
+{
+    string s{};
+    switch(as) {
+    case ThingNameSerialization::LINK:
+        // IMPROVE make this Note's method
+        {
+            s += "[";
+            s += o->getName();
+            s += "](";
+            string p = RepositoryIndexer::makePathRelative(
+                 config.getActiveRepository(),
+                 currentO?currentO->getKey():o->getKey(),
+                 o->getKey());
+            pathToLinuxDelimiters(p, p);
+            s += p;
+            s += ")";
+            break;
+        }
+    case ThingNameSerialization::NAME:
+    case ThingNameSerialization::SCOPED_NAME:
+    default:
+        s += o->getName();
+        break;
     }
-    vector<Note*> ns{};
-    getAllNotes(ns);
-    for(Note* n:ns) {
-        if((pattern && stringStartsWith(n->getName(), *pattern))
-              ||
-            pattern==nullptr)
+    return s;
+}
+
+string Mind::noteToName(Note* n, ThingNameSerialization as, Outline* currentO) const
+{
+    string s{};
+    switch(as) {
+    case ThingNameSerialization::NAME:
+        s += n->getName();
+        break;
+    case ThingNameSerialization::LINK:
+        // IMPROVE make this Note's method
         {
-            things.push_back(n);
-            if(thingsNames) {
-                string s{};
-                switch(as) {
-                case ThingNameSerialization::NAME:
-                    s += n->getName();
-                    break;
-                case ThingNameSerialization::LINK:
-                    // IMPROVE make this Note's method
-                    {
-                        s += "[";
-                        s += n->getName();
-                        s += " (";
-                        s += n->getOutline()->getName();
-                        s += ")](";
-                        string p = RepositoryIndexer::makePathRelative(
-                             config.getActiveRepository(),
-                             currentO?currentO->getKey():n->getOutline()->getKey(),
-                             n->getKey());
-                        pathToLinuxDelimiters(p, p);
-                        s += p;
-                        s += ")";
-                        break;
-                    }
-                case ThingNameSerialization::SCOPED_NAME:
-                default:
-                    {
-                        // IMPROVE make this Note's method: getScopedName()
-                        s += n->getName();
-                        s += " (";
-                        s += n->getOutline()->getName();
-                        s += ")";
-                        break;
-                    }
-                }
-                thingsNames->push_back(s);
-            }
+            s += "[";
+            s += n->getName();
+            s += " (";
+            s += n->getOutline()->getName();
+            s += ")](";
+            string p = RepositoryIndexer::makePathRelative(
+                 config.getActiveRepository(),
+                 currentO?currentO->getKey():n->getOutline()->getKey(),
+                 n->getKey());
+            pathToLinuxDelimiters(p, p);
+            s += p;
+            s += ")";
+            break;
+        }
+    case ThingNameSerialization::SCOPED_NAME:
+    default:
+        {
+            // IMPROVE make this Note's method: getScopedName()
+            s += n->getName();
+            s += " (";
+            s += n->getOutline()->getName();
+            s += ")";
+            break;
         }
     }
+    return s;
 }
 
 const vector<Outline*>& Mind::getOutlines() const
@@ -683,21 +1004,17 @@ vector<Note*>* Mind::getNotesOfType(const NoteType& type, const Outline& outline
     return nullptr;
 }
 
-void Mind::findOutlinesByTags(const std::vector<const Tag*>& tags, std::vector<Outline*>& result) const
+void Mind::findOutlinesByTags(const vector<const Tag*>& tags, vector<Outline*>& result, bool all) const
 {
-    for(Outline* o:memory.getOutlines()) {
-        bool allMatched = true;
-        for(size_t i=0; i<tags.size(); i++) {
-            if(std::find(
-                        o->getTags()->begin(),
-                        o->getTags()->end(),
-                        tags.at(i)) == o->getTags()->end())
-            {
-                allMatched = false;
-                break;
-            }
-        }
-        if(allMatched) {
+    const vector<Outline*>& outlines = memory.getOutlines();
+    tagIndex.update(outlines, memory.getChanges());
+    vector<Outline*> tagged{};
+    tagIndex.findOutlines(tags, tagged, all);
+
+    // IDs of reindexed Os are not in memory order
+    unordered_set<const Outline*> found{tagged.begin(), tagged.end()};
+    for(Outline* o:outlines) {
+        if(found.find(o) != found.end() && scopeAspect.isInScope(o)) {
             result.push_back(o);
         }
     }
@@ -717,47 +1034,16 @@ void Mind::getTagsCardinality(map<const Tag*,int>& tagsCardinality)
 {
     if(ontology.getTags().size()) {
         for(const Tag* t:ontology.getTags().values()) {
-            // IMPROVE make NONE exclusion faster (checks in three loops below)
-            if(!stringistring(string("none"), t->getName())) {
+            if(!aggregates.isNoneTag(t)) {
                 tagsCardinality[t] = 0;
             }
         }
-        const vector<Outline*>& outlines = memory.getOutlines();
-        bool doO, doN;
-        for(Outline* o:outlines) {
-            doO = false;
-            if(scopeAspect.isEnabled()) {
-                if(scopeAspect.isInScope(o)) {
-                    doO = true;
-                }
-            } else {
-                doO = true;
-            }
-            if(doO) {
-                for(const Tag* ot:*o->getTags()) {
-                    if(!stringistring(string("none"), ot->getName())) {
-                        tagsCardinality[ot] = tagsCardinality[ot]+1;
-                    }
-                }
-
-                doN = false;
-                for(Note* n:o->getNotes()) {
-                    if(scopeAspect.isEnabled()) {
-                        if(scopeAspect.isInScope(n)) {
-                            doN = true;
-                        }
-                    } else {
-                        doN = true;
-                    }
-                    if(doN) {
-                        for(const Tag* nt:*n->getTags()) {
-                            if(!stringistring(string("none"), nt->getName())) {
-                                tagsCardinality[nt] = tagsCardinality[nt]+1;
-                            }
-                        }
-                    }
-                }
-            }
+        aggregates.update(memory.getOutlines(), memory.getChanges(), scopeAspect);
+        const map<const Tag*,int>& cardinality = scopeAspect.isEnabled()
+            ? aggregates.getScopedTagsCardinality()
+            : aggregates.getTagsCardinality();
+        for(auto& c:cardinality) {
+            tagsCardinality[c.first] = c.second;
         }
     } else {
         tagsCardinality.clear();
@@ -1012,6 +1298,8 @@ Outline* Mind::noteRefactor(Note* noteToRefactor, const string& targetOutlineKey
         if(targetOutline) {
             vector<Note*> children{};
             Outline* sourceOutline = noteToRefactor->getOutline();
+            // moved Ns bodies must be in memory as they cannot be recalled from target O's file
+            memory.recall(sourceOutline);
             sourceOutline->getAllNoteChildren(noteToRefactor, &children);
             children.insert(children.begin(), noteToRefactor);
             // IMPROVE allow passing parent for the Note in the target Outline
@@ -1100,64 +1388,40 @@ void Mind::onRemembering()
 
 MindStatistics* Mind::getStatistics()
 {
-    // IMPROVE cache it until memory is dirty
-    const vector<Outline*>&os = memory.getOutlines();
-    if(os.size()) {
-        u_int32_t maxReads=0;
-        u_int32_t maxWrites=0;
-        for(Outline* o:os) {
-            if(o->getReads() > maxReads) {
-                maxReads = o->getReads();
-                stats->mostReadOutline = o;
-            }
-            if(o->getRevision() > maxWrites) {
-                maxWrites = o->getRevision();
-                stats->mostWrittenOutline = o;
-            }
-        }
-    } else {
-        stats->mostReadOutline = nullptr;
-        stats->mostWrittenOutline = nullptr;
-    }
-
-    vector<Note*> ns{};
-    memory.getAllNotes(ns);
-    if(ns.size()) {
-        u_int32_t maxReads=0;
-        u_int32_t maxWrites=0;
-        for(Note* n:ns) {
-            if(n->getReads() > maxReads) {
-                maxReads = n->getReads();
-                stats->mostReadNote = n;
-            }
-            if(n->getRevision() > maxWrites) {
-                maxWrites = n->getRevision();
-                stats->mostWrittenNote = n;
-            }
-        }
-    } else {
-        stats->mostReadNote = nullptr;
-        stats->mostWrittenNote = nullptr;
-    }
+    aggregates.update(memory.getOutlines(), memory.getChanges(), scopeAspect);
+
+    stats->mostReadOutline = aggregates.getMostReadOutline();
+    stats->mostWrittenOutline = aggregates.getMostWrittenOutline();
+    stats->mostReadNote = aggregates.getMostReadNote();
+    stats->mostWrittenNote = aggregates.getMostWrittenNote();
+    stats->notesCount = aggregates.getNotesCount();
+    stats->markdownsBytesize = aggregates.getBytesize();
 
-    map<const Tag*,int> ts{};
-    getTagsCardinality(ts);
-    if(ts.size()) {
-        map<const Tag*,int>::iterator it{};
+    if(scopeAspect.isEnabled()) {
+        map<const Tag*,int> ts{};
+        getTagsCardinality(ts);
+        stats->mostUsedTag = nullptr;
         int maxCardinality = 0;
-        for(it = ts.begin(); it != ts.end(); it++) {
-            if(it->second > maxCardinality) {
-                stats->mostUsedTag = it->first;
-                maxCardinality = it->second;
+        for(auto& t:ts) {
+            if(t.second > maxCardinality) {
+                stats->mostUsedTag = t.first;
+                maxCardinality = t.second;
             }
         }
     } else {
-        stats->mostUsedTag = nullptr;
+        stats->mostUsedTag = aggregates.getMostUsedTag();
     }
 
     return stats;
 }
 
+void Mind::noteRead(Note* note)
+{
+    note->makeRead();
+    aggregates.onNoteRead(note);
+    queryPlanner.onNoteRead();
+}
+
 /*
  * NER
  */
@@ -20,17 +20,28 @@
 #define M8R_MIND_H_
 
 #include <inttypes.h>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <regex>
+#include <unordered_map>
 
 #include "memory.h"
+#include "fts_stream.h"
+#include "bm25_ranking.h"
+#include "thing_prefix_index.h"
+#include "tag_index.h"
+#include "mind_aggregates.h"
+#include "query_planner.h"
 #include "knowledge_graph.h"
 #include "ai/ai.h"
 #include "associated_notes.h"
 #include "ontology/thing_class_rel_triple.h"
 #include "aspect/mind_scope_aspect.h"
 #include "../config/configuration.h"
+#include "../gear/fuzzy_name_index.h"
+#include "../gear/linear_regex.h"
+#include "../gear/top_k.h"
 #include "../representations/representation_interceptor.h"
 #include "../representations/markdown/markdown_configuration_representation.h"
 #ifdef MF_NER
@@ -59,6 +70,9 @@ struct MindStatistics {
     Note* mostWrittenNote;
 
     const Tag* mostUsedTag;
+
+    size_t notesCount;
+    size_t markdownsBytesize;
 };
 
 enum class ThingNameSerialization {
@@ -142,6 +156,7 @@ class Mind : public OntologyProvider
 {
 public:
     static constexpr int ALL_ENTRIES = -1;
+    static constexpr size_t FUZZY_NAME_LIMIT = 50;
 
 private:
     Configuration &config;
@@ -217,6 +232,37 @@ private:
      */
     std::vector<Note*> allNotesCache;
 
+    /**
+     * @brief Fuzzy indices of O and N names: updated incrementally on fuzzy lookup - names
+     * of Os which were added, forgotten or changed since the last lookup (see Memory changes)
+     * are reindexed.
+     */
+    struct NamesIndexEntry {
+        uint32_t outlineId;
+        std::vector<uint32_t> noteIds;
+    };
+    FuzzyNameIndex outlineNamesIndex;
+    std::vector<Outline*> outlineNamesIndexThings;
+    FuzzyNameIndex noteNamesIndex;
+    std::vector<Note*> noteNamesIndexThings;
+    std::unordered_map<const Outline*,NamesIndexEntry> namesIndexEntries;
+    OutlineChanges::Cursor namesIndexCursor;
+
+    /**
+     * @brief Sorted O and N names for autocomplete: updated incrementally on lookup.
+     */
+    ThingPrefixIndex thingPrefixIndex;
+
+    /**
+     * @brief Tag bitmaps of Os and Ns: updated incrementally on (const) tag lookup.
+     */
+    mutable TagIndex tagIndex;
+
+    /**
+     * @brief Statistics and tag cardinalities: updated incrementally on lookup.
+     */
+    MindAggregates aggregates;
+
     /**
      * @brief Time scope.
      */
@@ -230,6 +276,11 @@ private:
      */
     MindScopeAspect scopeAspect;
 
+    /**
+     * @brief N query planner w/ type and time indices (and tag index): rebuilt on query when Os change.
+     */
+    QueryPlanner queryPlanner;
+
 public:
     explicit Mind(Configuration &config);
     Mind() = delete;
@@ -263,6 +314,22 @@ public:
      */
     bool learn();
 
+    /**
+     * @brief Learn Markdown files changed outside of MindForger (e.g. by git pull).
+     *
+     * Changes are reported by repository watcher once they calm down, only changed
+     * Outlines are relearned and Mind indices are updated. Changes of Outlines which
+     * are being modified (dirty or edited Outline with given key) are not learned,
+     * but postponed - they are kept pending in the watcher and added to postponed
+     * changes so that the conflict can be reported to user.
+     *
+     * @return true if Memory changed - learned changes are added to given vector.
+     */
+    bool learnChanges(
+            std::vector<RepositoryChange>& changes,
+            std::vector<RepositoryChange>& postponed,
+            const std::string* editedOutlineKey=nullptr);
+
     /**
      * @brief Think to do useful things for user when searching, viewing or editing.
      *
@@ -371,9 +438,49 @@ public:
             const std::string& pattern,
             const FtsSearch mode = FtsSearch::EXACT,
             Outline* outlineScope=nullptr);
+    /**
+     * @brief Find Ns in parallel and stream matches in the order of findNoteFts() result.
+     *
+     * Os are searched by workers - Ns bodies of header-only learned Os are recalled by
+     * workers in parallel and kept until the O is searched. Stream must be destroyed
+     * before Os are modified.
+     */
+    std::unique_ptr<FtsStream> findNoteFtsStream(
+            const std::string& pattern,
+            const FtsSearch mode = FtsSearch::EXACT,
+            Outline* outlineScope=nullptr);
+    /**
+     * @brief Find top k Ns ranked by BM25 score of query words in N names and descriptions.
+     *
+     * Result is ordered by score (the best first) and it contains only Ns w/ any query word.
+     */
+    void findNoteFtsRanked(
+            const std::string& query,
+            std::vector<std::pair<Note*,float>>& result,
+            size_t k,
+            const Bm25Parameters& parameters=Bm25Parameters{},
+            Outline* outlineScope=nullptr);
     // TODO findFts() - search also outline name and description
     //   >> temporary note of Outline type (never saved), cannot be created by user
     void getOutlineNames(std::vector<std::string>& names) const;
+    /**
+     * @brief Find Os by name tolerating typos - the best matches (edit distance, recency) first.
+     */
+    void findOutlineByNameFuzzy(const std::string& pattern, std::vector<Outline*>& result, size_t limit=FUZZY_NAME_LIMIT);
+    /**
+     * @brief Find Ns by name tolerating typos - the best matches (edit distance, recency) first.
+     */
+    void findNoteByNameFuzzy(
+            const std::string& pattern,
+            std::vector<Note*>& result,
+            size_t limit=FUZZY_NAME_LIMIT,
+            Outline* outlineScope=nullptr);
+    /**
+     * @brief Find Ns (in scope) matching the query e.g. tag:todo "release notes" -type:idea read:<7d
+     *
+     * Query language is described by NoteQuery - MindForgerException is thrown for invalid query.
+     */
+    void findNotesByQuery(const std::string& query, std::vector<Note*>& result);
 
     /*
      * SCOPING
@@ -410,14 +517,14 @@ public:
      */
 
     /**
-     * @brief Get Outlines tagged by given tags (logical AND).
+     * @brief Get Outlines (in scope) tagged by given tags (logical AND, logical OR if all is false) - in memory order.
      */
-    void findOutlinesByTags(const std::vector<const Tag*>& tags, std::vector<Outline*>& result) const;
+    void findOutlinesByTags(const std::vector<const Tag*>& tags, std::vector<Outline*>& result, bool all=true) const;
 
     /**
-     * @brief Get Notes tagged by given tags (logical AND).
+     * @brief Get Notes (in scope) tagged by given tags (logical AND, logical OR if all is false) - in memory order.
      */
-    void findNotesByTags(const std::vector<const Tag*>& tags, std::vector<Note*>& result) const;
+    void findNotesByTags(const std::vector<const Tag*>& tags, std::vector<Note*>& result, bool all=true) const;
 
     /**
      * @brief Get all tags assigned to Outlines in the memory.
@@ -469,12 +576,21 @@ public:
      * TYPES
      */
 
+    /**
+     * @brief Get Os and Ns (both sorted by name) whose name starts w/ the pattern.
+     *
+     * Names are serialized only for the returned page of things.
+     *
+     * @param pattern   name prefix (case sensitive) or nullptr for all things
+     * @param pageSize  max number of things or ALL_ENTRIES
+     */
     void getAllThings(
             std::vector<Thing*>& things,
             std::vector<std::string>* thingsNames=nullptr,
             std::string* pattern=nullptr,
             ThingNameSerialization as=ThingNameSerialization::SCOPED_NAME,
-            Outline* currentO=nullptr);
+            Outline* currentO=nullptr,
+            int pageSize=ALL_ENTRIES);
     // IMPROVE rename to getAllOs()
     const std::vector<Outline*>& getOutlines() const;
     std::vector<Outline*>* getOutlinesOfType(const OutlineType& type) const;
@@ -652,6 +768,11 @@ public:
 
     MindStatistics* getStatistics();
 
+    /**
+     * @brief Make N read and update statistics.
+     */
+    void noteRead(Note* note);
+
 private:
     /**
      * @brief Dream to reset, detox, optimize, check/clean up mind/memory and prepare to think.
@@ -678,16 +799,34 @@ private:
     bool mindSleep();
     bool mindAmnesia();
 
+    /**
+     * @brief Reindex names of Os which changed since the last update of fuzzy names indices.
+     */
+    void updateNamesIndex();
+
+    std::string outlineToName(Outline* o, ThingNameSerialization as, Outline* currentO) const;
+    std::string noteToName(Note* n, ThingNameSerialization as, Outline* currentO) const;
+
     /**
      * @brief Invoked on remembering Outline/Note/... to flush all inferred knowledge, caches, ...
      */
     void onRemembering();
 
+    /**
+     * @brief Get in scope Os which may match the pattern (index narrowed) in memory order.
+     */
+    void getFtsCandidates(const std::string& pattern, const FtsSearch searchMode, std::vector<Outline*>& candidates);
+    /**
+     * @brief Search O - thread safe if O's Ns bodies are in memory and regex is not shared.
+     *
+     * O descriptor N is not updated (O is only read) - caller must update it before the search.
+     */
     void findNoteFts(
             std::vector<Note*>* result,
             const std::string& pattern,
             const FtsSearch searchMode,
-            Outline* outline);
+            Outline* outline,
+            LinearRegex* regex);
 };
 
 } /* namespace */
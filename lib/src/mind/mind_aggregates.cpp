@@ -0,0 +1,342 @@
+/*
+ mind_aggregates.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "mind_aggregates.h"
+
+#include "../gear/string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+MindAggregates::MindAggregates()
+    : scope{false, false, 0, {}},
+      notesCount{0},
+      bytesize{0},
+      mostReadOutline{nullptr},
+      mostWrittenOutline{nullptr},
+      mostReadNote{nullptr},
+      mostWrittenNote{nullptr},
+      mostUsedTag{nullptr},
+      maxOutlineReads{0},
+      maxOutlineRevision{0},
+      maxNoteReads{0},
+      maxNoteRevision{0},
+      maxTagCardinality{0},
+      mostReadNoteOutline{nullptr},
+      mostWrittenNoteOutline{nullptr},
+      maximaStale{false},
+      mostUsedTagStale{false}
+{
+}
+
+MindAggregates::~MindAggregates()
+{
+}
+
+void MindAggregates::clear()
+{
+    aggregates.clear();
+    cursor = OutlineChanges::Cursor{};
+    readOutlines.clear();
+    noneTags.clear();
+    tagsCardinality.clear();
+    scopedTagsCardinality.clear();
+    scope = Scope{false, false, 0, {}};
+    notesCount = 0;
+    bytesize = 0;
+    mostReadOutline = mostWrittenOutline = nullptr;
+    mostReadNote = mostWrittenNote = nullptr;
+    mostUsedTag = nullptr;
+    maxOutlineReads = maxOutlineRevision = maxNoteReads = maxNoteRevision = 0;
+    maxTagCardinality = 0;
+    mostReadNoteOutline = mostWrittenNoteOutline = nullptr;
+    maximaStale = mostUsedTagStale = false;
+}
+
+bool MindAggregates::isNoneTag(const Tag* tag)
+{
+    auto n = noneTags.find(tag);
+    if(n == noneTags.end()) {
+        n = noneTags.insert(make_pair(tag, stringistring(string("none"), tag->getName()))).first;
+    }
+    return n->second;
+}
+
+size_t MindAggregates::update(const vector<Outline*>& outlines, const OutlineChanges& changes, const MindScopeAspect& mindScope)
+{
+    const TimeScopeAspect& timeScope = mindScope.getTimeScopeAspect();
+    const TagsScopeAspect& tagsScope = mindScope.getTagsScopeAspect();
+    Scope current{
+        mindScope.isEnabled(),
+        timeScope.isEnabled(),
+        timeScope.isEnabled() ? timeScope.getTimePoint() : 0,
+        tagsScope.isEnabled() ? tagsScope.getTags() : vector<const Tag*>{}};
+
+    vector<Outline*> changed{};
+    vector<const Outline*> forgotten{};
+    if(!changes.since(cursor, changed, forgotten)) {
+        clear();
+        cursor = changes.end();
+        scope = current;
+        for(Outline* o:outlines) {
+            OutlineAggregate& a = aggregates[o];
+            add(o, a);
+            if(scope.enabled) {
+                addScoped(o, a, mindScope);
+            }
+        }
+        updateMaxima(outlines);
+        updateMostUsedTag();
+        return outlines.size();
+    }
+
+    const bool rescope = !(current == scope);
+    const bool scoped = scope.enabled && !rescope;
+    // forgotten Os (pointers are compared, never dereferenced)
+    for(const Outline* o:forgotten) {
+        auto a = aggregates.find(o);
+        if(a != aggregates.end()) {
+            if(o==mostReadOutline || o==mostWrittenOutline || o==mostReadNoteOutline || o==mostWrittenNoteOutline) {
+                maximaStale = true;
+            }
+            subtract(a->second);
+            if(scoped) {
+                subtractScoped(a->second);
+            }
+            aggregates.erase(a);
+        }
+    }
+    for(Outline* o:changed) {
+        auto a = aggregates.find(o);
+        if(a != aggregates.end()) {
+            subtract(a->second);
+            if(scoped) {
+                subtractScoped(a->second);
+            }
+        }
+        OutlineAggregate& aggregate = aggregates[o];
+        add(o, aggregate);
+        if(scoped) {
+            addScoped(o, aggregate, mindScope);
+        }
+
+        // maximum of the O might have decreased
+        if(o==mostReadOutline && o->getReads()<maxOutlineReads) {
+            maximaStale = true;
+        }
+        if(o==mostWrittenOutline && o->getRevision()<maxOutlineRevision) {
+            maximaStale = true;
+        }
+        if(o == mostReadNoteOutline) {
+            if(aggregate.mostReadNote && aggregate.mostReadNote->getReads()>=maxNoteReads) {
+                mostReadNote = aggregate.mostReadNote;
+                maxNoteReads = mostReadNote->getReads();
+            } else {
+                maximaStale = true;
+            }
+        }
+        if(o == mostWrittenNoteOutline) {
+            if(aggregate.mostWrittenNote && aggregate.mostWrittenNote->getRevision()>=maxNoteRevision) {
+                mostWrittenNote = aggregate.mostWrittenNote;
+                maxNoteRevision = mostWrittenNote->getRevision();
+            } else {
+                maximaStale = true;
+            }
+        }
+        offerMaxima(o, aggregate);
+    }
+    // N read time determines whether N is in time scope
+    if(scoped) {
+        for(const Outline* o:readOutlines) {
+            auto a = aggregates.find(o);
+            if(a != aggregates.end()) {
+                subtractScoped(a->second);
+                addScoped(o, a->second, mindScope);
+            }
+        }
+    }
+    readOutlines.clear();
+    if(rescope) {
+        scope = current;
+        scopedTagsCardinality.clear();
+        for(Outline* o:outlines) {
+            OutlineAggregate& a = aggregates[o];
+            a.scopedTags.clear();
+            if(scope.enabled) {
+                addScoped(o, a, mindScope);
+            }
+        }
+    }
+
+    if(maximaStale) {
+        updateMaxima(outlines);
+    }
+    if(mostUsedTagStale) {
+        updateMostUsedTag();
+    }
+    return changed.size() + forgotten.size();
+}
+
+void MindAggregates::add(Outline* o, OutlineAggregate& aggregate)
+{
+    aggregate.notesCount = o->getNotesCount();
+    aggregate.bytesize = o->getBytesize();
+    aggregate.tags.clear();
+    aggregate.mostReadNote = aggregate.mostWrittenNote = nullptr;
+
+    for(const Tag* t:*o->getTags()) {
+        if(!isNoneTag(t)) aggregate.tags.push_back(t);
+    }
+    for(Note* n:o->getNotes()) {
+        for(const Tag* t:*n->getTags()) {
+            if(!isNoneTag(t)) aggregate.tags.push_back(t);
+        }
+        if(!aggregate.mostReadNote || n->getReads() > aggregate.mostReadNote->getReads()) {
+            aggregate.mostReadNote = n;
+        }
+        if(!aggregate.mostWrittenNote || n->getRevision() > aggregate.mostWrittenNote->getRevision()) {
+            aggregate.mostWrittenNote = n;
+        }
+    }
+
+    for(const Tag* t:aggregate.tags) {
+        int c = ++tagsCardinality[t];
+        if(!mostUsedTag || c > maxTagCardinality) {
+            mostUsedTag = t;
+            maxTagCardinality = c;
+        }
+    }
+    notesCount += aggregate.notesCount;
+    bytesize += aggregate.bytesize;
+}
+
+void MindAggregates::subtract(OutlineAggregate& aggregate)
+{
+    for(const Tag* t:aggregate.tags) {
+        if(t == mostUsedTag) {
+            mostUsedTagStale = true;
+        }
+    }
+    decrement(tagsCardinality, aggregate.tags);
+    notesCount -= aggregate.notesCount;
+    bytesize -= aggregate.bytesize;
+}
+
+void MindAggregates::addScoped(const Outline* o, OutlineAggregate& aggregate, const MindScopeAspect& mindScope)
+{
+    aggregate.scopedTags.clear();
+    if(mindScope.isInScope(o)) {
+        for(const Tag* t:*o->getTags()) {
+            if(!isNoneTag(t)) aggregate.scopedTags.push_back(t);
+        }
+        for(const Note* n:o->getNotes()) {
+            if(mindScope.isInScope(n)) {
+                for(const Tag* t:*n->getTags()) {
+                    if(!isNoneTag(t)) aggregate.scopedTags.push_back(t);
+                }
+            }
+        }
+    }
+    for(const Tag* t:aggregate.scopedTags) {
+        scopedTagsCardinality[t]++;
+    }
+}
+
+void MindAggregates::subtractScoped(OutlineAggregate& aggregate)
+{
+    decrement(scopedTagsCardinality, aggregate.scopedTags);
+    aggregate.scopedTags.clear();
+}
+
+void MindAggregates::decrement(map<const Tag*,int>& cardinality, const vector<const Tag*>& tags)
+{
+    for(const Tag* t:tags) {
+        auto c = cardinality.find(t);
+        if(!--c->second) {
+            cardinality.erase(c);
+        }
+    }
+}
+
+void MindAggregates::offerMaxima(Outline* o, const OutlineAggregate& aggregate)
+{
+    if(!mostReadOutline || o->getReads() > maxOutlineReads) {
+        mostReadOutline = o;
+        maxOutlineReads = o->getReads();
+    }
+    if(!mostWrittenOutline || o->getRevision() > maxOutlineRevision) {
+        mostWrittenOutline = o;
+        maxOutlineRevision = o->getRevision();
+    }
+    if(aggregate.mostReadNote && (!mostReadNote || aggregate.mostReadNote->getReads() > maxNoteReads)) {
+        mostReadNote = aggregate.mostReadNote;
+        maxNoteReads = mostReadNote->getReads();
+        mostReadNoteOutline = o;
+    }
+    if(aggregate.mostWrittenNote && (!mostWrittenNote || aggregate.mostWrittenNote->getRevision() > maxNoteRevision)) {
+        mostWrittenNote = aggregate.mostWrittenNote;
+        maxNoteRevision = mostWrittenNote->getRevision();
+        mostWrittenNoteOutline = o;
+    }
+}
+
+void MindAggregates::updateMaxima(const vector<Outline*>& outlines)
+{
+    // maxima of O aggregates - Ns are not iterated
+    mostReadOutline = mostWrittenOutline = nullptr;
+    mostReadNote = mostWrittenNote = nullptr;
+    mostReadNoteOutline = mostWrittenNoteOutline = nullptr;
+    for(Outline* o:outlines) {
+        offerMaxima(o, aggregates[o]);
+    }
+    maximaStale = false;
+}
+
+void MindAggregates::updateMostUsedTag()
+{
+    mostUsedTag = nullptr;
+    maxTagCardinality = 0;
+    for(auto& c:tagsCardinality) {
+        if(c.second > maxTagCardinality) {
+            mostUsedTag = c.first;
+            maxTagCardinality = c.second;
+        }
+    }
+    mostUsedTagStale = false;
+}
+
+void MindAggregates::onNoteRead(Note* n)
+{
+    auto a = aggregates.find(n->getOutline());
+    if(a != aggregates.end()) {
+        if(!a->second.mostReadNote || n->getReads() > a->second.mostReadNote->getReads()) {
+            a->second.mostReadNote = n;
+        }
+        if(!mostReadNote || n->getReads() > maxNoteReads) {
+            mostReadNote = n;
+            maxNoteReads = n->getReads();
+            mostReadNoteOutline = n->getOutline();
+        }
+        if(scope.enabled) {
+            readOutlines.push_back(n->getOutline());
+        }
+    }
+}
+
+} // m8r namespace
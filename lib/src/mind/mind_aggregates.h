@@ -0,0 +1,158 @@
+/*
+ mind_aggregates.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_MIND_AGGREGATES_H
+#define M8R_MIND_AGGREGATES_H
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "../model/outline.h"
+#include "aspect/mind_scope_aspect.h"
+#include "outline_changes.h"
+
+namespace m8r {
+
+/**
+ * @brief Statistics of Os and Ns maintained incrementally: tag cardinalities (of all
+ * things and of things in the Mind scope), Ns count, Markdown size, the most read and
+ * the most written O and N.
+ *
+ * Every O contributes its aggregate (counts, tags, the most read/written N). On update
+ * only Os which were added, forgotten or changed since the last update (see Memory
+ * changes) are recounted - their contribution is subtracted and added again. N reads
+ * do not change O, therefore they are reported by onNoteRead() event.
+ *
+ * Maxima are compared w/ recounted Os only - all Os are walked only if O which holds
+ * a maximum was forgotten or its maximum decreased. Scoped cardinalities are recounted
+ * for all Os only when the scope changes (time point, tags).
+ *
+ * Tags "none" are not counted.
+ */
+class MindAggregates
+{
+private:
+    struct OutlineAggregate {
+        size_t notesCount;
+        unsigned bytesize;
+        // tags of O and its Ns (w/ repetition)
+        std::vector<const Tag*> tags;
+        // tags of O and its Ns in the scope (w/ repetition)
+        std::vector<const Tag*> scopedTags;
+        Note* mostReadNote;
+        Note* mostWrittenNote;
+    };
+
+    // scope of scoped cardinalities
+    struct Scope {
+        bool enabled;
+        bool time;
+        time_t timePoint;
+        std::vector<const Tag*> tags;
+
+        bool operator==(const Scope& s) const {
+            return enabled==s.enabled && time==s.time && timePoint==s.timePoint && tags==s.tags;
+        }
+    };
+
+    std::unordered_map<const Outline*,OutlineAggregate> aggregates;
+    OutlineChanges::Cursor cursor;
+    // Os whose Ns were read since the last update (N read time affects scope)
+    std::vector<const Outline*> readOutlines;
+    // tag > is none
+    std::unordered_map<const Tag*,bool> noneTags;
+
+    std::map<const Tag*,int> tagsCardinality;
+    std::map<const Tag*,int> scopedTagsCardinality;
+    Scope scope;
+    size_t notesCount;
+    size_t bytesize;
+
+    Outline* mostReadOutline;
+    Outline* mostWrittenOutline;
+    Note* mostReadNote;
+    Note* mostWrittenNote;
+    const Tag* mostUsedTag;
+    // maxima when they were found (things might have changed since then)
+    uint32_t maxOutlineReads;
+    uint32_t maxOutlineRevision;
+    uint32_t maxNoteReads;
+    uint32_t maxNoteRevision;
+    int maxTagCardinality;
+    // Os of the most read/written N
+    const Outline* mostReadNoteOutline;
+    const Outline* mostWrittenNoteOutline;
+    // maxima must be found by walking all Os/tags
+    bool maximaStale;
+    bool mostUsedTagStale;
+
+public:
+    explicit MindAggregates();
+    MindAggregates(const MindAggregates&) = delete;
+    MindAggregates(const MindAggregates&&) = delete;
+    MindAggregates& operator=(const MindAggregates&) = delete;
+    MindAggregates& operator=(const MindAggregates&&) = delete;
+    ~MindAggregates();
+
+    /**
+     * @brief Recount Os which changed since the last update (and all Os in the scope if it changed).
+     *
+     * @return number of recounted (incl. forgotten) Os.
+     */
+    size_t update(const std::vector<Outline*>& outlines, const OutlineChanges& changes, const MindScopeAspect& mindScope);
+    void clear();
+
+    /**
+     * @brief N was read - event to be sent after N reads are incremented.
+     */
+    void onNoteRead(Note* n);
+
+    bool isNoneTag(const Tag* tag);
+
+    /**
+     * @brief Get cardinality of tags used by Os and Ns (tags w/ zero cardinality are not included).
+     */
+    const std::map<const Tag*,int>& getTagsCardinality() const { return tagsCardinality; }
+    /**
+     * @brief Get cardinality of tags used by Os and Ns in the scope of the last update.
+     */
+    const std::map<const Tag*,int>& getScopedTagsCardinality() const { return scopedTagsCardinality; }
+    size_t getNotesCount() const { return notesCount; }
+    size_t getBytesize() const { return bytesize; }
+    Outline* getMostReadOutline() const { return mostReadOutline; }
+    Outline* getMostWrittenOutline() const { return mostWrittenOutline; }
+    Note* getMostReadNote() const { return mostReadNote; }
+    Note* getMostWrittenNote() const { return mostWrittenNote; }
+    const Tag* getMostUsedTag() const { return mostUsedTag; }
+
+private:
+    void add(Outline* o, OutlineAggregate& aggregate);
+    void subtract(OutlineAggregate& aggregate);
+    void addScoped(const Outline* o, OutlineAggregate& aggregate, const MindScopeAspect& mindScope);
+    void subtractScoped(OutlineAggregate& aggregate);
+    void offerMaxima(Outline* o, const OutlineAggregate& aggregate);
+    void updateMaxima(const std::vector<Outline*>& outlines);
+    void updateMostUsedTag();
+    static void decrement(std::map<const Tag*,int>& cardinality, const std::vector<const Tag*>& tags);
+};
+
+} // m8r namespace
+
+#endif // M8R_MIND_AGGREGATES_H
@@ -26,15 +26,17 @@ using namespace std;
  * Thing
  */
 
-long Thing::sequence = 0;
+std::atomic<uint32_t> Thing::sequence{0};
 
 Thing::Thing()
-    : key{std::to_string(++sequence)},
+    : id{++sequence},
+      key{std::to_string(id)},
       name{}
 {
 }
 
 Thing::Thing(const string name)
+    : id{++sequence}
 {
     setName(name);
 }
@@ -19,6 +19,8 @@
 #ifndef M8R_THING_CLASS_REL_TRIPLE_H_
 #define M8R_THING_CLASS_REL_TRIPLE_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <set>
 
@@ -26,6 +28,7 @@
 #include "../../config/color.h"
 #include "../../gear/string_utils.h"
 #include "../../gear/datetime_utils.h"
+#include "../../gear/string_interner.h"
 
 /*
  * Thing, Class, Relationship, RelationshipType and Triple
@@ -45,12 +48,29 @@ class Relationship;
 class Thing
 {
 private:
-    static long sequence;
+    static std::atomic<uint32_t> sequence;
 
 public:
     static std::string getNextKey() { return std::to_string(++sequence); }
 
+    /**
+     * @brief Interned Thing keys.
+     *
+     * Keys which are used to index Things (like O paths) are interned
+     * so that indices can use compact integer IDs instead of strings.
+     */
+    static StringInterner& getKeys() {
+        // static initialization order fiasco prevention
+        static StringInterner keys{};
+        return keys;
+    }
+
 protected:
+    /**
+     * @brief Thing ID - compact integer unique within the process.
+     */
+    uint32_t id;
+
     /**
      * @brief Thing identifier.
      */
@@ -96,6 +116,7 @@ public:
      * @return unique thing identifier.
      */
     virtual std::string& getKey() { return key; }
+    uint32_t getId() const { return id; }
 
     const std::string& getName() const { return name; }
     virtual void setName(const std::string& name) { this->name = name; autolinkName(); }
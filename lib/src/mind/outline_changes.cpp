@@ -0,0 +1,80 @@
+/*
+ outline_changes.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "outline_changes.h"
+
+using namespace std;
+
+namespace m8r {
+
+OutlineChanges::OutlineChanges()
+    : epoch{1}
+{
+}
+
+OutlineChanges::~OutlineChanges()
+{
+}
+
+void OutlineChanges::reset()
+{
+    epoch++;
+    log.clear();
+    last.clear();
+}
+
+void OutlineChanges::append(Outline* outline, bool forgotten)
+{
+    // Os changed repeatedly (typically read) prevail > start a new epoch instead of compaction
+    if(log.size() >= COMPACTION_THRESHOLD && log.size() > 2*last.size()) {
+        reset();
+    }
+
+    last[outline] = log.size();
+    log.push_back(Change{outline, forgotten});
+}
+
+bool OutlineChanges::since(Cursor& cursor, vector<Outline*>& changed, vector<const Outline*>& forgotten) const
+{
+    if(cursor.epoch != epoch) {
+        return false;
+    }
+
+    for(size_t i=cursor.position; i<log.size(); i++) {
+        // O is reported by its last change only
+        if(last.find(log[i].outline)->second == i) {
+            if(log[i].forgotten) {
+                forgotten.push_back(log[i].outline);
+            } else {
+                changed.push_back(log[i].outline);
+            }
+        }
+    }
+    cursor.position = log.size();
+    return true;
+}
+
+OutlineChanges::Cursor OutlineChanges::end() const
+{
+    Cursor cursor{};
+    cursor.epoch = epoch;
+    cursor.position = log.size();
+    return cursor;
+}
+
+} // m8r namespace
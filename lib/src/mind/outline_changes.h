@@ -0,0 +1,112 @@
+/*
+ outline_changes.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_OUTLINE_CHANGES_H
+#define M8R_OUTLINE_CHANGES_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../model/outline.h"
+
+namespace m8r {
+
+/**
+ * @brief Log of Os which were learned, remembered, changed in memory or forgotten.
+ *
+ * Memory appends O to the log whenever it learns, remembers or forgets it and Os
+ * it remembers report their in-memory changes (modification, read, Ns added or
+ * removed) as listener. Indices keep a cursor to the log and on update they get
+ * only Os which changed since their cursor - each O once, regardless how many times
+ * it changed.
+ *
+ * Log is reset once it's mostly formed by repeated changes of the same Os, which
+ * starts a new epoch - cursors of previous epochs (and new cursors) get no changes
+ * and indices must reindex all Os of memory (as after learn or amnesia).
+ */
+class OutlineChanges : public OutlineListener
+{
+public:
+    /**
+     * @brief Position of an index in the log.
+     */
+    struct Cursor {
+        uint64_t epoch;
+        size_t position;
+
+        Cursor() : epoch{0}, position{0} {}
+    };
+
+private:
+    static constexpr size_t COMPACTION_THRESHOLD = 1024;
+
+    struct Change {
+        // forgotten O is in limbo i.e. valid until amnesia, which resets the log
+        Outline* outline;
+        bool forgotten;
+    };
+
+    uint64_t epoch;
+    std::vector<Change> log;
+    // O > position of its last change in the log
+    std::unordered_map<const Outline*,size_t> last;
+
+public:
+    explicit OutlineChanges();
+    OutlineChanges(const OutlineChanges&) = delete;
+    OutlineChanges(const OutlineChanges&&) = delete;
+    OutlineChanges& operator=(const OutlineChanges&) = delete;
+    OutlineChanges& operator=(const OutlineChanges&&) = delete;
+    virtual ~OutlineChanges();
+
+    virtual void onOutlineChanged(Outline* outline) override { append(outline, false); }
+    void onOutlineForgotten(Outline* outline) { append(outline, true); }
+
+    /**
+     * @brief Forget the log - all Os are to be reindexed.
+     */
+    void reset();
+
+    /**
+     * @brief Get Os changed and forgotten since the cursor and move the cursor to the end of the log.
+     *
+     * @return false if the cursor is of another epoch i.e. changes are not known and all Os must
+     *         be reindexed (cursor is not moved - index sets it to the end of the log).
+     */
+    bool since(Cursor& cursor, std::vector<Outline*>& changed, std::vector<const Outline*>& forgotten) const;
+    /**
+     * @brief Check whether there are no changes since the cursor.
+     */
+    bool isCurrent(const Cursor& cursor) const {
+        return cursor.epoch == epoch && cursor.position == log.size();
+    }
+    /**
+     * @brief Get cursor at the end of the log (index which reindexed all Os).
+     */
+    Cursor end() const;
+
+    size_t size() const { return log.size(); }
+
+private:
+    void append(Outline* outline, bool forgotten);
+};
+
+} // m8r namespace
+
+#endif // M8R_OUTLINE_CHANGES_H
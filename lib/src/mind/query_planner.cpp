@@ -0,0 +1,716 @@
+/*
+ query_planner.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "query_planner.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <unordered_set>
+
+using namespace std;
+
+namespace m8r {
+
+/*
+ * Parser
+ */
+
+namespace {
+
+class QueryParser
+{
+private:
+    const string& query;
+    size_t pos;
+    time_t now;
+
+public:
+    QueryParser(const string& query, time_t now) : query(query), pos(0), now(now) {}
+
+    unique_ptr<NoteQuery> parse() {
+        skipSpaces();
+        if(pos >= query.size()) {
+            throw MindForgerException{"Query: empty query"};
+        }
+        unique_ptr<NoteQuery> q = parseOr();
+        if(pos < query.size()) {
+            throw MindForgerException{"Query: unexpected '" + query.substr(pos) + "'"};
+        }
+        return q;
+    }
+
+private:
+    void skipSpaces() {
+        while(pos < query.size() && std::isspace(static_cast<unsigned char>(query[pos]))) pos++;
+    }
+
+    bool isDelimiter(size_t i) const {
+        return i >= query.size()
+            || std::isspace(static_cast<unsigned char>(query[i]))
+            || query[i]=='('
+            || query[i]==')';
+    }
+
+    bool isKeyword(const char* keyword) {
+        size_t length = strlen(keyword);
+        return !query.compare(pos, length, keyword) && isDelimiter(pos+length);
+    }
+
+    bool consumeKeyword(const char* keyword) {
+        if(isKeyword(keyword)) {
+            pos += strlen(keyword);
+            skipSpaces();
+            return true;
+        }
+        return false;
+    }
+
+    static unique_ptr<NoteQuery> simplify(unique_ptr<NoteQuery> q) {
+        if(q->children.size() == 1) {
+            return std::move(q->children[0]);
+        }
+        return q;
+    }
+
+    unique_ptr<NoteQuery> parseOr() {
+        unique_ptr<NoteQuery> q{new NoteQuery{NoteQuery::Kind::OR}};
+        q->children.push_back(parseAnd());
+        while(consumeKeyword("OR")) {
+            q->children.push_back(parseAnd());
+        }
+        return simplify(std::move(q));
+    }
+
+    unique_ptr<NoteQuery> parseAnd() {
+        unique_ptr<NoteQuery> q{new NoteQuery{NoteQuery::Kind::AND}};
+        q->children.push_back(parseUnary());
+        while(pos < query.size() && query[pos]!=')' && !isKeyword("OR")) {
+            consumeKeyword("AND");
+            q->children.push_back(parseUnary());
+        }
+        return simplify(std::move(q));
+    }
+
+    unique_ptr<NoteQuery> parseUnary() {
+        if(pos >= query.size()) {
+            throw MindForgerException{"Query: condition expected at the end"};
+        }
+        if(consumeKeyword("NOT") || (query[pos]=='-' && !isDelimiter(pos+1) && ++pos)) {
+            unique_ptr<NoteQuery> q{new NoteQuery{NoteQuery::Kind::NOT}};
+            q->children.push_back(parseUnary());
+            return q;
+        }
+        if(query[pos] == '(') {
+            pos++;
+            skipSpaces();
+            unique_ptr<NoteQuery> q = parseOr();
+            if(pos >= query.size() || query[pos]!=')') {
+                throw MindForgerException{"Query: missing ')'"};
+            }
+            pos++;
+            skipSpaces();
+            return q;
+        }
+        if(query[pos] == ')') {
+            throw MindForgerException{"Query: unexpected ')'"};
+        }
+        unique_ptr<NoteQuery> q = parseCondition();
+        skipSpaces();
+        return q;
+    }
+
+    string parsePhrase() {
+        size_t end = query.find('"', pos+1);
+        if(end == string::npos) {
+            throw MindForgerException{"Query: missing '\"'"};
+        }
+        string phrase{query.substr(pos+1, end-pos-1)};
+        pos = end+1;
+        return phrase;
+    }
+
+    unique_ptr<NoteQuery> parseCondition() {
+        string word{};
+        if(query[pos] == '"') {
+            word = parsePhrase();
+        } else {
+            size_t begin = pos;
+            while(!isDelimiter(pos) && query[pos]!=':') pos++;
+            if(pos < query.size() && query[pos]==':') {
+                string key{};
+                stringToLower(query.substr(begin, pos-begin), key);
+                NoteQuery::Kind kind;
+                if(key == "tag") kind = NoteQuery::Kind::TAG;
+                else if(key == "type") kind = NoteQuery::Kind::TYPE;
+                else if(key == "read") kind = NoteQuery::Kind::READ;
+                else if(key == "modified") kind = NoteQuery::Kind::MODIFIED;
+                else {
+                    throw MindForgerException{"Query: unknown condition '" + key + ":'"};
+                }
+                pos++;
+                string value{};
+                if(pos < query.size() && query[pos]=='"') {
+                    value = parsePhrase();
+                } else {
+                    size_t valueBegin = pos;
+                    while(!isDelimiter(pos)) pos++;
+                    value = query.substr(valueBegin, pos-valueBegin);
+                }
+                if(value.empty()) {
+                    throw MindForgerException{"Query: value of '" + key + ":' expected"};
+                }
+                unique_ptr<NoteQuery> q{new NoteQuery{kind}};
+                if(kind==NoteQuery::Kind::READ || kind==NoteQuery::Kind::MODIFIED) {
+                    parseTime(value, *q);
+                } else {
+                    stringToLower(value, q->value);
+                }
+                return q;
+            }
+            while(!isDelimiter(pos)) pos++;
+            word = query.substr(begin, pos-begin);
+        }
+        if(word.empty()) {
+            throw MindForgerException{"Query: empty phrase"};
+        }
+        unique_ptr<NoteQuery> q{new NoteQuery{NoteQuery::Kind::TEXT}};
+        stringToLower(word, q->value);
+        return q;
+    }
+
+    void parseTime(const string& value, NoteQuery& q) {
+        size_t i = 0;
+        bool newer = true;
+        if(value[i]=='<' || value[i]=='>') {
+            newer = value[i++]=='<';
+        }
+        long long count = 0;
+        size_t digits = i;
+        while(i < value.size() && std::isdigit(static_cast<unsigned char>(value[i]))) {
+            count = count*10 + (value[i++]-'0');
+        }
+        if(i == digits || i+1 != value.size()) {
+            throw MindForgerException{"Query: invalid time '" + value + "' - use e.g. <7d or >1y"};
+        }
+        long long unit;
+        switch(value[i]) {
+        case 'h': unit = 60*60; break;
+        case 'd': unit = 24*60*60; break;
+        case 'w': unit = 7*24*60*60; break;
+        case 'm': unit = 30*24*60*60; break;
+        case 'y': unit = 365*24*60*60; break;
+        default:
+            throw MindForgerException{"Query: invalid time unit in '" + value + "' - use h, d, w, m or y"};
+        }
+        time_t threshold = now - static_cast<time_t>(count*unit);
+        if(newer) {
+            q.from = threshold;
+            q.to = numeric_limits<time_t>::max();
+        } else {
+            q.from = numeric_limits<time_t>::min();
+            q.to = threshold;
+        }
+    }
+};
+
+} // anonymous namespace
+
+unique_ptr<NoteQuery> NoteQuery::parse(const string& query, time_t now)
+{
+    QueryParser parser{query, now};
+    return parser.parse();
+}
+
+/*
+ * Planner
+ */
+
+QueryPlanner::QueryPlanner(Memory& memory, TagIndex& tagIndex)
+    : memory(memory),
+      tagIndex(tagIndex),
+      nextOrder{0},
+      released{0},
+      ordered{true},
+      readsChanged{false},
+      cost{0}
+{
+}
+
+QueryPlanner::~QueryPlanner()
+{
+}
+
+void QueryPlanner::clear()
+{
+    cursor = OutlineChanges::Cursor{};
+    notes.clear();
+    noteIds.clear();
+    outlineIds.clear();
+    outlines.clear();
+    outlineFirstIds.clear();
+    outlineOrders.clear();
+    entries.clear();
+    nextOrder = 0;
+    released = 0;
+    ordered = true;
+    types.clear();
+    byRead.clear();
+    byModified.clear();
+    readsChanged = false;
+    textCandidates.clear();
+    queryTags.clear();
+}
+
+void QueryPlanner::update()
+{
+    const vector<Outline*>& os = memory.getOutlines();
+    const OutlineChanges& changes = memory.getChanges();
+    tagIndex.update(os, changes);
+
+    vector<Outline*> changed{};
+    vector<const Outline*> forgotten{};
+    if(!changes.since(cursor, changed, forgotten)) {
+        reindex(os);
+        return;
+    }
+
+    if(changed.size() || forgotten.size()) {
+        // all Ns are released before Ns are indexed - (deleted) Ns are never dereferenced
+        for(const Outline* o:forgotten) {
+            auto e = entries.find(o);
+            if(e != entries.end()) {
+                release(e->second.slot);
+                entries.erase(e);
+            }
+        }
+        for(Outline* o:changed) {
+            auto e = entries.find(o);
+            if(e != entries.end()) {
+                release(e->second.slot);
+                // O keeps its place in memory, but its Ns get the highest IDs
+                ordered = false;
+            }
+        }
+        auto isReleased = [this](uint32_t id) { return notes[id] == nullptr; };
+        byRead.erase(std::remove_if(byRead.begin(), byRead.end(), isReleased), byRead.end());
+        byModified.erase(std::remove_if(byModified.begin(), byModified.end(), isReleased), byModified.end());
+
+        const uint32_t first = static_cast<uint32_t>(notes.size());
+        for(Outline* o:changed) {
+            index(o);
+        }
+
+        // compaction: IDs are assigned in memory order again if most of them were released
+        if(released > (notes.size() + outlines.size())/2) {
+            reindex(os);
+            return;
+        }
+
+        // sort only IDs of new Ns and merge them
+        auto merge = [this,first](Ids& byTime, bool read) {
+            auto less = [this,read](uint32_t i1, uint32_t i2) { return noteTime(i1, read) < noteTime(i2, read); };
+            size_t sorted = byTime.size();
+            for(uint32_t id=first; id<notes.size(); id++) {
+                byTime.push_back(id);
+            }
+            std::stable_sort(byTime.begin()+sorted, byTime.end(), less);
+            std::inplace_merge(byTime.begin(), byTime.begin()+sorted, byTime.end(), less);
+        };
+        merge(byModified, false);
+        // IDs are sorted again below if Ns were read
+        merge(byRead, true);
+    }
+
+    if(readsChanged) {
+        sortByRead();
+    }
+}
+
+void QueryPlanner::reindex(const vector<Outline*>& os)
+{
+    clear();
+    cursor = memory.getChanges().end();
+    for(Outline* o:os) {
+        index(o);
+    }
+    byRead = all();
+    sortByRead();
+    byModified = all();
+    std::stable_sort(byModified.begin(), byModified.end(), [this](uint32_t i1, uint32_t i2) {
+        return notes[i1]->getModified() < notes[i2]->getModified();
+    });
+}
+
+void QueryPlanner::index(Outline* o)
+{
+    uint32_t slot = static_cast<uint32_t>(outlines.size());
+    auto e = entries.find(o);
+    if(e == entries.end()) {
+        // O is new in memory i.e. appended to memory
+        e = entries.insert(make_pair(o, OutlineEntry{slot, nextOrder++})).first;
+    } else {
+        e->second.slot = slot;
+    }
+    outlines.push_back(o);
+    outlineFirstIds.push_back(static_cast<uint32_t>(notes.size()));
+    outlineOrders.push_back(e->second.order);
+
+    for(Note* n:o->getNotes()) {
+        uint32_t id = static_cast<uint32_t>(notes.size());
+        notes.push_back(n);
+        noteIds[n] = id;
+        outlineIds.push_back(slot);
+        if(n->getType()) {
+            string name{};
+            stringToLower(n->getType()->getName(), name);
+            types[name].push_back(id);
+        }
+    }
+}
+
+void QueryPlanner::release(uint32_t slot)
+{
+    uint32_t end = slot+1<outlineFirstIds.size() ? outlineFirstIds[slot+1] : static_cast<uint32_t>(notes.size());
+    for(uint32_t id=outlineFirstIds[slot]; id<end; id++) {
+        noteIds.erase(notes[id]);
+        notes[id] = nullptr;
+        released++;
+    }
+    outlines[slot] = nullptr;
+    released++;
+}
+
+void QueryPlanner::sortByRead()
+{
+    std::stable_sort(byRead.begin(), byRead.end(), [this](uint32_t i1, uint32_t i2) {
+        return notes[i1]->getRead() < notes[i2]->getRead();
+    });
+    readsChanged = false;
+}
+
+QueryPlanner::Ids QueryPlanner::all() const
+{
+    Ids ids{};
+    ids.reserve(notes.size());
+    for(uint32_t i=0; i<notes.size(); i++) {
+        if(notes[i]) {
+            ids.push_back(i);
+        }
+    }
+    return ids;
+}
+
+void QueryPlanner::find(const NoteQuery& query, vector<Note*>& result, const MindScopeAspect* scope)
+{
+    update();
+    cost = 0;
+    textCandidates.clear();
+    queryTags.clear();
+
+    Ids ids = evaluate(query);
+    if(!ordered) {
+        // Ns of O have consecutive IDs
+        std::sort(ids.begin(), ids.end(), [this](uint32_t i1, uint32_t i2) {
+            uint32_t o1 = outlineOrders[outlineIds[i1]];
+            uint32_t o2 = outlineOrders[outlineIds[i2]];
+            return o1 < o2 || (o1 == o2 && i1 < i2);
+        });
+    }
+    for(uint32_t id:ids) {
+        if(!scope || !scope->isEnabled() || scope->isInScope(notes[id])) {
+            result.push_back(notes[id]);
+        }
+    }
+}
+
+const vector<uint32_t>& QueryPlanner::candidates(const NoteQuery& q)
+{
+    auto cached = textCandidates.find(&q);
+    if(cached != textCandidates.end()) {
+        return cached->second;
+    }
+
+    // O which is not current in the trigram index is always a candidate
+    TrigramIndex& ftsIndex = memory.getFtsIndex();
+    unordered_set<const Outline*> indexCandidates{};
+    bool narrowed = ftsIndex.candidates(vector<string>{q.value}, indexCandidates);
+    vector<uint32_t>& result = textCandidates[&q];
+    for(uint32_t i=0; i<outlines.size(); i++) {
+        if(outlines[i]
+             &&
+           (!narrowed
+             ||
+           !ftsIndex.isCurrent(outlines[i])
+             ||
+           indexCandidates.find(outlines[i])!=indexCandidates.end()))
+        {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+const vector<const Tag*>& QueryPlanner::tagsOf(const NoteQuery& q)
+{
+    auto cached = queryTags.find(&q);
+    if(cached != queryTags.end()) {
+        return cached->second;
+    }
+    vector<const Tag*>& result = queryTags[&q];
+    tagIndex.findNoteTags(q.value, result);
+    return result;
+}
+
+QueryPlanner::Ids QueryPlanner::timeRange(const Ids& byTime, bool read, time_t from, time_t to) const
+{
+    auto before = [this,read](uint32_t id, time_t t) { return noteTime(id, read) < t; };
+    auto begin = std::lower_bound(byTime.begin(), byTime.end(), from, before);
+    auto end = std::lower_bound(begin, byTime.end(), to, before);
+    Ids ids(begin, end);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+size_t QueryPlanner::estimate(const NoteQuery& q)
+{
+    switch(q.kind) {
+    case NoteQuery::Kind::TEXT: {
+        size_t count = 0;
+        for(uint32_t i:candidates(q)) {
+            count += outlines[i]->getNotesCount();
+        }
+        return count;
+    }
+    case NoteQuery::Kind::TAG: {
+        // N might have more tags w/ the name (differently cased)
+        size_t count = 0;
+        for(const Tag* t:tagsOf(q)) {
+            count += tagIndex.getNotesCount(t);
+        }
+        return std::min(count, notes.size());
+    }
+    case NoteQuery::Kind::TYPE: {
+        auto p = types.find(q.value);
+        return p==types.end() ? 0 : p->second.size();
+    }
+    case NoteQuery::Kind::READ:
+    case NoteQuery::Kind::MODIFIED: {
+        const bool read = q.kind==NoteQuery::Kind::READ;
+        const Ids& byTime = read ? byRead : byModified;
+        auto before = [this,read](uint32_t id, time_t t) { return noteTime(id, read) < t; };
+        auto begin = std::lower_bound(byTime.begin(), byTime.end(), q.from, before);
+        auto end = std::lower_bound(begin, byTime.end(), q.to, before);
+        return static_cast<size_t>(end-begin);
+    }
+    case NoteQuery::Kind::AND: {
+        size_t min = notes.size();
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            if(c->kind != NoteQuery::Kind::NOT) {
+                min = std::min(min, estimate(*c));
+            }
+        }
+        return min;
+    }
+    case NoteQuery::Kind::OR: {
+        size_t sum = 0;
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            sum += estimate(*c);
+        }
+        return std::min(sum, notes.size());
+    }
+    case NoteQuery::Kind::NOT:
+        return notes.size() - std::min(notes.size(), estimate(*q.children[0]));
+    }
+    return notes.size();
+}
+
+QueryPlanner::Ids QueryPlanner::evaluate(const NoteQuery& q)
+{
+    Ids ids{};
+    switch(q.kind) {
+    case NoteQuery::Kind::TEXT:
+        for(uint32_t i:candidates(q)) {
+            const vector<Note*>& ns = outlines[i]->getNotes();
+            if(ns.empty()) {
+                continue;
+            }
+            // Ns of O have consecutive IDs
+            uint32_t first = outlineFirstIds[i];
+            for(uint32_t id=first; id<first+ns.size(); id++) {
+                if(matches(q, id)) {
+                    ids.push_back(id);
+                }
+            }
+        }
+        break;
+    case NoteQuery::Kind::TAG: {
+        const vector<const Tag*>& ts = tagsOf(q);
+        if(ts.size()) {
+            vector<Note*> tagged{};
+            tagIndex.findNotes(ts, tagged, false);
+            for(Note* n:tagged) {
+                auto id = noteIds.find(n);
+                if(id != noteIds.end()) {
+                    ids.push_back(id->second);
+                }
+            }
+            std::sort(ids.begin(), ids.end());
+            cost += ids.size();
+        }
+        break;
+    }
+    case NoteQuery::Kind::TYPE: {
+        auto p = types.find(q.value);
+        if(p != types.end()) {
+            for(uint32_t id:p->second) {
+                if(notes[id]) ids.push_back(id);
+            }
+            cost += p->second.size();
+        }
+        break;
+    }
+    case NoteQuery::Kind::READ:
+    case NoteQuery::Kind::MODIFIED:
+        ids = timeRange(
+            q.kind==NoteQuery::Kind::READ ? byRead : byModified,
+            q.kind==NoteQuery::Kind::READ,
+            q.from,
+            q.to);
+        cost += ids.size();
+        break;
+    case NoteQuery::Kind::OR:
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            Ids child = evaluate(*c);
+            Ids merged{};
+            std::set_union(ids.begin(), ids.end(), child.begin(), child.end(), std::back_inserter(merged));
+            ids.swap(merged);
+        }
+        break;
+    case NoteQuery::Kind::NOT: {
+        Ids universe = all();
+        Ids child = evaluate(*q.children[0]);
+        std::set_difference(universe.begin(), universe.end(), child.begin(), child.end(), std::back_inserter(ids));
+        cost += universe.size();
+        break;
+    }
+    case NoteQuery::Kind::AND: {
+        // the most selective positive condition first
+        vector<pair<size_t,const NoteQuery*>> positive{};
+        vector<const NoteQuery*> negative{};
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            if(c->kind == NoteQuery::Kind::NOT) {
+                negative.push_back(c->children[0].get());
+            } else {
+                positive.push_back(make_pair(estimate(*c), c.get()));
+            }
+        }
+        std::stable_sort(positive.begin(), positive.end(),
+            [](const pair<size_t,const NoteQuery*>& p1, const pair<size_t,const NoteQuery*>& p2) {
+                return p1.first < p2.first;
+            });
+
+        if(positive.empty()) {
+            ids = all();
+            cost += ids.size();
+        } else {
+            ids = evaluate(*positive[0].second);
+        }
+        // intersect cheap posting lists, verify Ns of (small) intermediate result otherwise
+        for(size_t i=1; i<positive.size() && ids.size(); i++) {
+            Ids next{};
+            if(positive[i].first < ids.size()) {
+                Ids child = evaluate(*positive[i].second);
+                std::set_intersection(ids.begin(), ids.end(), child.begin(), child.end(), std::back_inserter(next));
+            } else {
+                for(uint32_t id:ids) {
+                    if(matches(*positive[i].second, id)) next.push_back(id);
+                }
+            }
+            ids.swap(next);
+        }
+        for(size_t i=0; i<negative.size() && ids.size(); i++) {
+            Ids next{};
+            if(estimate(*negative[i]) < ids.size()) {
+                Ids child = evaluate(*negative[i]);
+                std::set_difference(ids.begin(), ids.end(), child.begin(), child.end(), std::back_inserter(next));
+            } else {
+                for(uint32_t id:ids) {
+                    if(!matches(*negative[i], id)) next.push_back(id);
+                }
+            }
+            ids.swap(next);
+        }
+        break;
+    }
+    }
+    return ids;
+}
+
+bool QueryPlanner::matches(const NoteQuery& q, uint32_t id)
+{
+    const Note* n = notes[id];
+    switch(q.kind) {
+    case NoteQuery::Kind::TEXT:
+        cost++;
+        memory.recall(outlines[outlineIds[id]]);
+        return stringFindIgnoreCase(n->getName(), q.value) != string::npos
+            || stringFindIgnoreCase(n->getDescription().getText(), q.value) != string::npos;
+    case NoteQuery::Kind::TAG:
+        cost++;
+        for(const Tag* t:*n->getTags()) {
+            string name{};
+            stringToLower(t->getName(), name);
+            if(name == q.value) {
+                return true;
+            }
+        }
+        return false;
+    case NoteQuery::Kind::TYPE: {
+        cost++;
+        string name{};
+        if(n->getType()) {
+            stringToLower(n->getType()->getName(), name);
+        }
+        return n->getType() && name == q.value;
+    }
+    case NoteQuery::Kind::READ:
+    case NoteQuery::Kind::MODIFIED: {
+        cost++;
+        time_t t = noteTime(id, q.kind==NoteQuery::Kind::READ);
+        return t >= q.from && t < q.to;
+    }
+    case NoteQuery::Kind::AND:
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            if(!matches(*c, id)) return false;
+        }
+        return true;
+    case NoteQuery::Kind::OR:
+        for(const unique_ptr<NoteQuery>& c:q.children) {
+            if(matches(*c, id)) return true;
+        }
+        return false;
+    case NoteQuery::Kind::NOT:
+        return !matches(*q.children[0], id);
+    }
+    return false;
+}
+
+} // m8r namespace
@@ -0,0 +1,198 @@
+/*
+ query_planner.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_QUERY_PLANNER_H
+#define M8R_QUERY_PLANNER_H
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "memory.h"
+#include "tag_index.h"
+#include "aspect/mind_scope_aspect.h"
+#include "../exceptions.h"
+
+namespace m8r {
+
+/**
+ * @brief Parsed N query.
+ *
+ * Query language:
+ *
+ *   word "a phrase"    ... (case insensitive) text in N name or description
+ *   tag:name           ... N has the tag (tag:"tag name" for names w/ spaces)
+ *   type:name          ... N is of the type
+ *   read:<7d           ... N was read in the last 7 days (>7d older than 7 days),
+ *                          units h(ours), d(ays), w(eeks), m(onths) and y(ears)
+ *   modified:<1y       ... N was modified in the last year
+ *   AND OR NOT ( )     ... operators (AND is implicit), -x is NOT x
+ *
+ * AND has higher precedence than OR.
+ */
+struct NoteQuery
+{
+    enum class Kind {
+        TEXT,
+        TAG,
+        TYPE,
+        READ,
+        MODIFIED,
+        AND,
+        OR,
+        NOT
+    };
+
+    Kind kind;
+    // lower case text, tag or type name
+    std::string value;
+    // time interval [from, to)
+    time_t from;
+    time_t to;
+    std::vector<std::unique_ptr<NoteQuery>> children;
+
+    explicit NoteQuery(Kind kind) : kind(kind), value{}, from(0), to(0) {}
+    NoteQuery(const NoteQuery&) = delete;
+    NoteQuery(const NoteQuery&&) = delete;
+    NoteQuery &operator=(const NoteQuery&) = delete;
+    NoteQuery &operator=(const NoteQuery&&) = delete;
+    ~NoteQuery() {}
+
+    /**
+     * @brief Parse query - MindForgerException is thrown for invalid query.
+     *
+     * @param now   reference time point of relative time conditions
+     */
+    static std::unique_ptr<NoteQuery> parse(const std::string& query, time_t now);
+};
+
+/**
+ * @brief Evaluate N queries using indices instead of filtering all Ns.
+ *
+ * Ns get dense IDs (memory order) and types, read and modified times are
+ * indexed to sorted posting lists. Tags are looked up in Mind's tag index and
+ * text is narrowed by FTS trigram index to candidate Os whose Ns are verified.
+ *
+ * Planner estimates cardinality of every condition and evaluates conjunction
+ * starting w/ the most selective condition - other conditions either intersect
+ * their posting list w/ the (smaller) intermediate result or verify only the Ns
+ * of the intermediate result, whatever is cheaper. Cost of a query is therefore
+ * proportional to the most selective condition rather than to the number of Ns.
+ *
+ * Indices are updated incrementally: IDs of Ns of Os which were forgotten or
+ * changed since the last query (see Memory changes) are released and Ns of changed
+ * Os get new IDs, which are merged to time ordered IDs. Ns of O reindexed in place
+ * are no longer in memory order, therefore result is sorted by memory order of Os
+ * (Os are appended to memory) until indices are compacted. Read times are sorted
+ * again after N is read.
+ */
+class QueryPlanner
+{
+private:
+    typedef std::vector<uint32_t> Ids;
+
+    struct OutlineEntry {
+        uint32_t slot;
+        // memory order of O
+        uint32_t order;
+    };
+
+    Memory& memory;
+    TagIndex& tagIndex;
+
+    OutlineChanges::Cursor cursor;
+    // N ID > N (nullptr for released IDs)
+    std::vector<Note*> notes;
+    std::unordered_map<const Note*,uint32_t> noteIds;
+    // N ID > O slot
+    Ids outlineIds;
+    // O slot > O (nullptr for released slots), ID of its first N and its memory order
+    std::vector<Outline*> outlines;
+    Ids outlineFirstIds;
+    std::vector<uint32_t> outlineOrders;
+    std::unordered_map<const Outline*,OutlineEntry> entries;
+    uint32_t nextOrder;
+    // released N IDs and O slots
+    size_t released;
+    // IDs are in memory order
+    bool ordered;
+    // type > IDs (incl. released)
+    std::unordered_map<std::string,Ids> types;
+    // IDs ordered by time
+    Ids byRead;
+    Ids byModified;
+    // N was read since IDs were ordered by read time
+    bool readsChanged;
+
+    // tag condition > tags w/ the name
+    std::unordered_map<const NoteQuery*,std::vector<const Tag*>> queryTags;
+    // text condition > candidate O indices (all Os if not narrowed)
+    std::unordered_map<const NoteQuery*,std::vector<uint32_t>> textCandidates;
+    // Ns visited by the last query (postings and verified Ns)
+    size_t cost;
+
+public:
+    explicit QueryPlanner(Memory& memory, TagIndex& tagIndex);
+    QueryPlanner(const QueryPlanner&) = delete;
+    QueryPlanner(const QueryPlanner&&) = delete;
+    QueryPlanner &operator=(const QueryPlanner&) = delete;
+    QueryPlanner &operator=(const QueryPlanner&&) = delete;
+    ~QueryPlanner();
+
+    /**
+     * @brief Find Ns matching the query (in memory order) and the scope.
+     */
+    void find(const NoteQuery& query, std::vector<Note*>& result, const MindScopeAspect* scope=nullptr);
+
+    /**
+     * @brief Evict indices.
+     */
+    void clear();
+    /**
+     * @brief N read time changed - IDs are ordered by read time again on the next query.
+     */
+    void onNoteRead() { readsChanged = true; }
+
+    size_t getLastCost() const { return cost; }
+
+private:
+    void update();
+    void reindex(const std::vector<Outline*>& os);
+    void index(Outline* o);
+    void release(uint32_t slot);
+    void sortByRead();
+
+    size_t estimate(const NoteQuery& q);
+    Ids evaluate(const NoteQuery& q);
+    bool matches(const NoteQuery& q, uint32_t id);
+
+    const std::vector<uint32_t>& candidates(const NoteQuery& q);
+    const std::vector<const Tag*>& tagsOf(const NoteQuery& q);
+    Ids timeRange(const Ids& byTime, bool read, time_t from, time_t to) const;
+    time_t noteTime(uint32_t id, bool read) const {
+        return read ? notes[id]->getRead() : notes[id]->getModified();
+    }
+    Ids all() const;
+};
+
+} // m8r namespace
+
+#endif // M8R_QUERY_PLANNER_H
@@ -0,0 +1,227 @@
+/*
+ tag_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "tag_index.h"
+
+#include "../gear/string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+TagIndex::TagIndex()
+    : released{0}
+{
+}
+
+TagIndex::~TagIndex()
+{
+}
+
+void TagIndex::clear()
+{
+    outlines.clear();
+    notes.clear();
+    outlinesTags.clear();
+    notesTags.clear();
+    outlineBitmaps.clear();
+    noteBitmaps.clear();
+    entries.clear();
+    released = 0;
+    cursor = OutlineChanges::Cursor{};
+}
+
+size_t TagIndex::update(const vector<Outline*>& os, const OutlineChanges& changes)
+{
+    vector<Outline*> changed{};
+    vector<const Outline*> forgotten{};
+    if(!changes.since(cursor, changed, forgotten)) {
+        reindex(os, changes);
+        return os.size();
+    }
+
+    // forgotten Os are never dereferenced
+    for(const Outline* o:forgotten) {
+        auto e = entries.find(o);
+        if(e != entries.end()) {
+            release(e->second);
+            entries.erase(e);
+        }
+    }
+    for(Outline* o:changed) {
+        auto e = entries.find(o);
+        if(e != entries.end()) {
+            release(e->second);
+        }
+        index(o, entries[o]);
+    }
+
+    // compaction: IDs are assigned in memory order again if most of them were released
+    if(released > (outlines.size() + notes.size())/2) {
+        reindex(os, changes);
+    }
+    return changed.size() + forgotten.size();
+}
+
+void TagIndex::reindex(const vector<Outline*>& os, const OutlineChanges& changes)
+{
+    clear();
+    cursor = changes.end();
+    for(Outline* o:os) {
+        index(o, entries[o]);
+    }
+}
+
+void TagIndex::index(Outline* o, Entry& entry)
+{
+    entry.outlineId = static_cast<uint32_t>(outlines.size());
+    outlines.push_back(o);
+    outlinesTags.push_back(*o->getTags());
+    for(const Tag* t:*o->getTags()) {
+        outlineBitmaps[t].add(entry.outlineId);
+    }
+
+    entry.noteIds.clear();
+    for(Note* n:o->getNotes()) {
+        uint32_t id = static_cast<uint32_t>(notes.size());
+        entry.noteIds.push_back(id);
+        notes.push_back(n);
+        notesTags.push_back(*n->getTags());
+        for(const Tag* t:*n->getTags()) {
+            noteBitmaps[t].add(id);
+        }
+    }
+}
+
+void TagIndex::release(Entry& entry)
+{
+    for(const Tag* t:outlinesTags[entry.outlineId]) {
+        // O might have duplicate tags
+        auto b = outlineBitmaps.find(t);
+        if(b != outlineBitmaps.end()) {
+            b->second.remove(entry.outlineId);
+            if(b->second.empty()) {
+                outlineBitmaps.erase(b);
+            }
+        }
+    }
+    outlines[entry.outlineId] = nullptr;
+    outlinesTags[entry.outlineId].clear();
+
+    for(uint32_t id:entry.noteIds) {
+        for(const Tag* t:notesTags[id]) {
+            auto b = noteBitmaps.find(t);
+            if(b != noteBitmaps.end()) {
+                b->second.remove(id);
+                if(b->second.empty()) {
+                    noteBitmaps.erase(b);
+                }
+            }
+        }
+        notes[id] = nullptr;
+        notesTags[id].clear();
+    }
+    released += 1 + entry.noteIds.size();
+    entry.noteIds.clear();
+}
+
+bool TagIndex::match(
+        const unordered_map<const Tag*,RoaringBitmap>& bitmaps,
+        const vector<const Tag*>& tags,
+        bool all,
+        RoaringBitmap& result)
+{
+    bool first = true;
+    for(const Tag* t:tags) {
+        auto b = bitmaps.find(t);
+        if(b == bitmaps.end()) {
+            if(all) {
+                result.clear();
+                return true;
+            }
+            continue;
+        }
+        if(first) {
+            result = b->second;
+            first = false;
+        } else if(all) {
+            result.intersect(b->second);
+        } else {
+            result.unite(b->second);
+        }
+    }
+    // no tags > no restriction when all tags are required
+    return !(all && tags.empty());
+}
+
+void TagIndex::findOutlines(const vector<const Tag*>& tags, vector<Outline*>& result, bool all) const
+{
+    RoaringBitmap bitmap{};
+    if(match(outlineBitmaps, tags, all, bitmap)) {
+        vector<uint32_t> ids{};
+        bitmap.toVector(ids);
+        for(uint32_t id:ids) {
+            result.push_back(outlines[id]);
+        }
+    } else {
+        for(Outline* o:outlines) {
+            if(o) result.push_back(o);
+        }
+    }
+}
+
+void TagIndex::findNotes(const vector<const Tag*>& tags, vector<Note*>& result, bool all) const
+{
+    RoaringBitmap bitmap{};
+    if(match(noteBitmaps, tags, all, bitmap)) {
+        vector<uint32_t> ids{};
+        bitmap.toVector(ids);
+        for(uint32_t id:ids) {
+            result.push_back(notes[id]);
+        }
+    } else {
+        for(Note* n:notes) {
+            if(n) result.push_back(n);
+        }
+    }
+}
+
+void TagIndex::findNoteTags(const string& name, vector<const Tag*>& tags) const
+{
+    for(auto& b:noteBitmaps) {
+        string tagName{};
+        stringToLower(b.first->getName(), tagName);
+        if(tagName == name) {
+            tags.push_back(b.first);
+        }
+    }
+}
+
+size_t TagIndex::getOutlinesCount(const Tag* tag) const
+{
+    auto b = outlineBitmaps.find(tag);
+    return b==outlineBitmaps.end() ? 0 : b->second.cardinality();
+}
+
+size_t TagIndex::getNotesCount(const Tag* tag) const
+{
+    auto b = noteBitmaps.find(tag);
+    return b==noteBitmaps.end() ? 0 : b->second.cardinality();
+}
+
+} // m8r namespace
@@ -0,0 +1,116 @@
+/*
+ tag_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_TAG_INDEX_H
+#define M8R_TAG_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../gear/roaring_bitmap.h"
+#include "../model/outline.h"
+#include "outline_changes.h"
+
+namespace m8r {
+
+/**
+ * @brief Per tag bitmaps of Os and Ns.
+ *
+ * Os and Ns get dense IDs and every tag has a compressed bitmap of IDs of Os/Ns
+ * it tags - tag queries are bitmap intersections (AND) or unions (OR).
+ *
+ * Index is updated incrementally: bits of Os which were added, forgotten or
+ * changed (tags edit modifies N and its O) since the last update (see Memory
+ * changes) are cleared and the O is indexed again. IDs of changed Os are not
+ * reused until the index is compacted (IDs are assigned in memory order again).
+ */
+class TagIndex
+{
+private:
+    struct Entry {
+        uint32_t outlineId;
+        std::vector<uint32_t> noteIds;
+    };
+
+    // ID > thing (nullptr for released IDs)
+    std::vector<Outline*> outlines;
+    std::vector<Note*> notes;
+    // ID > tags when indexed (thing might have been modified or deleted since)
+    std::vector<std::vector<const Tag*>> outlinesTags;
+    std::vector<std::vector<const Tag*>> notesTags;
+
+    std::unordered_map<const Tag*,RoaringBitmap> outlineBitmaps;
+    std::unordered_map<const Tag*,RoaringBitmap> noteBitmaps;
+
+    std::unordered_map<const Outline*,Entry> entries;
+    // released O and N IDs
+    size_t released;
+    OutlineChanges::Cursor cursor;
+
+public:
+    explicit TagIndex();
+    TagIndex(const TagIndex&) = delete;
+    TagIndex(const TagIndex&&) = delete;
+    TagIndex& operator=(const TagIndex&) = delete;
+    TagIndex& operator=(const TagIndex&&) = delete;
+    ~TagIndex();
+
+    /**
+     * @brief Reindex Os which changed since the last update.
+     *
+     * @return number of reindexed (incl. forgotten) Os.
+     */
+    size_t update(const std::vector<Outline*>& os, const OutlineChanges& changes);
+    void clear();
+
+    /**
+     * @brief Find Os tagged by all (or any) of the tags - in ID order.
+     */
+    void findOutlines(const std::vector<const Tag*>& tags, std::vector<Outline*>& result, bool all=true) const;
+    /**
+     * @brief Find Ns tagged by all (or any) of the tags - in ID order.
+     */
+    void findNotes(const std::vector<const Tag*>& tags, std::vector<Note*>& result, bool all=true) const;
+
+    /**
+     * @brief Find tags of Ns w/ the (lower case) name ignoring case.
+     */
+    void findNoteTags(const std::string& name, std::vector<const Tag*>& tags) const;
+
+    /**
+     * @brief Get number of Os or Ns tagged by the tag.
+     */
+    size_t getOutlinesCount(const Tag* tag) const;
+    size_t getNotesCount(const Tag* tag) const;
+
+private:
+    void reindex(const std::vector<Outline*>& os, const OutlineChanges& changes);
+    void index(Outline* o, Entry& entry);
+    void release(Entry& entry);
+    static bool match(
+            const std::unordered_map<const Tag*,RoaringBitmap>& bitmaps,
+            const std::vector<const Tag*>& tags,
+            bool all,
+            RoaringBitmap& result);
+};
+
+} // m8r namespace
+
+#endif // M8R_TAG_INDEX_H
@@ -0,0 +1,105 @@
+/*
+ thing_prefix_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "thing_prefix_index.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace std;
+
+namespace m8r {
+
+namespace {
+
+bool entryLess(const ThingPrefixIndex::Entry& e1, const ThingPrefixIndex::Entry& e2)
+{
+    return e1.name < e2.name;
+}
+
+} // anonymous namespace
+
+ThingPrefixIndex::ThingPrefixIndex()
+{
+}
+
+ThingPrefixIndex::~ThingPrefixIndex()
+{
+}
+
+size_t ThingPrefixIndex::update(const vector<Outline*>& outlines, const OutlineChanges& changes)
+{
+    // changed Os: new, changed or forgotten (their pointers are compared, never dereferenced)
+    vector<Outline*> changedOutlines{};
+    vector<const Outline*> forgotten{};
+    if(!changes.since(cursor, changedOutlines, forgotten)) {
+        clear();
+        cursor = changes.end();
+        changedOutlines = outlines;
+    }
+    if(changedOutlines.empty() && forgotten.empty()) {
+        return 0;
+    }
+
+    unordered_set<const Outline*> changed{changedOutlines.begin(), changedOutlines.end()};
+    changed.insert(forgotten.begin(), forgotten.end());
+    auto isChanged = [&changed](const Entry& e) { return changed.find(e.outline) != changed.end(); };
+    outlineEntries.erase(std::remove_if(outlineEntries.begin(), outlineEntries.end(), isChanged), outlineEntries.end());
+    noteEntries.erase(std::remove_if(noteEntries.begin(), noteEntries.end(), isChanged), noteEntries.end());
+
+    // sort only new entries and merge them w/ (sorted) entries of unchanged Os
+    size_t outlinesSorted = outlineEntries.size();
+    size_t notesSorted = noteEntries.size();
+    for(Outline* o:changedOutlines) {
+        outlineEntries.push_back(Entry{o->getName(), o, o});
+        for(Note* n:o->getNotes()) {
+            noteEntries.push_back(Entry{n->getName(), n, o});
+        }
+    }
+    std::stable_sort(outlineEntries.begin()+outlinesSorted, outlineEntries.end(), entryLess);
+    std::inplace_merge(outlineEntries.begin(), outlineEntries.begin()+outlinesSorted, outlineEntries.end(), entryLess);
+    std::stable_sort(noteEntries.begin()+notesSorted, noteEntries.end(), entryLess);
+    std::inplace_merge(noteEntries.begin(), noteEntries.begin()+notesSorted, noteEntries.end(), entryLess);
+
+    return changed.size();
+}
+
+void ThingPrefixIndex::clear()
+{
+    outlineEntries.clear();
+    noteEntries.clear();
+    cursor = OutlineChanges::Cursor{};
+}
+
+pair<const ThingPrefixIndex::Entry*,const ThingPrefixIndex::Entry*> ThingPrefixIndex::range(
+        const vector<Entry>& entries,
+        const string& prefix)
+{
+    auto begin = std::lower_bound(entries.begin(), entries.end(), prefix, [](const Entry& e, const string& p) {
+        return e.name < p;
+    });
+    // names w/ the prefix are sorted right after it
+    auto end = std::partition_point(begin, entries.end(), [&prefix](const Entry& e) {
+        return !e.name.compare(0, prefix.size(), prefix);
+    });
+    return pair<const Entry*,const Entry*>{
+        entries.data() + (begin-entries.begin()),
+        entries.data() + (end-entries.begin())};
+}
+
+} // m8r namespace
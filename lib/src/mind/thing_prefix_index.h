@@ -0,0 +1,90 @@
+/*
+ thing_prefix_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_THING_PREFIX_INDEX_H
+#define M8R_THING_PREFIX_INDEX_H
+
+#include <string>
+#include <vector>
+
+#include "../model/outline.h"
+#include "outline_changes.h"
+
+namespace m8r {
+
+/**
+ * @brief Sorted arrays of O and N names for prefix (autocomplete) lookup.
+ *
+ * Names matching a prefix are a contiguous range found by binary search. Index
+ * is updated incrementally: entries of Os which were added, forgotten or changed
+ * since the last update (see Memory changes) are replaced and merged to the sorted
+ * arrays - names of unchanged Os are neither copied nor sorted.
+ */
+class ThingPrefixIndex
+{
+public:
+    struct Entry {
+        std::string name;
+        Thing* thing;
+        // O of N (the O itself for O entry)
+        const Outline* outline;
+    };
+
+private:
+    std::vector<Entry> outlineEntries;
+    std::vector<Entry> noteEntries;
+    OutlineChanges::Cursor cursor;
+
+public:
+    explicit ThingPrefixIndex();
+    ThingPrefixIndex(const ThingPrefixIndex&) = delete;
+    ThingPrefixIndex(const ThingPrefixIndex&&) = delete;
+    ThingPrefixIndex& operator=(const ThingPrefixIndex&) = delete;
+    ThingPrefixIndex& operator=(const ThingPrefixIndex&&) = delete;
+    ~ThingPrefixIndex();
+
+    /**
+     * @brief Reindex Os which changed since the last update.
+     *
+     * @return number of reindexed (incl. forgotten) Os.
+     */
+    size_t update(const std::vector<Outline*>& outlines, const OutlineChanges& changes);
+    void clear();
+
+    /**
+     * @brief Get range of O entries whose name starts w/ the prefix (case sensitive).
+     */
+    std::pair<const Entry*,const Entry*> outlines(const std::string& prefix) const {
+        return range(outlineEntries, prefix);
+    }
+    /**
+     * @brief Get range of N entries whose name starts w/ the prefix (case sensitive).
+     */
+    std::pair<const Entry*,const Entry*> notes(const std::string& prefix) const {
+        return range(noteEntries, prefix);
+    }
+
+    size_t size() const { return outlineEntries.size() + noteEntries.size(); }
+
+private:
+    static std::pair<const Entry*,const Entry*> range(const std::vector<Entry>& entries, const std::string& prefix);
+};
+
+} // m8r namespace
+
+#endif // M8R_THING_PREFIX_INDEX_H
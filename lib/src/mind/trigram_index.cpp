@@ -0,0 +1,354 @@
+/*
+ trigram_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "trigram_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+using namespace std;
+
+namespace m8r {
+
+constexpr size_t TrigramIndex::TRIGRAM_LENGTH;
+
+TrigramIndex::TrigramIndex()
+{
+}
+
+TrigramIndex::~TrigramIndex()
+{
+}
+
+void TrigramIndex::addTrigrams(const string& text, vector<uint32_t>& trigrams)
+{
+    if(text.size() < TRIGRAM_LENGTH) {
+        return;
+    }
+
+    // search lowers pattern using the same function
+    string s{};
+    s.reserve(text.size());
+    stringToLower(text, s);
+
+    const unsigned char* c = reinterpret_cast<const unsigned char*>(s.data());
+    uint32_t trigram = (static_cast<uint32_t>(c[0])<<8) | c[1];
+    for(size_t i=2; i<s.size(); i++) {
+        trigram = ((trigram<<8) | c[i]) & 0xFFFFFF;
+        trigrams.push_back(trigram);
+    }
+}
+
+void TrigramIndex::trigrams(const Outline* outline, vector<uint32_t>& trigrams)
+{
+    addTrigrams(outline->getName(), trigrams);
+    addTrigrams(outline->getDescription().getText(), trigrams);
+    for(const Note* n:outline->getNotes()) {
+        addTrigrams(n->getName(), trigrams);
+        addTrigrams(n->getDescription().getText(), trigrams);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void TrigramIndex::index(const Outline* outline)
+{
+    vector<uint32_t> t{};
+    trigrams(outline, t);
+    index(outline, std::move(t));
+}
+
+void TrigramIndex::index(const Outline* outline, vector<uint32_t>&& trigrams)
+{
+    forget(outline);
+
+    Document d{};
+    if(freeIds.size()) {
+        d.id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        d.id = static_cast<uint32_t>(outlines.size());
+        outlines.push_back(nullptr);
+    }
+    d.modified = outline->getModified();
+    d.revision = outline->getRevision();
+    d.trigrams = std::move(trigrams);
+    d.trigrams.shrink_to_fit();
+
+    // reused ID might be lower than IDs in the posting list
+    for(uint32_t t:d.trigrams) {
+        vector<uint32_t>& p = postings[t];
+        if(p.empty() || p.back() < d.id) {
+            p.push_back(d.id);
+        } else {
+            p.insert(std::lower_bound(p.begin(), p.end(), d.id), d.id);
+        }
+    }
+    outlines[d.id] = outline;
+    documents[outline] = std::move(d);
+}
+
+void TrigramIndex::forget(const Outline* outline)
+{
+    auto d = documents.find(outline);
+    if(d == documents.end()) {
+        return;
+    }
+
+    for(uint32_t t:d->second.trigrams) {
+        auto p = postings.find(t);
+        if(p != postings.end()) {
+            auto id = std::lower_bound(p->second.begin(), p->second.end(), d->second.id);
+            if(id != p->second.end() && *id == d->second.id) {
+                p->second.erase(id);
+            }
+            if(p->second.empty()) {
+                postings.erase(p);
+            }
+        }
+    }
+    outlines[d->second.id] = nullptr;
+    freeIds.push_back(d->second.id);
+    documents.erase(d);
+}
+
+void TrigramIndex::clear()
+{
+    documents.clear();
+    outlines.clear();
+    freeIds.clear();
+    postings.clear();
+}
+
+bool TrigramIndex::isCurrent(const Outline* outline) const
+{
+    auto d = documents.find(outline);
+    return d != documents.end()
+        && !outline->isDirty()
+        && d->second.modified == outline->getModified()
+        && d->second.revision == outline->getRevision();
+}
+
+bool TrigramIndex::candidates(const vector<string>& literals, unordered_set<const Outline*>& result) const
+{
+    vector<uint32_t> trigrams{};
+    for(const string& l:literals) {
+        addTrigrams(l, trigrams);
+    }
+    if(trigrams.empty()) {
+        return false;
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    vector<const vector<uint32_t>*> lists{};
+    for(uint32_t t:trigrams) {
+        auto p = postings.find(t);
+        if(p == postings.end()) {
+            // no indexed O contains the trigram
+            return true;
+        }
+        lists.push_back(&p->second);
+    }
+    // intersect the shortest lists first
+    std::sort(lists.begin(), lists.end(), [](const vector<uint32_t>* l, const vector<uint32_t>* r) {
+        return l->size() < r->size();
+    });
+
+    vector<uint32_t> ids{*lists[0]};
+    vector<uint32_t> intersection{};
+    for(size_t i=1; i<lists.size() && ids.size(); i++) {
+        intersection.clear();
+        std::set_intersection(
+            ids.begin(), ids.end(),
+            lists[i]->begin(), lists[i]->end(),
+            std::back_inserter(intersection));
+        ids.swap(intersection);
+    }
+
+    for(uint32_t id:ids) {
+        if(outlines[id]) {
+            result.insert(outlines[id]);
+        }
+    }
+    return true;
+}
+
+/*
+ * Regexp literals
+ */
+
+namespace {
+
+// skip quantifier (incl. lazy ?) at i
+void skipQuantifier(const string& regex, size_t& i)
+{
+    if(i < regex.size()) {
+        if(regex[i]=='*' || regex[i]=='+' || regex[i]=='?') {
+            i++;
+        } else if(regex[i]=='{') {
+            size_t end = regex.find('}', i);
+            i = end==string::npos ? regex.size() : end+1;
+        } else {
+            return;
+        }
+        if(i < regex.size() && regex[i]=='?') {
+            i++;
+        }
+    }
+}
+
+// skip character class starting at i ([)
+void skipClass(const string& regex, size_t& i)
+{
+    i++;
+    // ] right after [ or [^ is a literal
+    if(i < regex.size() && regex[i]=='^') i++;
+    if(i < regex.size() && regex[i]==']') i++;
+    while(i < regex.size() && regex[i]!=']') {
+        if(regex[i]=='\\') i++;
+        i++;
+    }
+    i++;
+}
+
+// skip escape sequence starting at i (\) which is not an identity escape
+void skipEscape(const string& regex, size_t& i)
+{
+    i++;
+    if(i < regex.size()) {
+        switch(regex[i]) {
+        case 'x':
+            i += 3;
+            break;
+        case 'u':
+            i += 5;
+            break;
+        case 'c':
+            i += 2;
+            break;
+        default:
+            // backreference
+            if(std::isdigit(static_cast<unsigned char>(regex[i]))) {
+                while(i < regex.size() && std::isdigit(static_cast<unsigned char>(regex[i]))) i++;
+            } else {
+                i++;
+            }
+        }
+    }
+    if(i > regex.size()) i = regex.size();
+}
+
+} // anonymous namespace
+
+void TrigramIndex::regexToLiterals(const string& regex, vector<string>& literals)
+{
+    vector<string> found{};
+    string literal{};
+    auto flush = [&]() {
+        if(literal.size() >= TRIGRAM_LENGTH) {
+            found.push_back(literal);
+        }
+        literal.clear();
+    };
+
+    size_t i = 0;
+    while(i < regex.size()) {
+        char c = regex[i];
+        switch(c) {
+        case '|':
+            // top level alternation > no literal is required
+            return;
+        case '(': {
+            flush();
+            int depth = 1;
+            i++;
+            while(i < regex.size() && depth) {
+                if(regex[i]=='\\') {
+                    i += 2;
+                } else if(regex[i]=='[') {
+                    skipClass(regex, i);
+                } else {
+                    if(regex[i]=='(') depth++;
+                    else if(regex[i]==')') depth--;
+                    i++;
+                }
+            }
+            skipQuantifier(regex, i);
+            continue;
+        }
+        case '[':
+            flush();
+            skipClass(regex, i);
+            skipQuantifier(regex, i);
+            continue;
+        case '\\':
+            if(i+1 < regex.size() && !std::isalnum(static_cast<unsigned char>(regex[i+1]))) {
+                // identity escape
+                c = regex[++i];
+                break;
+            }
+            flush();
+            skipEscape(regex, i);
+            skipQuantifier(regex, i);
+            continue;
+        case '.':
+        case '^':
+        case '$':
+            flush();
+            i++;
+            skipQuantifier(regex, i);
+            continue;
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            flush();
+            skipQuantifier(regex, i);
+            continue;
+        case ')':
+        case ']':
+        case '}':
+            flush();
+            i++;
+            continue;
+        default:
+            break;
+        }
+
+        // literal character
+        i++;
+        if(i < regex.size() && (regex[i]=='*' || regex[i]=='?' || regex[i]=='{')) {
+            // optional character
+            flush();
+            skipQuantifier(regex, i);
+            continue;
+        }
+        literal += c;
+        if(i < regex.size() && regex[i]=='+') {
+            flush();
+            skipQuantifier(regex, i);
+        }
+    }
+    flush();
+
+    literals.insert(literals.end(), found.begin(), found.end());
+}
+
+} // m8r namespace
@@ -0,0 +1,131 @@
+/*
+ trigram_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_TRIGRAM_INDEX_H
+#define M8R_TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../model/outline.h"
+
+namespace m8r {
+
+/**
+ * @brief Trigram inverted index of Outlines text.
+ *
+ * Index maps (lower case) trigrams of O name/description and Ns names/descriptions
+ * to posting lists of Os containing them. It's used to narrow the set of Os which
+ * must be scanned by full-text search: O can contain a literal only if it contains
+ * all literal's trigrams. Candidates are always verified by the search, therefore
+ * the index never changes search results.
+ *
+ * O is indexed when it is learned, remembered or searched (if it was modified
+ * since it has been indexed and it's not dirty i.e. being edited) - O which is not
+ * current in the index (not indexed, modified or dirty) must be always considered
+ * to be a candidate.
+ */
+class TrigramIndex
+{
+public:
+    /**
+     * @brief Literals shorter than trigram cannot be used to narrow candidates.
+     */
+    static constexpr size_t TRIGRAM_LENGTH = 3;
+
+private:
+    struct Document {
+        uint32_t id;
+        time_t modified;
+        uint32_t revision;
+        // sorted unique trigrams
+        std::vector<uint32_t> trigrams;
+    };
+
+    std::unordered_map<const Outline*,Document> documents;
+    // document ID to O (nullptr if O was forgotten/reindexed)
+    std::vector<const Outline*> outlines;
+    // IDs of forgotten documents to be reused
+    std::vector<uint32_t> freeIds;
+    // trigram to sorted document IDs
+    std::unordered_map<uint32_t,std::vector<uint32_t>> postings;
+
+public:
+    explicit TrigramIndex();
+    TrigramIndex(const TrigramIndex&) = delete;
+    TrigramIndex(const TrigramIndex&&) = delete;
+    TrigramIndex& operator=(const TrigramIndex&) = delete;
+    TrigramIndex& operator=(const TrigramIndex&&) = delete;
+    ~TrigramIndex();
+
+    /**
+     * @brief (Re)index O - Ns bodies must be in memory.
+     */
+    void index(const Outline* outline);
+    /**
+     * @brief (Re)index O using (persisted) sorted unique trigrams.
+     */
+    void index(const Outline* outline, std::vector<uint32_t>&& trigrams);
+    /**
+     * @brief Index O unless it's current.
+     */
+    void update(const Outline* outline) { if(!isCurrent(outline)) index(outline); }
+    void forget(const Outline* outline);
+    void clear();
+
+    /**
+     * @brief Check whether O is indexed and was not modified since then.
+     */
+    bool isCurrent(const Outline* outline) const;
+
+    /**
+     * @brief Find Os which may contain all given (case insensitive) literals.
+     *
+     * @return false if literals cannot narrow candidates (all Os are candidates).
+     */
+    bool candidates(const std::vector<std::string>& literals, std::unordered_set<const Outline*>& result) const;
+
+    /**
+     * @brief Get literals which must be present in every text matched by the regexp.
+     *
+     * Only literals in the top level sequence are extracted (top level alternation
+     * yields no literal) - groups, classes and optional characters are skipped.
+     */
+    static void regexToLiterals(const std::string& regex, std::vector<std::string>& literals);
+
+    size_t size() const { return documents.size(); }
+    /**
+     * @brief Get number of document IDs (incl. IDs of forgotten documents to be reused).
+     */
+    size_t getIdsCount() const { return outlines.size(); }
+
+    /**
+     * @brief Get sorted unique trigrams of O - Ns bodies must be in memory.
+     */
+    static void trigrams(const Outline* outline, std::vector<uint32_t>& trigrams);
+
+private:
+    static void addTrigrams(const std::string& text, std::vector<uint32_t>& trigrams);
+};
+
+} // m8r namespace
+
+#endif // M8R_TRIGRAM_INDEX_H
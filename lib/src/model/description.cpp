@@ -0,0 +1,101 @@
+/*
+ description.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "description.h"
+
+using namespace std;
+
+namespace m8r {
+
+string Description::toString(const string& separator) const
+{
+    if(separator == "\n") {
+        return text;
+    }
+
+    string result{};
+    result.reserve(text.size() + offsets.size()*separator.size());
+    for(DescriptionLine line:*this) {
+        result.append(line.data(), line.size());
+        result += separator;
+    }
+    return result;
+}
+
+void Description::addLine(const char* line, size_t size)
+{
+    offsets.push_back(static_cast<uint32_t>(text.size()));
+    text.append(line, size);
+    text += '\n';
+}
+
+void Description::addText(const string& t)
+{
+    size_t off = 0;
+    size_t eol;
+    while(off < t.size()) {
+        eol = t.find('\n', off);
+        if(eol == string::npos) {
+            eol = t.size();
+        }
+        addLine(t.data()+off, eol-off);
+        off = eol+1;
+    }
+}
+
+void Description::setLines(const vector<string*>& lines)
+{
+    clear();
+
+    size_t size = 0;
+    for(const string* line:lines) {
+        if(line) {
+            size += line->size()+1;
+        }
+    }
+    text.reserve(size);
+    offsets.reserve(lines.size());
+
+    for(const string* line:lines) {
+        if(line) {
+            addLine(*line);
+        }
+    }
+}
+
+void Description::toLines(vector<string*>& lines) const
+{
+    lines.reserve(lines.size()+offsets.size());
+    for(DescriptionLine line:*this) {
+        lines.push_back(new string{line.data(), line.size()});
+    }
+}
+
+void Description::clear()
+{
+    text.clear();
+    offsets.clear();
+}
+
+void Description::shrink()
+{
+    text.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
+
+} // m8r namespace
@@ -0,0 +1,152 @@
+/*
+ description.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_DESCRIPTION_H
+#define M8R_DESCRIPTION_H
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Read only view of a description line (w/o EOL).
+ *
+ * View is valid until the description it comes from is modified.
+ */
+class DescriptionLine
+{
+private:
+    const char* chars;
+    size_t length;
+
+public:
+    DescriptionLine(const char* chars, size_t length) : chars(chars), length(length) {}
+
+    const char* data() const { return chars; }
+    size_t size() const { return length; }
+    bool empty() const { return !length; }
+    char operator[](size_t i) const { return chars[i]; }
+    const char* begin() const { return chars; }
+    const char* end() const { return chars+length; }
+
+    std::string toString() const { return std::string{chars, length}; }
+
+    bool operator==(const std::string& s) const {
+        return s.size()==length && !memcmp(chars, s.data(), length);
+    }
+    bool operator!=(const std::string& s) const { return !(*this == s); }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const DescriptionLine& line)
+{
+    return os.write(line.data(), line.size());
+}
+
+/**
+ * @brief Description of Outline or Note - lines of Markdown.
+ *
+ * Lines are stored one after another (each of them terminated by EOL) in a single
+ * contiguous buffer which is indexed by offsets of line beginnings. Description
+ * costs two allocations regardless the number of lines and the whole text can be
+ * scanned at once. Lines are accessed through DescriptionLine views.
+ */
+class Description
+{
+public:
+    class const_iterator
+    {
+    private:
+        const Description* description;
+        size_t i;
+
+    public:
+        const_iterator(const Description* description, size_t i) : description(description), i(i) {}
+
+        DescriptionLine operator*() const { return (*description)[i]; }
+        const_iterator& operator++() { ++i; return *this; }
+        bool operator==(const const_iterator& o) const { return i==o.i; }
+        bool operator!=(const const_iterator& o) const { return i!=o.i; }
+    };
+
+private:
+    // all lines, each terminated by EOL
+    std::string text;
+    // offsets of line beginnings in text
+    std::vector<uint32_t> offsets;
+
+public:
+    explicit Description() {}
+    Description(const Description&) = default;
+    Description(Description&&) = default;
+    Description& operator=(const Description&) = default;
+    Description& operator=(Description&&) = default;
+    ~Description() = default;
+
+    size_t size() const { return offsets.size(); }
+    bool empty() const { return offsets.empty(); }
+    DescriptionLine operator[](size_t i) const {
+        size_t end = i+1 < offsets.size() ? offsets[i+1] : text.size();
+        return DescriptionLine{text.data()+offsets[i], end-offsets[i]-1};
+    }
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{this, offsets.size()}; }
+
+    /**
+     * @brief Get text of all lines - every line is terminated by EOL.
+     */
+    const std::string& getText() const { return text; }
+    /**
+     * @brief Get lines joined by given separator (which is appended also after the last line).
+     */
+    std::string toString(const std::string& separator) const;
+    /**
+     * @brief Get the number of bytes used by the description.
+     */
+    size_t getMemorySize() const { return text.capacity() + offsets.capacity()*sizeof(uint32_t); }
+
+    void addLine(const char* line, size_t size);
+    void addLine(const std::string& line) { addLine(line.data(), line.size()); }
+    /**
+     * @brief Append lines of Markdown text (split on EOLs).
+     */
+    void addText(const std::string& text);
+    /**
+     * @brief Replace lines - strings are copied i.e. they are still owned by the caller.
+     */
+    void setLines(const std::vector<std::string*>& lines);
+    /**
+     * @brief Copy lines to strings - caller is expected to destroy them.
+     */
+    void toLines(std::vector<std::string*>& lines) const;
+    void clear();
+    void swap(Description& d) { text.swap(d.text); offsets.swap(d.offsets); }
+    /**
+     * @brief Release unused capacity once the description is complete.
+     */
+    void shrink();
+};
+
+} // m8r namespace
+
+#endif // M8R_DESCRIPTION_H
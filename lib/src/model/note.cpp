@@ -22,6 +22,8 @@ using namespace std;
 
 namespace m8r {
 
+constexpr int Note::NO_FORGOTTEN_BODY;
+
 Note::Note(const NoteType* type, Outline* outline)
     : ThingInTime{},
       outline(outline),
@@ -37,7 +39,9 @@ Note::Note(const NoteType* type, Outline* outline)
       reads{},
       progress{},
       deadline{},
-      aiAaMatrixIndex{}
+      aiAaMatrixIndex{},
+      forgottenBodySection{NO_FORGOTTEN_BODY},
+      forgottenBodyBytesize{}
 {
 }
 
@@ -46,11 +50,7 @@ Note::Note(const Note& n)
 {
     name = n.name;
     autolinkName();
-    if(n.description.size()) {
-        for(string* s:n.description) {
-            description.push_back(new string(*s));
-        }
-    }
+    description = n.description;
 
     depth = n.depth;
     created = n.created;
@@ -62,6 +62,9 @@ Note::Note(const Note& n)
     progress = n.progress;
     // share old N's similarity assessment
     aiAaMatrixIndex = n.aiAaMatrixIndex;
+    // clone in the same O has the same body
+    forgottenBodySection = n.forgottenBodySection;
+    forgottenBodyBytesize = n.forgottenBodyBytesize;
 
     if(n.tags.size()) {
         tags.insert(tags.end(), n.tags.begin(), n.tags.end());
@@ -72,9 +75,6 @@ Note::Note(const Note& n)
 
 Note::~Note()
 {
-    for(string* d:description) {
-        delete d;
-    }
     for(Link* l:links) {
         delete l;
     }
@@ -284,49 +284,44 @@ void Note::clear()
     description.clear();
 }
 
-const vector<string*>& Note::getDescription() const
-{
-    return description;
-}
-
 string Note::getDescriptionAsString(const std::string& separator) const
 {    
-    // IMPROVE cache narrowed description for performance & return it by reference
-    string result{};
-    if(description.size()) {
-        for(string *s:description) {
-            result += *s;
-            result += separator;
-        }
-    }
-    return result;
+    return description.toString(separator);
 }
 
 void Note::setDescription(const vector<string*>& description)
 {
-    this->description = description;
+    this->description.setLines(description);
+    forgottenBodySection = NO_FORGOTTEN_BODY;
 }
 
-void Note::moveDescription(std::vector<std::string*>& target)
+void Note::moveDescription(Description& target)
 {
-    if(description.size()) {
-        // IMPROVE find a more efficient method - perhaps an algorithm function
-        for(auto& s:description) {
-            target.push_back(s);
-        }
-        description.clear();
-    }
+    target.clear();
+    target.swap(description);
 }
 
 void Note::clearDescription()
 {
     this->description.clear();
+    forgottenBodySection = NO_FORGOTTEN_BODY;
+}
+
+void Note::forgetBody(int section)
+{
+    // body which is already forgotten keeps its size
+    forgetBody(
+        section,
+        forgottenBodySection==NO_FORGOTTEN_BODY?description.getText().size():forgottenBodyBytesize);
 }
 
-void Note::addDescription(const vector<string*>& d)
+void Note::forgetBody(int section, size_t bytesize)
 {
-    // IMPROVE why not description.push_back(d);
-    description.insert(description.end(),d.begin(),d.end());
+    // completed N always has (at least empty) description line
+    description.clear();
+    description.addLine(std::string{});
+    forgottenBodySection = section;
+    forgottenBodyBytesize = bytesize?bytesize:description.getText().size();
 }
 
 Outline* Note::getOutline() const
@@ -348,13 +343,6 @@ string& Note::getOutlineKey() const
     }
 }
 
-void Note::addDescriptionLine(string *line)
-{
-    if(line) {
-        description.push_back(line);
-    }
-}
-
 void Note::setType(const NoteType* type)
 {
     this->type = type;
@@ -412,8 +400,9 @@ void Note::completeProperties(const time_t outlineModificationTime)
     }
 
     if(description.empty()) {
-        description.push_back(new string{""});
+        description.addLine(string{});
     }
+    description.shrink();
 
     checkAndFixProperties();
     setModifiedPretty();
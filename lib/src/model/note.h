@@ -28,6 +28,7 @@
 #include "note_type.h"
 #include "tag.h"
 #include "link.h"
+#include "description.h"
 #include "../exceptions.h"
 
 namespace m8r {
@@ -46,6 +47,9 @@ class Outline;
  */
 class Note : public ThingInTime
 {
+public:
+    static constexpr int NO_FORGOTTEN_BODY = -1;
+
 private:
     static constexpr int FLAG_MASK_POST_DECLARED_SECTION = 1;
     static constexpr int FLAG_MASK_TRAILING_HASHES_SECTION = 1<<1;
@@ -64,7 +68,7 @@ private:
     std::vector<const Tag*> tags;
     std::vector<Link*> links;
     const NoteType* type;
-    std::vector<std::string*> description;
+    Description description;
 
     std::string modifiedPretty;
     u_int32_t revision;
@@ -79,6 +83,10 @@ private:
      */
 
     int aiAaMatrixIndex;
+    // section of O's file w/ N body which was forgotten (header-only Memory)
+    int forgottenBodySection;
+    // size of forgotten body as description text (lines terminated by EOL)
+    size_t forgottenBodyBytesize;
 
 public:
     Note() = delete;
@@ -148,13 +156,26 @@ public:
     void addName(const std::string& s);
     const NoteType* getType() const;
     void setType(const NoteType* type);
-    const std::vector<std::string*>& getDescription() const;
+    const Description& getDescription() const { return description; }
     std::string getDescriptionAsString(const std::string& separator="\n") const;
+    void setDescription(const Description& description) {
+        this->description = description;
+        forgottenBodySection = NO_FORGOTTEN_BODY;
+    }
+    void setDescription(Description&& description) {
+        this->description = std::move(description);
+        forgottenBodySection = NO_FORGOTTEN_BODY;
+    }
+    /**
+     * @brief Set description lines - strings are copied i.e. they are still owned by the caller.
+     */
     void setDescription(const std::vector<std::string*>& description);
-    void moveDescription(std::vector<std::string*>& target);
+    /**
+     * @brief Move description to the target - N is left w/o description.
+     */
+    void moveDescription(Description& target);
     void clearDescription();
-    void addDescription(const std::vector<std::string*>& d);
-    void addDescriptionLine(std::string *line);
+    void addDescriptionLine(const std::string& line) { description.addLine(line); }
     Outline* getOutline() const;
     void setOutline(Outline* outline);
 
@@ -176,6 +197,27 @@ public:
 
     int getAiAaMatrixIndex() const { return aiAaMatrixIndex; }
     void setAiAaMatrixIndex(int i) { aiAaMatrixIndex = i; }
+
+    /**
+     * @brief Forget body (description) which is in given section of O's file.
+     *
+     * Section is the offset of N in O's file (which must be the same as in O),
+     * it identifies the body on recall even if N is renamed or moved meanwhile.
+     * Setting of description makes N to forget the section. Size of the body
+     * is kept so that N can be ranked w/o recall of the body.
+     */
+    void forgetBody(int section);
+    /**
+     * @brief Forget body of given size in bytes - body which was not parsed (header-only learn).
+     */
+    void forgetBody(int section, size_t bytesize);
+    int getForgottenBodySection() const { return forgottenBodySection; }
+    /**
+     * @brief Get size of description text in bytes - size of forgotten body if it was forgotten.
+     */
+    size_t getDescriptionBytesize() const {
+        return forgottenBodySection==NO_FORGOTTEN_BODY?description.getText().size():forgottenBodyBytesize;
+    }
 };
 
 } // m8r namespace
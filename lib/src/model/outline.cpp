@@ -62,6 +62,7 @@ void Outline::sortByRead(vector<Note*>& ns)
 Outline::Outline(const OutlineType* type)
     : ThingInTime{},
       memoryLocation(OutlineMemoryLocation::NORMAL),
+      keyId{StringInterner::NO_ID},
       flags{},
       format(MarkdownDocument::Format::MINDFORGER),
       preamble{},
@@ -80,14 +81,12 @@ Outline::Outline(const OutlineType* type)
       bytesize{},
       dirty{false},
       readOnly{false},
-      timeScope{}
+      timeScope{},
+      listener{nullptr}
 {
 }
 
 Outline::~Outline() {
-    for(string* d:description) {
-        delete d;
-    }
     for(string* d:preamble) {
         delete d;
     }
@@ -98,9 +97,7 @@ Outline::~Outline() {
         delete note;
     }
 
-    // description is shared between this outline and Note
     if(outlineDescriptorAsNote) {
-        outlineDescriptorAsNote->clear();
         delete outlineDescriptorAsNote;
     }
 }
@@ -120,6 +117,7 @@ void Outline::resetClonedOutline(Outline* o)
 Outline::Outline(const Outline& o)
     : ThingInTime{},
       memoryLocation(OutlineMemoryLocation::NORMAL),
+      keyId{StringInterner::NO_ID},
       flags{},
       format(o.format),
       preamble{},
@@ -138,18 +136,15 @@ Outline::Outline(const Outline& o)
       bytesize{},
       dirty{},
       readOnly{},
-      timeScope{}
+      timeScope{},
+      listener{nullptr}
 {
     key.clear();
 
     // IMPROVE i18n
     name = "Copy of " + o.name;
     autolinkName();
-    if(o.description.size()) {
-        for(string* s:o.description) {
-            description.push_back(new string(*s));
-        }
-    }
+    description = o.description;
     if(o.preamble.size()) {
         for(string* s:o.preamble) {
             preamble.push_back(new string(*s));
@@ -304,6 +299,7 @@ void Outline::notifyChange(Note* note)
     note->setModified(modified);
     note->setModifiedPretty(datetimeToPrettyHtml(modified));
     note->incRevision();
+    notifyListener();
 }
 
 void Outline::setImportance(int8_t importance)
@@ -324,6 +320,7 @@ string& Outline::getKey()
 void Outline::setKey(const string key)
 {
     this->key = key;
+    keyId = key.size()?Thing::getKeys().intern(key):StringInterner::NO_ID;
 }
 
 const Tag* Outline::getPrimaryTag() const
@@ -361,6 +358,7 @@ void Outline::makeModified()
     setModified();
     setModifiedPretty();
     incRevision();
+    notifyListener();
 }
 
 const string& Outline::getModifiedPretty() const
@@ -542,6 +540,7 @@ void Outline::addNote(Note* note)
 {
     note->setOutline(this);
     notes.push_back(note);
+    notifyListener();
 }
 
 void Outline::addNote(Note* note, int offset)
@@ -552,6 +551,7 @@ void Outline::addNote(Note* note, int offset)
     } else {
         notes.insert(notes.begin()+offset, note);
     }
+    notifyListener();
 }
 
 void Outline::addNotes(std::vector<Note*>& notesToAdd, int offset)
@@ -722,12 +722,14 @@ void Outline::removeNote(Note* note, bool deallocate)
                     delete note;
                 }
 
+                notifyListener();
                 return;
             }
         }
 
         // IMPROVE this iterates ALL Ns, but I know that I need to delete just 1st one
         notes.erase(std::remove(notes.begin(), notes.end(), note), notes.end());
+        notifyListener();
     }
 }
 
@@ -1037,34 +1039,14 @@ void Outline::setPreamble(const vector<string*>& preamble)
     this->preamble = preamble;
 }
 
-const vector<string*>& Outline::getDescription() const
-{
-    return description;
-}
-
 string Outline::getDescriptionAsString(const std::string& separator) const
 {
-    // IMPROVE cache narrowed description for performance
-    string result{};
-    if(description.size()) {
-        for(string *s:description) {
-            result += *s;
-            result += separator;
-        }
-    }
-    return result;
-}
-
-void Outline::addDescriptionLine(string *line)
-{
-    if(line) {
-        description.push_back(line);
-    }
+    return description.toString(separator);
 }
 
 void Outline::setDescription(const vector<string*>& description)
 {
-    this->description = description;
+    this->description.setLines(description);
 }
 
 void Outline::clearDescription()
@@ -1147,9 +1129,10 @@ void Outline::organizeToEisenhowerMatrix(
             if(Organizer::FilterBy::NOTES == organizer->getFilterBy()) {
                 Outline* scopeOrganizer{nullptr};
 
-                if(organizer->getOutlineScope().size()) {
+                StringInterner::Id scopeId = Thing::getKeys().find(organizer->getOutlineScope());
+                if(scopeId != StringInterner::NO_ID) {
                     for(auto* o:os) {
-                        if(o->getKey() == organizer->getOutlineScope()) {
+                        if(o->getKeyId() == scopeId) {
                             scopeOrganizer = o;
                             break;
                         }
@@ -1230,9 +1213,10 @@ void Outline::organizeToKanbanColumns(
         if(Organizer::FilterBy::NOTES == kanban->getFilterBy()) {
             Outline* scopeKanban{nullptr};
 
-            if(kanban->getOutlineScope().size()) {
+            StringInterner::Id scopeId = Thing::getKeys().find(kanban->getOutlineScope());
+            if(scopeId != StringInterner::NO_ID) {
                 for(auto* o:os) {
-                    if(o->getKey() == kanban->getOutlineScope()) {
+                    if(o->getKeyId() == scopeId) {
                         scopeKanban= o;
                         break;
                     }
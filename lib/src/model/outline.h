@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "../mind/ontology/thing_class_rel_triple.h"
+#include "description.h"
 #include "note.h"
 #include "outline_type.h"
 #include "eisenhower_matrix.h"
@@ -35,6 +36,17 @@
 namespace m8r {
 
 class Note;
+class Outline;
+
+/**
+ * @brief Listener of in-memory changes of Outline (modification, read, Ns added or removed).
+ */
+class OutlineListener
+{
+public:
+    virtual void onOutlineChanged(Outline* outline) = 0;
+    virtual ~OutlineListener() {}
+};
 
 enum class OutlineMemoryLocation {
     NORMAL,
@@ -112,8 +124,10 @@ private:
     /**
      * Outline path on the filesystem within the scope
      * of associated repository, can be used as ID.
+     *
+     * Key is interned (see Thing::getKeys()) and its ID allows fast equals.
      */
-    // IMPROVE make Key object w/ equals - std::string and sequence integer for fast equals
+    StringInterner::Id keyId;
 
     // various format, structure, semantic, ... flags (bit)
     int flags;
@@ -125,7 +139,7 @@ private:
     std::vector<const Tag*> tags;
     std::vector<Link*> links;
     const OutlineType* type;
-    std::vector<std::string*> description;
+    Description description;
 
     std::string modifiedPretty;
     u_int32_t revision;
@@ -165,6 +179,11 @@ private:
      */
     TimeScope timeScope;
 
+    /**
+     * @brief Listener of O changes (Memory which remembers the O).
+     */
+    OutlineListener* listener;
+
 public:
     Outline() = delete;
     explicit Outline(const OutlineType* type);
@@ -200,15 +219,24 @@ public:
 
     virtual std::string& getKey();
     void setKey(const std::string key);
+    /**
+     * @brief Get ID of the interned key (NO_ID if key is not set).
+     */
+    StringInterner::Id getKeyId() const { return keyId; }
     MarkdownDocument::Format getFormat() const { return format; }
     void setFormat(MarkdownDocument::Format format) { this->format = format; }
     const std::vector<std::string*>& getPreamble() const;
     std::string getPreambleAsString() const;
     void addPreambleLine(std::string *line);
     void setPreamble(const std::vector<std::string*>& preamble);
-    const std::vector<std::string*>& getDescription() const;
+    const Description& getDescription() const { return description; }
     std::string getDescriptionAsString(const std::string& separator="\n") const;
-    void addDescriptionLine(std::string *);
+    void addDescriptionLine(const std::string& line) { description.addLine(line); }
+    void setDescription(const Description& description) { this->description = description; }
+    void setDescription(Description&& description) { this->description = std::move(description); }
+    /**
+     * @brief Set description lines - strings are copied i.e. they are still owned by the caller.
+     */
     void setDescription(const std::vector<std::string*>& description);
     void clearDescription();
     int8_t getImportance() const;
@@ -241,7 +269,7 @@ public:
     u_int32_t getRevision() const;
     void setRevision(u_int32_t revision);
     void incRevision();
-    void incReads() { reads++; }
+    void incReads() { reads++; notifyListener(); }
     const OutlineType* getType() const;
     void setType(const OutlineType* type);
     int8_t getUrgency() const;
@@ -327,6 +355,10 @@ public:
     void moveNoteToLast(Note* note, Outline::Patch* patch=nullptr);
 
     Note* getOutlineDescriptorAsNote();
+    /**
+     * @brief Get N representing O as it was set by the last getOutlineDescriptorAsNote() (read only access).
+     */
+    Note* getOutlineDescriptorNote() const { return outlineDescriptorAsNote; }
     const NoteType* getOutlineDescriptorNoteType() const {
         return &NOTE_4_OUTLINE_TYPE;
     }
@@ -338,6 +370,8 @@ public:
     bool isReadOnly() const { return readOnly; }
     void setReadOnly(bool readOnly) { this->readOnly = readOnly; }
 
+    void setListener(OutlineListener* listener) { this->listener = listener; }
+
     /*
      * Links
      */
@@ -377,6 +411,8 @@ private:
 
     void resetClonedNote(Note* n);
     void resetClonedOutline(Outline* o);
+
+    void notifyListener() { if(listener) listener->onOutlineChanged(this); }
 };
 
 /**
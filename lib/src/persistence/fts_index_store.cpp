@@ -0,0 +1,558 @@
+/*
+ fts_index_store.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "fts_index_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "outline_cache.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr const char* FtsIndexStore::SEGMENT_MAGIC;
+constexpr const char* FtsIndexStore::MANIFEST_MAGIC;
+constexpr const char* FtsIndexStore::MANIFEST_FILENAME;
+constexpr uint32_t FtsIndexStore::VERSION;
+constexpr uint32_t FtsIndexStore::ENDIANNESS_MARK;
+constexpr size_t FtsIndexStore::MAX_SEGMENTS;
+
+/*
+ * Segment - numbers are stored in native byte order (checked by header):
+ *
+ *   header | trigram arrays (u32) | keys | directory (entries sorted by key)
+ */
+
+class FtsIndexStore::Segment
+{
+public:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianness;
+        uint64_t count;
+        uint64_t directoryOffset;
+        uint64_t keysOffset;
+        uint64_t keysSize;
+        uint64_t directoryHash;
+    };
+
+    struct Entry {
+        uint64_t keyOffset;
+        uint64_t trigramsOffset;
+        int64_t fileModified;
+        int64_t modified;
+        uint64_t hash;
+        uint32_t keyLength;
+        uint32_t trigramsCount;
+        uint32_t revision;
+        uint32_t removed;
+    };
+
+private:
+    std::string fileName;
+    filesystem::MappedFile file;
+    uint64_t count;
+    const char* directory;
+    const char* keys;
+    uint64_t keysSize;
+    bool valid;
+
+public:
+    explicit Segment(const std::string& fileName, const std::string& path)
+        : fileName(fileName),
+          file(path),
+          count(0),
+          directory(nullptr),
+          keys(nullptr),
+          keysSize(0),
+          valid(false)
+    {
+        const char* data = file.getData();
+        const uint64_t size = file.getSize();
+        Header h;
+        if(size < sizeof(Header)) {
+            return;
+        }
+        memcpy(&h, data, sizeof(Header));
+        if(memcmp(h.magic, SEGMENT_MAGIC, sizeof(h.magic))
+             ||
+           h.version != VERSION
+             ||
+           h.endianness != ENDIANNESS_MARK
+             ||
+           h.directoryOffset > size
+             ||
+           h.count > (size-h.directoryOffset)/sizeof(Entry)
+             ||
+           h.keysOffset > size
+             ||
+           h.keysSize > size-h.keysOffset)
+        {
+            MF_DEBUG("FTS index: unknown format or version of " << path << endl);
+            return;
+        }
+        if(OutlineCache::hash(data+h.directoryOffset, h.count*sizeof(Entry)) != h.directoryHash) {
+            MF_DEBUG("FTS index: corrupted directory of " << path << endl);
+            return;
+        }
+        count = h.count;
+        directory = data+h.directoryOffset;
+        keys = data+h.keysOffset;
+        keysSize = h.keysSize;
+        valid = true;
+    }
+    Segment(const Segment&) = delete;
+    Segment(const Segment&&) = delete;
+    Segment& operator=(const Segment&) = delete;
+    Segment& operator=(const Segment&&) = delete;
+    ~Segment() {}
+
+    const std::string& getFileName() const { return fileName; }
+    bool isValid() const { return valid; }
+    uint64_t size() const { return count; }
+
+    Entry entry(uint64_t i) const {
+        Entry e;
+        memcpy(&e, directory+i*sizeof(Entry), sizeof(Entry));
+        return e;
+    }
+
+    /**
+     * @brief Check entry bounds - directory is checksummed, but its values might be wrong.
+     */
+    bool isSound(const Entry& e) const {
+        return e.keyOffset <= keysSize
+            && e.keyLength <= keysSize-e.keyOffset
+            && e.trigramsOffset <= file.getSize()
+            && e.trigramsCount <= (file.getSize()-e.trigramsOffset)/sizeof(uint32_t);
+    }
+
+    std::string key(const Entry& e) const { return std::string{keys+e.keyOffset, e.keyLength}; }
+    const char* trigrams(const Entry& e) const { return file.getData()+e.trigramsOffset; }
+
+    /**
+     * @brief Binary search of the key - entry index or -1.
+     */
+    int64_t find(const std::string& key) const {
+        int64_t low = 0, high = static_cast<int64_t>(count)-1;
+        while(low <= high) {
+            int64_t middle = low + (high-low)/2;
+            Entry e = entry(static_cast<uint64_t>(middle));
+            if(!isSound(e)) {
+                return -1;
+            }
+            // byte order is the order of std::string
+            size_t common = std::min<size_t>(key.size(), e.keyLength);
+            int c = memcmp(key.data(), keys+e.keyOffset, common);
+            if(!c) {
+                c = key.size()<e.keyLength ? -1 : (key.size()>e.keyLength ? 1 : 0);
+            }
+            if(!c) {
+                return middle;
+            } else if(c < 0) {
+                high = middle-1;
+            } else {
+                low = middle+1;
+            }
+        }
+        return -1;
+    }
+};
+
+/*
+ * Store
+ */
+
+FtsIndexStore::FtsIndexStore()
+    : directory{},
+      generation{0},
+      writing{false}
+{
+}
+
+FtsIndexStore::~FtsIndexStore()
+{
+    close();
+}
+
+string FtsIndexStore::segmentPath(const string& fileName) const
+{
+    return directory + FILE_PATH_SEPARATOR + fileName;
+}
+
+string FtsIndexStore::newSegmentFileName()
+{
+    return "fts-" + std::to_string(generation++) + ".segment";
+}
+
+void FtsIndexStore::open(const string& directory)
+{
+    close();
+    this->directory = directory;
+
+    // manifest: magic & version, generation, segment file names (the oldest first)
+    ifstream is{segmentPath(MANIFEST_FILENAME)};
+    string line{};
+    if(!is || !getline(is, line) || line != string{MANIFEST_MAGIC} + " " + std::to_string(VERSION)) {
+        MF_DEBUG("FTS index: no usable manifest in " << directory << endl);
+        return;
+    }
+    if(getline(is, line)) {
+        generation = std::strtoull(line.c_str(), nullptr, 10);
+    }
+    lock_guard<mutex> criticalSection{segmentsMutex};
+    while(getline(is, line)) {
+        if(line.size()) {
+            shared_ptr<Segment> s{new Segment{line, segmentPath(line)}};
+            if(s->isValid()) {
+                segments.push_back(s);
+            }
+        }
+    }
+    MF_DEBUG("FTS index: " << segments.size() << " segment(s) opened in " << directory << endl);
+}
+
+void FtsIndexStore::close()
+{
+    if(isOpen()) {
+        flush();
+    }
+    waitForFlush();
+
+    lock_guard<mutex> criticalSection{segmentsMutex};
+    segments.clear();
+    delta.clear();
+    directory.clear();
+    generation = 0;
+}
+
+bool FtsIndexStore::lookup(
+        const Delta& delta,
+        const string& key,
+        const Stamp& stamp,
+        vector<uint32_t>& trigrams,
+        bool& found)
+{
+    auto d = delta.find(key);
+    if(d != delta.end()) {
+        found = true;
+        if(d->second.removed || !(d->second.stamp == stamp)) {
+            return false;
+        }
+        trigrams = d->second.trigrams;
+        return true;
+    }
+    found = false;
+    return false;
+}
+
+bool FtsIndexStore::lookup(const string& key, const Stamp& stamp, vector<uint32_t>& trigrams)
+{
+    bool found;
+    bool hit = lookup(delta, key, stamp, trigrams, found);
+    if(found) {
+        return hit;
+    }
+
+    // flushed delta is removed when its segment is added > snapshot is consistent
+    vector<shared_ptr<const Delta>> flushed{};
+    vector<shared_ptr<Segment>> snapshot{};
+    {
+        lock_guard<mutex> criticalSection{segmentsMutex};
+        flushed.assign(flushing.begin(), flushing.end());
+        snapshot = segments;
+    }
+    // the newest delta/segment wins
+    for(auto f=flushed.rbegin(); f!=flushed.rend(); ++f) {
+        hit = lookup(**f, key, stamp, trigrams, found);
+        if(found) {
+            return hit;
+        }
+    }
+    for(auto s=snapshot.rbegin(); s!=snapshot.rend(); ++s) {
+        int64_t i = (*s)->find(key);
+        if(i < 0) {
+            continue;
+        }
+        Segment::Entry e = (*s)->entry(static_cast<uint64_t>(i));
+        if(e.removed || !(Stamp{e.fileModified, e.modified, e.revision, e.hash} == stamp)) {
+            return false;
+        }
+        trigrams.resize(e.trigramsCount);
+        if(e.trigramsCount) {
+            memcpy(trigrams.data(), (*s)->trigrams(e), e.trigramsCount*sizeof(uint32_t));
+        }
+        return true;
+    }
+    return false;
+}
+
+void FtsIndexStore::put(const string& key, const Stamp& stamp, const vector<uint32_t>& trigrams)
+{
+    if(isOpen()) {
+        Change& c = delta[key];
+        c.stamp = stamp;
+        c.removed = false;
+        c.trigrams = trigrams;
+    }
+}
+
+void FtsIndexStore::remove(const string& key)
+{
+    if(isOpen()) {
+        Change& c = delta[key];
+        c.stamp = Stamp{0, 0, 0, 0};
+        c.removed = true;
+        c.trigrams.clear();
+    }
+}
+
+bool FtsIndexStore::writeSegment(const string& fileName, const vector<Record>& records) const
+{
+    // header is written last (offsets are known)
+    string bytes(sizeof(Segment::Header), 0);
+    vector<Segment::Entry> entries{};
+    entries.reserve(records.size());
+    for(const Record& r:records) {
+        Segment::Entry e{};
+        e.trigramsOffset = bytes.size();
+        e.trigramsCount = r.trigramsCount;
+        e.fileModified = r.stamp.fileModified;
+        e.modified = r.stamp.modified;
+        e.revision = r.stamp.revision;
+        e.hash = r.stamp.hash;
+        e.removed = r.removed?1:0;
+        bytes.append(r.trigrams, r.trigramsCount*sizeof(uint32_t));
+        entries.push_back(e);
+    }
+    Segment::Header h{};
+    memcpy(h.magic, SEGMENT_MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.endianness = ENDIANNESS_MARK;
+    h.count = records.size();
+    h.keysOffset = bytes.size();
+    for(size_t i=0; i<records.size(); i++) {
+        entries[i].keyOffset = bytes.size()-h.keysOffset;
+        entries[i].keyLength = static_cast<uint32_t>(records[i].key->size());
+        bytes.append(*records[i].key);
+    }
+    h.keysSize = bytes.size()-h.keysOffset;
+    h.directoryOffset = bytes.size();
+    if(entries.size()) {
+        bytes.append(reinterpret_cast<const char*>(entries.data()), entries.size()*sizeof(Segment::Entry));
+    }
+    h.directoryHash = OutlineCache::hash(bytes.data()+h.directoryOffset, entries.size()*sizeof(Segment::Entry));
+    memcpy(&bytes[0], &h, sizeof(h));
+
+    // write & rename so that the segment is never left half-written
+    string path{segmentPath(fileName)};
+    string tmpPath{path + ".tmp"};
+    ofstream os{tmpPath, ios::out | ios::binary | ios::trunc};
+    if(os) {
+        os.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+        os.close();
+        if(!os.fail() && !std::rename(tmpPath.c_str(), path.c_str())) {
+            return true;
+        }
+        std::remove(tmpPath.c_str());
+    }
+    MF_DEBUG("FTS index: unable to write segment " << path << endl);
+    return false;
+}
+
+bool FtsIndexStore::writeManifest()
+{
+    string path{segmentPath(MANIFEST_FILENAME)};
+    string tmpPath{path + ".tmp"};
+    ofstream os{tmpPath, ios::out | ios::trunc};
+    if(os) {
+        os << MANIFEST_MAGIC << " " << VERSION << "\n" << generation << "\n";
+        for(shared_ptr<Segment>& s:segments) {
+            os << s->getFileName() << "\n";
+        }
+        os.close();
+        if(!os.fail() && !std::rename(tmpPath.c_str(), path.c_str())) {
+            return true;
+        }
+        std::remove(tmpPath.c_str());
+    }
+    MF_DEBUG("FTS index: unable to write manifest " << path << endl);
+    return false;
+}
+
+bool FtsIndexStore::flush()
+{
+    if(!isOpen() || delta.empty()) {
+        return false;
+    }
+
+    shared_ptr<const Delta> flushed{new Delta{std::move(delta)}};
+    delta.clear();
+    lock_guard<mutex> criticalSection{segmentsMutex};
+    flushing.push_back(flushed);
+    if(!writing) {
+        writing = true;
+        writer = TaskExecutor::getInstance().submit(
+            [this]() { write(); },
+            TaskExecutor::Priority::LOW);
+    }
+    return true;
+}
+
+void FtsIndexStore::write()
+{
+    while(true) {
+        shared_ptr<const Delta> flushed{};
+        string fileName{};
+        {
+            lock_guard<mutex> criticalSection{segmentsMutex};
+            if(flushing.empty()) {
+                writing = false;
+                return;
+            }
+            flushed = flushing.front();
+            fileName = newSegmentFileName();
+        }
+
+        // delta is ordered by key
+        vector<Record> records{};
+        records.reserve(flushed->size());
+        for(auto& d:*flushed) {
+            records.push_back(Record{
+                &d.first,
+                d.second.stamp,
+                d.second.removed,
+                reinterpret_cast<const char*>(d.second.trigrams.data()),
+                static_cast<uint32_t>(d.second.trigrams.size())});
+        }
+        shared_ptr<Segment> segment{};
+        if(writeSegment(fileName, records)) {
+            segment.reset(new Segment{fileName, segmentPath(fileName)});
+            if(!segment->isValid()) {
+                std::remove(segmentPath(fileName).c_str());
+                segment.reset();
+            }
+        }
+
+        vector<shared_ptr<Segment>> merged{};
+        {
+            // delta which cannot be written is dropped - stamps w/ content hash keep older entries sound
+            lock_guard<mutex> criticalSection{segmentsMutex};
+            flushing.pop_front();
+            if(segment) {
+                segments.push_back(segment);
+                writeManifest();
+                if(segments.size() > MAX_SEGMENTS) {
+                    merged = segments;
+                }
+            }
+        }
+        MF_DEBUG("FTS index: delta of " << records.size() << " O(s) written to " << fileName << endl);
+
+        if(merged.size()) {
+            merge(merged);
+        }
+    }
+}
+
+void FtsIndexStore::merge(vector<shared_ptr<Segment>> merged)
+{
+    // the newest entry of the key wins - tombstones are dropped as there is no older segment
+    map<string,Record> latest{};
+    for(shared_ptr<Segment>& s:merged) {
+        for(uint64_t i=0; i<s->size(); i++) {
+            Segment::Entry e = s->entry(i);
+            if(s->isSound(e)) {
+                latest[s->key(e)] = Record{
+                    nullptr,
+                    Stamp{e.fileModified, e.modified, e.revision, e.hash},
+                    e.removed!=0,
+                    s->trigrams(e),
+                    e.trigramsCount};
+            }
+        }
+    }
+    vector<Record> records{};
+    for(auto& l:latest) {
+        if(!l.second.removed) {
+            l.second.key = &l.first;
+            records.push_back(l.second);
+        }
+    }
+
+    string fileName{};
+    {
+        lock_guard<mutex> criticalSection{segmentsMutex};
+        fileName = newSegmentFileName();
+    }
+    if(writeSegment(fileName, records)) {
+        shared_ptr<Segment> segment{new Segment{fileName, segmentPath(fileName)}};
+        if(segment->isValid()) {
+            {
+                // segments flushed while merging stay after the merged segment
+                lock_guard<mutex> criticalSection{segmentsMutex};
+                vector<shared_ptr<Segment>> remaining{segment};
+                for(shared_ptr<Segment>& s:segments) {
+                    if(std::find(merged.begin(), merged.end(), s) == merged.end()) {
+                        remaining.push_back(s);
+                    }
+                }
+                segments.swap(remaining);
+                writeManifest();
+            }
+            // mapped segments stay valid until the last reader releases them
+            for(shared_ptr<Segment>& s:merged) {
+                std::remove(segmentPath(s->getFileName()).c_str());
+            }
+            MF_DEBUG("FTS index: " << merged.size() << " segments merged to " << fileName << endl);
+        } else {
+            std::remove(segmentPath(fileName).c_str());
+        }
+    }
+}
+
+void FtsIndexStore::waitForFlush()
+{
+    if(writer) {
+        TaskExecutor::getInstance().wait(writer);
+        writer.reset();
+    }
+    // writer was skipped (executor is being destroyed) > flushed deltas are written by the calling thread
+    bool skipped;
+    {
+        lock_guard<mutex> criticalSection{segmentsMutex};
+        skipped = writing;
+    }
+    if(skipped) {
+        write();
+    }
+}
+
+size_t FtsIndexStore::getSegmentsCount()
+{
+    lock_guard<mutex> criticalSection{segmentsMutex};
+    return segments.size();
+}
+
+} // m8r namespace
@@ -0,0 +1,171 @@
+/*
+ fts_index_store.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_FTS_INDEX_STORE_H_
+#define M8R_FTS_INDEX_STORE_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../debug.h"
+#include "../gear/file_utils.h"
+#include "../gear/task_executor.h"
+
+namespace m8r {
+
+/**
+ * @brief Persistent FTS index - trigrams of Outlines keyed by Markdown file path.
+ *
+ * Index is stored in repository's mind/ directory as immutable segment files
+ * listed by a manifest. Segment has a header, trigram arrays, keys and a directory
+ * of fixed size entries sorted by key - segment is read through mmap() and it is
+ * searched in place, therefore opening the index costs only header checks.
+ *
+ * Changes (put/remove) are kept in a delta which is handed over to a low priority
+ * background task on flush() - the task writes it as a new segment, therefore
+ * saving of an O doesn't wait for I/O. Newer segment overrides older ones (removed O
+ * is a tombstone). When there are too many segments, they are merged to a single
+ * segment by the same task.
+ *
+ * Entry is used only if its stamp (file modification time and content hash,
+ * O modified and revision) is identical to the stamp of the learned O. Segment or manifest which cannot be
+ * used (older version, corrupted, ...) is silently ignored.
+ */
+class FtsIndexStore
+{
+public:
+    static constexpr const auto SEGMENT_MAGIC = "M8RFTSEG";
+    static constexpr const auto MANIFEST_MAGIC = "M8RFTSMF";
+    static constexpr const auto MANIFEST_FILENAME = "fts.manifest";
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t ENDIANNESS_MARK = 0x01020304;
+    // segments are merged in background when there are more of them
+    static constexpr size_t MAX_SEGMENTS = 8;
+
+    struct Stamp {
+        int64_t fileModified;
+        int64_t modified;
+        uint32_t revision;
+        uint64_t hash;
+
+        bool operator==(const Stamp& s) const {
+            return fileModified==s.fileModified && modified==s.modified && revision==s.revision && hash==s.hash;
+        }
+    };
+
+private:
+    class Segment;
+
+    struct Change {
+        Stamp stamp;
+        bool removed;
+        std::vector<uint32_t> trigrams;
+    };
+    typedef std::map<std::string,Change> Delta;
+
+    std::string directory;
+    // segment file names are never reused
+    uint64_t generation;
+
+    // guards segments list, manifest and flushed deltas
+    std::mutex segmentsMutex;
+    // the oldest segment first
+    std::vector<std::shared_ptr<Segment>> segments;
+
+    Delta delta;
+    // flushed deltas which are being written, the oldest first
+    std::deque<std::shared_ptr<const Delta>> flushing;
+    bool writing;
+    TaskExecutor::TaskHandle writer;
+
+public:
+    explicit FtsIndexStore();
+    FtsIndexStore(const FtsIndexStore&) = delete;
+    FtsIndexStore(const FtsIndexStore&&) = delete;
+    FtsIndexStore &operator=(const FtsIndexStore&) = delete;
+    FtsIndexStore &operator=(const FtsIndexStore&&) = delete;
+    ~FtsIndexStore();
+
+    /**
+     * @brief Open index in the directory - segments are mapped, but not read.
+     */
+    void open(const std::string& directory);
+    /**
+     * @brief Flush delta, wait for its write and merge and unmap segments.
+     */
+    void close();
+    bool isOpen() const { return !directory.empty(); }
+
+    /**
+     * @brief Get O trigrams if the index has an entry w/ the same stamp.
+     */
+    bool lookup(const std::string& key, const Stamp& stamp, std::vector<uint32_t>& trigrams);
+    void put(const std::string& key, const Stamp& stamp, const std::vector<uint32_t>& trigrams);
+    void remove(const std::string& key);
+
+    /**
+     * @brief Write delta as a new segment in background (and merge segments if there are too many).
+     *
+     * Flushed delta is looked up until its segment is written.
+     */
+    bool flush();
+    /**
+     * @brief Wait for background writes and merges of flushed deltas.
+     */
+    void waitForFlush();
+
+    size_t getSegmentsCount();
+    size_t getDeltaSize() const { return delta.size(); }
+
+private:
+    struct Record {
+        const std::string* key;
+        Stamp stamp;
+        bool removed;
+        const char* trigrams;
+        uint32_t trigramsCount;
+    };
+
+    std::string segmentPath(const std::string& fileName) const;
+    std::string newSegmentFileName();
+    bool writeSegment(const std::string& fileName, const std::vector<Record>& records) const;
+    bool writeManifest();
+    /**
+     * @brief Write flushed deltas as segments - run by background task until there is none.
+     */
+    void write();
+    void merge(std::vector<std::shared_ptr<Segment>> merged);
+    /**
+     * @brief Look up the key in delta - false if delta has no change of the key.
+     */
+    static bool lookup(
+            const Delta& delta,
+            const std::string& key,
+            const Stamp& stamp,
+            std::vector<uint32_t>& trigrams,
+            bool& found);
+};
+
+} // m8r namespace
+
+#endif /* M8R_FTS_INDEX_STORE_H_ */
@@ -0,0 +1,466 @@
+/*
+ outline_cache.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "outline_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace m8r {
+
+/*
+ * Binary (de)serialization primitives - cache is machine local, therefore
+ * numbers are stored in native byte order (checked by file header).
+ */
+
+class CacheWriter
+{
+private:
+    string& bytes;
+
+public:
+    explicit CacheWriter(string& bytes) : bytes(bytes) {}
+
+    template<typename T> void number(T n) {
+        bytes.append(reinterpret_cast<const char*>(&n), sizeof(T));
+    }
+    void str(const string& s) {
+        number<uint32_t>(static_cast<uint32_t>(s.size()));
+        bytes.append(s);
+    }
+    void lines(const vector<string*>& ls) {
+        number<uint32_t>(static_cast<uint32_t>(ls.size()));
+        for(const string* l:ls) {
+            str(*l);
+        }
+    }
+    // same format as lines
+    void description(const Description& d) {
+        number<uint32_t>(static_cast<uint32_t>(d.size()));
+        for(DescriptionLine l:d) {
+            number<uint32_t>(static_cast<uint32_t>(l.size()));
+            bytes.append(l.data(), l.size());
+        }
+    }
+    void tags(const vector<const Tag*>* ts) {
+        number<uint32_t>(static_cast<uint32_t>(ts->size()));
+        for(const Tag* t:*ts) {
+            str(t->getName());
+        }
+    }
+    void links(const vector<Link*>& ls) {
+        number<uint32_t>(static_cast<uint32_t>(ls.size()));
+        for(Link* l:ls) {
+            str(l->getName());
+            str(l->getUrl());
+        }
+    }
+};
+
+class CacheReader
+{
+private:
+    const char* p;
+    const char* end;
+
+public:
+    explicit CacheReader(const char* bytes, size_t size) : p(bytes), end(bytes+size) {}
+
+    bool eof() const { return p==end; }
+    const char* bytes(size_t size) {
+        if(static_cast<size_t>(end-p) < size) {
+            throw MindForgerException{"Outline cache: unexpected end of data"};
+        }
+        const char* result = p;
+        p += size;
+        return result;
+    }
+    template<typename T> T number() {
+        T n;
+        memcpy(&n, bytes(sizeof(T)), sizeof(T));
+        return n;
+    }
+    string str() {
+        uint32_t size = number<uint32_t>();
+        return string{bytes(size), size};
+    }
+    void lines(vector<string*>& ls) {
+        uint32_t count = number<uint32_t>();
+        for(uint32_t i=0; i<count; i++) {
+            ls.push_back(new string{str()});
+        }
+    }
+    void description(Description& d) {
+        uint32_t count = number<uint32_t>();
+        for(uint32_t i=0; i<count; i++) {
+            uint32_t size = number<uint32_t>();
+            d.addLine(bytes(size), size);
+        }
+        d.shrink();
+    }
+    void skipDescription() {
+        uint32_t count = number<uint32_t>();
+        for(uint32_t i=0; i<count; i++) {
+            bytes(number<uint32_t>());
+        }
+    }
+};
+
+/*
+ * OutlineCache
+ */
+
+constexpr const char* OutlineCache::MAGIC;
+constexpr uint32_t OutlineCache::VERSION;
+constexpr uint32_t OutlineCache::ENDIANNESS_MARK;
+
+OutlineCache::OutlineCache(Ontology& ontology)
+    : ontology(ontology),
+      filePath{},
+      noteBodies{true},
+      entries{},
+      learned{},
+      dirty{false}
+{
+}
+
+OutlineCache::~OutlineCache()
+{
+}
+
+void OutlineCache::clear()
+{
+    filePath.clear();
+    entries.clear();
+    learned.clear();
+    dirty = false;
+}
+
+void OutlineCache::load(const string& cacheFilePath, bool noteBodies)
+{
+    clear();
+    filePath = cacheFilePath;
+    this->noteBodies = noteBodies;
+
+    if(isFile(filePath.c_str())) {
+        filesystem::MappedFile file{filePath};
+        CacheReader in{file.getData(), file.getSize()};
+        try {
+            if(memcmp(in.bytes(strlen(MAGIC)), MAGIC, strlen(MAGIC))
+                 ||
+               in.number<uint32_t>() != VERSION
+                 ||
+               in.number<uint32_t>() != ENDIANNESS_MARK)
+            {
+                MF_DEBUG("Outline cache: unknown format or version of " << filePath << endl);
+                return;
+            }
+            uint64_t count = in.number<uint64_t>();
+            for(uint64_t i=0; i<count; i++) {
+                string path{in.str()};
+                Entry e{};
+                e.size = in.number<uint64_t>();
+                e.modified = in.number<int64_t>();
+                e.hash = in.number<uint64_t>();
+                e.bodies = in.number<uint8_t>();
+                e.data = in.str();
+                if(in.number<uint64_t>() != hash(e.data.data(), e.data.size())) {
+                    throw MindForgerException{"Outline cache: corrupted entry " + path};
+                }
+                entries[path] = std::move(e);
+            }
+            if(!in.eof()) {
+                throw MindForgerException{"Outline cache: trailing data"};
+            }
+        } catch(MindForgerException& e) {
+            MF_DEBUG(e.what() << " > ignoring cache " << filePath << endl);
+            entries.clear();
+        }
+    }
+}
+
+bool OutlineCache::save()
+{
+    // rewrite cache if an O was (re)parsed or a cached O was not used (file deleted)
+    if(filePath.empty() || (!dirty && entries.empty())) {
+        return false;
+    }
+
+    string bytes{MAGIC};
+    CacheWriter out{bytes};
+    out.number<uint32_t>(VERSION);
+    out.number<uint32_t>(ENDIANNESS_MARK);
+    out.number<uint64_t>(learned.size());
+    for(auto& l:learned) {
+        out.str(l.first);
+        out.number<uint64_t>(l.second.size);
+        out.number<int64_t>(l.second.modified);
+        out.number<uint64_t>(l.second.hash);
+        out.number<uint8_t>(l.second.bodies);
+        out.str(l.second.data);
+        out.number<uint64_t>(hash(l.second.data.data(), l.second.data.size()));
+    }
+
+    // write & rename so that the cache is never left half-written
+    string tmpFilePath{filePath + ".tmp"};
+    ofstream os{tmpFilePath, ios::out | ios::binary | ios::trunc};
+    if(os) {
+        os.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+        os.close();
+        if(!os.fail() && !std::rename(tmpFilePath.c_str(), filePath.c_str())) {
+            MF_DEBUG("Outline cache: " << learned.size() << " Os saved to " << filePath << endl);
+            dirty = false;
+            return true;
+        }
+        std::remove(tmpFilePath.c_str());
+    }
+    MF_DEBUG("Outline cache: unable to save " << filePath << endl);
+    return false;
+}
+
+bool OutlineCache::isFresh(const string& markdownFilePath) const
+{
+    auto e = entries.find(markdownFilePath);
+    if(e != entries.end()
+         &&
+       (e->second.bodies || !noteBodies)
+         &&
+       e->second.modified == static_cast<int64_t>(fileModificationTime(&markdownFilePath)))
+    {
+        // Markdown might be written by external editor meanwhile > not mapped
+        filesystem::MappedFile file{markdownFilePath, false};
+        return e->second.size == file.getSize()
+               &&
+               e->second.hash == hash(file.getData(), file.getSize());
+    }
+    return false;
+}
+
+Outline* OutlineCache::outline(const string& markdownFilePath)
+{
+    auto e = entries.find(markdownFilePath);
+    if(e != entries.end()) {
+        try {
+            Outline* o = fromBytes(e->second.data, markdownFilePath, noteBodies);
+            learned[markdownFilePath] = std::move(e->second);
+            entries.erase(e);
+            return o;
+        } catch(MindForgerException& ex) {
+            MF_DEBUG(ex.what() << " > parsing " << markdownFilePath << endl);
+            entries.erase(e);
+            dirty = true;
+        }
+    }
+    return nullptr;
+}
+
+bool OutlineCache::getHash(const string& markdownFilePath, time_t modified, uint64_t& hash) const
+{
+    auto e = learned.find(markdownFilePath);
+    if(e != learned.end() && e->second.modified == static_cast<int64_t>(modified)) {
+        hash = e->second.hash;
+        return true;
+    }
+    return false;
+}
+
+void OutlineCache::remember(
+        const string& markdownFilePath,
+        time_t modified,
+        size_t size,
+        uint64_t hash,
+        Outline* outline)
+{
+    if(filePath.size() && outline) {
+        Entry e{};
+        e.size = size;
+        e.modified = static_cast<int64_t>(modified);
+        e.hash = hash;
+        e.bodies = noteBodies;
+        toBytes(outline, e.data);
+        learned[markdownFilePath] = std::move(e);
+        entries.erase(markdownFilePath);
+        dirty = true;
+    }
+}
+
+void OutlineCache::toBytes(Outline* o, string& bytes) const
+{
+    CacheWriter out{bytes};
+
+    out.number<int8_t>(static_cast<int8_t>(o->getFormat()));
+    out.number<uint8_t>(o->isPostDeclaredSection() | o->isTrailingHashesSection()<<1);
+    out.str(o->getName());
+    out.str(o->getType()->getName());
+    out.lines(o->getPreamble());
+    out.description(o->getDescription());
+    out.number<int64_t>(o->getCreated());
+    out.number<int64_t>(o->getModified());
+    out.number<int64_t>(o->getRead());
+    out.number<uint32_t>(o->getRevision());
+    out.number<uint32_t>(o->getReads());
+    out.number<int8_t>(o->getImportance());
+    out.number<int8_t>(o->getUrgency());
+    out.number<int8_t>(o->getProgress());
+    const TimeScope& ts = o->getTimeScope();
+    out.number<uint8_t>(ts.years);
+    out.number<uint8_t>(ts.months);
+    out.number<uint8_t>(ts.days);
+    out.number<uint8_t>(ts.hours);
+    out.number<uint8_t>(ts.minutes);
+    out.number<int32_t>(ts.relativeSecs);
+    out.number<uint32_t>(o->getBytesize());
+    out.tags(o->getTags());
+    out.links(o->getLinks());
+
+    out.number<uint32_t>(static_cast<uint32_t>(o->getNotes().size()));
+    for(Note* n:o->getNotes()) {
+        out.number<uint8_t>(n->isPostDeclaredSection() | n->isTrailingHashesSection()<<1);
+        out.str(n->getName());
+        out.str(n->getType()->getName());
+        out.number<uint16_t>(n->getDepth());
+        out.description(n->getDescription());
+        // body size is known also for Ns w/ forgotten bodies
+        out.number<uint32_t>(static_cast<uint32_t>(n->getDescriptionBytesize()));
+        out.number<int64_t>(n->getCreated());
+        out.number<int64_t>(n->getModified());
+        out.number<int64_t>(n->getRead());
+        out.number<int64_t>(n->getDeadline());
+        out.number<uint32_t>(n->getRevision());
+        out.number<uint32_t>(n->getReads());
+        out.number<uint8_t>(n->getProgress());
+        out.tags(n->getTags());
+        out.links(n->getLinks());
+    }
+}
+
+Outline* OutlineCache::fromBytes(const string& bytes, const string& key, bool noteBodies)
+{
+    CacheReader in{bytes.data(), bytes.size()};
+    Outline* o = new Outline{ontology.getDefaultOutlineType()};
+    vector<string*> lines{};
+    try {
+        o->setKey(key);
+        o->setFormat(static_cast<MarkdownDocument::Format>(in.number<int8_t>()));
+        uint8_t flags = in.number<uint8_t>();
+        if(flags & 1) o->setPostDeclaredSection();
+        if(flags & 1<<1) o->setTrailingHashesSection();
+        o->setName(in.str());
+        const OutlineType* outlineType = ontology.getOutlineTypes().get(in.str());
+        if(outlineType) {
+            o->setType(outlineType);
+        }
+        in.lines(lines);
+        o->setPreamble(lines);
+        lines.clear();
+        Description description{};
+        in.description(description);
+        o->setDescription(std::move(description));
+        o->setCreated(in.number<int64_t>());
+        o->setModified(in.number<int64_t>());
+        o->setRead(in.number<int64_t>());
+        o->setRevision(in.number<uint32_t>());
+        o->setReads(in.number<uint32_t>());
+        o->setImportance(in.number<int8_t>());
+        o->setUrgency(in.number<int8_t>());
+        o->setProgress(in.number<int8_t>());
+        TimeScope ts{};
+        ts.years = in.number<uint8_t>();
+        ts.months = in.number<uint8_t>();
+        ts.days = in.number<uint8_t>();
+        ts.hours = in.number<uint8_t>();
+        ts.minutes = in.number<uint8_t>();
+        ts.relativeSecs = in.number<int32_t>();
+        if(ts.relativeSecs) {
+            o->setTimeScope(ts);
+        }
+        o->setBytesize(in.number<uint32_t>());
+        uint32_t count = in.number<uint32_t>();
+        for(uint32_t i=0; i<count; i++) {
+            o->addTag(ontology.findOrCreateTag(in.str()));
+        }
+        count = in.number<uint32_t>();
+        for(uint32_t i=0; i<count; i++) {
+            string name{in.str()};
+            o->addLink(new Link{name, in.str()});
+        }
+
+        uint32_t notesCount = in.number<uint32_t>();
+        for(uint32_t n=0; n<notesCount; n++) {
+            Note* note = new Note{ontology.getDefaultNoteType(), o};
+            o->addNote(note);
+            flags = in.number<uint8_t>();
+            if(flags & 1) note->setPostDeclaredSection();
+            if(flags & 1<<1) note->setTrailingHashesSection();
+            note->setName(in.str());
+            const NoteType* noteType = ontology.getNoteTypes().get(in.str());
+            if(noteType) {
+                note->setType(noteType);
+            }
+            note->setDepth(in.number<uint16_t>());
+            if(noteBodies) {
+                description.clear();
+                in.description(description);
+                note->setDescription(std::move(description));
+                in.number<uint32_t>();
+            } else {
+                // N body is loaded from Markdown file on recall
+                in.skipDescription();
+                note->forgetBody(static_cast<int>(n), in.number<uint32_t>());
+            }
+            note->setCreated(in.number<int64_t>());
+            note->setModified(in.number<int64_t>());
+            note->setRead(in.number<int64_t>());
+            note->setDeadline(in.number<int64_t>());
+            note->setRevision(in.number<uint32_t>());
+            note->setReads(in.number<uint32_t>());
+            note->setProgress(in.number<uint8_t>());
+            count = in.number<uint32_t>();
+            for(uint32_t i=0; i<count; i++) {
+                note->addTag(ontology.findOrCreateTag(in.str()));
+            }
+            count = in.number<uint32_t>();
+            for(uint32_t i=0; i<count; i++) {
+                string name{in.str()};
+                note->addLink(new Link{name, in.str()});
+            }
+            note->setModifiedPretty();
+            note->setReadPretty();
+        }
+        if(!in.eof()) {
+            throw MindForgerException{"Outline cache: trailing data in " + key};
+        }
+    } catch(MindForgerException&) {
+        for(string* l:lines) {
+            delete l;
+        }
+        delete o;
+        throw;
+    }
+
+    // same as completed properties of a parsed O (some of them are time dependent)
+    o->checkAndFixProperties();
+    o->setModifiedPretty(datetimeToPrettyHtml(o->getModified()));
+
+    return o;
+}
+
+} // m8r namespace
@@ -0,0 +1,142 @@
+/*
+ outline_cache.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_OUTLINE_CACHE_H_
+#define M8R_OUTLINE_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "../debug.h"
+#include "../exceptions.h"
+#include "../gear/file_utils.h"
+#include "../mind/ontology/ontology.h"
+#include "../model/outline.h"
+
+namespace m8r {
+
+/**
+ * @brief Binary cache of parsed Outlines.
+ *
+ * Cache file is stored in repository's mind/ directory and it keeps serialized
+ * Outlines and Notes (as created by the Markdown representation) keyed by Markdown
+ * file path. Entry is used only if file size, modification time and content hash
+ * did not change since the Outline was cached - unchanged files are deserialized
+ * instead of being lexed and parsed again.
+ *
+ * Cache file has magic, version and byte order header and every entry is protected
+ * by a checksum - cache file which cannot be used (older version, corrupted, ...) is
+ * silently ignored and Outlines are parsed from Markdown files.
+ *
+ * Cache is loaded for the memory mode: when Ns bodies are not kept in memory
+ * (header-only learn), Outlines are cached w/o Ns bodies and Ns bodies of cached
+ * Outlines are skipped on deserialization - only their sizes are kept (ranking).
+ * Entries w/o Ns bodies are not fresh when the cache is loaded with bodies.
+ *
+ * Freshness checks are read only and can be run in parallel, (de)serialization
+ * modifies the ontology (tags, types) and must be done by a single thread.
+ */
+class OutlineCache
+{
+public:
+    static constexpr const auto MAGIC = "M8ROCACH";
+    static constexpr uint32_t VERSION = 3;
+    static constexpr uint32_t ENDIANNESS_MARK = 0x01020304;
+
+    /**
+     * @brief FNV-1a 64b hash of bytes.
+     */
+    static uint64_t hash(const char* bytes, size_t size) { return bytesHash(bytes, size); }
+
+private:
+    struct Entry {
+        uint64_t size;
+        int64_t modified;
+        uint64_t hash;
+        // serialized w/ Ns bodies
+        bool bodies;
+        std::string data;
+    };
+
+    Ontology& ontology;
+
+    std::string filePath;
+    // Ns bodies are (de)serialized
+    bool noteBodies;
+    // entries loaded from the cache file
+    std::map<std::string,Entry> entries;
+    // entries to be written to the cache file on save
+    std::map<std::string,Entry> learned;
+    bool dirty;
+
+public:
+    explicit OutlineCache(Ontology& ontology);
+    OutlineCache(const OutlineCache&) = delete;
+    OutlineCache(const OutlineCache&&) = delete;
+    OutlineCache &operator=(const OutlineCache&) = delete;
+    OutlineCache &operator=(const OutlineCache&&) = delete;
+    ~OutlineCache();
+
+    /**
+     * @brief Load cache file - entries are dropped if the file is missing, corrupted or of other version.
+     *
+     * Cached Outlines are learned w/ or w/o Ns bodies as specified.
+     */
+    void load(const std::string& cacheFilePath, bool noteBodies=true);
+    /**
+     * @brief Write learned entries to the cache file (if any of them changed).
+     */
+    bool save();
+    void clear();
+
+    const std::string& getFilePath() const { return filePath; }
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Check whether file has a cached Outline and whether the file did not change since then.
+     */
+    bool isFresh(const std::string& markdownFilePath) const;
+    /**
+     * @brief Deserialize cached Outline - nullptr is returned if it cannot be deserialized.
+     */
+    Outline* outline(const std::string& markdownFilePath);
+    /**
+     * @brief Get content hash of the learned Outline's file if the file wasn't modified since then.
+     */
+    bool getHash(const std::string& markdownFilePath, time_t modified, uint64_t& hash) const;
+    /**
+     * @brief Serialize Outline which was just parsed from the Markdown file.
+     *
+     * Size and hash must be of the parsed bytes - file might be changed since then.
+     */
+    void remember(
+            const std::string& markdownFilePath,
+            time_t modified,
+            size_t size,
+            uint64_t hash,
+            Outline* outline);
+
+private:
+    void toBytes(Outline* outline, std::string& bytes) const;
+    Outline* fromBytes(const std::string& bytes, const std::string& key, bool noteBodies);
+};
+
+} // m8r namespace
+
+#endif /* M8R_OUTLINE_CACHE_H_ */
@@ -18,13 +18,18 @@
  */
 #include "repository_indexer.h"
 
+#ifdef __linux__
+    #include <sys/inotify.h>
+#endif
+
 using namespace std;
 using namespace m8r::filesystem;
 
 namespace m8r {
 
 RepositoryIndexer::RepositoryIndexer()
-    : repository(nullptr)
+    : repository(nullptr),
+      watchFd(-1)
 {}
 
 RepositoryIndexer::~RepositoryIndexer() {
@@ -33,6 +38,8 @@ RepositoryIndexer::~RepositoryIndexer() {
 
 void RepositoryIndexer::clear()
 {
+    unwatch();
+
     repository = nullptr;
 
     for(const string* f:allFiles) {
@@ -42,6 +49,7 @@ void RepositoryIndexer::clear()
 
     // markdowns (strings were cleared as a part of allFiles strings)
     markdowns.clear();
+    markdownsByPath.clear();
     // txt
     texts.clear();
     // PDFs
@@ -150,6 +158,7 @@ void RepositoryIndexer::updateIndexMemory(const string& directory)
                         allFiles.insert(ppath);
                         if(File::fileHasMarkdownExtension(*ppath)) {
                             markdowns.insert(ppath);
+                            markdownsByPath[*ppath] = ppath;
                         } else if(File::fileHasPdfExtension(*ppath)) {
                             pdfs.insert(ppath);
                         } else if(File::fileHasTextExtension(*ppath)) {
@@ -169,6 +178,7 @@ void RepositoryIndexer::updateIndexMemory(const string& directory)
             allFiles.insert(path);
             if(File::fileHasMarkdownExtension(*path)) {
                 markdowns.insert(path);
+                markdownsByPath[*path] = path;
             }
         }
     }
@@ -198,6 +208,311 @@ void RepositoryIndexer::updateIndexStencils(const string& directory, set<const s
     }
 }
 
+/*
+ * Watcher
+ */
+
+bool RepositoryIndexer::watch()
+{
+    unwatch();
+#ifdef __linux__
+    if(repository) {
+        watchFd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+        if(watchFd >= 0) {
+            if(repository->getMode() == Repository::RepositoryMode::REPOSITORY) {
+                watchDirectory(memoryDirectory, true);
+            } else {
+                watchDirectory(repository->getDir(), false);
+            }
+        }
+        if(watchDirectories.empty()) {
+            MF_DEBUG("Watcher: unable to watch repository " << repository->getDir() << endl);
+            unwatch();
+        }
+    }
+#endif
+    return isWatching();
+}
+
+void RepositoryIndexer::unwatch()
+{
+    if(watchFd >= 0) {
+        // closing the descriptor removes all its watches
+        close(watchFd);
+        watchFd = -1;
+    }
+    watchDirectories.clear();
+    pendingChanges.clear();
+    ownWrites.clear();
+}
+
+void RepositoryIndexer::watchDirectory(const string& directory, bool recursive)
+{
+#ifdef __linux__
+    int wd = inotify_add_watch(
+        watchFd,
+        directory.c_str(),
+        IN_CLOSE_WRITE|IN_MODIFY|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_ONLYDIR);
+    if(wd < 0) {
+        MF_DEBUG("Watcher: unable to watch " << directory << endl);
+        return;
+    }
+    watchDirectories[wd] = directory;
+
+    if(recursive) {
+        DIR* dir;
+        if((dir = opendir(directory.c_str()))) {
+            const struct dirent* entry;
+            string path;
+            while((entry = readdir(dir))) {
+                if(entry->d_type == DT_DIR
+                     &&
+                   strcmp(entry->d_name, ".")
+                     &&
+                   strcmp(entry->d_name, ".."))
+                {
+                    path.assign(directory);
+                    path += FILE_PATH_SEPARATOR;
+                    path += entry->d_name;
+                    watchDirectory(path, true);
+                }
+            }
+            closedir(dir);
+        }
+    }
+#else
+    UNUSED_ARG(directory);
+    UNUSED_ARG(recursive);
+#endif
+}
+
+void RepositoryIndexer::readWatchEvents()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+    while((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+        for(char* p = buffer; p < buffer+length; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event)+event->len;
+
+            if(event->mask & IN_Q_OVERFLOW) {
+                MF_DEBUG("Watcher: events queue overflow > checking all files" << endl);
+                pendDirectoryChanges(
+                    repository->getMode()==Repository::RepositoryMode::REPOSITORY
+                    ?memoryDirectory:repository->getDir());
+                for(const string* m:markdowns) {
+                    pendChange(*m);
+                }
+                continue;
+            }
+
+            auto directory = watchDirectories.find(event->wd);
+            if(directory == watchDirectories.end()) {
+                continue;
+            }
+            if(event->mask & IN_IGNORED) {
+                watchDirectories.erase(directory);
+                continue;
+            }
+            if(!event->len) {
+                continue;
+            }
+
+            string path{directory->second};
+            path += FILE_PATH_SEPARATOR;
+            path += event->name;
+            if(event->mask & IN_ISDIR) {
+                if(repository->getMode() == Repository::RepositoryMode::REPOSITORY) {
+                    if(event->mask & (IN_CREATE|IN_MOVED_TO)) {
+                        // files might be created before the directory is watched
+                        watchDirectory(path, true);
+                        pendDirectoryChanges(path);
+                    } else if(event->mask & (IN_DELETE|IN_MOVED_FROM)) {
+                        string prefix{path};
+                        prefix += FILE_PATH_SEPARATOR;
+                        for(auto w=watchDirectories.begin(); w!=watchDirectories.end(); ) {
+                            if(w->second == path || stringStartsWith(w->second, prefix)) {
+                                inotify_rm_watch(watchFd, w->first);
+                                w = watchDirectories.erase(w);
+                            } else {
+                                ++w;
+                            }
+                        }
+                        for(const string* m:markdowns) {
+                            if(stringStartsWith(*m, prefix)) {
+                                pendChange(*m);
+                            }
+                        }
+                    }
+                }
+            } else if(isWatchedFile(path)) {
+                pendChange(path);
+            }
+        }
+    }
+#endif
+}
+
+void RepositoryIndexer::pendChange(const string& path)
+{
+    auto now = chrono::steady_clock::now();
+    auto pending = pendingChanges.find(path);
+    if(pending == pendingChanges.end()) {
+        pendingChanges[path] = PendingChange{isIndexedMarkdown(path), now};
+    } else {
+        pending->second.lastEvent = now;
+    }
+}
+
+void RepositoryIndexer::pendDirectoryChanges(const string& directory)
+{
+    DIR* dir;
+    if((dir = opendir(directory.c_str()))) {
+        const struct dirent* entry;
+        string path;
+        while((entry = readdir(dir))) {
+            if(strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+                path.assign(directory);
+                path += FILE_PATH_SEPARATOR;
+                path += entry->d_name;
+                if(entry->d_type == DT_DIR) {
+                    if(repository->getMode() == Repository::RepositoryMode::REPOSITORY) {
+                        pendDirectoryChanges(path);
+                    }
+                } else if(isWatchedFile(path)) {
+                    pendChange(path);
+                }
+            }
+        }
+        closedir(dir);
+    }
+}
+
+bool RepositoryIndexer::isWatchedFile(const string& path) const
+{
+    if(repository->getMode() == Repository::RepositoryMode::REPOSITORY) {
+        return File::fileHasMarkdownExtension(path);
+    } else {
+        string file{repository->getDir()};
+        file += FILE_PATH_SEPARATOR;
+        file += repository->getFile();
+        return path == file;
+    }
+}
+
+bool RepositoryIndexer::isIndexedMarkdown(const string& path) const
+{
+    return markdownsByPath.find(path) != markdownsByPath.end();
+}
+
+void RepositoryIndexer::indexChange(const RepositoryChange& change)
+{
+    if(change.type == RepositoryChange::Type::ADDED) {
+        if(!isIndexedMarkdown(change.path)) {
+            string* path = new string{change.path};
+            allFiles.insert(path);
+            markdowns.insert(path);
+            markdownsByPath[*path] = path;
+        }
+    } else if(change.type == RepositoryChange::Type::DELETED) {
+        auto m = markdownsByPath.find(change.path);
+        if(m != markdownsByPath.end()) {
+            const string* path = m->second;
+            markdownsByPath.erase(m);
+            markdowns.erase(path);
+            allFiles.erase(path);
+            delete path;
+        }
+    }
+}
+
+bool RepositoryIndexer::getFileStamp(const string& path, FileStamp& stamp)
+{
+    struct stat s;
+    if(!stat(path.c_str(), &s) && S_ISREG(s.st_mode)) {
+        stamp.seconds = s.st_mtime;
+#ifdef __linux__
+        stamp.nanoseconds = s.st_mtim.tv_nsec;
+#else
+        stamp.nanoseconds = 0;
+#endif
+        stamp.size = s.st_size;
+        return true;
+    }
+    return false;
+}
+
+void RepositoryIndexer::onFileWritten(const string& path)
+{
+    if(isWatching() && isWatchedFile(path)) {
+        FileStamp stamp;
+        if(getFileStamp(path, stamp)) {
+            ownWrites[path] = stamp;
+            indexChange(RepositoryChange{RepositoryChange::Type::ADDED, path});
+        }
+    }
+}
+
+bool RepositoryIndexer::getChanges(vector<RepositoryChange>& changes, unsigned debounceMillis)
+{
+    if(!isWatching()) {
+        return false;
+    }
+
+    readWatchEvents();
+
+    size_t changesCount = changes.size();
+    auto now = chrono::steady_clock::now();
+    FileStamp stamp;
+    for(auto pending=pendingChanges.begin(); pending!=pendingChanges.end(); ) {
+        if(now - pending->second.lastEvent < chrono::milliseconds(debounceMillis)) {
+            ++pending;
+            continue;
+        }
+
+        bool exists = getFileStamp(pending->first, stamp);
+        auto written = ownWrites.find(pending->first);
+        if(written != ownWrites.end()) {
+            bool own = exists && written->second == stamp;
+            ownWrites.erase(written);
+            if(own) {
+                pending = pendingChanges.erase(pending);
+                continue;
+            }
+        }
+
+        if(exists) {
+            changes.push_back(RepositoryChange{
+                pending->second.indexed?RepositoryChange::Type::MODIFIED:RepositoryChange::Type::ADDED,
+                pending->first});
+            indexChange(changes.back());
+        } else if(isIndexedMarkdown(pending->first)) {
+            changes.push_back(RepositoryChange{RepositoryChange::Type::DELETED, pending->first});
+            indexChange(changes.back());
+        } // else file created & deleted within debounce interval
+
+        pending = pendingChanges.erase(pending);
+    }
+
+    if(changes.size() > changesCount) {
+        MF_DEBUG("Watcher: " << changes.size()-changesCount << " changed file(s)" << endl);
+        return true;
+    }
+    return false;
+}
+
+void RepositoryIndexer::postponeChange(const RepositoryChange& change)
+{
+    if(change.type == RepositoryChange::Type::DELETED) {
+        // keep the file indexed so that its deletion is reported again
+        indexChange(RepositoryChange{RepositoryChange::Type::ADDED, change.path});
+    }
+    pendingChanges[change.path] = PendingChange{
+        change.type != RepositoryChange::Type::ADDED,
+        chrono::steady_clock::now()};
+}
+
 const set<const string*> RepositoryIndexer::getMarkdownFiles() const {
     return markdowns;
 }
@@ -30,7 +30,10 @@
 #include <cstring>
 #include <cstdlib>
 
+#include <chrono>
 #include <iostream>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "debug.h"
@@ -40,11 +43,28 @@
 
 namespace m8r {
 
+/**
+ * @brief Change of a Markdown file made outside of MindForger.
+ */
+struct RepositoryChange
+{
+    enum class Type {
+        ADDED,
+        MODIFIED,
+        DELETED
+    };
+
+    Type type;
+    std::string path;
+};
+
 /**
  * @brief MindForger/Markdown repository/file indexer.
  */
 class RepositoryIndexer {
 public:
+    static constexpr unsigned WATCH_DEBOUNCE_MILLIS = 500;
+
     /**
      * @brief Check whether given directory contains a MindForger repository.
      */
@@ -79,6 +99,8 @@ private:
 
     std::set<const std::string*> allFiles;
     std::set<const std::string*> markdowns;
+    // markdowns by path - watcher looks up path of every event
+    std::unordered_map<std::string,const std::string*> markdownsByPath;
     std::set<const std::string*> outlineStencils;
     std::set<const std::string*> noteStencils;
 
@@ -91,6 +113,33 @@ private:
     // TXTs
     std::set<const std::string*> texts;
 
+    /*
+     * Watcher (inotify on Linux)
+     */
+
+    struct FileStamp {
+        time_t seconds;
+        long nanoseconds;
+        off_t size;
+
+        bool operator==(const FileStamp& s) const {
+            return seconds==s.seconds && nanoseconds==s.nanoseconds && size==s.size;
+        }
+    };
+    struct PendingChange {
+        // whether the file was indexed when its first event came
+        bool indexed;
+        std::chrono::steady_clock::time_point lastEvent;
+    };
+
+    int watchFd;
+    // watch descriptor > directory
+    std::map<int,std::string> watchDirectories;
+    // changed files waiting for a burst of events to calm down
+    std::map<std::string,PendingChange> pendingChanges;
+    // files written by MindForger which must not be reported as changes
+    std::map<std::string,FileStamp> ownWrites;
+
 public:
     explicit RepositoryIndexer();
     RepositoryIndexer(const RepositoryIndexer&) = delete;
@@ -124,9 +173,51 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Start watching Markdown files of the indexed repository.
+     *
+     * Watching is supported on Linux only - false is returned elsewhere.
+     */
+    bool watch();
+    void unwatch();
+    bool isWatching() const { return watchFd >= 0; }
+
+    /**
+     * @brief Remember file written by MindForger so that it's not reported as a change.
+     */
+    void onFileWritten(const std::string& path);
+
+    /**
+     * @brief Get Markdown files changed since the last call and update the index.
+     *
+     * Events are coalesced per file and the file is reported only once no event came
+     * for debounce interval i.e. a burst of events (editor save, git pull) results
+     * in a single change. Files which are still changing are kept pending.
+     */
+    bool getChanges(
+            std::vector<RepositoryChange>& changes,
+            unsigned debounceMillis=WATCH_DEBOUNCE_MILLIS);
+
+    /**
+     * @brief Return change which cannot be learned yet (O is being edited) to pending changes.
+     *
+     * Change is reported again once it calms down. If O is saved meanwhile, then
+     * the change is overwritten by MindForger's write and it is not reported.
+     */
+    void postponeChange(const RepositoryChange& change);
+
 private:
     void updateIndexMemory(const std::string& directory);
     void updateIndexStencils(const std::string& directory, std::set<const std::string*>& stencils);
+
+    bool isWatchedFile(const std::string& path) const;
+    bool isIndexedMarkdown(const std::string& path) const;
+    void watchDirectory(const std::string& directory, bool recursive);
+    void readWatchEvents();
+    void pendChange(const std::string& path);
+    void pendDirectoryChanges(const std::string& directory);
+    void indexChange(const RepositoryChange& change);
+    static bool getFileStamp(const std::string& path, FileStamp& stamp);
 };
 
 } /* namespace */
@@ -61,6 +61,7 @@ MarkdownAstNodeSection::MarkdownAstNodeSection()
     flags = 0;
     text = nullptr;
     body = new vector<string*>{};
+    skippedBodyBytesize = 0;
 }
 
 MarkdownAstNodeSection::MarkdownAstNodeSection(string *text)
@@ -180,6 +180,8 @@ protected:
     u_int16_t depth;
     MarkdownAstSectionMetadata metadata;
     std::vector<std::string*>* body;
+    // size of body which was not parsed (header-only parsing) in bytes
+    size_t skippedBodyBytesize;
 
     // various flags (bit)
     int flags;
@@ -196,6 +198,8 @@ public:
     std::vector<std::string*>* getBody() const { return body; }
     std::vector<std::string*>* moveBody() { std::vector<std::string*>* result=body; body=nullptr; return result; }
     void setBody(std::vector<std::string*>* body);
+    size_t getSkippedBodyBytesize() const { return skippedBodyBytesize; }
+    void setSkippedBodyBytesize(size_t bytesize) { skippedBodyBytesize = bytesize; }
 
     u_int16_t getDepth() const;
     void setDepth(u_int16_t depth);
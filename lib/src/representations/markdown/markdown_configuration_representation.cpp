@@ -34,6 +34,8 @@ constexpr const auto CONFIG_SETTING_MIND_TIME_SCOPE_LABEL = "* Time scope: ";
 constexpr const auto CONFIG_SETTING_MIND_TAGS_SCOPE_LABEL = "* Tags scope: ";
 constexpr const auto CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL = "* Async refresh interval (ms): ";
 constexpr const auto CONFIG_SETTING_MIND_AUTOLINKING = "* Autolinking: ";
+constexpr const auto CONFIG_SETTING_MIND_LEARN_THREADS = "* Learn threads: ";
+constexpr const auto CONFIG_SETTING_MIND_OUTLINE_BODIES = "* Notebooks with loaded notes: ";
 
 // application
 constexpr const auto CONFIG_SETTING_STARTUP_VIEW_LABEL = "* Startup view: ";
@@ -379,6 +381,34 @@ void MarkdownConfigurationRepresentation::configurationSection(
                         }
                         i %= 10000;
                         c.setDistributorSleepInterval(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_LEARN_THREADS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_LEARN_THREADS));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_MEMORY_LEARN_THREADS;
+                        }
+                        if(i<0 || i>Configuration::MAX_MEMORY_LEARN_THREADS) {
+                            i = Configuration::DEFAULT_MEMORY_LEARN_THREADS;
+                        }
+                        c.setMemoryLearnThreads(static_cast<unsigned int>(i));
+                    } else if(line->find(CONFIG_SETTING_MIND_OUTLINE_BODIES) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_OUTLINE_BODIES));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_MEMORY_OUTLINE_BODIES;
+                        }
+                        if(i<0) {
+                            i = Configuration::DEFAULT_MEMORY_OUTLINE_BODIES;
+                        }
+                        c.setMemoryOutlineBodies(static_cast<unsigned int>(i));
                     } else if(line->find(CONFIG_SETTING_MIND_AUTOLINKING) != std::string::npos) {
                         if(line->find("yes") != std::string::npos) {
                             c.setAutolinking(true);
@@ -476,6 +506,12 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          "    * Examples: 500, 1000, 3000, 5000" << endl <<
          CONFIG_SETTING_MIND_AUTOLINKING << (c?(c->isAutolinking()?"yes":"no"):(Configuration::DEFAULT_AUTOLINKING?"yes":"no")) << endl <<
          "    * Examples: yes, no" << endl <<
+         CONFIG_SETTING_MIND_LEARN_THREADS << (c?c->getMemoryLearnThreads():Configuration::DEFAULT_MEMORY_LEARN_THREADS) << endl <<
+         "    * Number of threads used to parse repository Markdown files on learn, 0 to use all CPU cores" << endl <<
+         "    * Examples: 0, 1, 4" << endl <<
+         CONFIG_SETTING_MIND_OUTLINE_BODIES << (c?c->getMemoryOutlineBodies():Configuration::DEFAULT_MEMORY_OUTLINE_BODIES) << endl <<
+         "    * Maximum number of notebooks whose notes text is kept in memory, 0 to load all notebooks on startup" << endl <<
+         "    * Examples: 0, 100, 1000" << endl <<
          endl <<
 
          "# " << CONFIG_SECTION_APP << endl <<
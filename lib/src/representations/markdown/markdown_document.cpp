@@ -27,6 +27,10 @@ MarkdownDocument::MarkdownDocument(const std::string* filePath)
     this->filePath = filePath;
     this->fileSize = 0;
     this->modified = 0;
+    this->noteBodies = true;
+    this->hashBytes = false;
+    this->bytesSize = 0;
+    this->hash = 0;
     this->ast = nullptr;
     this->format = Format::MINDFORGER;
 }
@@ -35,6 +39,8 @@ void MarkdownDocument::clear()
 {
     this->fileSize = 0;
     this->modified = 0;
+    this->bytesSize = 0;
+    this->hash = 0;
     this->name.clear();
     if(ast!=nullptr) {
         delete ast;
@@ -49,11 +55,16 @@ void MarkdownDocument::from()
     modified = fileModificationTime(filePath);
     MarkdownLexerSections lexer{filePath};
     lexer.tokenize();
+    if(hashBytes && lexer.getFile()) {
+        bytesSize = lexer.getFile()->getSize();
+        hash = bytesHash(lexer.getFile()->getData(), bytesSize);
+    }
     // IMPROVE the rest of this section could be shared by file & text
     if(lexer.getLexems().size()) {
         fileSize = lexer.getFileSize();
         // must be pointer (circular header dep)
         MarkdownParserSections parser{lexer};
+        parser.setNoteBodies(noteBodies);
         parser.parse();
         format = parser.hasMetadata()?Format::MINDFORGER:Format::MARKDOWN;
         // parser is deleted on return, but AST is kept
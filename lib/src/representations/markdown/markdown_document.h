@@ -61,6 +61,12 @@ private:
     Format format;
     unsigned fileSize;
     time_t modified;
+    // false ~ parse Os header/description, but skip Ns bodies
+    bool noteBodies;
+    // hash of parsed bytes (if requested) ~ parsed file can be changed meanwhile
+    bool hashBytes;
+    size_t bytesSize;
+    uint64_t hash;
 
     /**
      * @brief Markdown root section name.
@@ -79,6 +85,14 @@ public:
 
     void from();
     void from(const std::string* text);
+    /**
+     * @brief Parse (or skip) Ns bodies on from() - Os preamble and description are always parsed.
+     */
+    void setNoteBodies(bool noteBodies) { this->noteBodies = noteBodies; }
+    /**
+     * @brief Calculate hash of file bytes on from() - bytes are hashed as they were parsed.
+     */
+    void setHashBytes(bool hashBytes) { this->hashBytes = hashBytes; }
     bool isParsed() const { return ast==nullptr; }
     void clear();
 
@@ -86,6 +100,8 @@ public:
     Format getFormat() const { return format; }
     unsigned getFileSize() const;
     time_t getModified() const { return modified; }
+    size_t getBytesSize() const { return bytesSize; }
+    uint64_t getBytesHash() const { return hash; }
     std::string* getName();
     /**
      * @brief Get AST for read only processing.
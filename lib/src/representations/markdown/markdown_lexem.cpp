@@ -51,25 +51,11 @@ MarkdownLexem::MarkdownLexem(MarkdownLexemType type, unsigned short int depth)
     idx = lng = 0;
 }
 
-MarkdownLexem::~MarkdownLexem()
-{
-}
-
-MarkdownLexemType MarkdownLexem::getType() const
-{
-    return type;
-}
-
 void MarkdownLexem::setType(MarkdownLexemType type)
 {
     this->type = type;
 }
 
-unsigned MarkdownLexem::getDepth() const
-{
-    return depth;
-}
-
 void MarkdownLexem::setIdx(unsigned short int idx)
 {
     this->idx = idx;
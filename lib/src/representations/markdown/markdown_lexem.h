@@ -111,11 +111,12 @@ public:
     MarkdownLexem(const MarkdownLexem&&) = delete;
     MarkdownLexem& operator=(const MarkdownLexem&) = delete;
     MarkdownLexem& operator=(const MarkdownLexem&&) = delete;
-    virtual ~MarkdownLexem();
+    // trivial destructor: lexems are allocated from a pool and freed w/o destruction
+    ~MarkdownLexem() = default;
 
-    MarkdownLexemType getType() const;
+    MarkdownLexemType getType() const { return type; }
     void setType(MarkdownLexemType type);
-    unsigned getDepth() const;
+    unsigned getDepth() const { return depth; }
     void setDepth(unsigned depth);
     unsigned short int getIdx() const { return idx; }
     void setIdx(unsigned short int idx);
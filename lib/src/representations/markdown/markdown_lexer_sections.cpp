@@ -22,42 +22,6 @@ using namespace std;
 
 namespace m8r {
 
-/*
- * FileLineProvider
- */
-
-// IMPROVE consider lazy loading of lines using FileLineProvider instead of pre-loading
-class FileLineProvider
-{
-private:
-    ifstream* infile;
-
-public:
-    explicit FileLineProvider(const char* filename);
-    virtual ~FileLineProvider();
-
-    string* getLine();
-};
-
-FileLineProvider::FileLineProvider(const char* filename)
-{
-    infile = new ifstream{filename};
-}
-
-string* FileLineProvider::getLine()
-{
-    // IMPROVE this is slow heap operation
-    string* line = new string();
-    getline(*infile, *line);
-    return line;
-}
-
-FileLineProvider::~FileLineProvider()
-{
-    infile->close();
-    delete infile;
-}
-
 /*
  * MarkdownLexemTable
  */
@@ -164,6 +128,19 @@ MarkdownSymbolTable::~MarkdownSymbolTable()
     }
 }
 
+/*
+ * MarkdownLexemPool
+ */
+
+void MarkdownLexemPool::clear()
+{
+    for(MarkdownLexem* block:blocks) {
+        ::operator delete(block);
+    }
+    blocks.clear();
+    blockUsed = BLOCK_LEXEMS;
+}
+
 /*
  * MarkdownLexerSections
  */
@@ -172,35 +149,54 @@ MarkdownLexerSections::MarkdownLexerSections(const string* filePath)
 {
     this->filePath = filePath;
     this->fileSize = 0;
+    this->file = nullptr;
+    this->text = nullptr;
     this->inCodeBlock = false;
     this->lastBrTokensOffset = 0;
 }
 
 MarkdownLexerSections::~MarkdownLexerSections()
 {
-    // lines
-    for(string*& line:lines) {
-        if(line!=nullptr) {
-            delete line;
-        }
+    // lexems are freed with the pool, reusable lexems are owned by the table
+
+    // lines are just offsets to file buffer
+    if(file) {
+        delete file;
     }
+}
 
-    // lexems
-    for(MarkdownLexem*& lexem:lexems) {
-        if(lexem!=nullptr) {
-            if(!MarkdownSymbolTable::LEXEM.contains(lexem)) {
-                delete lexem;
-                lexem=nullptr;
-            }
+bool MarkdownLexerSections::textToLines(const char* bytes, size_t size)
+{
+    text = bytes;
+    if(text && size) {
+        size_t off = 0;
+        const char* eol;
+        while(off < size) {
+            eol = static_cast<const char*>(memchr(text+off, '\n', size-off));
+            MarkdownLine line{off, eol?static_cast<size_t>(eol-text)-off:size-off};
+            lines.push_back(line);
+            off += line.lng+1;
         }
+        return true;
     }
+    return false;
 }
 
 void MarkdownLexerSections::tokenize()
 {
     fileSize = 0;
-    if(fileToLines(filePath, lines, fileSize)) {
+    if(file) {
+        delete file;
+    }
+    file = new filesystem::MappedFile{*filePath, false};
+    if(textToLines(file->getData(), file->getSize())) {
+        // compatibility: size of the file as if every line would be terminated by EOL
+        for(const MarkdownLine& line:lines) {
+            fileSize += line.lng+1;
+        }
+
         // IMPROVE body of this function can be shared by file & text
+        lexems.reserve(2*lines.size()+2);
         lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
 
         unsigned offset = 0;
@@ -218,8 +214,9 @@ void MarkdownLexerSections::tokenize()
 
 void MarkdownLexerSections::tokenize(const string* text)
 {
-    if(stringToLines(text, lines)) {
+    if(text && textToLines(text->data(), text->size())) {
         // IMPROVE body of this function can be shared by file & text
+        lexems.reserve(2*lines.size()+2);
         lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
 
         unsigned offset = 0;
@@ -238,12 +235,12 @@ void MarkdownLexerSections::tokenize(const string* text)
 bool MarkdownLexerSections::lexWhitespaces(const unsigned offset, unsigned short int& idx)
 {
     unsigned short int i = idx+1;
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>i && isspace(lines[offset]->at(i))) {
+    if(hasLine(offset)) {
+        while(lineSize(offset)>i && isspace(lineAt(offset,i))) {
             i++;
         }
         if(i != idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx));
+            lexems.push_back(pool.make(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx));
             idx = i-1;
             return true;
         }
@@ -253,9 +250,9 @@ bool MarkdownLexerSections::lexWhitespaces(const unsigned offset, unsigned short
 
 bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=3
+    if(lineSize(offset)>=3
          &&
-       lines[offset]->at(0)=='`' && lines[offset]->at(1)=='`' && lines[offset]->at(2)=='`'
+       lineAt(offset,0)=='`' && lineAt(offset,1)=='`' && lineAt(offset,2)=='`'
     ){
         return true;
     } else {
@@ -265,9 +262,9 @@ bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) con
 
 bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lineSize(offset)>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lineAt(offset,idx)=='-' && lineAt(offset,idx+1)=='-' && lineAt(offset,idx+2)=='>'
     ){
         return true;
     } else {
@@ -278,16 +275,16 @@ bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset
 bool MarkdownLexerSections::lexSectionSymbol(const unsigned offset, unsigned short int& idx)
 {
     unsigned depth = 0; // depth = [0,n)
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>depth && lines[offset]->at(depth)=='#') {
+    if(hasLine(offset)) {
+        while(lineSize(offset)>depth && lineAt(offset,depth)=='#') {
             ++depth;
         }
         if(depth
              &&
-           (lines[offset]->size()>=depth || isspace(lines[offset]->at(depth))))
+           (lineSize(offset)>=depth || isspace(lineAt(offset,depth))))
         {
             idx = depth-1;
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::SECTION,depth-1));
+            lexems.push_back(pool.make(MarkdownLexemType::SECTION,depth-1));
             return true;
         }
     }
@@ -296,9 +293,9 @@ bool MarkdownLexerSections::lexSectionSymbol(const unsigned offset, unsigned sho
 
 bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+4)
+    if(lineSize(offset)>=(size_t)(idx+4)
          &&
-       lines[offset]->at(idx)=='<' && lines[offset]->at(idx+1)=='!' && lines[offset]->at(idx+2)=='-' && lines[offset]->at(idx+3)=='-'
+       lineAt(offset,idx)=='<' && lineAt(offset,idx+1)=='!' && lineAt(offset,idx+2)=='-' && lineAt(offset,idx+3)=='-'
     ){
         idx+=4;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_BEGIN);
@@ -310,9 +307,9 @@ bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, uns
 
 bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lineSize(offset)>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lineAt(offset,idx)=='-' && lineAt(offset,idx+1)=='-' && lineAt(offset,idx+2)=='>'
     ){
         idx+=3;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_END);
@@ -325,17 +322,17 @@ bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsig
 bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned short int& idx)
 {
     // case insensitive 'metadata'
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+9)
+    if(lineSize(offset)>=(size_t)(idx+9)
          &&
-       (lines[offset]->at(idx+1)=='M' || lines[offset]->at(idx+1)=='m') &&
-       (lines[offset]->at(idx+2)=='e' || lines[offset]->at(idx+2)=='E') &&
-       (lines[offset]->at(idx+3)=='t' || lines[offset]->at(idx+3)=='T') &&
-       (lines[offset]->at(idx+4)=='a' || lines[offset]->at(idx+4)=='A') &&
-       (lines[offset]->at(idx+5)=='d' || lines[offset]->at(idx+5)=='D') &&
-       (lines[offset]->at(idx+6)=='a' || lines[offset]->at(idx+6)=='A') &&
-       (lines[offset]->at(idx+7)=='t' || lines[offset]->at(idx+7)=='T') &&
-       (lines[offset]->at(idx+8)=='a' || lines[offset]->at(idx+8)=='A') &&
-       lines[offset]->at(idx+9)==':'
+       (lineAt(offset,idx+1)=='M' || lineAt(offset,idx+1)=='m') &&
+       (lineAt(offset,idx+2)=='e' || lineAt(offset,idx+2)=='E') &&
+       (lineAt(offset,idx+3)=='t' || lineAt(offset,idx+3)=='T') &&
+       (lineAt(offset,idx+4)=='a' || lineAt(offset,idx+4)=='A') &&
+       (lineAt(offset,idx+5)=='d' || lineAt(offset,idx+5)=='D') &&
+       (lineAt(offset,idx+6)=='a' || lineAt(offset,idx+6)=='A') &&
+       (lineAt(offset,idx+7)=='t' || lineAt(offset,idx+7)=='T') &&
+       (lineAt(offset,idx+8)=='a' || lineAt(offset,idx+8)=='A') &&
+       lineAt(offset,idx+9)==':'
     ){
         idx+=9;
         lexems.push_back(symbolTable.LEXEM.META_BEGIN);
@@ -347,21 +344,21 @@ bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned sh
 
 bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
-        switch(lines[offset]->at(idx+1)) {
+    if(lineSize(offset) > (size_t)(idx+1)) {
+        switch(lineAt(offset,idx+1)) {
         case 't':
-            if(lines[offset]->at(idx+2)=='y' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='e' &&
-               (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+            if(lineAt(offset,idx+2)=='y' &&
+               lineAt(offset,idx+3)=='p' &&
+               lineAt(offset,idx+4)=='e' &&
+               (lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                 idx+=4;
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_type);
                 return true;
             } else {
-                if(lines[offset]->at(idx+2)=='a' &&
-                   lines[offset]->at(idx+3)=='g' &&
-                   lines[offset]->at(idx+4)=='s' &&
-                   (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                if(lineAt(offset,idx+2)=='a' &&
+                   lineAt(offset,idx+3)=='g' &&
+                   lineAt(offset,idx+4)=='s' &&
+                   (lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                     idx+=4;
                     lexems.push_back(symbolTable.LEXEM.META_PROPERTY_tags);
                     return true;
@@ -370,13 +367,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 }
             }
         case 'c':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='e' &&
-               lines[offset]->at(idx+4)=='a' &&
-               lines[offset]->at(idx+5)=='t' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='d' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='e' &&
+               lineAt(offset,idx+4)=='a' &&
+               lineAt(offset,idx+5)=='t' &&
+               lineAt(offset,idx+6)=='e' &&
+               lineAt(offset,idx+7)=='d' &&
+               (lineAt(offset,idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_created);
                 idx+=7;
                 return true;
@@ -384,30 +381,30 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'r':
-            if(lines[offset]->at(idx+2)=='e') {
-                if(lines[offset]->at(idx+3)=='a' &&
-                   lines[offset]->at(idx+4)=='d')
+            if(lineAt(offset,idx+2)=='e') {
+                if(lineAt(offset,idx+3)=='a' &&
+                   lineAt(offset,idx+4)=='d')
                 {
-                    if(lines[offset]->at(idx+5)=='s' &&
-                       (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+                    if(lineAt(offset,idx+5)=='s' &&
+                       (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                         idx+=5;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_reads);
                         return true;
                     } else {
-                        if((lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                        if((lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                             idx+=4;
                             lexems.push_back(symbolTable.LEXEM.META_PROPERTY_read);
                             return true;
                         }
                     }
                 } else {
-                    if(lines[offset]->at(idx+3)=='v' &&
-                       lines[offset]->at(idx+4)=='i' &&
-                       lines[offset]->at(idx+5)=='s' &&
-                       lines[offset]->at(idx+6)=='i' &&
-                       lines[offset]->at(idx+7)=='o' &&
-                       lines[offset]->at(idx+8)=='n' &&
-                       (lines[offset]->at(idx+9)==':' || !isspace(idx+9)))
+                    if(lineAt(offset,idx+3)=='v' &&
+                       lineAt(offset,idx+4)=='i' &&
+                       lineAt(offset,idx+5)=='s' &&
+                       lineAt(offset,idx+6)=='i' &&
+                       lineAt(offset,idx+7)=='o' &&
+                       lineAt(offset,idx+8)=='n' &&
+                       (lineAt(offset,idx+9)==':' || !isspace(idx+9)))
                     {
                         idx+=8;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_revision);
@@ -417,16 +414,16 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
             return false;
         case 'i':
-            if(lines[offset]->at(idx+2)=='m' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='o' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='t' &&
-               lines[offset]->at(idx+7)=='a' &&
-               lines[offset]->at(idx+8)=='n' &&
-               lines[offset]->at(idx+9)=='c' &&
-               lines[offset]->at(idx+10)=='e' &&
-               (lines[offset]->at(idx+11)==':' || !isspace(idx+11))) {
+            if(lineAt(offset,idx+2)=='m' &&
+               lineAt(offset,idx+3)=='p' &&
+               lineAt(offset,idx+4)=='o' &&
+               lineAt(offset,idx+5)=='r' &&
+               lineAt(offset,idx+6)=='t' &&
+               lineAt(offset,idx+7)=='a' &&
+               lineAt(offset,idx+8)=='n' &&
+               lineAt(offset,idx+9)=='c' &&
+               lineAt(offset,idx+10)=='e' &&
+               (lineAt(offset,idx+11)==':' || !isspace(idx+11))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_importance);
                 idx+=10;
                 return true;
@@ -434,13 +431,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'u':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='g' &&
-               lines[offset]->at(idx+4)=='e' &&
-               lines[offset]->at(idx+5)=='n' &&
-               lines[offset]->at(idx+6)=='c' &&
-               lines[offset]->at(idx+7)=='y' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='g' &&
+               lineAt(offset,idx+4)=='e' &&
+               lineAt(offset,idx+5)=='n' &&
+               lineAt(offset,idx+6)=='c' &&
+               lineAt(offset,idx+7)=='y' &&
+               (lineAt(offset,idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_urgency);
                 idx+=7;
                 return true;
@@ -448,14 +445,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'p':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='g' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='s' &&
-               lines[offset]->at(idx+8)=='s' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='o' &&
+               lineAt(offset,idx+4)=='g' &&
+               lineAt(offset,idx+5)=='r' &&
+               lineAt(offset,idx+6)=='e' &&
+               lineAt(offset,idx+7)=='s' &&
+               lineAt(offset,idx+8)=='s' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_progress);
                 idx+=8;
                 return true;
@@ -463,14 +460,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'm':
-            if(lines[offset]->at(idx+2)=='o' &&
-               lines[offset]->at(idx+3)=='d' &&
-               lines[offset]->at(idx+4)=='i' &&
-               lines[offset]->at(idx+5)=='f' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='e' &&
-               lines[offset]->at(idx+8)=='d' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='o' &&
+               lineAt(offset,idx+3)=='d' &&
+               lineAt(offset,idx+4)=='i' &&
+               lineAt(offset,idx+5)=='f' &&
+               lineAt(offset,idx+6)=='i' &&
+               lineAt(offset,idx+7)=='e' &&
+               lineAt(offset,idx+8)=='d' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_modified);
                 idx+=8;
                 return true;
@@ -479,11 +476,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
         case 'l':
             // key for relationships is 'links' because a) there are clashes for 'r' b) links is shorter than relationships
-            if(lines[offset]->at(idx+2)=='i' &&
-               lines[offset]->at(idx+3)=='n' &&
-               lines[offset]->at(idx+4)=='k' &&
-               lines[offset]->at(idx+5)=='s' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lineAt(offset,idx+2)=='i' &&
+               lineAt(offset,idx+3)=='n' &&
+               lineAt(offset,idx+4)=='k' &&
+               lineAt(offset,idx+5)=='s' &&
+               (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_links);
                 idx+=5;
                 return true;
@@ -491,11 +488,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 's':
-            if(lines[offset]->at(idx+2)=='c' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='p' &&
-               lines[offset]->at(idx+5)=='e' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lineAt(offset,idx+2)=='c' &&
+               lineAt(offset,idx+3)=='o' &&
+               lineAt(offset,idx+4)=='p' &&
+               lineAt(offset,idx+5)=='e' &&
+               (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_scope);
                 idx+=5;
                 return true;
@@ -503,14 +500,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'd':
-            if(lines[offset]->at(idx+2)=='e' &&
-               lines[offset]->at(idx+3)=='a' &&
-               lines[offset]->at(idx+4)=='d' &&
-               lines[offset]->at(idx+5)=='l' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='n' &&
-               lines[offset]->at(idx+8)=='e' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='e' &&
+               lineAt(offset,idx+3)=='a' &&
+               lineAt(offset,idx+4)=='d' &&
+               lineAt(offset,idx+5)=='l' &&
+               lineAt(offset,idx+6)=='i' &&
+               lineAt(offset,idx+7)=='n' &&
+               lineAt(offset,idx+8)=='e' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_deadline);
                 idx+=8;
                 return true;
@@ -529,19 +526,19 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
  */
 bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lineSize(offset)>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size();
+            i<lineSize(offset);
             i++) {
-            if(lines[offset]->at(i)=='-') {
+            if(lineAt(offset,i)=='-') {
                 if(startsWithHtmlCommentEndSymbol(offset,i)) {
                     if(i > idx+1) {
-                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+                        lexems.push_back(pool.make(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
                         idx=i;
                     }
                     lexHtmlCommentEndSymbol(offset,i);
-                    if(lines[offset]->size()>=i) {
+                    if(lineSize(offset)>=i) {
                         lexems.push_back(symbolTable.LEXEM.BR);
                     }
                     return true;
@@ -549,7 +546,7 @@ bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigne
             }
         }
         if(i > idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+            lexems.push_back(pool.make(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
             lexems.push_back(symbolTable.LEXEM.BR);
             idx=i;
             return true;
@@ -567,7 +564,7 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
         return false;
     } else {
         // previous line is valid section name && current line is header line for that name
-        if(lines[offset-1]!=nullptr && lines[offset-1]->size()>=2 && !isspace(lines[offset-1]->at(0))
+        if(hasLine(offset-1) && lineSize(offset-1)>=2 && !isspace(lineAt(offset-1,0))
              &&
            isSameCharsLine(offset, delimiter))
         {
@@ -610,9 +607,9 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
                lexems[lexems.size()-2]->getType()==MarkdownLexemType::LINE)
             {
                 if(delimiter=='=') {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_equals,0));
+                    lexems.insert(lexems.begin()+lexems.size()-2, pool.make(MarkdownLexemType::SECTION_equals,0));
                 } else {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_hyphens,1));
+                    lexems.insert(lexems.begin()+lexems.size()-2, pool.make(MarkdownLexemType::SECTION_hyphens,1));
                 }
             } else {
                 addLineToLexems(offset);
@@ -629,17 +626,17 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
 
 void MarkdownLexerSections::addLineToLexems(const unsigned int offset)
 {
-    lexems.push_back(new MarkdownLexem{MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE});
+    lexems.push_back(pool.make(MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE));
     lexems.push_back(symbolTable.LEXEM.BR);
 }
 
 bool MarkdownLexerSections::nextToken(const unsigned int offset) {
     if(offset<lines.size()) {
-        if(lines[offset]->size()==0) {
+        if(lineSize(offset)==0) {
             lexems.push_back(symbolTable.LEXEM.BR);
             return true;
         } else {
-            switch(lines[offset]->at(0)) {
+            switch(lineAt(offset,0)) {
             case '`':
                 if(startsWithCodeBlockSymbol(offset)) {
                     // sections lexer just needs to detect code block to avoid detection of false sections, but no need to tokenize it
@@ -659,11 +656,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                         char cc;
                         unsigned short int ws=0, text=0, x = idx+1;
                         while(lookahead(offset,idx)) {
-                            cc = lines[offset]->at(++idx);
+                            cc = lineAt(offset,++idx);
                             if(isspace(cc)) {
                                 // a) whitespaces
                                 if(ws==0 && text) {
-                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                    lexems.push_back(pool.make(MarkdownLexemType::TEXT,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
                                     text = 0;
                                     x = idx;
                                 }
@@ -700,11 +697,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                         unsigned short int mess = 0;
                                         char ccc;
                                         while(lookahead(offset,idx)) {
-                                            ccc = lines[offset]->at(++idx);
+                                            ccc = lineAt(offset,++idx);
                                             if(ccc=='-' && lexHtmlCommentEndSymbol(offset,idx)) {
                                                 if(mess) {
                                                     // TODO BUG add text BEFORE last lexem
-                                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                                    lexems.push_back(pool.make(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
                                                 }
                                                 // IMPROVE process the rest of line after --> (ignored for now)
 
@@ -718,7 +715,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                             }
                                         }
                                         if(mess) {
-                                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                            lexems.push_back(pool.make(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
                                         }
 
                                         // TODO FIX
@@ -733,7 +730,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                 } else {
                                     // b2) text
                                     if(text==0 && ws) {
-                                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                        lexems.push_back(pool.make(MarkdownLexemType::WHITESPACES,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
                                         ws = 0;
                                         x = idx;
                                     }
@@ -742,10 +739,10 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                             }
                         } // while
                         if(ws) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.push_back(pool.make(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
                         }
                         if(text) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.push_back(pool.make(MarkdownLexemType::TEXT,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
                         }
                         lexems.push_back(symbolTable.LEXEM.BR);
                         return true;
@@ -774,12 +771,12 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
 bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c) const
 {
     // fail fast
-    if(lines[offset]!=nullptr && lines[offset]->size()
+    if(lineSize(offset)
          &&
-       lines[offset]->at(0)==c && lines[offset]->at(lines[offset]->size()-1)==c)
+       lineAt(offset,0)==c && lineAt(offset,lineSize(offset)-1)==c)
     {
-        for(unsigned i=1; i<lines[offset]->size()-1; i++) {
-            if(lines[offset]->at(i)!=c) {
+        for(unsigned i=1; i<lineSize(offset)-1; i++) {
+            if(lineAt(offset,i)!=c) {
                 return false;
             }
         }
@@ -790,7 +787,7 @@ bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c)
 
 bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
+    if(lineSize(offset) > (size_t)(idx+1)) {
         return true;
     } else {
         return false;
@@ -799,7 +796,7 @@ bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned shor
 
 bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==':') {
+    if(lineSize(offset)>(size_t)(idx+1) && lineAt(offset,idx+1)==':') {
         idx++;
         lexems.push_back(symbolTable.LEXEM.META_NAMEVALUE_DELIMITER);
         return true;
@@ -810,14 +807,14 @@ bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned off
 
 bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lineSize(offset)>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size() && lines[offset]->at(i)!=';';
+            i<lineSize(offset) && lineAt(offset,i)!=';';
             i++)
         {}
         if(i>idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1));
+            lexems.push_back(pool.make(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1));
             idx=i-1;
             return true;
         }
@@ -827,7 +824,7 @@ bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned
 
 bool MarkdownLexerSections::lexMetaPropertyDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==';') {
+    if(lineSize(offset)>(size_t)(idx+1) && lineAt(offset,idx+1)==';') {
         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_DELIMITER);
         idx++;
         return true;
@@ -840,15 +837,18 @@ string* MarkdownLexerSections::getText(const MarkdownLexem* lexem)
 {
     if(lexem!=nullptr && lines.size()) {
         if(lexem->getOff()<lines.size()) {
+            const MarkdownLine& line = lines[lexem->getOff()];
             if(lexem->getLng()==MarkdownLexem::WHOLE_LINE) {
-                string *result = lines[lexem->getOff()];
-                lines[lexem->getOff()] = nullptr;
-                return result;
+                return new string{text+line.off, line.lng};
             } else {
-                if(lexem->getLng()==0) {
+                if(lexem->getLng()==0 || lexem->getIdx()>=line.lng) {
                     return new string{};
                 } else {
-                    return new string{lines[lexem->getOff()]->substr(lexem->getIdx(),lexem->getLng())};
+                    size_t lng = line.lng-lexem->getIdx();
+                    if(lexem->getLng() < lng) {
+                        lng = lexem->getLng();
+                    }
+                    return new string{text+line.off+lexem->getIdx(), lng};
                 }
             }
         }
@@ -856,4 +856,18 @@ string* MarkdownLexerSections::getText(const MarkdownLexem* lexem)
     return nullptr;
 }
 
+size_t MarkdownLexerSections::getTextLength(const MarkdownLexem* lexem) const
+{
+    if(lexem!=nullptr && lexem->getOff()<lines.size()) {
+        const MarkdownLine& line = lines[lexem->getOff()];
+        if(lexem->getLng()==MarkdownLexem::WHOLE_LINE) {
+            return line.lng;
+        } else if(lexem->getLng()!=0 && lexem->getIdx()<line.lng) {
+            size_t lng = line.lng-lexem->getIdx();
+            return lexem->getLng() < lng ? lexem->getLng() : lng;
+        }
+    }
+    return 0;
+}
+
 } // m8r namespace
@@ -20,7 +20,10 @@
 #define M8R_MARKDOWN_LEXER_SECTIONS_H_
 
 #include <set>
+#include <cstring>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <unordered_set>
 
@@ -71,6 +74,49 @@ public:
     bool contains(MarkdownLexem *lexem) const { return lexems.find(lexem)!=lexems.end(); }
 };
 
+/**
+ * @brief Arena of lexems created by the lexer.
+ *
+ * Lexems are allocated from fixed size blocks i.e. allocation is a pointer bump
+ * and lexems are freed at once with the pool (block by block, no destructors).
+ */
+class MarkdownLexemPool
+{
+public:
+    static constexpr size_t BLOCK_LEXEMS = 4096;
+
+private:
+    static_assert(
+        std::is_trivially_destructible<MarkdownLexem>::value,
+        "pooled lexems are freed w/o calling destructors");
+
+    std::vector<MarkdownLexem*> blocks;
+    // lexems used in the last block
+    size_t blockUsed;
+
+public:
+    explicit MarkdownLexemPool() : blockUsed(BLOCK_LEXEMS) {}
+    MarkdownLexemPool(const MarkdownLexemPool&) = delete;
+    MarkdownLexemPool(const MarkdownLexemPool&&) = delete;
+    MarkdownLexemPool& operator=(const MarkdownLexemPool&) = delete;
+    MarkdownLexemPool& operator=(const MarkdownLexemPool&&) = delete;
+    ~MarkdownLexemPool() { clear(); }
+
+    template<typename... Args>
+    MarkdownLexem* make(Args... args) {
+        if(blockUsed == BLOCK_LEXEMS) {
+            blocks.push_back(static_cast<MarkdownLexem*>(::operator new(BLOCK_LEXEMS*sizeof(MarkdownLexem))));
+            blockUsed = 0;
+        }
+        return new(blocks.back()+blockUsed++) MarkdownLexem(args...);
+    }
+
+    /**
+     * @brief Free all lexems - pointers to pooled lexems become invalid.
+     */
+    void clear();
+};
+
 class MarkdownSymbolTable
 {
 private:
@@ -99,8 +145,21 @@ public:
     void clearSymbols() { symbols.clear(); }
 };
 
+/**
+ * @brief Line of the lexed text - offset and length of the line (w/o EOL) in the text.
+ */
+struct MarkdownLine
+{
+    size_t off;
+    size_t lng;
+};
+
 /**
  * @brief Markdown lexical analyzer for section-level granularity parser.
+ *
+ * Lexer reads the file to a contiguous buffer or lexes text given by the caller
+ * and builds line offset table over it - lexems refer to lines and spans of this
+ * buffer, strings are created only when the parser asks for a lexem text.
  */
 class MarkdownLexerSections
 {
@@ -110,8 +169,12 @@ private:
     bool inCodeBlock;
 
     size_t fileSize;
-    std::vector<std::string*> lines;
-    // IMPROVE prepare a LexemPool: vector + MarkdownLexem[1000] and allocate from there (performance)
+    // lexed bytes: either file read to buffer (it might be written meanwhile) or text owned by the caller
+    filesystem::MappedFile* file;
+    const char* text;
+    std::vector<MarkdownLine> lines;
+    // lexems are either reusable lexems from the table or pooled lexems
+    MarkdownLexemPool pool;
     std::vector<MarkdownLexem*> lexems;
     MarkdownSymbolTable symbolTable;
 
@@ -130,11 +193,19 @@ public:
      * Returns text, caller is expected to destroy it.
      */
     std::string* getText(const MarkdownLexem*);
+    /**
+     * @brief Get length of lexem's text w/o its copying (0 if lexem has no text).
+     */
+    size_t getTextLength(const MarkdownLexem*) const;
 
     void setFilePath(const std::string*& filePath) { this->filePath = filePath; }
     size_t getFileSize() const { return fileSize; }
+    /**
+     * @brief Get file which was lexed (nullptr if text was lexed).
+     */
+    const filesystem::MappedFile* getFile() const { return file; }
     const std::vector<MarkdownLexem*>& getLexems() const { return lexems; }
-    const std::vector<std::string*>& getLines() const { return lines; }
+    size_t getLinesCount() const { return lines.size(); }
     const MarkdownSymbolTable& getSymbolTable() const { return symbolTable; }
     MarkdownLexem* operator[](size_t i) { return lexems[i]; }
     const MarkdownLexem* operator[](size_t i) const { return lexems[i]; }
@@ -142,6 +213,20 @@ public:
     size_t size() const { return lexems.size(); }
 
 private:
+    /**
+     * @brief Build line offset table for given bytes (lines are split using getline() semantic).
+     */
+    bool textToLines(const char* bytes, size_t size);
+
+    inline bool hasLine(const unsigned offset) const { return offset < lines.size(); }
+    inline size_t lineSize(const unsigned offset) const { return lines[offset].lng; }
+    /**
+     * @brief Get line character - NUL is returned for index beyond the end of the line.
+     */
+    inline char lineAt(const unsigned offset, const size_t idx) const {
+        return idx < lines[offset].lng ? text[lines[offset].off + idx] : 0;
+    }
+
     bool nextToken(const unsigned int offset);
 
     inline bool lookahead(const unsigned offset, const unsigned short idx) const;
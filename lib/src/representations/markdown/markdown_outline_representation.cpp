@@ -67,9 +67,17 @@ Note* MarkdownOutlineRepresentation::note(vector<MarkdownAstNodeSection*>* ast,
         note->setDepth(ast->at(i)->getDepth());
         body = ast->at(i)->moveBody();
         if(body != nullptr) {
+            Description description{};
+            description.setLines(*body);
+            note->setDescription(std::move(description));
             for(string*& bodyItem : *body) {
-                note->addDescriptionLine(bodyItem);
+                delete bodyItem;
             }
+        } else if(outline) {
+            // body was not parsed (header-only) - N's section is its index in O
+            note->forgetBody(
+                static_cast<int>(outline->getNotes().size()),
+                ast->at(i)->getSkippedBodyBytesize());
         }
         delete body;
         note->setCreated(ast->at(i)->getMetadata().getCreated());
@@ -105,6 +113,11 @@ Outline* MarkdownOutlineRepresentation::outline(const File& file)
 {
     MarkdownDocument md{&file.name};
     md.from();
+    return outline(md);
+}
+
+Outline* MarkdownOutlineRepresentation::outline(MarkdownDocument& md)
+{
     vector<MarkdownAstNodeSection*>* ast = md.moveAst();
 
     Outline* o = outline(ast);
@@ -118,6 +131,31 @@ Outline* MarkdownOutlineRepresentation::outline(const File& file)
     return o;
 }
 
+void MarkdownOutlineRepresentation::noteBodies(MarkdownDocument& md, vector<Description>& bodies)
+{
+    vector<MarkdownAstNodeSection*>* ast = md.getAst();
+    if(ast) {
+        // preamble and O's sections are followed by Ns sections (as in outline())
+        size_t off = ast->size() && ast->at(0)->isPreambleSection() ? 2 : 1;
+        for(size_t i=off; i<ast->size(); i++) {
+            Description description{};
+            vector<string*>* body = ast->at(i)->moveBody();
+            if(body != nullptr) {
+                description.setLines(*body);
+                for(string*& bodyItem : *body) {
+                    delete bodyItem;
+                }
+                delete body;
+            }
+            // as completed N, recalled N has (at least empty) description line
+            if(description.empty()) {
+                description.addLine(string{});
+            }
+            bodies.push_back(std::move(description));
+        }
+    }
+}
+
 Outline* MarkdownOutlineRepresentation::outline(vector<MarkdownAstNodeSection*>* ast)
 {
     Outline* outline = new Outline{ontology.getDefaultOutlineType()};
@@ -192,9 +230,11 @@ Outline* MarkdownOutlineRepresentation::outline(vector<MarkdownAstNodeSection*>*
 
                 vector<string*>* body = ast->at(off)->moveBody();
                 if(body!=nullptr) {
-                    // IMPROVE use body as is
+                    Description description{};
+                    description.setLines(*body);
+                    outline->setDescription(std::move(description));
                     for(string*& bodyItem:*body) {
-                        outline->addDescriptionLine(bodyItem);
+                        delete bodyItem;
                     }
                     delete body;
                 }
@@ -331,18 +371,12 @@ void MarkdownOutlineRepresentation::toHeader(Outline* outline, string* md)
             md->append("\n");
         }
 
-        const vector<string*>& description=outline->getDescription();
-        if(description.size()) {
-            for(string *s:description) {
-                md->append(*s);
-                // IMPROVE endl
-                md->append("\n");
-            }
-        }
+        // every description line is terminated by EOL
+        md->append(outline->getDescription().getText());
     }
 }
 
-void MarkdownOutlineRepresentation::description(const std::string* md, std::vector<std::string*>& description)
+void MarkdownOutlineRepresentation::description(const std::string* md, Description& description)
 {
     if(md) {
         bool lastLineEmpty = false;
@@ -384,11 +418,11 @@ void MarkdownOutlineRepresentation::description(const std::string* md, std::vect
                    || (line[0]==CE && line[1]==CE && line[2]==CE)
                   )
             ) {
-                description.push_back(new string{""});
+                description.addLine("");
             }
             lastLineEmpty = !line.size();
 
-            description.push_back(new string{line});
+            description.addLine(line);
         }
         MF_DEBUG(
             "MD representation: unbounded code fence count=" << codeblockBackticksCount
@@ -396,7 +430,7 @@ void MarkdownOutlineRepresentation::description(const std::string* md, std::vect
         );
         if(codeblockBackticksCount > 0 && codeblockBackticksCount%2 == 1) {
             // close opened ``` to avoid unbounded code fence as described ^
-            description.push_back(new string("```"));
+            description.addLine("```");
         }
     } else {
         description.clear();
@@ -554,7 +588,7 @@ string* MarkdownOutlineRepresentation::toDescription(const Note* note, string* m
             md->append(amd);
         }
     } else {
-        toString(note->getDescription(), *md);
+        md->append(note->getDescription().getText());
     }
 
     return md;
@@ -79,11 +79,23 @@ public:
     virtual ~MarkdownOutlineRepresentation();
 
     virtual Outline* outline(const filesystem::File& file) override;
+    /**
+     * @brief Create Outline from already lexed and parsed Markdown document.
+     *
+     * Document's AST is moved to the Outline i.e. document is left w/o AST.
+     */
+    virtual Outline* outline(MarkdownDocument& md);
+    /**
+     * @brief Move Ns bodies (descriptions of sections which follow O's section) of parsed Markdown document.
+     *
+     * Ontology is not used i.e. bodies can be moved by more threads in parallel.
+     */
+    static void noteBodies(MarkdownDocument& md, std::vector<Description>& bodies);
     virtual Outline* header(const std::string* md);
     virtual Note* note(const filesystem::File& file);
     virtual Note* note(const std::string* md);
 
-    virtual void description(const std::string* md, std::vector<std::string*>& description);
+    virtual void description(const std::string* md, Description& description);
 
     virtual std::string* to(Outline* outline);
     virtual std::string* to(Outline* outline, std::string* md);
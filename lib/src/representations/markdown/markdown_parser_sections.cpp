@@ -36,6 +36,7 @@ MarkdownParserSections::MarkdownParserSections(MarkdownLexerSections& lexer)
     : lexer(lexer)
 {
     this->ast = nullptr;
+    this->noteBodies = true;
 }
 
 MarkdownParserSections::~MarkdownParserSections()
@@ -175,7 +176,7 @@ MarkdownAstNodeSection* MarkdownParserSections::sectionRule(size_t& offset)
                 }
 
                 result->setDepth(depth);
-                result->setBody(sectionBodyRule(offset));
+                noteBodyRule(result, offset);
                 return result;
             }
             break;
@@ -188,7 +189,7 @@ MarkdownAstNodeSection* MarkdownParserSections::sectionRule(size_t& offset)
             result->setPostDeclaredSection();
             result->setDepth(depth);
             ++offset; // skip BR
-            result->setBody(sectionBodyRule(offset));
+            noteBodyRule(result, offset);
             return result;
         default:
             return nullptr;
@@ -247,11 +248,23 @@ void MarkdownParserSections::skipEOL(size_t& offset)
     }
 }
 
-void MarkdownParserSections::skipSectionBody(size_t& offset)
+size_t MarkdownParserSections::skipSectionBody(size_t& offset)
 {
-    while(lookaheadNotSection(offset+1)!=nullptr) {
+    // body size is measured as the size of its description (lines of sectionBodyRule() terminated by EOL)
+    size_t bytes = 0;
+    const MarkdownLexem* l;
+    while((l=lookaheadNotSection(offset+1))!=nullptr) {
         ++offset;
+        if(l->getType()==MarkdownLexemType::LINE || l->getType()==MarkdownLexemType::BR) {
+            if(l->getOff()<lexer.getLinesCount()) {
+                bytes += lexer.getTextLength(l)+1;
+            }
+            if(l->getType()==MarkdownLexemType::LINE) {
+                skipBr(offset);
+            }
+        }
     }
+    return bytes;
 }
 
 string* MarkdownParserSections::sectionNameRule(size_t& offset)
@@ -621,4 +634,20 @@ vector<string*>* MarkdownParserSections::sectionBodyRule(size_t& offset)
     return result;
 }
 
+void MarkdownParserSections::noteBodyRule(MarkdownAstNodeSection* section, size_t& offset)
+{
+    // 1st section (after preamble) is O's section whose body is O's description
+    if(noteBodies
+         ||
+       ast->empty()
+         ||
+       (ast->size()==1 && ast->at(0)->isPreambleSection()))
+    {
+        section->setBody(sectionBodyRule(offset));
+    } else {
+        section->setBody(nullptr);
+        section->setSkippedBodyBytesize(skipSectionBody(offset));
+    }
+}
+
 } // m8r namespace
@@ -52,6 +52,11 @@ private:
      */
     bool metadataExist;
 
+    /**
+     * @brief false if Ns sections bodies should be skipped (Os preamble and description are always parsed)
+     */
+    bool noteBodies;
+
 public:
     explicit MarkdownParserSections(MarkdownLexerSections& lexer);
     MarkdownParserSections(const MarkdownParserSections&) = delete;
@@ -71,6 +76,7 @@ public:
     size_t size() const { return ast==nullptr?0:ast->size(); }
     bool empty() const { return ast==nullptr?true:ast->empty(); }
     bool hasMetadata() const { return metadataExist; }
+    void setNoteBodies(bool noteBodies) { this->noteBodies = noteBodies; }
 
 private:
     inline const MarkdownLexem* lookahead(size_t offset);
@@ -80,7 +86,7 @@ private:
     inline const MarkdownLexem* lookaheadNotSection(size_t offset);
     inline void skipWhitespaces(size_t& offset);
     inline void skipEOL(size_t& offset);
-    inline void skipSectionBody(size_t& offset);
+    inline size_t skipSectionBody(size_t& offset);
     inline void skipBr(size_t& offset);
 
     void markdownRule();
@@ -90,6 +96,7 @@ private:
     std::string* sectionNameRule(size_t& offset);
     bool sectionMetadataRule(MarkdownAstSectionMetadata& meta, size_t& offset);
     std::vector<std::string*>* sectionBodyRule(size_t& offset);
+    void noteBodyRule(MarkdownAstNodeSection* section, size_t& offset);
 
     const MarkdownLexem* parsePropertyValue(size_t& offset);
     time_t parsePropertyValueTimestamp(size_t& offset);
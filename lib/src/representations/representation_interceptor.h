@@ -22,6 +22,8 @@
 #include <string>
 #include <vector>
 
+#include "../model/description.h"
+
 namespace m8r {
 
 class RepresentationInterceptor
@@ -29,7 +31,7 @@ class RepresentationInterceptor
 public:
     virtual ~RepresentationInterceptor() {}
 
-    virtual void process(const std::vector<std::string*>& in, std::string& out) = 0;
+    virtual void process(const Description& in, std::string& out) = 0;
 };
 
 }
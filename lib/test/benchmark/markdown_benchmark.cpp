@@ -89,3 +89,39 @@ TEST(MarkdownParserBenchmark, DISABLED_ParserNoMeta)
     MF_DEBUG(endl << (ITERATIONS*0.77) << "MiB (" << ITERATIONS << "x0.77MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
     MF_DEBUG(" ~ AVG: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
 }
+
+// 2026/10/18 meta.md (167k lexems) AVG per file (-O1):
+//   heap lexems:   lex 7.0ms, parse 24.6ms, teardown 7.4ms
+//   pooled lexems: lex 4.5ms, parse 22.7ms, teardown 2.4ms
+TEST(MarkdownParserBenchmark, DISABLED_LexerAndParserPerFile)
+{
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+
+    const int ITERATIONS = 100;
+    size_t lexemsCount = 0;
+    chrono::high_resolution_clock::duration lexing{}, parsing{}, teardown{};
+    for(int i=0; i<ITERATIONS; i++) {
+        auto begin = chrono::high_resolution_clock::now();
+        MarkdownLexerSections* lexer = new MarkdownLexerSections(fileName.get());
+        lexer->tokenize();
+        auto lexed = chrono::high_resolution_clock::now();
+        MarkdownParserSections* parser = new MarkdownParserSections(*lexer);
+        parser->parse();
+        auto parsed = chrono::high_resolution_clock::now();
+        lexemsCount = lexer->size();
+        delete parser;
+        delete lexer;
+        auto end = chrono::high_resolution_clock::now();
+
+        lexing += lexed-begin;
+        parsing += parsed-lexed;
+        teardown += end-parsed;
+    }
+    cout << endl << lexemsCount << " lexems per file, AVG per file:"
+         << " lex " << chrono::duration_cast<chrono::microseconds>(lexing).count()/ITERATIONS/1000.0 << "ms"
+         << " parse " << chrono::duration_cast<chrono::microseconds>(parsing).count()/ITERATIONS/1000.0 << "ms"
+         << " teardown " << chrono::duration_cast<chrono::microseconds>(teardown).count()/ITERATIONS/1000.0 << "ms"
+         << endl;
+}
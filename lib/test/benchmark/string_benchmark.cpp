@@ -0,0 +1,177 @@
+/*
+ string_benchmark.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <vector>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../../src/gear/string_utils.h"
+#include "../../src/gear/file_utils.h"
+#include "../../src/gear/linear_regex.h"
+
+using namespace std;
+using namespace m8r;
+
+extern char* getMindforgerGitHomePath();
+
+/*
+RESULT: SSE2 kernel is 6-40x faster than lower + find (no copy, no locale):
+
+Haystack: 1164949 bytes, 21474 lines
+LOWER+FIND 'mindforger' found 1 in 19.805ms
+KERNEL     'mindforger' found 1 in 0.618ms
+LOWER+FIND 'the' found 2705 in 20.119ms
+KERNEL     'the' found 2705 in 0.803ms
+LOWER+FIND 'knowledge' found 7 in 26.277ms
+KERNEL     'knowledge' found 7 in 0.894ms
+LOWER+FIND 'x-no-such-word-x' found 0 in 23.812ms
+KERNEL     'x-no-such-word-x' found 0 in 3.981ms
+LOWER+FIND 'a' found 10730 in 25.801ms
+KERNEL     'a' found 10730 in 0.62ms
+LOWER+FIND ALL 'mind' found 5 in 26.742ms
+KERNEL ALL     'mind' found 5 in 0.321ms
+ */
+TEST(StringBenchmark, DISABLED_FindIgnoreCase)
+{
+    // 1.1M file
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> text{m8r::fileToString(*fileName.get())};
+
+    // realistic FTS: search lines (titles/description lines) one by one
+    vector<string> lines{};
+    size_t from = 0, eol;
+    while((eol = text->find('\n', from)) != string::npos) {
+        lines.push_back(text->substr(from, eol-from));
+        from = eol+1;
+    }
+    cout << "Haystack: " << text->size() << " bytes, " << lines.size() << " lines" << endl;
+
+    vector<string> needles{"mindforger", "the", "knowledge", "x-no-such-word-x", "a"};
+    for(string& needle:needles) {
+        size_t found = 0;
+        auto begin = chrono::high_resolution_clock::now();
+        string s{};
+        for(string& line:lines) {
+            s.clear();
+            stringToLower(line, s);
+            if(s.find(needle) != string::npos) found++;
+        }
+        auto end = chrono::high_resolution_clock::now();
+        cout << "LOWER+FIND '" << needle << "' found " << found << " in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+        size_t lowerFound = found;
+
+        found = 0;
+        begin = chrono::high_resolution_clock::now();
+        for(string& line:lines) {
+            if(stringFindIgnoreCase(line, needle) != string::npos) found++;
+        }
+        end = chrono::high_resolution_clock::now();
+        cout << "KERNEL     '" << needle << "' found " << found << " in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+        ASSERT_EQ(lowerFound, found);
+    }
+
+    // whole text at once (contiguous descriptions)
+    size_t found = 0;
+    auto begin = chrono::high_resolution_clock::now();
+    string s{};
+    stringToLower(*text, s);
+    for(size_t m = s.find("mind"); m != string::npos; m = s.find("mind", m+1)) found++;
+    auto end = chrono::high_resolution_clock::now();
+    cout << "LOWER+FIND ALL 'mind' found " << found << " in "
+         << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+    size_t lowerFound = found;
+
+    found = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(size_t m = stringFindIgnoreCase(*text, "mind"); m != string::npos; m = stringFindIgnoreCase(*text, "mind", m+1)) found++;
+    end = chrono::high_resolution_clock::now();
+    cout << "KERNEL ALL     'mind' found " << found << " in "
+         << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+    ASSERT_EQ(lowerFound, found);
+}
+
+/*
+RESULT: lazy DFA/NFA w/ literal prefilter is 9-50x faster than std::regex (-O1):
+
+Haystack: 1164949 bytes, 21474 lines
+STD::REGEX 'mind[a-z]+' found 1 in 53.727ms
+LINEAR     'mind[a-z]+' found 1 in 1.018ms
+STD::REGEX '^# ' found 32 in 45.719ms
+LINEAR     '^# ' found 32 in 3.201ms
+STD::REGEX '\bthe\b' found 1968 in 197.457ms
+LINEAR     '\bthe\b' found 1968 in 10.926ms
+STD::REGEX '[0-9]{4}-[0-9]{2}' found 2508 in 28.896ms
+LINEAR     '[0-9]{4}-[0-9]{2}' found 2508 in 3.307ms
+STD::REGEX '(know|think)ing' found 7 in 57.545ms
+LINEAR     '(know|think)ing' found 7 in 2.827ms
+STD::REGEX 'x-no-such-word-x' found 0 in 32.305ms
+LINEAR     'x-no-such-word-x' found 0 in 0.66ms
+ */
+TEST(StringBenchmark, DISABLED_LinearRegex)
+{
+    // 1.1M file
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> text{m8r::fileToString(*fileName.get())};
+
+    vector<string> lines{};
+    size_t from = 0, eol;
+    while((eol = text->find('\n', from)) != string::npos) {
+        lines.push_back(text->substr(from, eol-from));
+        from = eol+1;
+    }
+    cout << "Haystack: " << text->size() << " bytes, " << lines.size() << " lines" << endl;
+
+    vector<string> patterns{"mind[a-z]+", "^# ", "\\bthe\\b", "[0-9]{4}-[0-9]{2}", "(know|think)ing", "x-no-such-word-x"};
+    for(string& pattern:patterns) {
+        size_t found = 0;
+        std::regex regex{pattern};
+        auto begin = chrono::high_resolution_clock::now();
+        for(string& line:lines) {
+            if(std::regex_search(line, regex)) found++;
+        }
+        auto end = chrono::high_resolution_clock::now();
+        cout << "STD::REGEX '" << pattern << "' found " << found << " in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+        size_t stdFound = found;
+
+        found = 0;
+        LinearRegex linear{pattern};
+        begin = chrono::high_resolution_clock::now();
+        for(string& line:lines) {
+            if(linear.search(line)) found++;
+        }
+        end = chrono::high_resolution_clock::now();
+        cout << "LINEAR     '" << pattern << "' found " << found << " in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+        ASSERT_EQ(stdFound, found);
+    }
+}
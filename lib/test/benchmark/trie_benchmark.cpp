@@ -20,11 +20,13 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <random>
 #include <string>
 
 #include <gtest/gtest.h>
 
 #include "../../src/gear/trie.h"
+#include "../../src/gear/fuzzy_name_index.h"
 #include "../../src/gear/file_utils.h"
 
 using namespace std;
@@ -118,3 +120,99 @@ TEST(TrieBenchmark, DISABLED_TrieVsMap)
     MF_DEBUG(words.size() << " words SEARCHED in " << chrono::duration_cast<chrono::microseconds>(endTrieSearch-beginTrieSearch).count()/1000.0 << "ms" << endl);
     cout << "TRIE done" << endl;
 }
+
+/*
+RESULT: fuzzy index lookup takes ~2ms for 100k names, 30x faster than scan (index returns top 50):
+
+INDEX 100000 names built in 216.81ms
+INDEX 100 lookups found 4884 in 191.165ms
+SCAN  100 lookups found 236642 in 5867.24ms
+ */
+TEST(TrieBenchmark, DISABLED_FuzzyNames)
+{
+    // 100k names of 1-4 words from 1.1M file
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> s{m8r::fileToString(*fileName.get())};
+    vector<string> words{};
+    string word{};
+    for(char c:*s) {
+        if(isalpha(static_cast<unsigned char>(c))) {
+            word += c;
+        } else if(word.size()) {
+            if(word.size() > 3) words.push_back(word);
+            word.clear();
+        }
+    }
+    std::mt19937 random{42};
+    vector<string> names{};
+    for(size_t i=0; i<100000; i++) {
+        string name{words[random()%words.size()]};
+        for(size_t w=random()%4; w; w--) {
+            name += " " + words[random()%words.size()];
+        }
+        names.push_back(name);
+    }
+    // typo in (the first word of) the names
+    vector<string> queries{};
+    for(size_t i=0; i<100; i++) {
+        string q = names[random()%names.size()];
+        q = q.substr(0, q.find(' '));
+        q.erase(random()%q.size(), 1);
+        queries.push_back(q);
+    }
+
+    auto begin = chrono::high_resolution_clock::now();
+    FuzzyNameIndex index{};
+    for(size_t i=0; i<names.size(); i++) {
+        index.add(names[i], static_cast<uint32_t>(i));
+    }
+    // sort is done on the first lookup
+    vector<FuzzyNameIndex::Match> matches{};
+    index.find("x", matches, 1);
+    auto end = chrono::high_resolution_clock::now();
+    cout << "INDEX " << names.size() << " names built in "
+         << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+    size_t found = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(string& q:queries) {
+        matches.clear();
+        index.find(q, matches, 50);
+        found += matches.size();
+    }
+    end = chrono::high_resolution_clock::now();
+    cout << "INDEX " << queries.size() << " lookups found " << found << " in "
+         << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+    // brute force: distance of the query to the prefix of every name
+    found = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(string& q:queries) {
+        string lq{};
+        stringToLower(q, lq);
+        const int k = FuzzyNameIndex::maxDistance(lq.size());
+        for(string& n:names) {
+            string ln{};
+            stringToLower(n, ln);
+            vector<int> row(lq.size()+1);
+            for(size_t j=0; j<row.size(); j++) row[j] = static_cast<int>(j);
+            int best = row[lq.size()];
+            for(size_t i=1; i<=ln.size() && i<=lq.size()+k; i++) {
+                int diagonal = row[0];
+                row[0] = static_cast<int>(i);
+                for(size_t j=1; j<=lq.size(); j++) {
+                    int above = row[j];
+                    row[j] = std::min(std::min(row[j]+1, row[j-1]+1), diagonal + (ln[i-1]!=lq[j-1]?1:0));
+                    diagonal = above;
+                }
+                best = std::min(best, row[lq.size()]);
+            }
+            if(best <= k) found++;
+        }
+    }
+    end = chrono::high_resolution_clock::now();
+    cout << "SCAN  " << queries.size() << " lookups found " << found << " in "
+         << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+}
@@ -0,0 +1,93 @@
+/*
+ aa_top_k_store_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/mind/ai/aa_top_k_store.h"
+
+using namespace std;
+
+TEST(AaTopKStoreTestCase, SameAsDenseMatrix)
+{
+    const size_t N = 300;
+    const size_t K = 10;
+
+    // dense symmetric AA matrix w/ ties
+    std::mt19937 random{7};
+    std::uniform_int_distribution<int> aa{0, 100};
+    vector<vector<float>> matrix(N, vector<float>(N));
+    for(size_t y=0; y<N; y++) {
+        for(size_t x=y; x<N; x++) {
+            matrix[y][x] = matrix[x][y] = x==y ? 1.f : aa(random)/100.f;
+        }
+    }
+
+    m8r::AaTopKStore store{K};
+    store.reset(N);
+    EXPECT_FALSE(store.isCalculated(0));
+    for(size_t y=0; y<N; y++) {
+        m8r::TopK<uint32_t> top{K};
+        for(size_t x=0; x<N; x++) {
+            if(x!=y) top.push(static_cast<uint32_t>(x), matrix[y][x]);
+        }
+        store.set(y, top);
+    }
+
+    // leaderboard: K best scores of the dense row
+    for(size_t y=0; y<N; y++) {
+        ASSERT_TRUE(store.isCalculated(y));
+        vector<float> row{};
+        for(size_t x=0; x<N; x++) {
+            if(x!=y) row.push_back(matrix[y][x]);
+        }
+        std::sort(row.begin(), row.end(), [](float f1, float f2) { return f1 > f2; });
+
+        vector<m8r::AaTopKStore::Association> associations{};
+        store.get(y, associations);
+        ASSERT_EQ(K, associations.size());
+        for(size_t i=0; i<K; i++) {
+            EXPECT_NEAR(row[i], associations[i].second, 1./65535.);
+            EXPECT_NEAR(matrix[y][associations[i].first], associations[i].second, 1./65535.);
+            EXPECT_NE(y, associations[i].first);
+            if(i) {
+                EXPECT_GE(associations[i-1].second, associations[i].second);
+            }
+        }
+    }
+
+    // row is affected by N which is in the row or which would enter the row
+    vector<m8r::AaTopKStore::Association> associations{};
+    store.get(0, associations);
+    EXPECT_TRUE(store.isAffectedBy(0, associations[K-1].first, 0.f));
+    EXPECT_TRUE(store.isAffectedBy(0, static_cast<uint32_t>(N), associations[K-1].second));
+    EXPECT_FALSE(store.isAffectedBy(0, static_cast<uint32_t>(N), associations[K-1].second-.01f));
+    store.invalidate(0);
+    EXPECT_FALSE(store.isCalculated(0));
+    EXPECT_TRUE(store.isAffectedBy(0, static_cast<uint32_t>(N), 0.f));
+
+    // memory ~ N x k (dense matrix needs N x N floats)
+    EXPECT_GE(N*K*8, store.getBytesize());
+
+    EXPECT_EQ(0, m8r::AaTopKStore::quantize(-1.f));
+    EXPECT_FLOAT_EQ(1.f, m8r::AaTopKStore::dequantize(m8r::AaTopKStore::quantize(1.f)));
+}
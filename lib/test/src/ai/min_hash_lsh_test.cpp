@@ -0,0 +1,151 @@
+/*
+ min_hash_lsh_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/mind/ai/min_hash_lsh.h"
+
+using namespace std;
+
+TEST(MinHashLshTestCase, RecallAgainstExhaustive)
+{
+    const size_t CLUSTERS = 100;
+    const size_t CLUSTER_SIZE = 10;
+
+    // clusters of similar documents: shared base features w/ noise
+    std::mt19937 random{7};
+    vector<set<uint64_t>> docs{};
+    for(size_t c=0; c<CLUSTERS; c++) {
+        vector<uint64_t> base{};
+        for(int f=0; f<20; f++) {
+            base.push_back(random());
+        }
+        for(size_t d=0; d<CLUSTER_SIZE; d++) {
+            set<uint64_t> doc{base.begin(), base.end()};
+            for(int n=0; n<4; n++) {
+                doc.erase(base[random()%base.size()]);
+                doc.insert(random());
+            }
+            docs.push_back(doc);
+        }
+    }
+    // document w/o features
+    docs.push_back(set<uint64_t>{});
+
+    m8r::MinHashLsh lsh{};
+    for(set<uint64_t>& doc:docs) {
+        lsh.add(vector<uint64_t>{doc.begin(), doc.end()});
+    }
+    lsh.index();
+    ASSERT_EQ(docs.size(), lsh.size());
+
+    // exhaustive: pairs w/ Jaccard similarity >= 0.5
+    size_t similar = 0, found = 0;
+    vector<uint32_t> candidates{};
+    for(uint32_t y=0; y<docs.size(); y++) {
+        lsh.getCandidates(y, candidates);
+        EXPECT_FALSE(std::binary_search(candidates.begin(), candidates.end(), y));
+        for(uint32_t x=0; x<docs.size(); x++) {
+            if(x == y || docs[x].empty() || docs[y].empty()) continue;
+            size_t i = 0;
+            for(uint64_t f:docs[x]) {
+                if(docs[y].count(f)) i++;
+            }
+            float jaccard = static_cast<float>(i)/(docs[x].size()+docs[y].size()-i);
+            if(jaccard >= .5) {
+                similar++;
+                if(std::binary_search(candidates.begin(), candidates.end(), x)) {
+                    found++;
+                }
+            }
+        }
+    }
+    lsh.getCandidates(static_cast<uint32_t>(docs.size()-1), candidates);
+    EXPECT_TRUE(candidates.empty());
+
+    // recall of similar pairs and candidates are only a fraction of all pairs
+    ASSERT_LT(0, similar);
+    cout << "LSH recall: " << found << " / " << similar << " similar pairs" << endl;
+    EXPECT_LE(0.95, static_cast<float>(found)/similar);
+    vector<pair<uint32_t,uint32_t>> pairs{};
+    lsh.getCandidatePairs(pairs);
+    EXPECT_GT(docs.size()*docs.size()/2/20, pairs.size());
+
+    // pairs are the same as candidates of every document
+    size_t candidatesCount = 0;
+    for(uint32_t y=0; y<docs.size(); y++) {
+        lsh.getCandidates(y, candidates);
+        candidatesCount += candidates.size();
+        for(uint32_t x:candidates) {
+            EXPECT_TRUE(std::binary_search(pairs.begin(), pairs.end(), make_pair(std::min(x,y), std::max(x,y))));
+        }
+    }
+    EXPECT_EQ(2*pairs.size(), candidatesCount);
+}
+
+TEST(MinHashLshTestCase, SetSameAsIndex)
+{
+    std::mt19937 random{7};
+    vector<vector<uint64_t>> docs(200);
+    for(vector<uint64_t>& doc:docs) {
+        for(int f=0; f<10; f++) {
+            doc.push_back(random()%300);
+        }
+    }
+
+    m8r::MinHashLsh changed{};
+    for(vector<uint64_t>& doc:docs) {
+        changed.add(doc);
+    }
+    changed.index();
+    // change documents in the index: new features, no features, the same features
+    for(uint32_t d=0; d<docs.size(); d+=3) {
+        docs[d].clear();
+        if(d%2) {
+            for(int f=0; f<10; f++) {
+                docs[d].push_back(random()%300);
+            }
+        }
+        changed.set(d, docs[d]);
+    }
+    changed.set(1, docs[1]);
+
+    // candidates are the same as if documents were indexed w/ changed features
+    m8r::MinHashLsh indexed{};
+    for(vector<uint64_t>& doc:docs) {
+        indexed.add(doc);
+    }
+    indexed.index();
+    vector<uint32_t> expected{}, candidates{};
+    for(uint32_t d=0; d<docs.size(); d++) {
+        indexed.getCandidates(d, expected);
+        changed.getCandidates(d, candidates);
+        EXPECT_EQ(expected, candidates);
+    }
+    vector<pair<uint32_t,uint32_t>> expectedPairs{}, pairs{};
+    indexed.getCandidatePairs(expectedPairs);
+    changed.getCandidatePairs(pairs);
+    EXPECT_EQ(expectedPairs, pairs);
+}
@@ -19,9 +19,14 @@
 
 #include <iostream>
 #include <cstdio>
+#include <chrono>
+#include <thread>
 #include <vector>
 #include <string>
 #include <map>
+#include <random>
+#include <set>
+#include <algorithm>
 
 #include "../../../src/config/configuration.h"
 #include "../../../src/mind/mind.h"
@@ -33,9 +38,12 @@
 #include "../../../src/mind/ai/nlp/lexicon.h"
 #include "../../../src/mind/ai/nlp/word_frequency_list.h"
 #include "../../../src/mind/ai/nlp/bag_of_words.h"
+#include "../../../src/mind/ai/nlp/sparse_word_vectors.h"
 
 #include <gtest/gtest.h>
 
+#include "../test_utils.h"
+
 extern char* getMindforgerGitHomePath();
 
 using namespace std;
@@ -102,6 +110,172 @@ TEST(AiNlpTestCase, Lexicon)
 
     // TODO weights: increase scale
 
+    // dense IDs survive growth of hash table
+    for(int i=0; i<5000; i++) {
+        ASSERT_EQ(3+i, lexicon.add("w"+std::to_string(i))->id);
+    }
+    ASSERT_EQ(5003, lexicon.size());
+    ASSERT_EQ(0, lexicon.get("a5")->id);
+    ASSERT_EQ(4002, lexicon.get("w3999")->id);
+    ASSERT_EQ("w3999", lexicon.getById(4002)->word);
+    ASSERT_EQ(nullptr, lexicon.get("w5000"));
+    lexicon.clear();
+    ASSERT_EQ(0, lexicon.size());
+    ASSERT_EQ(nullptr, lexicon.get("a5"));
+    ASSERT_EQ(0, lexicon.add("a5")->id);
+}
+
+TEST(AiNlpTestCase, WordFrequencyList)
+{
+    m8r::Lexicon lexicon{};
+    m8r::WordFrequencyList wfl{&lexicon};
+    for(uint32_t id:vector<uint32_t>{7, 3, 7, 1}) {
+        wfl.add(id);
+    }
+    EXPECT_EQ(3, wfl.size());
+    EXPECT_EQ((vector<uint32_t>{1, 3, 7}), wfl.getWordIds());
+    EXPECT_EQ((vector<uint32_t>{1, 1, 2}), wfl.getFrequencies());
+
+    // words added after sort are merged
+    for(uint32_t id:vector<uint32_t>{0, 7, 9, 9, 3}) {
+        wfl.add(id);
+    }
+    EXPECT_EQ((vector<uint32_t>{0, 1, 3, 7, 9}), wfl.getWordIds());
+    EXPECT_EQ((vector<uint32_t>{1, 1, 2, 3, 2}), wfl.getFrequencies());
+    EXPECT_EQ(3, wfl.getFrequency(7));
+    EXPECT_TRUE(wfl.contains(0));
+    EXPECT_FALSE(wfl.contains(2));
+    EXPECT_FALSE(wfl.contains(10));
+}
+
+TEST(AiNlpTestCase, SparseWordVectors)
+{
+    // word vector: the heaviest words sorted by ID
+    m8r::Lexicon lexicon{};
+    m8r::WordFrequencyList wfl{&lexicon};
+    for(const string& w:vector<string>{"a", "a", "a", "b", "b", "c", "d", "e"}) {
+        wfl.add(lexicon.add(w)->id);
+    }
+    lexicon.recalculateWeights();
+    vector<pair<uint32_t,float>> entries{};
+    wfl.toSparseVector(entries, 3);
+    ASSERT_EQ(3, entries.size());
+    EXPECT_EQ(lexicon.get("c")->id, entries[0].first);
+    EXPECT_EQ(lexicon.get("e")->id, entries[2].first);
+    EXPECT_FLOAT_EQ(lexicon.get("d")->weight, entries[1].second);
+    wfl.toSparseVector(entries, SIZE_MAX, false);
+    EXPECT_EQ(5, entries.size());
+    EXPECT_FLOAT_EQ(1.f, entries[0].second);
+
+    // similarity is the same as weighted Jaccard of sets
+    std::mt19937 random{7};
+    vector<float> weights(200);
+    for(float& w:weights) {
+        w = (random()%100+1)/100.f;
+    }
+    vector<set<uint32_t>> sets{};
+    m8r::SparseWordVectors vectors{};
+    for(int v=0; v<50; v++) {
+        set<uint32_t> words{};
+        size_t size = v%10?random()%30:0;
+        while(words.size() < size) {
+            words.insert(random()%weights.size());
+        }
+        entries.clear();
+        for(uint32_t w:words) {
+            entries.push_back(make_pair(w, weights[w]));
+        }
+        EXPECT_EQ(sets.size(), vectors.add(entries));
+        sets.push_back(words);
+    }
+    for(size_t v1=0; v1<sets.size(); v1++) {
+        for(size_t v2=0; v2<sets.size(); v2++) {
+            float iWeight=0, uWeight=0;
+            for(uint32_t w:sets[v1]) {
+                uWeight += weights[w];
+                if(sets[v2].count(w)) iWeight += weights[w];
+            }
+            for(uint32_t w:sets[v2]) {
+                if(!sets[v1].count(w)) uWeight += weights[w];
+            }
+            float expected = sets[v1].empty()||sets[v2].empty()?0.f:iWeight/uWeight;
+            EXPECT_NEAR(expected, vectors.similarity(v1, v2), 0.0001);
+        }
+    }
+    EXPECT_FLOAT_EQ(1.f, vectors.similarity(1, 1));
+
+    // relevant similarity is the same as BoW AA always calculated: threshold heaviest
+    // words of v1 and threshold-1 heaviest words of v2 checked against all words of the other
+    const size_t threshold = 10;
+    auto relevant = [&weights](const set<uint32_t>& words, size_t limit) {
+        vector<uint32_t> r(words.begin(), words.end());
+        std::stable_sort(r.begin(), r.end(), [&weights](uint32_t w1, uint32_t w2) { return weights[w1] > weights[w2]; });
+        if(r.size() > limit) r.resize(limit);
+        return r;
+    };
+    for(size_t v1=0; v1<sets.size(); v1++) {
+        for(size_t v2=0; v2<sets.size(); v2++) {
+            float iWeight=0, uWeight=0;
+            set<uint32_t> intersection{};
+            for(uint32_t w:relevant(sets[v1], threshold)) {
+                uWeight += weights[w];
+                if(sets[v2].count(w)) {
+                    iWeight += weights[w];
+                    intersection.insert(w);
+                }
+            }
+            for(uint32_t w:relevant(sets[v2], threshold-1)) {
+                if(!intersection.count(w)) {
+                    uWeight += weights[w];
+                    if(sets[v1].count(w)) iWeight += weights[w];
+                }
+            }
+            float expected = sets[v1].empty()||sets[v2].empty()?0.f:iWeight/uWeight;
+            EXPECT_NEAR(expected, vectors.relevantSimilarity(v1, v2, threshold), 0.0001);
+        }
+    }
+
+    // changed vectors: shorter, longer and reweighted by lexicon
+    entries.clear();
+    entries.push_back(make_pair(lexicon.get("a")->id, 1.f));
+    vectors.set(1, entries);
+    EXPECT_EQ(1, vectors.getEntriesCount(1));
+    entries.push_back(make_pair(lexicon.get("b")->id, 1.f));
+    vectors.set(0, entries);
+    EXPECT_EQ(2, vectors.getEntriesCount(0));
+    EXPECT_FLOAT_EQ(.5f, vectors.similarity(0, 1));
+    m8r::SparseWordVectors words{};
+    words.add(entries);
+    entries.pop_back();
+    words.add(entries);
+    words.reweight(lexicon);
+    float a = lexicon.get("a")->weight, b = lexicon.get("b")->weight;
+    EXPECT_FLOAT_EQ(a/(a+b), words.similarity(0, 1));
+
+    // repeatedly growing vectors are compacted i.e. arrays don't grow with updates
+    for(int update=1; update<100; update++) {
+        size_t v = update%sets.size();
+        entries.clear();
+        sets[v].clear();
+        for(uint32_t w=0; w<static_cast<uint32_t>(update%20+1); w++) {
+            entries.push_back(make_pair(w, weights[w]));
+            sets[v].insert(w);
+        }
+        vectors.set(v, entries);
+        size_t live = 0;
+        for(size_t v=0; v<vectors.size(); v++) {
+            live += vectors.getEntriesCount(v);
+        }
+        EXPECT_EQ(live+vectors.getGarbageCount(), vectors.getCapacity());
+        EXPECT_LE(vectors.getCapacity(), 2*live+20);
+    }
+    for(size_t v=0; v<sets.size(); v++) {
+        ASSERT_EQ(sets[v].size(), vectors.getEntriesCount(v));
+        EXPECT_TRUE(equal(sets[v].begin(), sets[v].end(), vectors.getIds(v)));
+    }
+    vectors.compact();
+    EXPECT_EQ(0, vectors.getGarbageCount());
+    EXPECT_FLOAT_EQ(1.f, vectors.similarity(2, 2));
 }
 
 // DISABLED test because 3rd party stemmer has memory leaks()
@@ -297,6 +471,225 @@ TEST(AiNlpTestCase, DISABLED_AaUniverseBow)
     ASSERT_EQ("Alternative Universe", (*leaderboard)[1].first->getOutline()->getName());
 }
 
+vector<string> getAssociatedNoteNames(m8r::Mind& mind, m8r::Note* n)
+{
+    // 1st request calculates leaderboard, 2nd one gets it from cache
+    m8r::AssociatedNotes calculated{m8r::ResourceType::NOTE, n};
+    mind.getAssociatedNotes(calculated).get();
+    m8r::AssociatedNotes cached{m8r::ResourceType::NOTE, n};
+    mind.getAssociatedNotes(cached).get();
+
+    vector<string> names{};
+    for(auto& a:*cached.getAssociations()) {
+        names.push_back(a.first->getName());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST(AiNlpTestCase, AaBowChangedNotes)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-bow-changed-notes"};
+    map<string,string> pathToContent;
+    pathToContent[repositoryPath+"/memory/space.md"].assign(
+        "# Space"
+        "\n"
+        "\n## Stars"
+        "\nStars are giant balls of hot gas shining in galaxies."
+        "\n"
+        "\n## Galaxies"
+        "\nGalaxies are systems of stars, gas and dust."
+        "\n"
+        "\n## Planets"
+        "\nPlanets orbit stars."
+        "\n"
+        "\n## Cooking"
+        "\nPasta with tomato sauce."
+        "\n"
+        "\n## Baking"
+        "\nBread made of flour."
+        "\n");
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abcn.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    m8r::Note* stars = o->getNoteByName("Stars");
+    ASSERT_NE(nullptr, stars);
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Cooking", "Galaxies", "Planets"}),
+        getAssociatedNoteNames(mind, stars));
+
+    // delete N which is in the leaderboard and edit another N
+    mind.noteForget(o->getNoteByName("Galaxies"));
+    m8r::Note* cooking = o->getNoteByName("Cooking");
+    cooking->setName("Cooking under the stars");
+    cooking->makeModified();
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Cooking under the stars", "Planets"}),
+        getAssociatedNoteNames(mind, stars));
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Planets", "Stars"}),
+        getAssociatedNoteNames(mind, cooking));
+
+    // edit N w/o deletion (changed N is learned incrementally)
+    cooking->setName("Cooking");
+    cooking->makeModified();
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Cooking", "Planets"}),
+        getAssociatedNoteNames(mind, stars));
+
+    // add N
+    string name{"Comets"};
+    mind.noteNew(o->getKey(), 0, &name);
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Comets", "Cooking", "Planets"}),
+        getAssociatedNoteNames(mind, stars));
+}
+
+TEST(AiNlpTestCase, AaBowChangedMarkdowns)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-bow-changed-markdowns"};
+    string spacePath{repositoryPath+"/memory/space.md"};
+    auto space = [](const string& cooking) {
+        return "# Space"
+            "\n"
+            "\n## Stars"
+            "\nStars are giant balls of hot gas shining in galaxies."
+            "\n"
+            "\n## Galaxies"
+            "\nGalaxies are systems of stars, gas and dust."
+            "\n"
+            "\n## " + cooking +
+            "\nPasta with tomato sauce."
+            "\n";
+    };
+    map<string,string> pathToContent;
+    pathToContent[spacePath] = space("Cooking");
+    pathToContent[repositoryPath+"/memory/kitchen.md"].assign(
+        "# Kitchen"
+        "\n"
+        "\n## Baking"
+        "\nBread made of flour."
+        "\n");
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abcm.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_TRUE(mind.remind().getRepositoryIndexer().isWatching());
+    m8r::Note* stars = mind.remind().getOutline(spacePath)->getNoteByName("Stars");
+    ASSERT_NE(nullptr, stars);
+    int starsId = stars->getAiAaMatrixIndex();
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Cooking", "Galaxies"}),
+        getAssociatedNoteNames(mind, stars));
+
+    // external change of Markdown replaces O > its Ns take IDs of replaced Ns
+    m8r::stringToFile(spacePath, space("Cooking under the stars"));
+    vector<m8r::RepositoryChange> changes{};
+    vector<m8r::RepositoryChange> postponed{};
+    mind.learnChanges(changes, postponed);
+    this_thread::sleep_for(chrono::milliseconds(m8r::RepositoryIndexer::WATCH_DEBOUNCE_MILLIS+100));
+    ASSERT_TRUE(mind.learnChanges(changes, postponed));
+    m8r::Outline* o = mind.remind().getOutline(spacePath);
+    ASSERT_NE(stars->getOutline(), o);
+    stars = o->getNoteByName("Stars");
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Cooking under the stars", "Galaxies"}),
+        getAssociatedNoteNames(mind, stars));
+    EXPECT_EQ(starsId, stars->getAiAaMatrixIndex());
+    EXPECT_EQ(
+        (vector<string>{"Baking", "Galaxies", "Stars"}),
+        getAssociatedNoteNames(mind, o->getNoteByName("Cooking under the stars")));
+}
+
+vector<pair<string,float>> getAssociatedNoteScores(m8r::Mind& mind, m8r::Note* n)
+{
+    m8r::AssociatedNotes calculated{m8r::ResourceType::NOTE, n};
+    mind.getAssociatedNotes(calculated).get();
+    m8r::AssociatedNotes cached{m8r::ResourceType::NOTE, n};
+    mind.getAssociatedNotes(cached).get();
+
+    vector<pair<string,float>> scores{};
+    for(auto& a:*cached.getAssociations()) {
+        scores.push_back(make_pair(a.first->getName(), a.second));
+    }
+    return scores;
+}
+
+TEST(AiNlpTestCase, AaBowSimilarityScores)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-bow-scores"};
+    map<string,string> pathToContent;
+    pathToContent[repositoryPath+"/memory/space.md"].assign(
+        "# Space"
+        "\n"
+        "\n## Bright stars"
+        "\nStars shine in galaxies and stars burn hydrogen."
+        "\n"
+        "\n## Dwarf stars"
+        "\nDwarf stars burn hydrogen slowly."
+        "\n"
+        "\n## Galaxies"
+        "\nGalaxies are made of stars, gas and dust."
+        "\n"
+        "\n## Bread"
+        "\nBread is made of flour and water."
+        "\n");
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abss.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+
+    // scores are 0.1 (same type) + 0.05 (same O) + 0.2 (no tags) + 0.2 x title + 0.45 x description
+    // similarity, where title words are weighted by the same lexicon as description words and Ns are
+    // short i.e. all their words are relevant (and similarity is symmetric)
+    vector<pair<string,float>> bright = getAssociatedNoteScores(mind, o->getNoteByName("Bright stars"));
+    ASSERT_EQ(3, bright.size());
+    EXPECT_EQ("Dwarf stars", bright[0].first);
+    EXPECT_NEAR(0.479255, bright[0].second, 0.0001);
+    EXPECT_EQ("Galaxies", bright[1].first);
+    EXPECT_NEAR(0.390433, bright[1].second, 0.0001);
+    EXPECT_EQ("Bread", bright[2].first);
+    EXPECT_NEAR(0.35, bright[2].second, 0.0001);
+
+    vector<pair<string,float>> dwarf = getAssociatedNoteScores(mind, o->getNoteByName("Dwarf stars"));
+    ASSERT_EQ(3, dwarf.size());
+    EXPECT_EQ("Bright stars", dwarf[0].first);
+    EXPECT_FLOAT_EQ(bright[0].second, dwarf[0].second);
+    EXPECT_EQ("Galaxies", dwarf[1].first);
+    EXPECT_NEAR(0.35079, dwarf[1].second, 0.0001);
+    EXPECT_EQ("Bread", dwarf[2].first);
+    EXPECT_NEAR(0.35, dwarf[2].second, 0.0001);
+}
+
 /*
  * AA: FTS
  */
@@ -157,3 +157,30 @@ TEST(FileGearTestCase, DeepCopyToExisting)
     p.assign(dstRepositoryDir); p.append("/stencils/notebooks/s-o1.md");
     ASSERT_TRUE(m8r::isDirectoryOrFileExists(p.c_str()));
 }
+
+TEST(FileGearTestCase, MappedFile)
+{
+    string file{m8r::platformSpecificPath("/tmp/mf-file-gear-mapped.md")};
+    string content{"# Mapped Outline\n\nOutline text.\n"};
+    m8r::stringToFile(file, content);
+
+    // cold start files are mapped
+    {
+        m8r::filesystem::MappedFile mapped{file};
+#ifndef _WIN32
+        EXPECT_TRUE(mapped.isMapped());
+#endif
+        ASSERT_EQ(content.size(), mapped.getSize());
+        EXPECT_EQ(content, string(mapped.getData(), mapped.getSize()));
+    }
+
+    // files which might be truncated meanwhile are read to buffer
+    m8r::filesystem::MappedFile read{file, false};
+    EXPECT_FALSE(read.isMapped());
+    ASSERT_EQ(content.size(), read.getSize());
+    m8r::stringToFile(file, "#");
+    EXPECT_EQ(content, string(read.getData(), read.getSize()));
+
+    m8r::filesystem::MappedFile empty{"/tmp/mf-file-gear-mapped-missing.md", false};
+    EXPECT_EQ(0, empty.getSize());
+}
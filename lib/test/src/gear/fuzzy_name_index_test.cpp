@@ -0,0 +1,193 @@
+/*
+ fuzzy_name_index_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/fuzzy_name_index.h"
+
+using namespace std;
+
+namespace {
+
+int levenshtein(const string& s1, const string& s2)
+{
+    vector<int> row(s2.size()+1);
+    for(size_t j=0; j<row.size(); j++) row[j] = static_cast<int>(j);
+    for(size_t i=1; i<=s1.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for(size_t j=1; j<=s2.size(); j++) {
+            int above = row[j];
+            row[j] = std::min(std::min(row[j]+1, row[j-1]+1), diagonal + (s1[i-1]!=s2[j-1]?1:0));
+            diagonal = above;
+        }
+    }
+    return row[s2.size()];
+}
+
+} // anonymous namespace
+
+TEST(FuzzyNameIndexTestCase, Lookup)
+{
+    m8r::FuzzyNameIndex index{};
+    vector<string> names{
+        "Kubernetes",
+        "Kubernetes Cluster Setup",
+        "Docker",
+        "Cooking",
+        "Books to Read",
+        "Kubectl Cheatsheet",
+    };
+    for(size_t i=0; i<names.size(); i++) {
+        // the later, the more recent
+        index.add(names[i], static_cast<uint32_t>(i), static_cast<long long>(i));
+    }
+    EXPECT_EQ(names.size(), index.size());
+
+    // typo: the whole name before the (more recent) prefix match
+    vector<m8r::FuzzyNameIndex::Match> matches{};
+    index.find("kuberntes", matches, 10);
+    ASSERT_EQ(2, matches.size());
+    EXPECT_EQ(0, matches[0].id);
+    EXPECT_EQ(1, matches[0].distance);
+    EXPECT_FALSE(matches[0].prefix);
+    EXPECT_EQ(1, matches[1].id);
+    EXPECT_TRUE(matches[1].prefix);
+
+    // name being typed
+    matches.clear();
+    index.find("Kube", matches, 10);
+    ASSERT_EQ(3, matches.size());
+    // exact prefix matches ordered by recency
+    EXPECT_EQ(5, matches[0].id);
+    EXPECT_EQ(1, matches[1].id);
+    EXPECT_EQ(0, matches[2].id);
+    EXPECT_EQ(0, matches[2].distance);
+    EXPECT_TRUE(matches[2].prefix);
+
+    // word in the middle of the name
+    matches.clear();
+    index.find("clustr", matches, 10);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(1, matches[0].id);
+
+    // limit
+    matches.clear();
+    index.find("kube", matches, 1);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(5, matches[0].id);
+
+    // short query must match exactly, distance can be given
+    matches.clear();
+    index.find("xo", matches, 10);
+    EXPECT_EQ(0, matches.size());
+    index.find("xocker", matches, 10, 1);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(2, matches[0].id);
+
+    // index can be extended after lookup
+    index.add("Kubernetes Operators", static_cast<uint32_t>(names.size()));
+    matches.clear();
+    index.find("kubernetes operator", matches, 10);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(names.size(), matches[0].id);
+
+    // removed names are not found, other names are kept sorted
+    index.remove(0);
+    index.remove(static_cast<uint32_t>(names.size()));
+    EXPECT_EQ(names.size()-1, index.size());
+    EXPECT_EQ(2, index.getRemovedCount());
+    index.add("Kubernetes Ingress", static_cast<uint32_t>(names.size()+1));
+    matches.clear();
+    index.find("kuberntes", matches, 10);
+    ASSERT_EQ(2, matches.size());
+    EXPECT_EQ(1, matches[0].id);
+    EXPECT_EQ(names.size()+1, matches[1].id);
+    matches.clear();
+    index.find("Kube", matches, 10);
+    ASSERT_EQ(3, matches.size());
+    EXPECT_EQ(5, matches[0].id);
+    EXPECT_EQ(1, matches[1].id);
+    EXPECT_EQ(names.size()+1, matches[2].id);
+    matches.clear();
+    index.find("docker", matches, 10);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(2, matches[0].id);
+
+    index.clear();
+    matches.clear();
+    index.find("kube", matches, 10);
+    EXPECT_EQ(0, matches.size());
+}
+
+TEST(FuzzyNameIndexTestCase, SameAsBruteForce)
+{
+    // random names over small alphabet share prefixes > pruning and row reuse are exercised
+    std::mt19937 random{42};
+    const string alphabet{"abcd "};
+    vector<string> names{};
+    m8r::FuzzyNameIndex index{};
+    for(uint32_t i=0; i<3000; i++) {
+        string name{};
+        size_t length = 1 + random()%10;
+        for(size_t c=0; c<length; c++) {
+            name += alphabet[random()%alphabet.size()];
+        }
+        names.push_back(name);
+        index.add(name, i);
+    }
+
+    for(int q=0; q<100; q++) {
+        string query{};
+        size_t length = 1 + random()%7;
+        for(size_t c=0; c<length; c++) {
+            query += alphabet[random()%(alphabet.size()-1)];
+        }
+        const int k = m8r::FuzzyNameIndex::maxDistance(query.size());
+
+        vector<m8r::FuzzyNameIndex::Match> matches{};
+        index.find(query, matches, names.size());
+        vector<int> found(names.size(), -1);
+        for(auto& m:matches) {
+            found[m.id] = m.distance;
+        }
+
+        for(size_t i=0; i<names.size(); i++) {
+            // the best distance to the whole name, its prefix or word suffix (prefix)
+            int expected = -1;
+            vector<string> keys{names[i]};
+            for(size_t p=1; p<names[i].size(); p++) {
+                if(names[i][p-1]==' ' && names[i][p]!=' ') keys.push_back(names[i].substr(p));
+            }
+            for(const string& key:keys) {
+                for(size_t prefix=0; prefix<=key.size(); prefix++) {
+                    int d = levenshtein(query, key.substr(0, prefix));
+                    if(d<=k && (expected<0 || d<expected)) expected = d;
+                }
+            }
+            ASSERT_EQ(expected, found[i]) << "'" << query << "' vs. '" << names[i] << "'";
+        }
+    }
+}
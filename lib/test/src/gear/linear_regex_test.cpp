@@ -0,0 +1,145 @@
+/*
+ linear_regex_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/linear_regex.h"
+
+using namespace std;
+
+TEST(LinearRegexTestCase, SameAsStdRegex)
+{
+    vector<string> patterns{
+        "",
+        "hash",
+        "lo*king",
+        "^# ",
+        "end$",
+        "^$",
+        "a.c",
+        "colou?r",
+        "ab+c",
+        "(ab|cd)+e",
+        "(?:ab|cd){2}",
+        "x{2,}",
+        "x{1,3}y",
+        "x{0}y",
+        "[a-c]+d",
+        "[^a-z ]",
+        "[-a]b",
+        "[a-]b",
+        "\\d{2,4}",
+        "\\w+@\\w+\\.com",
+        "\\s\\S",
+        "[\\d\\s]x",
+        "\\bcat\\b",
+        "\\Bat",
+        "\\.\\*\\(",
+        "\\x41B",
+        "a|b|",
+        "(a*)*b",
+        "^(foo|bar)baz$",
+        ".*?end",
+        "[.]",
+    };
+    vector<string> texts{
+        "",
+        "hash map",
+        "Hash",
+        "looking for lking",
+        "# Heading",
+        "the end",
+        "end of the story",
+        "abc a-c a\nc",
+        "color and colour",
+        "abbbc ac",
+        "abcde cdabe ababe",
+        "cdab abab",
+        "xx xxx x",
+        "xxxy xxxxy",
+        "y",
+        "abcd cd",
+        "ABC 123",
+        "-b ab",
+        "bb",
+        "12 123456",
+        "me@example.com",
+        " x",
+        "cat concatenate",
+        "bat at",
+        ".*(",
+        "AB ab",
+        "foobaz",
+        "barbaz!",
+        "aaab",
+        "a.b",
+    };
+
+    for(const string& p:patterns) {
+        m8r::LinearRegex linear{p};
+        EXPECT_FALSE(linear.isFallback()) << p;
+        std::regex regex{p};
+        for(const string& t:texts) {
+            EXPECT_EQ(std::regex_search(t, regex), linear.search(t)) << "'" << p << "' in '" << t << "'";
+        }
+    }
+}
+
+TEST(LinearRegexTestCase, LiteralAndFallback)
+{
+    EXPECT_EQ("king", m8r::LinearRegex{"lo*king"}.getLiteral());
+    EXPECT_EQ("hij.k", m8r::LinearRegex{"^abc(de|fg)+hij\\.k[lm]"}.getLiteral());
+    EXPECT_EQ("", m8r::LinearRegex{"abcd|efgh"}.getLiteral());
+
+    m8r::LinearRegex literal{"needle"};
+    EXPECT_TRUE(literal.mayMatch("haystack\nwith needle"));
+    EXPECT_FALSE(literal.mayMatch("haystack w/o it"));
+
+    // unsupported regexps are searched by std::regex
+    m8r::LinearRegex backreference{"(a)\\1"};
+    EXPECT_TRUE(backreference.isFallback());
+    EXPECT_TRUE(backreference.search("baab"));
+    EXPECT_FALSE(backreference.search("bab"));
+    m8r::LinearRegex lookahead{"a(?=b)"};
+    EXPECT_TRUE(lookahead.isFallback());
+    EXPECT_TRUE(lookahead.search("ab"));
+    EXPECT_FALSE(lookahead.search("ac"));
+
+    // invalid regexp
+    EXPECT_THROW(m8r::LinearRegex{"(abc"}, std::regex_error);
+    EXPECT_THROW(m8r::LinearRegex{"*abc"}, std::regex_error);
+}
+
+TEST(LinearRegexTestCase, LongLine)
+{
+    // backtracking engine would run out of stack
+    string line(1000000, 'a');
+    line += 'c';
+    m8r::LinearRegex regex{"(a|b)*c"};
+    EXPECT_TRUE(regex.search(line));
+    line.back() = 'd';
+    EXPECT_FALSE(regex.search(line));
+    m8r::LinearRegex boundary{"\\b(a|b)*d"};
+    EXPECT_TRUE(boundary.search(line));
+}
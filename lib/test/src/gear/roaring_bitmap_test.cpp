@@ -0,0 +1,112 @@
+/*
+ roaring_bitmap_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/roaring_bitmap.h"
+
+using namespace std;
+
+namespace {
+
+vector<uint32_t> toVector(const m8r::RoaringBitmap& bitmap)
+{
+    vector<uint32_t> values{};
+    bitmap.toVector(values);
+    return values;
+}
+
+} // anonymous namespace
+
+TEST(RoaringBitmapTestCase, AddRemove)
+{
+    m8r::RoaringBitmap bitmap{};
+    EXPECT_TRUE(bitmap.empty());
+    bitmap.add(7);
+    bitmap.add(70000);
+    bitmap.add(3);
+    bitmap.add(7);
+    EXPECT_EQ(3, bitmap.cardinality());
+    EXPECT_EQ((vector<uint32_t>{3, 7, 70000}), toVector(bitmap));
+    EXPECT_TRUE(bitmap.contains(70000));
+    EXPECT_FALSE(bitmap.contains(70001));
+
+    bitmap.remove(70000);
+    bitmap.remove(8);
+    EXPECT_EQ((vector<uint32_t>{3, 7}), toVector(bitmap));
+
+    // dense chunk is converted to bitmap and back
+    for(uint32_t i=0; i<m8r::RoaringBitmap::ARRAY_MAX-1; i++) {
+        bitmap.add(i*2);
+    }
+    EXPECT_EQ(1, bitmap.getBitmapChunksCount());
+    EXPECT_EQ(m8r::RoaringBitmap::ARRAY_MAX+1, bitmap.cardinality());
+    bitmap.remove(0);
+    EXPECT_EQ(0, bitmap.getBitmapChunksCount());
+    EXPECT_TRUE(bitmap.contains(3));
+    EXPECT_FALSE(bitmap.contains(0));
+}
+
+TEST(RoaringBitmapTestCase, SameAsSet)
+{
+    std::mt19937 random{42};
+    // sparse and dense chunks
+    vector<pair<uint32_t,uint32_t>> distributions{{100000, 500}, {20000, 15000}, {70000, 30000}};
+    for(auto& d1:distributions) {
+        for(auto& d2:distributions) {
+            std::uniform_int_distribution<uint32_t> v1{0, d1.first}, v2{0, d2.first};
+            m8r::RoaringBitmap b1{}, b2{};
+            set<uint32_t> s1{}, s2{};
+            for(uint32_t i=0; i<d1.second; i++) {
+                uint32_t v = v1(random);
+                b1.add(v);
+                s1.insert(v);
+            }
+            for(uint32_t i=0; i<d2.second; i++) {
+                uint32_t v = v2(random);
+                b2.add(v);
+                s2.insert(v);
+            }
+            ASSERT_EQ(vector<uint32_t>(s1.begin(), s1.end()), toVector(b1));
+
+            vector<uint32_t> expected{};
+            std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+            m8r::RoaringBitmap intersection{b1};
+            intersection.intersect(b2);
+            EXPECT_EQ(expected, toVector(intersection));
+            EXPECT_EQ(expected.size(), intersection.cardinality());
+
+            expected.clear();
+            std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+            m8r::RoaringBitmap united{b1};
+            united.unite(b2);
+            EXPECT_EQ(expected, toVector(united));
+            EXPECT_EQ(expected.size(), united.cardinality());
+            for(uint32_t v:s2) {
+                EXPECT_TRUE(united.contains(v));
+            }
+        }
+    }
+}
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include "../../../src/gear/string_utils.h"
+#include "../../../src/gear/string_interner.h"
 
 using namespace std;
 using namespace m8r;
@@ -120,3 +121,56 @@ TEST(StringGearTestCase, StringTweaks)
 
     ASSERT_STREQ("a2345", s.c_str());
 }
+
+TEST(StringGearTestCase, StringInterner)
+{
+    StringInterner interner{};
+    ASSERT_EQ(0, interner.size());
+    ASSERT_EQ(StringInterner::NO_ID, interner.find("/a/b.md"));
+
+    StringInterner::Id ab = interner.intern("/a/b.md");
+    StringInterner::Id ac = interner.intern("/a/c.md");
+    ASSERT_NE(StringInterner::NO_ID, ab);
+    ASSERT_NE(ab, ac);
+    ASSERT_EQ(ab, interner.intern(string{"/a/"}+"b.md"));
+    ASSERT_EQ(ac, interner.find("/a/c.md"));
+    ASSERT_EQ(2, interner.size());
+
+    // interned strings survive rehashing
+    const string& abs = interner.get(ab);
+    for(int i=0; i<1000; i++) {
+        interner.intern(std::to_string(i));
+    }
+    ASSERT_EQ("/a/b.md", abs);
+    ASSERT_EQ("/a/c.md", interner.get(ac));
+    ASSERT_EQ("", interner.get(StringInterner::NO_ID));
+}
+
+TEST(StringGearTestCase, FindIgnoreCase)
+{
+    string s{"Hello MindForger, mindFORGER is thinking NOTEBOOK - ŽLUŤOUČKÝ kůň."};
+    ASSERT_EQ(6, stringFindIgnoreCase(s, "mindforger"));
+    ASSERT_EQ(18, stringFindIgnoreCase(s, "mindforger", 7));
+    ASSERT_EQ(0, stringFindIgnoreCase(s, "h"));
+    ASSERT_EQ(s.size()-1, stringFindIgnoreCase(s, "."));
+    ASSERT_EQ(string::npos, stringFindIgnoreCase(s, "notebooks"));
+    ASSERT_EQ(3, stringFindIgnoreCase(s, "", 3));
+    ASSERT_EQ(string::npos, stringFindIgnoreCase(s, "", s.size()+1));
+    ASSERT_EQ(string::npos, stringFindIgnoreCase("", "a"));
+
+    // identical to lower + find on all positions and needle lengths (SIMD blocks and tail)
+    string text{};
+    for(int i=0; i<500; i++) {
+        text += static_cast<char>("aBcDeFxYz 0@[`{\xC5\xBD\n"[(i*7+i/13)%19]);
+    }
+    string lowerText{};
+    stringToLower(text, lowerText);
+    for(size_t length=1; length<40; length+=3) {
+        for(size_t from=0; from+length<=lowerText.size(); from+=11) {
+            string needle = lowerText.substr(from, length);
+            for(size_t pos=0; pos<lowerText.size(); pos+=97) {
+                ASSERT_EQ(lowerText.find(needle, pos), stringFindIgnoreCase(text, needle, pos));
+            }
+        }
+    }
+}
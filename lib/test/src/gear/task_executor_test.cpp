@@ -0,0 +1,137 @@
+/*
+ task_executor_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/task_executor.h"
+
+using namespace std;
+
+TEST(TaskExecutorTestCase, Async)
+{
+    m8r::TaskExecutor executor{4};
+    EXPECT_EQ(4, executor.getWorkersCount());
+
+    vector<shared_future<int>> results{};
+    for(int i=0; i<100; i++) {
+        results.push_back(executor.async([i]() { return i*i; }));
+    }
+    for(int i=0; i<100; i++) {
+        EXPECT_EQ(i*i, results[i].get());
+    }
+
+    // task waits for its subtasks - the only worker runs them while it waits
+    m8r::TaskExecutor single{1};
+    shared_future<int> sum = single.async([&single]() {
+        atomic<int> s{0};
+        vector<m8r::TaskExecutor::TaskHandle> subtasks{};
+        for(int i=1; i<=10; i++) {
+            subtasks.push_back(single.submit([&s,i]() { s += i; }));
+        }
+        for(m8r::TaskExecutor::TaskHandle& t:subtasks) {
+            single.wait(t);
+        }
+        return s.load();
+    });
+    EXPECT_EQ(55, sum.get());
+}
+
+TEST(TaskExecutorTestCase, PrioritiesAndCancellation)
+{
+    m8r::TaskExecutor executor{1};
+
+    // block the only worker
+    promise<void> blocker{};
+    shared_future<void> unblocked = blocker.get_future().share();
+    m8r::TaskExecutor::TaskHandle blocking = executor.submit([unblocked]() { unblocked.wait(); });
+    while(executor.getPendingCount()) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    mutex orderMutex{};
+    vector<string> order{};
+    auto record = [&order,&orderMutex](const string& name) {
+        return [&order,&orderMutex,name]() {
+            lock_guard<mutex> criticalSection{orderMutex};
+            order.push_back(name);
+        };
+    };
+    vector<m8r::TaskExecutor::TaskHandle> tasks{};
+    tasks.push_back(executor.submit(record("low"), m8r::TaskExecutor::Priority::LOW));
+    tasks.push_back(executor.submit(record("normal"), m8r::TaskExecutor::Priority::NORMAL));
+    tasks.push_back(executor.submit(record("cancelled"), m8r::TaskExecutor::Priority::HIGH));
+    tasks.push_back(executor.submit(record("high"), m8r::TaskExecutor::Priority::HIGH));
+    m8r::TaskExecutor::TaskHandle cancelledAsync{};
+    shared_future<bool> cancelledResult
+        = executor.async([]() { return true; }, m8r::TaskExecutor::Priority::HIGH, &cancelledAsync);
+    EXPECT_EQ(5, executor.getPendingCount());
+    tasks[2]->cancel();
+    cancelledAsync->cancel();
+
+    blocker.set_value();
+    for(m8r::TaskExecutor::TaskHandle& t:tasks) {
+        executor.wait(t);
+        EXPECT_TRUE(t->isDone());
+    }
+    executor.wait(cancelledAsync);
+
+    EXPECT_TRUE(blocking->isDone());
+    EXPECT_EQ((vector<string>{"high", "normal", "low"}), order);
+    EXPECT_THROW(cancelledResult.get(), future_error);
+}
+
+TEST(TaskExecutorTestCase, Stealing)
+{
+    m8r::TaskExecutor executor{2};
+
+    // subtask is queued by busy worker > it can be run only by the other worker
+    atomic<bool> stolen{false};
+    shared_future<bool> result = executor.async([&executor,&stolen]() {
+        executor.submit([&stolen]() { stolen = true; });
+        for(int i=0; i<5000 && !stolen; i++) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return stolen.load();
+    });
+    EXPECT_TRUE(result.get());
+
+    // running task checks whether it was cancelled
+    atomic<bool> started{false};
+    m8r::TaskExecutor::TaskHandle cooperative = executor.submit([&started]() {
+        started = true;
+        while(!m8r::TaskExecutor::isCurrentTaskCancelled()) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    });
+    while(!started) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    cooperative->cancel();
+    executor.wait(cooperative);
+    EXPECT_TRUE(cooperative->isDone());
+    EXPECT_FALSE(m8r::TaskExecutor::isCurrentTaskCancelled());
+}
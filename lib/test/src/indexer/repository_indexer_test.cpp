@@ -17,6 +17,9 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include "../../../src/repository_indexer.h"
@@ -184,6 +187,160 @@ TEST(RepositoryIndexerTestCase, MindForgerRepository)
     delete outlineAsString;
 }
 
+#ifdef __linux__
+TEST(RepositoryIndexerTestCase, WatchChanges)
+{
+    string repositoryPath{"/tmp/mf-unit-repository-indexer-watch"};
+    map<string,string> pathToContent;
+    string o1Path{repositoryPath + "/memory/first.md"};
+    pathToContent[o1Path] = "# First Outline\n\nFirst outline text.\n\n## Note 1\nNote 1 text.\n";
+    string o2Path{repositoryPath + "/memory/second.md"};
+    pathToContent[o2Path] = "# Second Outline\n\nSecond outline text.\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ritc-wc.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    m8r::RepositoryIndexer& repositoryIndexer = memory.getRepositoryIndexer();
+    ASSERT_TRUE(repositoryIndexer.isWatching());
+    ASSERT_EQ(2, memory.getOutlinesCount());
+
+    // files written by MindForger are not reported
+    vector<m8r::RepositoryChange> changes{};
+    vector<m8r::RepositoryChange> postponed{};
+    memory.remember(o1Path);
+    EXPECT_FALSE(repositoryIndexer.getChanges(changes, 0));
+
+    // external modification, deletion and creation (new directory)
+    m8r::stringToFile(o1Path, "# First Outline Changed\n\nFirst outline text.\n");
+    m8r::stringToFile(o1Path, "# First Outline Changed Twice\n\nFirst outline text.\n");
+    remove(o2Path.c_str());
+    m8r::createDirectory(repositoryPath + "/memory/sub");
+    string o3Path{repositoryPath + "/memory/sub/third.md"};
+    m8r::stringToFile(o3Path, "# Third Outline\n\nThird outline text.\n");
+
+    // changes are kept pending until they calm down
+    EXPECT_FALSE(mind.learnChanges(changes, postponed));
+    this_thread::sleep_for(chrono::milliseconds(m8r::RepositoryIndexer::WATCH_DEBOUNCE_MILLIS+100));
+    ASSERT_TRUE(mind.learnChanges(changes, postponed));
+    ASSERT_EQ(3, changes.size());
+    for(m8r::RepositoryChange& c:changes) {
+        if(c.path == o1Path) {
+            EXPECT_EQ(m8r::RepositoryChange::Type::MODIFIED, c.type);
+        } else if(c.path == o2Path) {
+            EXPECT_EQ(m8r::RepositoryChange::Type::DELETED, c.type);
+        } else {
+            EXPECT_EQ(o3Path, c.path);
+            EXPECT_EQ(m8r::RepositoryChange::Type::ADDED, c.type);
+        }
+    }
+
+    // only changed Os were relearned
+    EXPECT_EQ(2, memory.getOutlinesCount());
+    EXPECT_EQ(2, repositoryIndexer.getMarkdownFiles().size());
+    ASSERT_NE(nullptr, memory.getOutline(o1Path));
+    EXPECT_EQ("First Outline Changed Twice", memory.getOutline(o1Path)->getName());
+    EXPECT_EQ(nullptr, memory.getOutline(o2Path));
+    ASSERT_NE(nullptr, memory.getOutline(o3Path));
+    EXPECT_EQ("Third Outline", memory.getOutline(o3Path)->getName());
+
+    changes.clear();
+    EXPECT_FALSE(mind.learnChanges(changes, postponed));
+    EXPECT_TRUE(postponed.empty());
+}
+
+TEST(RepositoryIndexerTestCase, WatchChangesOfEditedOutline)
+{
+    string repositoryPath{"/tmp/mf-unit-repository-indexer-watch-edit"};
+    map<string,string> pathToContent;
+    string oPath{repositoryPath + "/memory/edited.md"};
+    pathToContent[oPath] = "# Edited Outline\n\nOutline text.\n\n## Note 1\nNote 1 text.\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ritc-wce.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_TRUE(memory.getRepositoryIndexer().isWatching());
+    m8r::Outline* o = memory.getOutline(oPath);
+    ASSERT_NE(nullptr, o);
+    ASSERT_EQ(1, o->getNotesCount());
+    m8r::Note* n = o->getNotes()[0];
+    vector<m8r::RepositoryChange> changes{};
+    vector<m8r::RepositoryChange> postponed{};
+    // watcher events are read on learn > changes calm down after the next debounce interval
+    auto learnCalmChanges = [&](const string* editedOutlineKey) {
+        changes.clear();
+        postponed.clear();
+        mind.learnChanges(changes, postponed, editedOutlineKey);
+        this_thread::sleep_for(chrono::milliseconds(m8r::RepositoryIndexer::WATCH_DEBOUNCE_MILLIS+100));
+        return mind.learnChanges(changes, postponed, editedOutlineKey);
+    };
+
+    // N is being edited > external change is postponed and O is kept
+    m8r::stringToFile(oPath, "# Edited Outline Changed\n\nOutline text.\n\n## Note 1\nNote 1 text.\n");
+    EXPECT_FALSE(learnCalmChanges(&oPath));
+    EXPECT_TRUE(changes.empty());
+    ASSERT_EQ(1, postponed.size());
+    EXPECT_EQ(oPath, postponed[0].path);
+    EXPECT_EQ(m8r::RepositoryChange::Type::MODIFIED, postponed[0].type);
+    EXPECT_EQ(o, memory.getOutline(oPath));
+
+    // postponed change is reported again while N is being edited
+    EXPECT_FALSE(learnCalmChanges(&oPath));
+    EXPECT_EQ(1, postponed.size());
+
+    // save of edited N overwrites the external change, which is no longer reported
+    n->setName("Note 1 Edited");
+    n->makeModified();
+    mind.remember(oPath);
+    EXPECT_FALSE(learnCalmChanges(nullptr));
+    EXPECT_TRUE(postponed.empty());
+    ASSERT_EQ(o, memory.getOutline(oPath));
+    EXPECT_EQ("Edited Outline", o->getName());
+    string* content = m8r::fileToString(oPath);
+    EXPECT_NE(std::string::npos, content->find("Note 1 Edited"));
+    delete content;
+
+    // viewed O (reads, dirty) is not modified > its change is learned
+    o->incReads();
+    o->makeDirty();
+    m8r::stringToFile(oPath, "# Edited Outline Changed Again\n\nOutline text.\n");
+    ASSERT_TRUE(learnCalmChanges(nullptr));
+    EXPECT_TRUE(postponed.empty());
+    ASSERT_EQ(1, changes.size());
+    EXPECT_EQ(m8r::RepositoryChange::Type::MODIFIED, changes[0].type);
+    o = memory.getOutline(oPath);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Edited Outline Changed Again", o->getName());
+
+    // O modified, but not saved (yet) is kept, its change is postponed until the O is saved
+    o->setName("Edited Outline Modified");
+    o->makeModified();
+    m8r::stringToFile(oPath, "# Edited Outline Changed Thrice\n\nOutline text.\n");
+    EXPECT_FALSE(learnCalmChanges(nullptr));
+    EXPECT_EQ(1, postponed.size());
+    EXPECT_EQ(o, memory.getOutline(oPath));
+    mind.remember(oPath);
+    EXPECT_FALSE(learnCalmChanges(nullptr));
+    EXPECT_TRUE(postponed.empty());
+    EXPECT_EQ("Edited Outline Modified", memory.getOutline(oPath)->getName());
+}
+#endif
+
 TEST(RepositoryIndexerTestCase, MarkdownRepository)
 {
     string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-indexer-md")};
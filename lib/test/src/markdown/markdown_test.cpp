@@ -68,6 +68,10 @@ TEST(MarkdownParserTestCase, MarkdownLexerSections)
     EXPECT_EQ(0, lexems[3]->getOff());
     EXPECT_EQ(2, lexems[3]->getIdx());
     EXPECT_EQ(9, lexems[3]->getLng());
+
+    // file is read (it might be truncated by external editor while lexed)
+    ASSERT_NE(nullptr, lexer.getFile());
+    EXPECT_FALSE(lexer.getFile()->isMapped());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsNoMetadata)
@@ -162,6 +166,45 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsPostDeclaredHeaders2)
     EXPECT_EQ(MarkdownLexemType::BR, lexems[5]->getType());
 }
 
+TEST(MarkdownParserTestCase, MarkdownLexerSectionsFileAndText)
+{
+    string repositoryPath{"/tmp"};
+    string fileName{"md-lexer-file-and-text.md"};
+    string content;
+    string filePath{repositoryPath+"/"+fileName};
+
+    // CRLF line, truncated metadata and missing EOL at the end of file
+    content.assign(
+        "# Lexer <!-- Metadata: t"
+        "\n"
+        "\nFirst line.\r"
+        "\n## Note"
+        "\nLast line w/o EOL.");
+    m8r::stringToFile(filePath, content);
+
+    MarkdownLexerSections fileLexer(&filePath);
+    fileLexer.tokenize();
+    printLexems(fileLexer.getLexems());
+    MarkdownLexerSections textLexer(nullptr);
+    textLexer.tokenize(&content);
+
+    // asserts
+    EXPECT_EQ(5, fileLexer.getLinesCount());
+    EXPECT_EQ(content.size()+1, fileLexer.getFileSize());
+    ASSERT_EQ(textLexer.size(), fileLexer.size());
+    for(size_t i=0; i<fileLexer.size(); i++) {
+        EXPECT_EQ(textLexer[i]->getType(), fileLexer[i]->getType());
+        unique_ptr<string> fileText{fileLexer.getText(fileLexer[i])};
+        unique_ptr<string> textText{textLexer.getText(textLexer[i])};
+        ASSERT_EQ(textText.get()==nullptr, fileText.get()==nullptr);
+        if(fileText) {
+            EXPECT_EQ(*textText, *fileText);
+        }
+    }
+    unique_ptr<string> line{fileLexer.getText(fileLexer[fileLexer.size()-3])};
+    EXPECT_EQ("Last line w/o EOL.", *line);
+}
+
 TEST(MarkdownParserTestCase, MarkdownLexerTimeScope)
 {
     string content;
@@ -421,8 +464,8 @@ TEST(MarkdownParserTestCase, MarkdownRepresentation)
         }
         cout << endl << "    " << (note->getType()?note->getType()->getName():"NULL") << " (type)";
         cout << endl << "      Description[" << note->getDescription().size() << "]:";
-        for(string* description:note->getDescription()) {
-            cout << endl << "        '" << *description << "' (description)";
+        for(DescriptionLine description:note->getDescription()) {
+            cout << endl << "        '" << description << "' (description)";
         }
         cout << endl << "  " << note->getCreated() << " (created)";
         cout << endl << "  " << note->getModified() << " (modified)";
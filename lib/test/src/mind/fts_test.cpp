@@ -19,7 +19,9 @@
 
 #include <stddef.h>
 #include <iostream>
+#include <functional>
 #include <iterator>
+#include <unordered_set>
 #include <string>
 #include <vector>
 
@@ -27,6 +29,7 @@
 
 #include "../../../src/config/configuration.h"
 #include "../../../src/mind/mind.h"
+#include "../../../src/install/installer.h"
 
 extern char* getMindforgerGitHomePath();
 
@@ -94,3 +97,506 @@ TEST(FtsTestCase, FTS) {
     EXPECT_EQ(2, result->size());
     delete result;
 }
+
+TEST(FtsTestCase, TrigramIndex) {
+    // regexp literals
+    vector<string> literals{};
+    m8r::TrigramIndex::regexToLiterals("lo*king", literals);
+    ASSERT_EQ(1, literals.size());
+    EXPECT_EQ("king", literals[0]);
+    literals.clear();
+    m8r::TrigramIndex::regexToLiterals("^abc(de|fg)+hij\\.k[lm]nop?qrst\\d{2}uvw$", literals);
+    ASSERT_EQ(4, literals.size());
+    EXPECT_EQ("abc", literals[0]);
+    EXPECT_EQ("hij.k", literals[1]);
+    EXPECT_EQ("qrst", literals[2]);
+    EXPECT_EQ("uvw", literals[3]);
+    literals.clear();
+    m8r::TrigramIndex::regexToLiterals("abcd|efgh", literals);
+    EXPECT_EQ(0, literals.size());
+
+    // index narrows candidates, but search results are identical
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-ti.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+
+    m8r::TrigramIndex& index = mind.remind().getFtsIndex();
+    EXPECT_EQ(mind.remind().getOutlinesCount(), index.size());
+
+    unordered_set<const m8r::Outline*> candidates{};
+    EXPECT_FALSE(index.candidates(vector<string>{"ha"}, candidates));
+    EXPECT_TRUE(index.candidates(vector<string>{"hash"}, candidates));
+    EXPECT_LT(0, candidates.size());
+    EXPECT_GT(mind.remind().getOutlinesCount(), candidates.size());
+    candidates.clear();
+    EXPECT_TRUE(index.candidates(vector<string>{"no such text in repository"}, candidates));
+    EXPECT_EQ(0, candidates.size());
+
+    vector<pair<string,m8r::FtsSearch>> searches{
+        {"hash", m8r::FtsSearch::EXACT},
+        {"hash", m8r::FtsSearch::IGNORE_CASE},
+        {"the", m8r::FtsSearch::IGNORE_CASE},
+        {"lo*king", m8r::FtsSearch::REGEXP},
+        {"^#", m8r::FtsSearch::REGEXP},
+        {"no such text in repository", m8r::FtsSearch::EXACT},
+    };
+    for(auto& s:searches) {
+        vector<m8r::Note*>* indexed = mind.findNoteFts(s.first, s.second);
+        index.clear();
+        vector<m8r::Note*>* scanned = mind.findNoteFts(s.first, s.second);
+        cout << "'" << s.first << "' found " << indexed->size() << endl;
+        EXPECT_EQ(*scanned, *indexed);
+        // search reindexed all Os
+        EXPECT_EQ(mind.remind().getOutlinesCount(), index.size());
+        delete indexed;
+        delete scanned;
+    }
+
+    // reindexed and forgotten Os IDs are reused
+    vector<m8r::Note*>* expected = mind.findNoteFts("hash", m8r::FtsSearch::EXACT);
+    const vector<m8r::Outline*>& outlines = mind.remind().getOutlines();
+    for(int i=0; i<3; i++) {
+        for(auto o=outlines.rbegin(); o!=outlines.rend(); ++o) {
+            index.index(*o);
+        }
+    }
+    index.forget(outlines[0]);
+    index.index(outlines[0]);
+    EXPECT_EQ(outlines.size(), index.getIdsCount());
+    candidates.clear();
+    EXPECT_TRUE(index.candidates(vector<string>{"hash"}, candidates));
+    EXPECT_GT(mind.remind().getOutlinesCount(), candidates.size());
+    vector<m8r::Note*>* reindexed = mind.findNoteFts("hash", m8r::FtsSearch::EXACT);
+    EXPECT_EQ(*expected, *reindexed);
+    delete expected;
+    delete reindexed;
+}
+
+TEST(FtsTestCase, Stream) {
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-fs.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+
+    // streamed matches are identical to the synchronous search result
+    vector<pair<string,m8r::FtsSearch>> searches{
+        {"hash", m8r::FtsSearch::EXACT},
+        {"the", m8r::FtsSearch::IGNORE_CASE},
+        {"^#", m8r::FtsSearch::REGEXP},
+        {"e", m8r::FtsSearch::EXACT},
+        {"no such text in repository", m8r::FtsSearch::EXACT},
+    };
+    auto expectStreamed = [&]() {
+        for(auto& s:searches) {
+            vector<m8r::Note*>* expected = mind.findNoteFts(s.first, s.second);
+            unique_ptr<m8r::FtsStream> stream = mind.findNoteFtsStream(s.first, s.second);
+            vector<m8r::Note*> streamed{};
+            bool done;
+            do {
+                done = stream->isDone();
+                stream->takeMatches(streamed);
+            } while(!done);
+            cout << "'" << s.first << "' streamed " << streamed.size() << endl;
+            EXPECT_EQ(*expected, streamed);
+            EXPECT_EQ(expected->size(), stream->getMatchesCount());
+            delete expected;
+        }
+    };
+    expectStreamed();
+
+    // header-only learned Os are recalled by workers
+    config.setMemoryOutlineBodies(2);
+    mind.learn();
+    expectStreamed();
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+
+    // cancelled stream is done and it can be destroyed w/o waiting for all Os
+    unique_ptr<m8r::FtsStream> stream = mind.findNoteFtsStream("e", m8r::FtsSearch::IGNORE_CASE);
+    stream->cancel();
+    EXPECT_TRUE(stream->isCancelled());
+    EXPECT_TRUE(stream->isDone());
+    stream.reset();
+}
+
+TEST(FtsTestCase, Ranked) {
+    // bounded heap
+    m8r::TopK<int> top{3};
+    for(int i:vector<int>{5, 1, 9, 3, 7, 2}) {
+        top.push(i, static_cast<float>(i));
+    }
+    EXPECT_FALSE(top.accepts(4.f));
+    vector<pair<int,float>> best{};
+    top.take(best);
+    ASSERT_EQ(3, best.size());
+    EXPECT_EQ(9, best[0].first);
+    EXPECT_EQ(7, best[1].first);
+    EXPECT_EQ(5, best[2].first);
+    EXPECT_TRUE(top.empty());
+
+    vector<string> terms{};
+    m8r::Bm25Ranking::queryToTerms("Hash, map & HASH-map", terms);
+    ASSERT_EQ(2, terms.size());
+    EXPECT_EQ("hash", terms[0]);
+    EXPECT_EQ("map", terms[1]);
+
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-fr.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+
+    // every N w/ any query word is ranked, the best first
+    vector<pair<m8r::Note*,float>> all{};
+    mind.findNoteFtsRanked("hash the", all, 1000);
+    vector<m8r::Note*>* hash = mind.findNoteFts("hash", m8r::FtsSearch::IGNORE_CASE);
+    vector<m8r::Note*>* the = mind.findNoteFts("the", m8r::FtsSearch::IGNORE_CASE);
+    unordered_set<m8r::Note*> any{hash->begin(), hash->end()};
+    any.insert(the->begin(), the->end());
+    EXPECT_EQ(any.size(), all.size());
+    for(size_t i=0; i<all.size(); i++) {
+        EXPECT_TRUE(any.count(all[i].first));
+        EXPECT_LT(0.f, all[i].second);
+        if(i) {
+            EXPECT_GE(all[i-1].second, all[i].second);
+        }
+    }
+    delete hash;
+    delete the;
+
+    // top k are the best of all
+    vector<pair<m8r::Note*,float>> top2{};
+    mind.findNoteFtsRanked("hash the", top2, 2);
+    ASSERT_EQ(2, top2.size());
+    EXPECT_EQ(all[0].second, top2[0].second);
+    EXPECT_EQ(all[1].second, top2[1].second);
+
+    // title boost prefers Ns w/ the word in the name
+    m8r::Bm25Parameters titleOnly{};
+    titleOnly.descriptionBoost = 0.f;
+    vector<pair<m8r::Note*,float>> titles{};
+    mind.findNoteFtsRanked("hash", titles, 1000, titleOnly);
+    for(auto& t:titles) {
+        EXPECT_NE(string::npos, m8r::stringFindIgnoreCase(t.first->getName(), "hash"));
+    }
+
+    // short term doesn't widen candidates - all ranked Ns are in Os w/ the longer term
+    vector<pair<m8r::Note*,float>> shortTerm{};
+    mind.findNoteFtsRanked("hash of", shortTerm, 1000);
+    EXPECT_LT(0, shortTerm.size());
+    hash = mind.findNoteFts("hash", m8r::FtsSearch::IGNORE_CASE);
+    unordered_set<const m8r::Outline*> hashOutlines{};
+    for(m8r::Note* n:*hash) {
+        hashOutlines.insert(n->getOutline());
+    }
+    for(auto& s:shortTerm) {
+        EXPECT_TRUE(hashOutlines.count(s.first->getOutline()));
+    }
+    delete hash;
+
+    vector<pair<m8r::Note*,float>> none{};
+    mind.findNoteFtsRanked("nosuchwordinrepository", none, 10);
+    EXPECT_EQ(0, none.size());
+
+    // header-only learned Ns w/o recalled bodies are ranked using learned bodies sizes
+    config.setMemoryOutlineBodies(2);
+    mind.learn();
+    for(int pass=0; pass<2; pass++) {
+        vector<pair<m8r::Note*,float>> headerOnly{};
+        mind.findNoteFtsRanked("hash the", headerOnly, 1000);
+        ASSERT_EQ(all.size(), headerOnly.size());
+        for(size_t i=0; i<all.size(); i++) {
+            EXPECT_FLOAT_EQ(all[i].second, headerOnly[i].second);
+        }
+    }
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+}
+
+TEST(FtsTestCase, IndexStore) {
+    string storeDir{"/tmp/mf-unit-fts-index-store"};
+    m8r::removeDirectoryRecursively(storeDir.c_str());
+    m8r::createDirectory(storeDir);
+
+    // delta > segment > reopen
+    m8r::FtsIndexStore::Stamp stamp{1, 2, 3, 4};
+    vector<uint32_t> trigrams{};
+    {
+        m8r::FtsIndexStore store{};
+        store.open(storeDir);
+        EXPECT_EQ(0, store.getSegmentsCount());
+        store.put("/o1.md", stamp, vector<uint32_t>{1, 2, 3});
+        store.put("/o2.md", stamp, vector<uint32_t>{});
+        EXPECT_TRUE(store.lookup("/o1.md", stamp, trigrams));
+        EXPECT_TRUE(store.flush());
+        EXPECT_EQ(0, store.getDeltaSize());
+        // flushed delta is looked up while it's written in background
+        EXPECT_TRUE(store.lookup("/o1.md", stamp, trigrams));
+        store.waitForFlush();
+        EXPECT_EQ(1, store.getSegmentsCount());
+    }
+    {
+        m8r::FtsIndexStore store{};
+        store.open(storeDir);
+        EXPECT_EQ(1, store.getSegmentsCount());
+        trigrams.clear();
+        EXPECT_TRUE(store.lookup("/o1.md", stamp, trigrams));
+        EXPECT_EQ((vector<uint32_t>{1, 2, 3}), trigrams);
+        EXPECT_TRUE(store.lookup("/o2.md", stamp, trigrams));
+        EXPECT_TRUE(trigrams.empty());
+        EXPECT_FALSE(store.lookup("/o3.md", stamp, trigrams));
+        // modified O
+        EXPECT_FALSE(store.lookup("/o1.md", m8r::FtsIndexStore::Stamp{1, 2, 4, 4}, trigrams));
+        // file w/ the same modification time, but different content
+        EXPECT_FALSE(store.lookup("/o1.md", m8r::FtsIndexStore::Stamp{1, 2, 3, 5}, trigrams));
+
+        // tombstone in newer segment hides older entry
+        store.remove("/o2.md");
+        EXPECT_FALSE(store.lookup("/o2.md", stamp, trigrams));
+        store.flush();
+        EXPECT_FALSE(store.lookup("/o2.md", stamp, trigrams));
+
+        // too many segments (2 + 7 flushes) are merged in background
+        for(size_t i=0; i<m8r::FtsIndexStore::MAX_SEGMENTS-1; i++) {
+            store.put("/o" + std::to_string(i) + "-new.md", stamp, vector<uint32_t>{static_cast<uint32_t>(i)});
+            store.flush();
+        }
+        store.waitForFlush();
+        EXPECT_EQ(1, store.getSegmentsCount());
+        EXPECT_TRUE(store.lookup("/o1.md", stamp, trigrams));
+        EXPECT_EQ((vector<uint32_t>{1, 2, 3}), trigrams);
+        EXPECT_FALSE(store.lookup("/o2.md", stamp, trigrams));
+        EXPECT_TRUE(store.lookup("/o6-new.md", stamp, trigrams));
+        EXPECT_EQ((vector<uint32_t>{6}), trigrams);
+    }
+    {
+        m8r::FtsIndexStore store{};
+        store.open(storeDir);
+        EXPECT_EQ(1, store.getSegmentsCount());
+        EXPECT_TRUE(store.lookup("/o6-new.md", stamp, trigrams));
+    }
+
+    // header-only learned Os are indexed from the store w/o recall
+    string repositoryDir{"/tmp/mf-unit-repository-fts-store"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(repositoryDir+"/memory/o1.md", "# First Outline\nText.\n\n## Note\nHashing note text.");
+    m8r::stringToFile(repositoryDir+"/memory/o2.md", "# Second Outline\nText.\n\n## Note\nNote text.");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftc-is.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+
+    {
+        m8r::Mind mind(config);
+        mind.learn();
+        EXPECT_EQ(2, mind.remind().getFtsIndex().size());
+    }
+    config.setMemoryOutlineBodies(1);
+    {
+        m8r::Mind mind(config);
+        mind.learn();
+        m8r::TrigramIndex& index = mind.remind().getFtsIndex();
+        EXPECT_EQ(2, index.size());
+        unordered_set<const m8r::Outline*> candidates{};
+        EXPECT_TRUE(index.candidates(vector<string>{"hashing"}, candidates));
+        ASSERT_EQ(1, candidates.size());
+        EXPECT_EQ("First Outline", (*candidates.begin())->getName());
+
+        vector<m8r::Note*>* result = mind.findNoteFts("hashing", m8r::FtsSearch::IGNORE_CASE);
+        EXPECT_EQ(1, result->size());
+        delete result;
+    }
+    config.setMemoryOutlineBodies(0);
+}
+
+TEST(FtsTestCase, FuzzyName) {
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftc-fn.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    m8r::Mind mind(config);
+    mind.learn();
+
+    vector<m8r::Outline*> outlines{};
+    mind.findOutlineByNameFuzzy("canonicl mesage", outlines);
+    ASSERT_EQ(1, outlines.size());
+    EXPECT_EQ("Canonical Message", outlines[0]->getName());
+    outlines.clear();
+    mind.findOutlineByNameFuzzy("flat notse", outlines);
+    ASSERT_EQ(1, outlines.size());
+    EXPECT_EQ("Outline with Flat Notes Depth", outlines[0]->getName());
+
+    // scoped and unscoped Ns
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    ASSERT_LT(0, o->getNotesCount());
+    string name = o->getNotes()[0]->getName();
+    vector<m8r::Note*> notes{};
+    mind.findNoteByNameFuzzy(name.substr(0, name.size()-1) + "x", notes, 10, o);
+    ASSERT_LE(1, notes.size());
+    EXPECT_EQ(o, notes[0]->getOutline());
+    notes.clear();
+    mind.findNoteByNameFuzzy(name, notes);
+    ASSERT_LE(1, notes.size());
+    EXPECT_EQ(name, notes[0]->getName());
+
+    // only names of the changed O are reindexed
+    m8r::Outline* renamed = mind.remind().getOutlines()[1];
+    renamed->setName("Renamed Fuzzy Notebook");
+    renamed->makeModified();
+    outlines.clear();
+    mind.findOutlineByNameFuzzy("renamed fuzy notebok", outlines);
+    ASSERT_EQ(1, outlines.size());
+    EXPECT_EQ(renamed, outlines[0]);
+    outlines.clear();
+    mind.findOutlineByNameFuzzy("canonicl mesage", outlines);
+    ASSERT_EQ(1, outlines.size());
+    EXPECT_EQ("Canonical Message", outlines[0]->getName());
+}
+
+TEST(FtsTestCase, Query) {
+    string repositoryDir{"/tmp/mf-unit-repository-query"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string recent{"2026-01-10 10:00:00"};
+    string old{"2016-01-10 10:00:00"};
+    auto note = [](const string& name, const string& type, const string& tags, const string& read, const string& text) {
+        return "## " + name + " <!-- Metadata: type: " + type + "; created: 2016-01-01 10:00:00; reads: 1; read: "
+            + read + "; revision: 1; modified: " + read + "; tags: " + tags + "; -->\n" + text + "\n\n";
+    };
+    for(int i=0; i<10; i++) {
+        string o{"# Outline " + std::to_string(i) + "\nText.\n\n"};
+        o += note("Release plan", i%2 ? "Idea" : "Action", "todo,project", i<3 ? recent : old, "Release notes draft.");
+        o += note("Hashing", "Note", i==7 ? "todo,algorithms" : "algorithms", old, "Similarity codes.");
+        o += note("Review", "Idea", "project", recent, "Code review of hashing.");
+        m8r::stringToFile(repositoryDir+"/memory/o"+std::to_string(i)+".md", o);
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftc-q.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.getAllNotes(notes);
+    ASSERT_EQ(30, notes.size());
+
+    // planner returns the same Ns (in memory order) as brute force filter
+    auto hasTag = [](m8r::Note* n, const string& name) {
+        for(const m8r::Tag* t:*n->getTags()) if(t->getName()==name) return true;
+        return false;
+    };
+    auto isRecent = [](m8r::Note* n) { return n->getRead() >= time(nullptr)-365*24*60*60; };
+    auto expectQuery = [&](const string& query, std::function<bool(m8r::Note*)> predicate, size_t count) {
+        vector<m8r::Note*> expected{};
+        for(m8r::Outline* o:mind.remind().getOutlines()) {
+            for(m8r::Note* n:o->getNotes()) {
+                if(predicate(n)) expected.push_back(n);
+            }
+        }
+        vector<m8r::Note*> found{};
+        mind.findNotesByQuery(query, found);
+        EXPECT_EQ(expected, found) << query;
+        EXPECT_EQ(count, found.size()) << query;
+    };
+    expectQuery("tag:todo", [&](m8r::Note* n) { return hasTag(n, "todo"); }, 11);
+    expectQuery("tag:todo tag:algorithms", [&](m8r::Note* n) { return hasTag(n, "todo") && hasTag(n, "algorithms"); }, 1);
+    expectQuery("type:idea AND read:<1y", [&](m8r::Note* n) {
+        return n->getType()->getName()=="Idea" && isRecent(n);
+    }, 11);
+    expectQuery("hashing -tag:algorithms", [&](m8r::Note* n) { return n->getName()=="Review"; }, 10);
+    expectQuery("\"release notes\" OR tag:algorithms", [&](m8r::Note* n) {
+        return n->getName()!="Review";
+    }, 20);
+    expectQuery("(tag:project OR type:note) NOT read:>1y", [&](m8r::Note* n) {
+        return (hasTag(n, "project") || n->getType()->getName()=="Note") && isRecent(n);
+    }, 13);
+    expectQuery("tag:\"no such tag\" hashing", [](m8r::Note*) { return false; }, 0);
+
+    // the most selective condition drives the evaluation
+    m8r::TagIndex tagIndex{};
+    m8r::QueryPlanner planner{mind.remind(), tagIndex};
+    vector<m8r::Note*> found{};
+    planner.find(*m8r::NoteQuery::parse("hashing tag:todo tag:algorithms", time(nullptr)), found);
+    EXPECT_EQ(1, found.size());
+    EXPECT_GT(notes.size(), planner.getLastCost());
+
+    // read N is found by read time once it's read
+    m8r::Note* read = mind.remind().getOutlines()[5]->getNotes()[1];
+    ASSERT_EQ("Hashing", read->getName());
+    mind.noteRead(read);
+    expectQuery("read:<1h", [&](m8r::Note* n) { return n == read; }, 1);
+    expectQuery("read:>1h", [&](m8r::Note* n) { return n != read; }, 29);
+
+    // Ns of changed O keep memory order, Ns of forgotten O are not found
+    auto outline = [&](const string& name) {
+        for(m8r::Outline* o:mind.remind().getOutlines()) if(o->getName()==name) return o;
+        return static_cast<m8r::Outline*>(nullptr);
+    };
+    m8r::Note* tagged = outline("Outline 2")->getNotes()[1];
+    tagged->addTag(mind.getOntology().findOrCreateTag("todo"));
+    tagged->makeModified();
+    expectQuery("tag:todo", [&](m8r::Note* n) { return hasTag(n, "todo"); }, 12);
+    expectQuery("hashing", [&](m8r::Note* n) { return n->getName()!="Release plan"; }, 20);
+    mind.outlineForget(outline("Outline 0")->getKey());
+    expectQuery("tag:todo", [&](m8r::Note* n) { return hasTag(n, "todo"); }, 11);
+    expectQuery("type:idea", [&](m8r::Note* n) { return n->getType()->getName()=="Idea"; }, 14);
+    expectQuery("NOT type:idea", [&](m8r::Note* n) { return n->getType()->getName()!="Idea"; }, 13);
+
+    // invalid queries
+    EXPECT_THROW(mind.findNotesByQuery("", found), m8r::MindForgerException);
+    EXPECT_THROW(mind.findNotesByQuery("(tag:todo", found), m8r::MindForgerException);
+    EXPECT_THROW(mind.findNotesByQuery("read:7x", found), m8r::MindForgerException);
+    EXPECT_THROW(mind.findNotesByQuery("color:red", found), m8r::MindForgerException);
+}
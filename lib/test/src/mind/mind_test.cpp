@@ -20,6 +20,9 @@
 #include <stddef.h>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -58,7 +61,7 @@ void dumpOutline(m8r::Outline*& outline)
     cout << endl << "  '" << outline->getName() << "' (name)";
     cout << endl << "  Description[" << outline->getDescription().size() << "]:";
     for (size_t d = 0; d < outline->getDescription().size(); d++) {
-        cout << endl << "    '" << *outline->getDescription()[d] << "' (description)";
+        cout << endl << "    '" << outline->getDescription()[d] << "' (description)";
     }
     cout << endl << "  " << outline->getCreated() << " (created)";
     cout << endl << "  " << outline->getModified() << " (modified)";
@@ -106,8 +109,8 @@ void dumpOutline(m8r::Outline*& outline)
                     << " (type)";
             cout << endl << "      Description[" << note->getDescription().size()
                     << "]:";
-            for (string* description : note->getDescription()) {
-                cout << endl << "        '" << *description << "' (description)";
+            for (m8r::DescriptionLine description : note->getDescription()) {
+                cout << endl << "        '" << description << "' (description)";
             }
             cout << endl << "  " << note->getCreated() << " (created)";
             cout << endl << "  " << note->getModified() << " (modified)";
@@ -306,6 +309,378 @@ TEST(MindTestCase, LearnAmnesiaLearn) {
     EXPECT_EQ(17, memory.getOntology().getTags().size());
 }
 
+TEST(MindTestCase, LearnInParallel) {
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lip.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    // learn sequentially
+    config.setMemoryLearnThreads(1);
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    vector<string> sequentialKeys{};
+    vector<size_t> sequentialNotes{};
+    for(m8r::Outline* o:memory.getOutlines()) {
+        sequentialKeys.push_back(o->getKey());
+        sequentialNotes.push_back(o->getNotes().size());
+    }
+    ASSERT_LT(1, sequentialKeys.size());
+
+    // learn in parallel > same Os in the same order
+    config.setMemoryLearnThreads(4);
+    mind.learn();
+    ASSERT_EQ(sequentialKeys.size(), memory.getOutlines().size());
+    for(size_t i=0; i<sequentialKeys.size(); i++) {
+        EXPECT_EQ(sequentialKeys[i], memory.getOutlines()[i]->getKey());
+        EXPECT_EQ(sequentialNotes[i], memory.getOutlines()[i]->getNotes().size());
+        EXPECT_EQ(memory.getOutlines()[i], memory.getOutline(sequentialKeys[i]));
+    }
+}
+
+TEST(MindTestCase, LearnFromOutlineCache) {
+    string repositoryDir{"/tmp/mf-unit-repository-o-cache"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oFile{repositoryDir+"/memory/o1.md"};
+    m8r::stringToFile(oFile,
+        "Preamble line.\n"
+        "\n"
+        "# Cached Outline <!-- Metadata: type: Goal; tags: cool,idea; links: [L](http://l.com); created: 2018-01-01 10:10:10; reads: 3; read: 2018-01-02 10:10:10; revision: 2; modified: 2018-01-02 10:10:10; importance: 3/5; urgency: 2/5; progress: 20%; -->\n"
+        "Outline text.\n"
+        "\n"
+        "## Note 1 <!-- Metadata: type: Action; tags: todo; created: 2018-01-01 10:10:10; reads: 2; read: 2018-01-02 10:10:10; revision: 1; modified: 2018-01-02 10:10:10; deadline: 2019-01-01 10:10:10; progress: 50%; -->\n"
+        "Note 1 text.\n"
+        "\n"
+        "### Note 2\n"
+        "Note 2 text.\n");
+    m8r::stringToFile(repositoryDir+"/memory/o2.md", "# Second Outline\nText.\n\n## Note\nNote text.");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lfoc.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+
+    // learn from Markdown files > cache is created
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    ASSERT_EQ(2, memory.getOutlines().size());
+    string cacheFile{repositoryDir+"/mind/"+m8r::FILENAME_OUTLINES_CACHE};
+    m8r::OutlineCache cache{mind.getOntology()};
+    cache.load(cacheFile);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_TRUE(cache.isFresh(oFile));
+    m8r::MarkdownOutlineRepresentation mdr{mind.getOntology(), nullptr};
+    string parsed{};
+    for(m8r::Outline* o:memory.getOutlines()) {
+        parsed += o->getKey() + o->getModifiedPretty() + " " + std::to_string(o->getReads());
+        mdr.to(o, &parsed);
+    }
+
+    // learn from cache > the same Os
+    mind.learn();
+    string cached{};
+    for(m8r::Outline* o:memory.getOutlines()) {
+        cached += o->getKey() + o->getModifiedPretty() + " " + std::to_string(o->getReads());
+        mdr.to(o, &cached);
+    }
+    EXPECT_EQ(parsed, cached);
+    m8r::Outline* o = memory.getOutline(oFile);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Goal", o->getType()->getName());
+    EXPECT_EQ(2, o->getTags()->size());
+    EXPECT_EQ(1, o->getLinksCount());
+    EXPECT_EQ(2, o->getPreamble().size());
+    ASSERT_EQ(2, o->getNotes().size());
+    EXPECT_EQ("Action", o->getNotes()[0]->getType()->getName());
+    EXPECT_EQ(50, o->getNotes()[0]->getProgress());
+    EXPECT_EQ(2, o->getNotes()[1]->getDepth());
+
+    // modified file is parsed again
+    m8r::stringToFile(oFile, "# Changed Outline\nText.\n\n## Note\nNote text.\n\n## Another Note\nNote text.");
+    EXPECT_FALSE(cache.isFresh(oFile));
+    mind.learn();
+    o = memory.getOutline(oFile);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Changed Outline", o->getName());
+    EXPECT_EQ(2, o->getNotes().size());
+
+    // corrupted cache is ignored
+    m8r::stringToFile(cacheFile, "M8ROCACH corrupted cache");
+    mind.learn();
+    ASSERT_EQ(2, memory.getOutlines().size());
+    cache.load(cacheFile);
+    EXPECT_EQ(2, cache.size());
+
+    // header-only learn skips Ns bodies of cached Os and caches parsed Os w/o bodies
+    config.setMemoryOutlineBodies(1);
+    mind.learn();
+    o = nullptr;
+    for(m8r::Outline* learned:memory.getOutlines()) {
+        if(learned->getKey() == oFile) o = learned;
+    }
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("\n", o->getNotes()[0]->getDescriptionAsString());
+    EXPECT_EQ(string{"Note text.\n\n"}.size(), o->getNotes()[0]->getDescriptionBytesize());
+    memory.recall(o);
+    EXPECT_EQ("Note text.\n\n", o->getNotes()[0]->getDescriptionAsString());
+    m8r::stringToFile(oFile, "# Header-only Outline\nText.\n\n## Note\nHeader-only note text.");
+    mind.learn();
+    EXPECT_EQ("Header-only Outline", memory.getOutline(oFile)->getName());
+    cache.load(cacheFile, false);
+    EXPECT_TRUE(cache.isFresh(oFile));
+    cache.load(cacheFile);
+    EXPECT_FALSE(cache.isFresh(oFile));
+    // Ns bodies sizes are kept by Os parsed and cached w/o bodies
+    mind.learn();
+    for(m8r::Outline* learned:memory.getOutlines()) {
+        if(learned->getKey() == oFile) {
+            EXPECT_EQ(
+                string{"Header-only note text.\n"}.size(),
+                learned->getNotes()[0]->getDescriptionBytesize());
+        }
+    }
+
+    // Os cached w/o bodies are parsed again to learn bodies
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+    mind.learn();
+    o = memory.getOutline(oFile);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Header-only note text.\n", o->getNotes()[0]->getDescriptionAsString());
+    cache.load(cacheFile);
+    EXPECT_TRUE(cache.isFresh(oFile));
+}
+
+TEST(MindTestCase, LearnOutlineHeaders) {
+    string repositoryDir{"/tmp/mf-unit-repository-o-headers"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> oFiles{};
+    for(string o:{"o1","o2","o3"}) {
+        oFiles.push_back(repositoryDir+"/memory/"+o+".md");
+        m8r::stringToFile(oFiles.back(),
+            "# Outline "+o+"\n"
+            "Outline "+o+" text.\n"
+            "\n"
+            "## Note 1\n"
+            "Note 1 of "+o+" text.\n"
+            "\n"
+            "## Note 2\n"
+            "Note 2 of "+o+" text.\n");
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-loh.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    config.setMemoryOutlineBodies(1);
+
+    // learn header-only > Os and Ns w/o Ns bodies
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    ASSERT_EQ(3, memory.getOutlines().size());
+    EXPECT_EQ(6, memory.getNotesCount());
+    for(m8r::Outline* o:memory.getOutlines()) {
+        EXPECT_NE(string::npos, o->getDescriptionAsString().find("text."));
+        ASSERT_EQ(2, o->getNotes().size());
+        EXPECT_EQ("Note 2", o->getNotes()[1]->getName());
+        EXPECT_EQ("\n", o->getNotes()[1]->getDescriptionAsString());
+    }
+
+    // get O > Ns bodies loaded, LRU O bodies forgotten
+    m8r::Outline* o1 = memory.getOutline(oFiles[0]);
+    EXPECT_EQ("Note 2 of o1 text.\n", o1->getNotes()[1]->getDescriptionAsString());
+    m8r::Outline* o2 = memory.getOutline(oFiles[1]);
+    EXPECT_EQ("Note 1 of o2 text.\n\n", o2->getNotes()[0]->getDescriptionAsString());
+    EXPECT_EQ("\n", o1->getNotes()[1]->getDescriptionAsString());
+
+    // modified O bodies are kept until it's saved
+    o2->getNotes()[0]->clearDescription();
+    o2->getNotes()[0]->addDescriptionLine("Modified text.");
+    o2->notifyChange(o2->getNotes()[0]);
+    m8r::Outline* o3 = memory.getOutline(oFiles[2]);
+    EXPECT_EQ("Note 2 of o3 text.\n", o3->getNotes()[1]->getDescriptionAsString());
+    EXPECT_EQ("Modified text.\n", o2->getNotes()[0]->getDescriptionAsString());
+    memory.remember(oFiles[1]);
+    memory.getOutline(oFiles[0]);
+    EXPECT_EQ("\n", o2->getNotes()[0]->getDescriptionAsString());
+    EXPECT_EQ("Modified text.\n", memory.getOutline(oFiles[1])->getNotes()[0]->getDescriptionAsString());
+
+    // FTS searches bodies of all Os
+    unique_ptr<vector<m8r::Note*>> result{mind.findNoteFts("Note 2 of o3", m8r::FtsSearch::EXACT)};
+    ASSERT_EQ(1, result->size());
+    EXPECT_EQ("Note 2", result->at(0)->getName());
+
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+}
+
+TEST(MindTestCase, LearnOutlineHeadersViewEditSave) {
+    string repositoryDir{"/tmp/mf-unit-repository-o-headers-edit"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> oFiles{};
+    for(string o:{"o1","o2","o3"}) {
+        oFiles.push_back(repositoryDir+"/memory/"+o+".md");
+        m8r::stringToFile(oFiles.back(),
+            "# Outline "+o+"\n"
+            "Outline "+o+" text.\n"
+            "\n"
+            "## Note 1\n"
+            "Note 1 of "+o+" text.\n"
+            "\n"
+            "## Note 2\n"
+            "Note 2 of "+o+" text.\n");
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lohves.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    config.setMemoryOutlineBodies(1);
+
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    ASSERT_EQ(3, memory.getOutlines().size());
+
+    // view: O is recalled (as UI does for Os of outlines table), reads do not prevent forgetting of bodies
+    m8r::Outline* o1 = nullptr;
+    for(m8r::Outline* o:memory.getOutlines()) {
+        if(o->getKey() == oFiles[0]) o1 = o;
+    }
+    ASSERT_NE(nullptr, o1);
+    EXPECT_EQ("\n", o1->getNotes()[0]->getDescriptionAsString());
+    memory.recall(o1);
+    o1->incReads();
+    EXPECT_EQ("Note 1 of o1 text.\n\n", o1->getNotes()[0]->getDescriptionAsString());
+    memory.getOutline(oFiles[1]);
+    EXPECT_EQ("\n", o1->getNotes()[0]->getDescriptionAsString());
+
+    // edit & save: N is edited w/ its body
+    memory.recall(o1);
+    m8r::Note* n = o1->getNotes()[0];
+    string body = n->getDescriptionAsString();
+    n->clearDescription();
+    n->addDescriptionLine(body.substr(0, body.find('\n')));
+    n->addDescriptionLine("Edited line.");
+    n->makeModified();
+    memory.remember(oFiles[0]);
+    memory.getOutline(oFiles[2]);
+
+    // bodies of all Ns survived in the file
+    mind.learn();
+    o1 = memory.getOutline(oFiles[0]);
+    ASSERT_NE(nullptr, o1);
+    EXPECT_EQ("Note 1 of o1 text.\nEdited line.\n", o1->getNotes()[0]->getDescriptionAsString());
+    EXPECT_EQ("Note 2 of o1 text.\n", o1->getNotes()[1]->getDescriptionAsString());
+    unique_ptr<string> file{m8r::fileToString(oFiles[0])};
+    EXPECT_NE(string::npos, file->find("Note 2 of o1 text."));
+
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+}
+
+TEST(MindTestCase, LearnOutlineHeadersRecallBySection) {
+    string repositoryDir{"/tmp/mf-unit-repository-o-headers-recall"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string o1File{repositoryDir+"/memory/o1.md"};
+    m8r::stringToFile(o1File,
+        "# Outline o1\n"
+        "Outline o1 text.\n"
+        "\n"
+        "## Same\n"
+        "First same text.\n"
+        "\n"
+        "## Same\n"
+        "Second same text.\n"
+        "\n"
+        "## Other\n"
+        "Other text.\n");
+    string o2File{repositoryDir+"/memory/o2.md"};
+    m8r::stringToFile(o2File,
+        "# Outline o2\n"
+        "Outline o2 text.\n"
+        "\n"
+        "## Note 1\n"
+        "Note 1 of o2 text.\n");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lohrbs.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    config.setMemoryOutlineBodies(1);
+
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    ASSERT_EQ(2, memory.getOutlines().size());
+    m8r::Outline* o1 = nullptr;
+    for(m8r::Outline* o:memory.getOutlines()) {
+        if(o->getKey() == o1File) o1 = o;
+    }
+    ASSERT_NE(nullptr, o1);
+    ASSERT_EQ(3, o1->getNotes().size());
+
+    // Ns w/ the same name, renamed and moved N while bodies are forgotten > each N gets its own body
+    o1->getNotes()[0]->setName("Renamed");
+    o1->moveNoteUp(o1->getNotes()[2]);
+    memory.recall(o1);
+    ASSERT_EQ(3, o1->getNotes().size());
+    EXPECT_EQ("Renamed", o1->getNotes()[0]->getName());
+    EXPECT_EQ("First same text.\n\n", o1->getNotes()[0]->getDescriptionAsString());
+    EXPECT_EQ("Other", o1->getNotes()[1]->getName());
+    EXPECT_EQ("Other text.\n", o1->getNotes()[1]->getDescriptionAsString());
+    EXPECT_EQ("Same", o1->getNotes()[2]->getName());
+    EXPECT_EQ("Second same text.\n\n", o1->getNotes()[2]->getDescriptionAsString());
+
+    // refactored N takes its body to target O
+    memory.remember(o1File);
+    memory.getOutline(o2File);
+    EXPECT_EQ("\n", o1->getNotes()[1]->getDescriptionAsString());
+    m8r::Outline* o2 = mind.noteRefactor(o1->getNotes()[1], o2File);
+    ASSERT_NE(nullptr, o2);
+    ASSERT_EQ(2, o2->getNotes().size());
+    for(m8r::Note* n:o2->getNotes()) {
+        EXPECT_EQ(0, n->getDescriptionAsString().find(n->getName()=="Other"?"Other text.":"Note 1 of o2 text."));
+    }
+    ASSERT_EQ(2, o1->getNotes().size());
+    memory.recall(o1);
+    EXPECT_EQ(0, o1->getNotes()[0]->getDescriptionAsString().find("First same text."));
+    EXPECT_EQ(0, o1->getNotes()[1]->getDescriptionAsString().find("Second same text."));
+
+    config.setMemoryOutlineBodies(m8r::Configuration::DEFAULT_MEMORY_OUTLINE_BODIES);
+}
+
 TEST(MindTestCase, CommonWordsBlacklist) {
     m8r::CommonWordsBlacklist blacklist{};
 
@@ -313,3 +688,358 @@ TEST(MindTestCase, CommonWordsBlacklist) {
     ASSERT_TRUE(blacklist.findWord("you"));
     ASSERT_TRUE(blacklist.findWord("the"));
 }
+
+TEST(MindTestCase, AllThingsByPrefix) {
+    string repositoryPath{"/lib/test/resources/basic-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-atbp.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+
+    // all things
+    vector<m8r::Thing*> things{};
+    mind.getAllThings(things);
+    vector<m8r::Note*> notes{};
+    mind.getAllNotes(notes);
+    EXPECT_EQ(memory.getOutlinesCount() + notes.size(), things.size());
+
+    // prefix: Os sorted by name, then Ns sorted by name
+    auto expectPrefix = [&](string prefix) {
+        vector<m8r::Thing*> expected{};
+        vector<m8r::Outline*> os{memory.getOutlines()};
+        for(m8r::Outline* o:os) {
+            if(m8r::stringStartsWith(o->getName(), prefix)) expected.push_back(o);
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](m8r::Thing* t1, m8r::Thing* t2) {
+            return t1->getName() < t2->getName();
+        });
+        size_t outlinesCount = expected.size();
+        for(m8r::Note* n:notes) {
+            if(m8r::stringStartsWith(n->getName(), prefix)) expected.push_back(n);
+        }
+        std::stable_sort(expected.begin()+outlinesCount, expected.end(), [](m8r::Thing* t1, m8r::Thing* t2) {
+            return t1->getName() < t2->getName();
+        });
+
+        vector<m8r::Thing*> found{};
+        vector<string> names{};
+        mind.getAllThings(found, &names, &prefix, m8r::ThingNameSerialization::LINK);
+        EXPECT_EQ(expected, found) << prefix;
+        EXPECT_EQ(found.size(), names.size());
+        for(string& n:names) {
+            EXPECT_EQ('[', n[0]);
+        }
+    };
+    expectPrefix("Canonical");
+    expectPrefix("No Meta");
+    expectPrefix("S");
+    expectPrefix("no such prefix");
+
+    // page
+    string prefix{"No Meta"};
+    vector<string> names{};
+    things.clear();
+    mind.getAllThings(things, &names, &prefix, m8r::ThingNameSerialization::NAME, nullptr, 1);
+    ASSERT_EQ(1, things.size());
+    ASSERT_EQ(1, names.size());
+    EXPECT_EQ("No Meta + No Body Twin", names[0]);
+
+    // modified O is reindexed
+    m8r::Outline* o = memory.getOutlines()[0];
+    o->setName("Renamed Outline");
+    o->makeModified();
+    notes.clear();
+    mind.getAllNotes(notes);
+    expectPrefix("Renamed");
+    expectPrefix("Canonical");
+}
+
+TEST(MindTestCase, TagIndex) {
+    string repositoryDir{"/tmp/mf-unit-repository-tag-index"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    auto meta = [](const string& tags) {
+        return " <!-- Metadata: type: Note; created: 2016-01-01 10:00:00; reads: 1; read: 2016-01-01 10:00:00; "
+               "revision: 1; modified: 2016-01-01 10:00:00; tags: " + tags + "; -->\n";
+    };
+    for(int i=0; i<20; i++) {
+        string o{"# Outline " + std::to_string(i) + meta(i%3 ? "project" : "project,cool") + "Text.\n\n"};
+        for(int j=0; j<5; j++) {
+            string tags{j%2 ? "todo" : "done"};
+            if((i+j)%4 == 0) tags += ",important";
+            o += "## Note " + std::to_string(j) + meta(tags) + "Text.\n\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/o"+std::to_string(i)+".md", o);
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-ti.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+
+    m8r::Ontology& ontology = mind.getOntology();
+    const m8r::Tag* todo = ontology.findOrCreateTag("todo");
+    const m8r::Tag* important = ontology.findOrCreateTag("important");
+    const m8r::Tag* cool = ontology.findOrCreateTag("cool");
+    const m8r::Tag* unused = ontology.findOrCreateTag("unused");
+
+    // bitmap index returns the same Ns (in memory order) as brute force filter
+    auto expectNotes = [&](vector<const m8r::Tag*> tags, bool all) {
+        vector<m8r::Note*> expected{};
+        for(m8r::Outline* o:memory.getOutlines()) {
+            for(m8r::Note* n:o->getNotes()) {
+                size_t count = 0;
+                for(const m8r::Tag* t:tags) {
+                    if(n->hasTag(t)) count++;
+                }
+                if(all ? count==tags.size() : count>0) expected.push_back(n);
+            }
+        }
+        vector<m8r::Note*> found{};
+        mind.findNotesByTags(tags, found, all);
+        EXPECT_EQ(expected, found);
+        return found.size();
+    };
+    EXPECT_EQ(40, expectNotes({todo}, true));
+    EXPECT_EQ(10, expectNotes({todo, important}, true));
+    EXPECT_EQ(55, expectNotes({todo, important}, false));
+    EXPECT_EQ(0, expectNotes({todo, unused}, true));
+    EXPECT_EQ(100, expectNotes({}, true));
+
+    vector<m8r::Outline*> outlines{};
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{cool}, outlines);
+    EXPECT_EQ(7, outlines.size());
+
+    // Os out of scope are skipped
+    const m8r::Tag* project = ontology.findOrCreateTag("project");
+    mind.getTagsScopeAspect().setTags(vector<const m8r::Tag*>{cool});
+    outlines.clear();
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{project}, outlines);
+    EXPECT_EQ(7, outlines.size());
+    mind.getTagsScopeAspect().reset();
+
+    // tags edit is indexed
+    m8r::Note* n = memory.getOutlines()[0]->getNotes()[0];
+    EXPECT_FALSE(n->hasTag(todo));
+    n->addTag(todo);
+    n->makeModified();
+    EXPECT_EQ(41, expectNotes({todo}, true));
+    n->setTags(nullptr);
+    n->makeModified();
+    EXPECT_EQ(40, expectNotes({todo}, true));
+
+    // forgotten O
+    m8r::Outline* o = memory.getOutlines()[1];
+    mind.outlineForget(o->getKey());
+    EXPECT_EQ(38, expectNotes({todo}, true));
+
+    // reindexed O keeps its place in memory order
+    outlines.clear();
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{project}, outlines);
+    EXPECT_EQ(memory.getOutlines(), outlines);
+}
+
+TEST(MindTestCase, Statistics) {
+    string repositoryDir{"/tmp/mf-unit-repository-statistics"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    auto meta = [](const string& tags, int reads, int revision) {
+        return " <!-- Metadata: type: Note; created: 2016-01-01 10:00:00; reads: " + std::to_string(reads)
+            + "; read: 2016-01-01 10:00:00; revision: " + std::to_string(revision)
+            + "; modified: 2016-01-01 10:00:00; tags: " + tags + "; -->\n";
+    };
+    for(int i=0; i<10; i++) {
+        string o{"# Outline " + std::to_string(i) + meta(i%2 ? "project" : "none", 10+i, 20-i) + "Text.\n\n"};
+        for(int j=0; j<4; j++) {
+            o += "## Note " + std::to_string(j) + meta(j%2 ? "todo" : "done,cool", i*4+j, 100-i*4-j) + "Text.\n\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/o"+std::to_string(i)+".md", o);
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-s.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+
+    // incremental statistics are the same as full scan
+    auto expectStatistics = [&]() {
+        map<const m8r::Tag*,int> expected{};
+        for(const m8r::Tag* t:mind.getOntology().getTags().values()) {
+            if(t->getName() != "none") expected[t] = 0;
+        }
+        m8r::Outline* mostReadOutline{nullptr};
+        m8r::Note* mostWrittenNote{nullptr};
+        size_t notesCount = 0;
+        for(m8r::Outline* o:memory.getOutlines()) {
+            for(const m8r::Tag* t:*o->getTags()) if(t->getName() != "none") expected[t]++;
+            if(!mostReadOutline || o->getReads() > mostReadOutline->getReads()) mostReadOutline = o;
+            for(m8r::Note* n:o->getNotes()) {
+                for(const m8r::Tag* t:*n->getTags()) if(t->getName() != "none") expected[t]++;
+                if(!mostWrittenNote || n->getRevision() > mostWrittenNote->getRevision()) mostWrittenNote = n;
+                notesCount++;
+            }
+        }
+        map<const m8r::Tag*,int> found{};
+        mind.getTagsCardinality(found);
+        EXPECT_EQ(expected, found);
+
+        m8r::MindStatistics* stats = mind.getStatistics();
+        EXPECT_EQ(notesCount, stats->notesCount);
+        EXPECT_EQ(memory.getOutlineMarkdownsSize(), stats->markdownsBytesize);
+        EXPECT_EQ(mostReadOutline, stats->mostReadOutline);
+        EXPECT_EQ(mostWrittenNote, stats->mostWrittenNote);
+    };
+    expectStatistics();
+    EXPECT_EQ(40, mind.getStatistics()->notesCount);
+
+    // tags edit
+    m8r::Outline* o = memory.getOutlines()[0];
+    o->getNotes()[1]->setTags(nullptr);
+    o->getNotes()[1]->makeModified();
+    expectStatistics();
+
+    // N read event
+    m8r::Note* n = o->getNotes()[0];
+    n->setReads(1000);
+    mind.noteRead(n);
+    EXPECT_EQ(n, mind.getStatistics()->mostReadNote);
+
+    // forgotten O
+    mind.outlineForget(memory.getOutlines()[3]->getKey());
+    expectStatistics();
+    EXPECT_EQ(36, mind.getStatistics()->notesCount);
+
+    // scoped cardinalities are the same as full scan of things in the scope
+    auto expectScopedCardinality = [&]() {
+        const m8r::MindScopeAspect& scope = mind.getScopeAspect();
+        map<const m8r::Tag*,int> expected{};
+        for(const m8r::Tag* t:mind.getOntology().getTags().values()) {
+            if(t->getName() != "none") expected[t] = 0;
+        }
+        for(m8r::Outline* o:memory.getOutlines()) {
+            if(scope.isInScope(o)) {
+                for(const m8r::Tag* t:*o->getTags()) if(t->getName() != "none") expected[t]++;
+                for(m8r::Note* n:o->getNotes()) {
+                    if(scope.isInScope(n)) {
+                        for(const m8r::Tag* t:*n->getTags()) if(t->getName() != "none") expected[t]++;
+                    }
+                }
+            }
+        }
+        map<const m8r::Tag*,int> found{};
+        mind.getTagsCardinality(found);
+        EXPECT_EQ(expected, found);
+        return found;
+    };
+    const m8r::Tag* project = mind.getOntology().findOrCreateTag("project");
+    const m8r::Tag* cool = mind.getOntology().findOrCreateTag("cool");
+    mind.getTagsScopeAspect().setTags(vector<const m8r::Tag*>{project});
+    EXPECT_EQ(4, expectScopedCardinality()[project]);
+    // changed O in the scope
+    o = memory.getOutlines()[1];
+    ASSERT_TRUE(o->hasTag(project));
+    o->getNotes()[0]->setTags(nullptr);
+    o->getNotes()[0]->makeModified();
+    EXPECT_EQ(7, expectScopedCardinality()[cool]);
+    // another scope
+    mind.getTagsScopeAspect().reset();
+    mind.getTimeScopeAspect().setTimeScope(m8r::TimeScope{0,0,1,0,0});
+    EXPECT_EQ(0, expectScopedCardinality()[cool]);
+    // read N is in the scope once its O is read
+    n = o->getNotes()[2];
+    ASSERT_TRUE(n->hasTag(cool));
+    mind.noteRead(n);
+    EXPECT_EQ(0, expectScopedCardinality()[cool]);
+    o->makeRead();
+    EXPECT_EQ(1, expectScopedCardinality()[cool]);
+    mind.getTimeScopeAspect().resetTimeScope();
+    expectStatistics();
+}
+
+TEST(MindTestCase, OutlineChanges) {
+    string repositoryDir{"/tmp/mf-unit-repository-outline-changes"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    for(int i=0; i<3; i++) {
+        m8r::stringToFile(
+            repositoryDir+"/memory/o"+std::to_string(i)+".md",
+            "# Outline " + std::to_string(i) + "\nText.\n\n## Note\nText.\n");
+    }
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-oc.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::Memory& memory = mind.remind();
+    mind.learn();
+    ASSERT_EQ(3, memory.getOutlinesCount());
+
+    // changes are not known to a new cursor - all Os are to be indexed
+    const m8r::OutlineChanges& changes = memory.getChanges();
+    m8r::OutlineChanges::Cursor cursor{};
+    vector<m8r::Outline*> changed{};
+    vector<const m8r::Outline*> forgotten{};
+    EXPECT_FALSE(changes.since(cursor, changed, forgotten));
+    cursor = changes.end();
+    EXPECT_TRUE(changes.isCurrent(cursor));
+
+    // O is reported once regardless how many times it changed
+    m8r::Outline* o0 = memory.getOutlines()[0];
+    m8r::Outline* o1 = memory.getOutlines()[1];
+    o0->makeModified();
+    o1->makeRead();
+    o0->getNotes()[0]->makeModified();
+    EXPECT_FALSE(changes.isCurrent(cursor));
+    EXPECT_TRUE(changes.since(cursor, changed, forgotten));
+    EXPECT_EQ((vector<m8r::Outline*>{o1, o0}), changed);
+    EXPECT_TRUE(forgotten.empty());
+    EXPECT_TRUE(changes.isCurrent(cursor));
+
+    // remembered and forgotten Os
+    changed.clear();
+    memory.remember(o1->getKey());
+    mind.outlineForget(o0->getKey());
+    EXPECT_TRUE(changes.since(cursor, changed, forgotten));
+    EXPECT_EQ(vector<m8r::Outline*>{o1}, changed);
+    EXPECT_EQ(vector<const m8r::Outline*>{o0}, forgotten);
+
+    // forgotten O no longer reports its changes
+    o0->makeModified();
+    EXPECT_TRUE(changes.isCurrent(cursor));
+
+    // amnesia starts a new epoch
+    memory.amnesia();
+    EXPECT_FALSE(changes.since(cursor, changed, forgotten));
+}
@@ -933,3 +933,36 @@ TEST(NoteTestCase, DirectNoteChildren) {
     EXPECT_EQ("2", directChildren[1]->getName());
     EXPECT_EQ("4", directChildren[2]->getName());
 }
+
+TEST(NoteTestCase, Description) {
+    m8r::Description d{};
+    EXPECT_TRUE(d.empty());
+
+    d.addLine("First line.");
+    d.addLine("");
+    d.addText("Second line.\nThird line.");
+    EXPECT_EQ(4, d.size());
+    EXPECT_EQ("First line.\n\nSecond line.\nThird line.\n", d.getText());
+    EXPECT_TRUE(d[0] == "First line.");
+    EXPECT_TRUE(d[1].empty());
+    EXPECT_TRUE(d[3] == "Third line.");
+    EXPECT_EQ("First line.  Second line. Third line. ", d.toString(" "));
+
+    vector<string*> lines{};
+    d.toLines(lines);
+    EXPECT_EQ(4, lines.size());
+    EXPECT_EQ("Second line.", *lines[2]);
+
+    m8r::Note n{nullptr, nullptr};
+    n.setDescription(lines);
+    for(string* l:lines) {
+        delete l;
+    }
+    EXPECT_EQ(d.getText(), n.getDescription().getText());
+    EXPECT_EQ(d.getText(), n.getDescriptionAsString());
+
+    m8r::Description moved{};
+    n.moveDescription(moved);
+    EXPECT_TRUE(n.getDescription().empty());
+    EXPECT_EQ(4, moved.size());
+}
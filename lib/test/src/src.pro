@@ -122,10 +122,17 @@ SOURCES += \
     ../benchmark/html_benchmark.cpp \
     ./html/html_test.cpp \
     ./ai/nlp_test.cpp \
+    ./ai/aa_top_k_store_test.cpp \
+    ./ai/min_hash_lsh_test.cpp \
     ../benchmark/trie_benchmark.cpp \
     ../benchmark/ai_benchmark.cpp \
+    ../benchmark/string_benchmark.cpp \
     ./gear/file_utils_test.cpp \
     ./gear/trie_test.cpp \
+    ./gear/linear_regex_test.cpp \
+    ./gear/fuzzy_name_index_test.cpp \
+    ./gear/roaring_bitmap_test.cpp \
+    ./gear/task_executor_test.cpp \
     ./ai/autolinking_test.cpp \
     ./ai/autolinking_cmark_test.cpp \
     ./mind/filesystem_information_test.cpp